@@ -0,0 +1,25 @@
+#include "BenchmarkEnvironment.h"
+#include <InputManager.h>
+#include <Renderer/Renderers/Null/RendererNull.h>
+
+#include "Utils/ServiceLocator.h"
+#include "ECS/Components/Singletons/MapSingleton.h"
+
+BenchmarkEnvironment::BenchmarkEnvironment()
+{
+    ServiceLocator::SetGameRegistry(&gameRegistry);
+    ServiceLocator::SetUIRegistry(&uiRegistry);
+
+    renderer = new Renderer::RendererNull();
+    ServiceLocator::SetRenderer(renderer);
+
+    inputManager = new InputManager();
+    ServiceLocator::SetInputManager(inputManager);
+
+    gameRegistry.set<MapSingleton>();
+}
+
+BenchmarkEnvironment::~BenchmarkEnvironment()
+{
+    renderer->Deinit();
+}
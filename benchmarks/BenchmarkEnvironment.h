@@ -0,0 +1,22 @@
+#pragma once
+#include <NovusTypes.h>
+#include <entt.hpp>
+
+class InputManager;
+namespace Renderer
+{
+    class RendererNull;
+}
+
+// Everything the client systems expect to find in the ServiceLocator, backed by the null renderer so no GPU or window is needed
+struct BenchmarkEnvironment
+{
+    BenchmarkEnvironment();
+    ~BenchmarkEnvironment();
+
+    entt::registry gameRegistry;
+    entt::registry uiRegistry;
+
+    Renderer::RendererNull* renderer = nullptr;
+    InputManager* inputManager = nullptr;
+};
@@ -0,0 +1,112 @@
+#include "BenchmarkRunner.h"
+#include <Utils/DebugHandler.h>
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+
+void BenchmarkRunner::Add(const std::string& name, u32 iterations, u64 itemsPerIteration, std::function<void()> function, std::function<void()> setup)
+{
+    assert(iterations > 0);
+    assert(function != nullptr);
+
+    Benchmark& benchmark = _benchmarks.emplace_back();
+    benchmark.name = name;
+    benchmark.iterations = iterations;
+    benchmark.itemsPerIteration = itemsPerIteration;
+    benchmark.function = std::move(function);
+    benchmark.setup = std::move(setup);
+}
+
+void BenchmarkRunner::Run(const std::string& filter)
+{
+    std::vector<f64> timings;
+
+    for (Benchmark& benchmark : _benchmarks)
+    {
+        if (!filter.empty() && benchmark.name.find(filter) == std::string::npos)
+            continue;
+
+        if (benchmark.setup)
+            benchmark.setup();
+
+        // One untimed warmup iteration so first-touch allocations and cache misses don't end up in the results
+        benchmark.function();
+
+        timings.clear();
+        timings.reserve(benchmark.iterations);
+        for (u32 i = 0; i < benchmark.iterations; i++)
+        {
+            auto start = std::chrono::high_resolution_clock::now();
+            benchmark.function();
+            auto end = std::chrono::high_resolution_clock::now();
+
+            timings.push_back(std::chrono::duration<f64, std::nano>(end - start).count());
+        }
+
+        std::sort(timings.begin(), timings.end());
+
+        Result& result = _results.emplace_back();
+        result.name = benchmark.name;
+        result.iterations = benchmark.iterations;
+        result.itemsPerIteration = benchmark.itemsPerIteration;
+        result.minNs = timings.front();
+        result.maxNs = timings.back();
+        result.medianNs = timings[timings.size() / 2];
+
+        f64 total = 0.0;
+        for (f64 timing : timings)
+        {
+            total += timing;
+        }
+        result.meanNs = total / timings.size();
+
+        NC_LOG_MESSAGE("%-48s median %12.3f us, min %12.3f us, %8u iterations", result.name.c_str(), result.medianNs / 1000.0, result.minNs / 1000.0, result.iterations);
+    }
+}
+
+bool BenchmarkRunner::WriteResults(const std::string& path) const
+{
+    std::ofstream file(path, std::ofstream::out | std::ofstream::trunc);
+    if (!file)
+    {
+        NC_LOG_ERROR("Failed to open %s for writing", path.c_str());
+        return false;
+    }
+
+    // Names are plain identifiers, so they don't need escaping
+    file << std::fixed << std::setprecision(1);
+    file << "{\n";
+    file << "    \"version\": 1,\n";
+    file << "    \"timestamp\": " << static_cast<u64>(std::time(nullptr)) << ",\n";
+#ifdef NC_Debug
+    file << "    \"configuration\": \"Debug\",\n";
+#else
+    file << "    \"configuration\": \"Release\",\n";
+#endif // NC_Debug
+    file << "    \"benchmarks\": [";
+
+    for (size_t i = 0; i < _results.size(); i++)
+    {
+        const Result& result = _results[i];
+        f64 itemsPerSecond = result.medianNs > 0.0 ? (result.itemsPerIteration * 1000000000.0) / result.medianNs : 0.0;
+
+        file << (i == 0 ? "\n" : ",\n");
+        file << "        { ";
+        file << "\"name\": \"" << result.name << "\", ";
+        file << "\"iterations\": " << result.iterations << ", ";
+        file << "\"itemsPerIteration\": " << result.itemsPerIteration << ", ";
+        file << "\"minNs\": " << result.minNs << ", ";
+        file << "\"medianNs\": " << result.medianNs << ", ";
+        file << "\"meanNs\": " << result.meanNs << ", ";
+        file << "\"maxNs\": " << result.maxNs << ", ";
+        file << "\"itemsPerSecond\": " << itemsPerSecond;
+        file << " }";
+    }
+
+    file << "\n    ]\n";
+    file << "}\n";
+
+    return true;
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <NovusTypes.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+class BenchmarkRunner
+{
+public:
+    struct Result
+    {
+        std::string name;
+        u32 iterations = 0;
+        u64 itemsPerIteration = 0;
+
+        f64 minNs = 0.0;
+        f64 medianNs = 0.0;
+        f64 meanNs = 0.0;
+        f64 maxNs = 0.0;
+    };
+
+    // Setup runs once, untimed, right before the benchmark so expensive state is only created for benchmarks that pass the filter
+    void Add(const std::string& name, u32 iterations, u64 itemsPerIteration, std::function<void()> function, std::function<void()> setup = nullptr);
+
+    void Run(const std::string& filter);
+    bool WriteResults(const std::string& path) const;
+
+private:
+    struct Benchmark
+    {
+        std::string name;
+        u32 iterations;
+        u64 itemsPerIteration;
+        std::function<void()> function;
+        std::function<void()> setup;
+    };
+
+    std::vector<Benchmark> _benchmarks;
+    std::vector<Result> _results;
+};
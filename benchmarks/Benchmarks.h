@@ -0,0 +1,14 @@
+#pragma once
+
+class BenchmarkRunner;
+struct BenchmarkEnvironment;
+
+namespace Benchmarks
+{
+    void AddMapBenchmarks(BenchmarkRunner& runner, BenchmarkEnvironment& environment);
+    void AddRenderModelBenchmarks(BenchmarkRunner& runner, BenchmarkEnvironment& environment);
+    void AddCommandListBenchmarks(BenchmarkRunner& runner, BenchmarkEnvironment& environment);
+    void AddUIBenchmarks(BenchmarkRunner& runner, BenchmarkEnvironment& environment);
+    void AddScriptBenchmarks(BenchmarkRunner& runner, BenchmarkEnvironment& environment);
+    void AddNetworkBenchmarks(BenchmarkRunner& runner, BenchmarkEnvironment& environment);
+}
@@ -0,0 +1,144 @@
+#include "Benchmarks.h"
+#include "BenchmarkRunner.h"
+#include "BenchmarkEnvironment.h"
+
+#include <Memory/StackAllocator.h>
+#include <Renderer/Renderer.h>
+#include <Renderer/RenderGraph.h>
+#include <Renderer/RenderGraphBuilder.h>
+#include <Renderer/InstanceData.h>
+#include <Renderer/Renderers/Null/RendererNull.h>
+#include <vector>
+
+#include "Rendering/ViewConstantBuffer.h"
+
+namespace Benchmarks
+{
+    constexpr u32 NUM_BENCHMARK_DRAWS = 8192;
+    constexpr u32 NUM_BENCHMARK_INSTANCES = 256;
+    constexpr u16 NUM_BENCHMARK_DRAW_MODELS = 64;
+    constexpr size_t BENCHMARK_ALLOCATOR_SIZE = 8 * 1024 * 1024;
+
+    struct CommandListBenchmarkData
+    {
+        Memory::StackAllocator* renderGraphAllocator = nullptr;
+        Memory::StackAllocator* frameAllocator = nullptr;
+        Renderer::RenderGraph* renderGraph = nullptr;
+        Renderer::ImageID renderTarget = Renderer::ImageID::Invalid();
+        Renderer::RenderPassMutableResource renderTargetResource;
+        Renderer::GraphicsPipelineID pipeline = Renderer::GraphicsPipelineID::Invalid();
+        std::vector<Renderer::ModelID> models;
+        Renderer::ConstantBuffer<ViewConstantBuffer>* viewConstantBuffer = nullptr;
+        std::vector<Renderer::InstanceData> instances;
+    };
+
+    void AddCommandListBenchmarks(BenchmarkRunner& runner, BenchmarkEnvironment& environment)
+    {
+        std::shared_ptr<CommandListBenchmarkData> benchmarkData = std::make_shared<CommandListBenchmarkData>();
+
+        // Records a pass with the bind pattern of the main pass and translates it into the null backend, which is a full frame minus the GPU
+        runner.Add("CommandList::Record", 256, NUM_BENCHMARK_DRAWS, [benchmarkData, &environment]()
+        {
+            if (!benchmarkData->renderGraph->IsValid())
+            {
+                benchmarkData->renderGraph->Setup();
+            }
+
+            benchmarkData->renderGraph->Execute(0);
+            environment.renderer->Present(nullptr, benchmarkData->renderTarget);
+
+            benchmarkData->frameAllocator->Reset();
+        },
+        [benchmarkData, &environment]() // Setup
+        {
+            Renderer::RendererNull* renderer = environment.renderer;
+
+            benchmarkData->renderGraphAllocator = new Memory::StackAllocator(BENCHMARK_ALLOCATOR_SIZE);
+            benchmarkData->renderGraphAllocator->Init();
+
+            benchmarkData->frameAllocator = new Memory::StackAllocator(BENCHMARK_ALLOCATOR_SIZE);
+            benchmarkData->frameAllocator->Init();
+
+            Renderer::ImageDesc renderTargetDesc;
+            renderTargetDesc.debugName = "BenchmarkColor";
+            renderTargetDesc.dimensions = ivec2(1920, 1080);
+            renderTargetDesc.format = Renderer::IMAGE_FORMAT_R16G16B16A16_FLOAT;
+            renderTargetDesc.sampleCount = Renderer::SAMPLE_COUNT_1;
+            benchmarkData->renderTarget = renderer->CreateImage(renderTargetDesc);
+
+            benchmarkData->viewConstantBuffer = renderer->CreateConstantBuffer<ViewConstantBuffer>();
+
+            // The draws cycle through these like the client cycles through its loaded models
+            benchmarkData->models.resize(NUM_BENCHMARK_DRAW_MODELS);
+            for (Renderer::ModelID& model : benchmarkData->models)
+            {
+                Renderer::PrimitiveModelDesc modelDesc;
+                model = renderer->CreatePrimitiveModel(modelDesc);
+            }
+
+            benchmarkData->instances.resize(NUM_BENCHMARK_INSTANCES);
+            for (Renderer::InstanceData& instance : benchmarkData->instances)
+            {
+                instance.Init(renderer);
+            }
+
+            Renderer::RenderGraphDesc renderGraphDesc;
+            renderGraphDesc.allocator = benchmarkData->renderGraphAllocator;
+            renderGraphDesc.frameAllocator = benchmarkData->frameAllocator;
+            benchmarkData->renderGraph = renderer->CreateRenderGraph(renderGraphDesc);
+            benchmarkData->renderGraph->AddOutput(benchmarkData->renderTarget);
+
+            struct BenchmarkPassData
+            {
+                Renderer::RenderPassMutableResource renderTarget;
+            };
+
+            CommandListBenchmarkData* data = benchmarkData.get();
+            data->renderGraph->AddPass<BenchmarkPassData>("Benchmark Pass",
+                [data](BenchmarkPassData& passData, Renderer::RenderGraphBuilder& builder) // Setup
+            {
+                passData.renderTarget = builder.Write(data->renderTarget, Renderer::RenderGraphBuilder::WriteMode::WRITE_MODE_RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::LOAD_MODE_CLEAR);
+                data->renderTargetResource = passData.renderTarget;
+
+                return true;
+            },
+                [data, renderer](BenchmarkPassData& passData, Renderer::CommandList& commandList) // Execute
+            {
+                commandList.Clear(data->renderTarget, Color(0, 0, 0, 1));
+                commandList.BeginPipeline(data->pipeline);
+                commandList.SetConstantBuffer(0, data->viewConstantBuffer->GetDescriptor(0), 0);
+                commandList.SetStorageBuffer(1, renderer->GetInstanceBuffer()->GetDescriptor(0), 0);
+
+                for (u32 i = 0; i < NUM_BENCHMARK_DRAWS; i++)
+                {
+                    // Draws are sorted by model like a sorted RenderLayer would be
+                    Renderer::ModelID modelID = data->models[(i * NUM_BENCHMARK_DRAW_MODELS) / NUM_BENCHMARK_DRAWS];
+                    Renderer::InstanceData& instance = data->instances[i % NUM_BENCHMARK_INSTANCES];
+
+                    commandList.Draw(modelID, instance.GetInstanceID());
+                }
+                commandList.EndPipeline(data->pipeline);
+            });
+
+            // The client only creates its pipelines the first time a pass runs, so creating it is not part of what we measure
+            data->renderGraph->Setup();
+
+            Renderer::GraphicsPipelineDesc pipelineDesc;
+            data->renderGraph->InitializePipelineDesc(pipelineDesc);
+
+            Renderer::VertexShaderDesc vertexShaderDesc;
+            vertexShaderDesc.path = "Data/shaders/test.vert.spv";
+            pipelineDesc.states.vertexShader = renderer->LoadShader(vertexShaderDesc);
+
+            Renderer::PixelShaderDesc pixelShaderDesc;
+            pixelShaderDesc.path = "Data/shaders/test.frag.spv";
+            pipelineDesc.states.pixelShader = renderer->LoadShader(pixelShaderDesc);
+
+            pipelineDesc.states.constantBufferStates[0].enabled = true; // ViewCB
+            pipelineDesc.states.constantBufferStates[0].shaderVisibility = Renderer::ShaderVisibility::SHADER_VISIBILITY_VERTEX;
+            pipelineDesc.renderTargets[0] = data->renderTargetResource;
+
+            data->pipeline = renderer->CreatePipeline(pipelineDesc);
+        });
+    }
+}
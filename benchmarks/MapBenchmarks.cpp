@@ -0,0 +1,123 @@
+#include "Benchmarks.h"
+#include "BenchmarkRunner.h"
+#include "BenchmarkEnvironment.h"
+
+#include <Utils/ByteBuffer.h>
+#include <Containers/StringTable.h>
+#include <random>
+
+#include "Utils/MapLoader.h"
+#include "Gameplay/Map/Map.h"
+#include "Rendering/TerrainRenderer.h"
+#include "ECS/Components/Singletons/MapSingleton.h"
+
+namespace Benchmarks
+{
+    constexpr u16 BENCHMARK_CHUNK_X = 31; // The chunk TerrainRenderer loads around, so its constructor picks ours up as well
+    constexpr u16 BENCHMARK_CHUNK_Y = 49;
+    constexpr u32 MAX_ALPHA_MAPS_PER_CELL = 3;
+
+    // Writes a chunk in the same layout as the extracted .nmap files, with random heights, layers and alpha maps
+    std::shared_ptr<Bytebuffer> CreateSyntheticChunk()
+    {
+        std::mt19937 random(1337);
+        std::uniform_real_distribution<f32> heightDistribution(-50.0f, 50.0f);
+        std::uniform_int_distribution<u32> layerDistribution(0, MAX_ALPHA_MAPS_PER_CELL);
+
+        StringTable stringTable;
+        u32 textureIds[MAX_ALPHA_MAPS_PER_CELL + 1];
+        for (u32 i = 0; i < MAX_ALPHA_MAPS_PER_CELL + 1; i++)
+        {
+            textureIds[i] = stringTable.AddString("Tileset/Elwynn/ElwynnGrass" + std::to_string(i) + ".dds");
+        }
+
+        u32 numLayers[Terrain::MAP_CELLS_PER_CHUNK];
+        size_t size = sizeof(Terrain::ChunkHeader) + sizeof(Terrain::HeightHeader) + sizeof(Terrain::HeightBox) + 4096; // Leave room for the string table
+        for (u32 i = 0; i < Terrain::MAP_CELLS_PER_CHUNK; i++)
+        {
+            numLayers[i] = layerDistribution(random);
+            size += sizeof(Terrain::Cell) + sizeof(u32) + (numLayers[i] * sizeof(Terrain::AlphaMap));
+        }
+
+        std::shared_ptr<Bytebuffer> buffer = std::make_shared<Bytebuffer>(nullptr, size);
+
+        Terrain::ChunkHeader header;
+        header.token = Terrain::MAP_CHUNK_TOKEN;
+        header.version = Terrain::MAP_CHUNK_VERSION;
+        Terrain::HeightHeader heightHeader;
+        Terrain::HeightBox heightBox;
+        buffer->Put<Terrain::ChunkHeader>(header);
+        buffer->Put<Terrain::HeightHeader>(heightHeader);
+        buffer->Put<Terrain::HeightBox>(heightBox);
+
+        Terrain::AlphaMap alphaMap;
+        for (u32 i = 0; i < Terrain::MAP_CELLS_PER_CHUNK; i++)
+        {
+            Terrain::Cell cell;
+            for (f32& height : cell.heightData)
+            {
+                height = heightDistribution(random);
+            }
+
+            // The base layer has no alpha map, every layer on top of it has one
+            u32 numAlphaMaps = numLayers[i];
+            for (u32 layer = 0; layer < numAlphaMaps + 1; layer++)
+            {
+                cell.layers[layer].textureId = textureIds[layer];
+            }
+            buffer->Put<Terrain::Cell>(cell);
+
+            buffer->Put<u32>(numAlphaMaps);
+            for (u32 j = 0; j < numAlphaMaps; j++)
+            {
+                for (u8& alpha : alphaMap.alphaMap)
+                {
+                    alpha = static_cast<u8>(random());
+                }
+                buffer->Put<Terrain::AlphaMap>(alphaMap);
+            }
+        }
+
+        stringTable.Serialize(*buffer);
+        return buffer;
+    }
+
+    void AddMapBenchmarks(BenchmarkRunner& runner, BenchmarkEnvironment& environment)
+    {
+        // Chunks are big, so these live on the heap and get shared between the lambdas
+        std::shared_ptr<Bytebuffer> chunkBuffer = CreateSyntheticChunk();
+        std::shared_ptr<Terrain::Chunk> chunk = std::make_shared<Terrain::Chunk>();
+
+        runner.Add("MapLoader::ExtractChunkData", 64, 1, [chunkBuffer, chunk]()
+        {
+            chunkBuffer->readData = 0;
+
+            StringTable stringTable;
+            MapLoader::ExtractChunkData(*chunkBuffer, *chunk, stringTable);
+        });
+
+        // Every call creates new buffers and textures, so this one runs fewer iterations to keep memory in check
+        std::shared_ptr<TerrainRenderer*> terrainRenderer = std::make_shared<TerrainRenderer*>(nullptr);
+        runner.Add("TerrainRenderer::LoadChunk", 32, 1, [terrainRenderer, &environment]()
+        {
+            MapSingleton& mapSingleton = environment.gameRegistry.ctx<MapSingleton>();
+
+            // The chunk data buffer only fits one draw distance worth of chunks, so drop the previous ones first
+            (*terrainRenderer)->ClearChunks();
+            (*terrainRenderer)->LoadChunk(mapSingleton.maps[0], BENCHMARK_CHUNK_X, BENCHMARK_CHUNK_Y);
+        },
+        [terrainRenderer, chunkBuffer, &environment]() // Setup
+        {
+            MapSingleton& mapSingleton = environment.gameRegistry.ctx<MapSingleton>();
+            Terrain::Map& map = mapSingleton.maps[0];
+
+            u16 chunkId;
+            map.GetChunkIdFromChunkPosition(BENCHMARK_CHUNK_X, BENCHMARK_CHUNK_Y, chunkId);
+
+            chunkBuffer->readData = 0;
+            MapLoader::ExtractChunkData(*chunkBuffer, map.chunks[chunkId], map.stringTables[chunkId]);
+
+            *terrainRenderer = new TerrainRenderer(environment.renderer);
+        });
+    }
+}
@@ -0,0 +1,52 @@
+#include "Benchmarks.h"
+#include "BenchmarkRunner.h"
+#include "BenchmarkEnvironment.h"
+
+#include <Utils/ByteBuffer.h>
+#include <Utils/ConcurrentQueue.h>
+#include <Networking/NetworkPacket.h>
+#include <Networking/MessageHandler.h>
+#include <Networking/NetworkClient.h>
+
+#include "ECS/Systems/Network/ConnectionSystems.h"
+
+namespace Benchmarks
+{
+    constexpr u32 NUM_BENCHMARK_PACKETS = 1024;
+    constexpr u16 MAX_BENCHMARK_PAYLOAD_SIZE = 64;
+
+    void AddNetworkBenchmarks(BenchmarkRunner& runner, BenchmarkEnvironment& /*environment*/)
+    {
+        // A receive buffer full of movement updates, with a mix of payload sizes and some payloadless packets
+        size_t bufferSize = NUM_BENCHMARK_PACKETS * (sizeof(Opcode) + sizeof(u16) + MAX_BENCHMARK_PAYLOAD_SIZE);
+        std::shared_ptr<Bytebuffer> receiveBuffer = std::make_shared<Bytebuffer>(nullptr, bufferSize);
+
+        for (u32 i = 0; i < NUM_BENCHMARK_PACKETS; i++)
+        {
+            u16 payloadSize = static_cast<u16>((i % 5) * (MAX_BENCHMARK_PAYLOAD_SIZE / 4));
+
+            receiveBuffer->Put(Opcode::MSG_MOVE_ENTITY);
+            receiveBuffer->PutU16(payloadSize);
+            for (u16 j = 0; j < payloadSize / sizeof(u32); j++)
+            {
+                receiveBuffer->Put<u32>(i + j);
+            }
+        }
+
+        using PacketQueue = moodycamel::ConcurrentQueue<std::shared_ptr<NetworkPacket>>;
+        std::shared_ptr<PacketQueue> packetQueue = std::make_shared<PacketQueue>(NUM_BENCHMARK_PACKETS);
+
+        runner.Add("ConnectionUpdateSystem::ReadPackets", 256, NUM_BENCHMARK_PACKETS, [receiveBuffer, packetQueue]()
+        {
+            receiveBuffer->readData = 0;
+            ConnectionUpdateSystem::ReadPackets(receiveBuffer.get(), *packetQueue);
+
+            // Drain the queue so the packets go back to their pools, the update system does the same when it handles them
+            std::shared_ptr<NetworkPacket> packet = nullptr;
+            while (packetQueue->try_dequeue(packet))
+            {
+                packet = nullptr;
+            }
+        });
+    }
+}
@@ -0,0 +1,65 @@
+#include "Benchmarks.h"
+#include "BenchmarkRunner.h"
+#include "BenchmarkEnvironment.h"
+
+#include <Memory/StackAllocator.h>
+#include <Renderer/Renderer.h>
+#include <Renderer/Renderers/Null/RendererNull.h>
+#include <random>
+
+#include "ECS/Components/Transform.h"
+#include "ECS/Components/Rendering/Model.h"
+#include "ECS/Components/Rendering/VisibleModel.h"
+#include "ECS/Systems/Rendering/RenderModelSystem.h"
+
+namespace Benchmarks
+{
+    constexpr u32 NUM_BENCHMARK_MODELS = 10000;
+    constexpr u16 NUM_BENCHMARK_MODEL_TYPES = 64;
+    constexpr size_t RENDER_MODEL_ALLOCATOR_SIZE = 4 * 1024 * 1024;
+
+    void AddRenderModelBenchmarks(BenchmarkRunner& runner, BenchmarkEnvironment& environment)
+    {
+        std::shared_ptr<Memory::StackAllocator*> frameAllocator = std::make_shared<Memory::StackAllocator*>(nullptr);
+
+        runner.Add("RenderModelSystem::Update", 256, NUM_BENCHMARK_MODELS, [frameAllocator, &environment]()
+        {
+            // Dirty every transform so every model rebuilds its matrix, like when everything is moving
+            auto transformView = environment.gameRegistry.view<Transform, VisibleModel>();
+            transformView.each([](const auto, Transform& transform)
+            {
+                transform.isDirty = true;
+            });
+
+            (*frameAllocator)->Reset();
+            environment.renderer->ResetRenderLayers(*frameAllocator);
+
+            RenderModelSystem::Update(environment.gameRegistry);
+            environment.renderer->GetInstanceBuffer()->Apply(0);
+        },
+        [frameAllocator, &environment]() // Setup
+        {
+            *frameAllocator = new Memory::StackAllocator(RENDER_MODEL_ALLOCATOR_SIZE);
+            (*frameAllocator)->Init();
+
+            std::mt19937 random(1337);
+            std::uniform_real_distribution<f32> positionDistribution(-1000.0f, 1000.0f);
+            std::uniform_real_distribution<f32> rotationDistribution(0.0f, 360.0f);
+
+            for (u32 i = 0; i < NUM_BENCHMARK_MODELS; i++)
+            {
+                entt::entity entity = environment.gameRegistry.create();
+
+                Transform& transform = environment.gameRegistry.emplace<Transform>(entity);
+                transform.position = vec3(positionDistribution(random), positionDistribution(random), positionDistribution(random));
+                transform.rotation = vec3(0.0f, rotationDistribution(random), 0.0f);
+
+                Model& model = environment.gameRegistry.emplace<Model>(entity);
+                model.modelId = Renderer::ModelID(static_cast<type_safe::underlying_type<Renderer::ModelID>>(i % NUM_BENCHMARK_MODEL_TYPES));
+                model.instanceData.Init(environment.renderer);
+
+                environment.gameRegistry.emplace<VisibleModel>(entity);
+            }
+        });
+    }
+}
@@ -0,0 +1,39 @@
+#include "Benchmarks.h"
+#include "BenchmarkRunner.h"
+#include "BenchmarkEnvironment.h"
+
+#include "ECS/Components/Singletons/ScriptSingleton.h"
+
+namespace Benchmarks
+{
+    constexpr u32 NUM_BENCHMARK_SYSTEMS = 8;
+    constexpr u32 NUM_BENCHMARK_TRANSACTIONS_PER_SYSTEM = 1024;
+
+    void AddScriptBenchmarks(BenchmarkRunner& runner, BenchmarkEnvironment& /*environment*/)
+    {
+        std::shared_ptr<ScriptSingleton> scriptSingleton = std::make_shared<ScriptSingleton>();
+        std::shared_ptr<u64> counter = std::make_shared<u64>(0);
+
+        // Queues transactions the way the update systems do, one system after another, and then drains them all like the ScriptSingletonTask does
+        runner.Add("ScriptSingleton transactions", 256, NUM_BENCHMARK_SYSTEMS * NUM_BENCHMARK_TRANSACTIONS_PER_SYSTEM, [scriptSingleton, counter]()
+        {
+            u64* value = counter.get();
+
+            scriptSingleton->ResetCompletedSystems();
+            for (u32 system = 0; system < NUM_BENCHMARK_SYSTEMS; system++)
+            {
+                for (u32 i = 0; i < NUM_BENCHMARK_TRANSACTIONS_PER_SYSTEM; i++)
+                {
+                    scriptSingleton->AddTransaction([value, i]()
+                    {
+                        *value += i;
+                    });
+                }
+
+                scriptSingleton->CompleteSystem();
+            }
+
+            scriptSingleton->ExecuteTransactions();
+        });
+    }
+}
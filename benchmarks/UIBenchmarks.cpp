@@ -0,0 +1,98 @@
+#include "Benchmarks.h"
+#include "BenchmarkRunner.h"
+#include "BenchmarkEnvironment.h"
+
+#include <Utils/DebugHandler.h>
+#include <filesystem>
+
+#include "Rendering/UIRenderer.h"
+#include "ECS/Components/UI/UITransform.h"
+#include "ECS/Components/UI/UIRenderable.h"
+#include "ECS/Components/UI/UIText.h"
+
+namespace Benchmarks
+{
+    constexpr u32 NUM_BENCHMARK_PANELS = 2000;
+    constexpr u32 NUM_BENCHMARK_LABELS = 500;
+    const std::string BENCHMARK_FONT_PATH = "Data/fonts/Ubuntu/Ubuntu-Regular.ttf";
+
+    void AddUIBenchmarks(BenchmarkRunner& runner, BenchmarkEnvironment& environment)
+    {
+        std::shared_ptr<UIRenderer*> uiRenderer = std::make_shared<UIRenderer*>(nullptr);
+        auto createUIRenderer = [uiRenderer, &environment]()
+        {
+            if (*uiRenderer == nullptr)
+            {
+                *uiRenderer = new UIRenderer(environment.renderer);
+            }
+        };
+
+        runner.Add("UIRenderer::Update panels", 256, NUM_BENCHMARK_PANELS, [uiRenderer, &environment]()
+        {
+            auto renderableView = environment.uiRegistry.view<UITransform, UIRenderable>();
+            renderableView.each([](const auto, UITransform& transform, UIRenderable& renderable)
+            {
+                transform.isDirty = true;
+                renderable.isDirty = true;
+            });
+
+            (*uiRenderer)->Update(0.0f);
+        },
+        [createUIRenderer, &environment]() // Setup
+        {
+            createUIRenderer();
+
+            for (u32 i = 0; i < NUM_BENCHMARK_PANELS; i++)
+            {
+                entt::entity entity = environment.uiRegistry.create();
+
+                UITransform& transform = environment.uiRegistry.emplace<UITransform>(entity);
+                transform.position = vec2(static_cast<f32>((i % 40) * 48), static_cast<f32>((i / 40) * 20));
+                transform.size = vec2(48.0f, 20.0f);
+                transform.depth = static_cast<u16>(i % 16);
+                transform.type = UIElementType::UITYPE_PANEL;
+
+                UIRenderable& renderable = environment.uiRegistry.emplace<UIRenderable>(entity);
+                renderable.texture = "Data/textures/NovusUIPanel.png";
+            }
+        });
+
+        // Text needs a real font file to build its glyphs, so this one only runs from a directory that has the client data
+        if (!std::filesystem::exists(BENCHMARK_FONT_PATH))
+        {
+            NC_LOG_WARNING("Could not find %s, skipping the UIRenderer text benchmark", BENCHMARK_FONT_PATH.c_str());
+            return;
+        }
+
+        runner.Add("UIRenderer::Update text", 64, NUM_BENCHMARK_LABELS, [uiRenderer, &environment]()
+        {
+            auto textView = environment.uiRegistry.view<UITransform, UIText>();
+            textView.each([](const auto, UITransform& transform, UIText& text)
+            {
+                transform.isDirty = true;
+                text.isDirty = true;
+            });
+
+            (*uiRenderer)->Update(0.0f);
+        },
+        [createUIRenderer, &environment]() // Setup
+        {
+            createUIRenderer();
+
+            for (u32 i = 0; i < NUM_BENCHMARK_LABELS; i++)
+            {
+                entt::entity entity = environment.uiRegistry.create();
+
+                UITransform& transform = environment.uiRegistry.emplace<UITransform>(entity);
+                transform.position = vec2(static_cast<f32>((i % 10) * 192), static_cast<f32>((i / 10) * 20));
+                transform.size = vec2(192.0f, 20.0f);
+                transform.type = UIElementType::UITYPE_TEXT;
+
+                UIText& text = environment.uiRegistry.emplace<UIText>(entity);
+                text.text = "The quick brown fox " + std::to_string(i);
+                text.fontPath = BENCHMARK_FONT_PATH;
+                text.fontSize = 16.0f;
+            }
+        });
+    }
+}
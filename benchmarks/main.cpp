@@ -0,0 +1,52 @@
+#include <NovusTypes.h>
+#include <Utils/DebugHandler.h>
+#include <string>
+
+#include "BenchmarkRunner.h"
+#include "BenchmarkEnvironment.h"
+#include "Benchmarks.h"
+
+// Usage: novuscore-benchmarks [--filter <substring>] [--output <path>]
+// Results are written as json so they can be compared between releases
+i32 main(i32 argc, char* argv[])
+{
+    std::string filter = "";
+    std::string outputPath = "benchmark_results.json";
+
+    for (i32 i = 1; i < argc; i++)
+    {
+        std::string argument = argv[i];
+
+        if (argument == "--filter" && i + 1 < argc)
+        {
+            filter = argv[++i];
+        }
+        else if (argument == "--output" && i + 1 < argc)
+        {
+            outputPath = argv[++i];
+        }
+        else
+        {
+            NC_LOG_ERROR("Unknown argument %s, usage: novuscore-benchmarks [--filter <substring>] [--output <path>]", argument.c_str());
+            return 1;
+        }
+    }
+
+    BenchmarkEnvironment environment;
+    BenchmarkRunner runner;
+
+    Benchmarks::AddMapBenchmarks(runner, environment);
+    Benchmarks::AddRenderModelBenchmarks(runner, environment);
+    Benchmarks::AddCommandListBenchmarks(runner, environment);
+    Benchmarks::AddUIBenchmarks(runner, environment);
+    Benchmarks::AddScriptBenchmarks(runner, environment);
+    Benchmarks::AddNetworkBenchmarks(runner, environment);
+
+    runner.Run(filter);
+
+    if (!runner.WriteResults(outputPath))
+        return 1;
+
+    NC_LOG_SUCCESS("Wrote benchmark results to %s", outputPath.c_str());
+    return 0;
+}
@@ -5,19 +5,16 @@
 struct UIRenderable
 {
 public:
-    struct RenderableConstantBuffer
+    struct RenderablePushConstants
     {
         Color color; // 16 bytes
-
-        u8 padding[240] = {};
     };
-    UIRenderable() : texture(), textureID(Renderer::TextureID::Invalid()), modelID(Renderer::ModelID::Invalid()), color(1, 1, 1, 1), constantBuffer(nullptr), isDirty(true) { }
+    UIRenderable() : texture(), textureID(Renderer::TextureID::Invalid()), modelID(Renderer::ModelID::Invalid()), color(1, 1, 1, 1), isDirty(true) { }
 
     std::string texture;
     Renderer::TextureID textureID;
     Renderer::ModelID modelID;
     Color color;
-    Renderer::ConstantBuffer<RenderableConstantBuffer>* constantBuffer;
 
     bool isDirty;
 };
\ No newline at end of file
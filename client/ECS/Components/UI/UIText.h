@@ -6,17 +6,15 @@
 struct UIText
 {
 public:
-    struct TextConstantBuffer
+    struct TextPushConstants
     {
         Color textColor; // 16 bytes
         Color outlineColor; // 16 bytes
         f32 outlineWidth; // 4 bytes
-
-        u8 padding[220] = {};
     };
 
 public:
-    UIText() : text(), glyphCount(), color(1, 1, 1, 1), outlineColor(0, 0, 0, 1), outlineWidth(0.0f), fontPath(), fontSize(), font(), models(), textures(), constantBuffer(nullptr), isDirty(true) { }
+    UIText() : text(), glyphCount(), color(1, 1, 1, 1), outlineColor(0, 0, 0, 1), outlineWidth(0.0f), fontPath(), fontSize(), font(), models(), textures(), isDirty(true) { }
 
     std::string text;
     u32 glyphCount;
@@ -32,7 +30,5 @@ public:
     std::vector<Renderer::ModelID> models;
     std::vector<Renderer::TextureID> textures;
 
-    Renderer::ConstantBuffer<TextConstantBuffer>* constantBuffer;
-
     bool isDirty;
 };
\ No newline at end of file
@@ -76,43 +76,10 @@ void ConnectionUpdateSystem::AuthSocket_HandleRead(BaseSocket* socket)
 
     ConnectionSingleton* connectionSingleton = &gameRegistry->ctx<ConnectionSingleton>();
 
-    while (buffer->GetActiveSize())
+    if (!ReadPackets(buffer.get(), connectionSingleton->authPacketQueue))
     {
-        Opcode opcode = Opcode::INVALID;
-        u16 size = 0;
-
-        buffer->Get(opcode);
-        buffer->GetU16(size);
-
-        if (size > NETWORK_BUFFER_SIZE)
-        {
-            socket->Close(asio::error::shut_down);
-            return;
-        }
-
-        std::shared_ptr<NetworkPacket> packet = NetworkPacket::Borrow();
-        {
-            // Header
-            {
-                packet->header.opcode = opcode;
-                packet->header.size = size;
-            }
-
-            // Payload
-            {
-                if (size)
-                {
-                    packet->payload = Bytebuffer::Borrow<NETWORK_BUFFER_SIZE>();
-                    packet->payload->size = size;
-                    packet->payload->writtenData = size;
-                    std::memcpy(packet->payload->GetDataPointer(), buffer->GetReadPointer(), size);
-                }
-            }
-
-            connectionSingleton->authPacketQueue.enqueue(packet);
-        }
-
-        buffer->readData += size;
+        socket->Close(asio::error::shut_down);
+        return;
     }
 
     socket->AsyncRead();
@@ -161,6 +128,20 @@ void ConnectionUpdateSystem::GameSocket_HandleRead(BaseSocket* socket)
 
     ConnectionSingleton* connectionSingleton = &gameRegistry->ctx<ConnectionSingleton>();
 
+    if (!ReadPackets(buffer.get(), connectionSingleton->gamePacketQueue))
+    {
+        socket->Close(asio::error::shut_down);
+        return;
+    }
+
+    socket->AsyncRead();
+}
+void ConnectionUpdateSystem::GameSocket_HandleDisconnect(BaseSocket* socket)
+{
+}
+
+bool ConnectionUpdateSystem::ReadPackets(Bytebuffer* buffer, moodycamel::ConcurrentQueue<std::shared_ptr<NetworkPacket>>& packetQueue)
+{
     while (buffer->GetActiveSize())
     {
         Opcode opcode = Opcode::INVALID;
@@ -170,10 +151,7 @@ void ConnectionUpdateSystem::GameSocket_HandleRead(BaseSocket* socket)
         buffer->GetU16(size);
 
         if (size > NETWORK_BUFFER_SIZE)
-        {
-            socket->Close(asio::error::shut_down);
-            return;
-        }
+            return false;
 
         std::shared_ptr<NetworkPacket> packet = NetworkPacket::Borrow();
         {
@@ -194,14 +172,11 @@ void ConnectionUpdateSystem::GameSocket_HandleRead(BaseSocket* socket)
                 }
             }
 
-            connectionSingleton->gamePacketQueue.enqueue(packet);
+            packetQueue.enqueue(packet);
         }
 
         buffer->readData += size;
     }
 
-    socket->AsyncRead();
-}
-void ConnectionUpdateSystem::GameSocket_HandleDisconnect(BaseSocket* socket)
-{
+    return true;
 }
\ No newline at end of file
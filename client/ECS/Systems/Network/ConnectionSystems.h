@@ -1,7 +1,11 @@
 #pragma once
+#include <memory>
 #include <entity/fwd.hpp>
+#include <Utils/ConcurrentQueue.h>
 
 class BaseSocket;
+class Bytebuffer;
+struct NetworkPacket;
 class ConnectionUpdateSystem
 {
 public:
@@ -14,4 +18,7 @@ public:
     static void GameSocket_HandleConnect(BaseSocket* socket, bool connected);
     static void GameSocket_HandleRead(BaseSocket* socket);
     static void GameSocket_HandleDisconnect(BaseSocket* socket);
+
+    // Splits everything in the receive buffer into packets, returns false if the stream is malformed and the socket should be closed
+    static bool ReadPackets(Bytebuffer* buffer, moodycamel::ConcurrentQueue<std::shared_ptr<NetworkPacket>>& packetQueue);
 };
\ No newline at end of file
@@ -3,12 +3,11 @@
 #include <tracy/Tracy.hpp>
 #include <Renderer/Renderer.h>
 #include "../../../Utils/ServiceLocator.h"
-#include "../../../Rendering/ClientRenderer.h"
 #include "../../Components/Transform.h"
 #include "../../Components/Rendering/Model.h"
 #include "../../Components/Rendering/VisibleModel.h"
 
-void RenderModelSystem::Update(entt::registry& registry, ClientRenderer* clientRenderer)
+void RenderModelSystem::Update(entt::registry& registry)
 {
     Renderer::Renderer* renderer = ServiceLocator::GetRenderer();
 
@@ -23,8 +22,8 @@ void RenderModelSystem::Update(entt::registry& registry, ClientRenderer* clientR
             {
                 model.instanceData.modelMatrix = transform.GetMatrix();
 
-                // We should be using th 
-                model.instanceData.Apply(clientRenderer->GetFrameIndex());
+                // This writes into the shared instance buffer, ClientRenderer uploads it once for each frame
+                model.instanceData.Apply();
                 transform.isDirty = false;
             }
 
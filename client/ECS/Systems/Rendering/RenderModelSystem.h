@@ -1,9 +1,9 @@
 #pragma once
+#include <NovusTypes.h>
 #include <entity/fwd.hpp>
 
-class ClientRenderer;
 class RenderModelSystem
 {
 public:
-    static void Update(entt::registry& registry, ClientRenderer* clientRenderer);
+    static void Update(entt::registry& registry);
 };
\ No newline at end of file
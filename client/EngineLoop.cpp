@@ -42,7 +42,7 @@
 #include <InputManager.h>
 #include <GLFW/glfw3.h>
 
-EngineLoop::EngineLoop() : _isRunning(false), _inputQueue(256), _outputQueue(256)
+EngineLoop::EngineLoop(bool headless) : _isRunning(false), _headless(headless), _inputQueue(256), _outputQueue(256)
 {
     _network.asioService = std::make_shared<asio::io_service>(2);
     _network.authSocket = std::make_shared<NetworkClient>(new asio::ip::tcp::socket(*_network.asioService.get()));
@@ -121,7 +121,7 @@ void EngineLoop::Run()
     Timer timer;
     f32 targetDelta = 1.0f / 60.f;
 
-    _clientRenderer = new ClientRenderer();
+    _clientRenderer = new ClientRenderer(_headless);
 
     // Bind Movement Keys
     InputManager* inputManager = ServiceLocator::GetInputManager();
@@ -309,7 +309,7 @@ void EngineLoop::SetupUpdateFramework()
     tf::Task renderModelSystemTask = framework.emplace([this, &gameRegistry]()
         {
             ZoneScopedNC("RenderModelSystem::Update", tracy::Color::Blue2)
-                RenderModelSystem::Update(gameRegistry, _clientRenderer);
+                RenderModelSystem::Update(gameRegistry);
             gameRegistry.ctx<ScriptSingleton>().CompleteSystem();
         });
     renderModelSystemTask.gather(movementSystemTask);
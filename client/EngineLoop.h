@@ -55,7 +55,7 @@ class ClientRenderer;
 class EngineLoop
 {
 public:
-    EngineLoop();
+    EngineLoop(bool headless);
     ~EngineLoop();
 
     void Start();
@@ -87,6 +87,7 @@ private:
     void SetMessageHandler();
 private:
     bool _isRunning;
+    bool _headless; // Runs without a window on the null renderer
 
     moodycamel::ConcurrentQueue<Message> _inputQueue;
     moodycamel::ConcurrentQueue<Message> _outputQueue;
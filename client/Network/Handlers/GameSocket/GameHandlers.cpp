@@ -6,6 +6,7 @@
 #include "../../../Utils/EntityUtils.h"
 #include "../../../Utils/ServiceLocator.h"
 #include "../../../ECS/Components/Transform.h"
+#include "../../../ECS/Components/Rendering/Model.h"
 #include "../../../ECS/Components/LocalplayerSingleton.h"
 
 void GameSocket::GameHandlers::Setup(MessageHandler* messageHandler)
@@ -103,6 +104,11 @@ bool GameSocket::GameHandlers::SMSG_DELETE_ENTITY(std::shared_ptr<NetworkClient>
     if (localplayerSingleton.entity == entityId)
         return true;
 
+    if (registry->has<Model>(entityId))
+    {
+        EntityUtils::DestroyModelComponent(*registry, entityId);
+    }
+
     registry->destroy(entityId);
     return true;
 }
@@ -6,6 +6,7 @@
 
 #include <Renderer/Renderer.h>
 #include <Renderer/Renderers/Vulkan/RendererVK.h>
+#include <Renderer/Renderers/Null/RendererNull.h>
 #include <Window/Window.h>
 #include <InputManager.h>
 #include <GLFW/glfw3.h>
@@ -15,6 +16,7 @@
 const int WIDTH = 1920;
 const int HEIGHT = 1080;
 const size_t FRAME_ALLOCATOR_SIZE = 8 * 1024 * 1024; // 8 MB
+const size_t RENDER_GRAPH_ALLOCATOR_SIZE = 1 * 1024 * 1024; // 1 MB
 u32 MAIN_RENDER_LAYER = "MainLayer"_h; // _h will compiletime hash the string into a u32
 u32 DEPTH_PREPASS_RENDER_LAYER = "DepthPrepass"_h; // _h will compiletime hash the string into a u32
 
@@ -39,14 +41,19 @@ void cursor_position_callback(GLFWwindow* window, f64 x, f64 y)
     ServiceLocator::GetInputManager()->MousePositionHandler(userWindow, static_cast<f32>(x), static_cast<f32>(y));
 }
 
-ClientRenderer::ClientRenderer()
+ClientRenderer::ClientRenderer(bool headless)
+    : _headless(headless)
 {
     //_camera = new Camera(vec3(-8000.0f, 0.0f, 1600.0f)); // Goldshire
     //_camera = new Camera(vec3(300.0f, 0.0f, -4700.0f)); // Razor Hill
     _camera = new Camera(vec3(3308.0f, 0.0f, 5316.0f)); // Borean Tundra
 
+    // The window only gets initialized when we render to it, RendererNull never presents to it
     _window = new Window();
-    _window->Init(WIDTH, HEIGHT);
+    if (!_headless)
+    {
+        _window->Init(WIDTH, HEIGHT);
+    }
     ServiceLocator::SetWindow(_window);
 
     _inputManager = new InputManager();
@@ -55,21 +62,32 @@ ClientRenderer::ClientRenderer()
     // We have to call Init here as we use the InputManager
     _camera->Init();
 
-    glfwSetKeyCallback(_window->GetWindow(), key_callback);
-    glfwSetCharCallback(_window->GetWindow(), char_callback);
-    glfwSetMouseButtonCallback(_window->GetWindow(), mouse_callback);
-    glfwSetCursorPosCallback(_window->GetWindow(), cursor_position_callback);
+    if (!_headless)
+    {
+        glfwSetKeyCallback(_window->GetWindow(), key_callback);
+        glfwSetCharCallback(_window->GetWindow(), char_callback);
+        glfwSetMouseButtonCallback(_window->GetWindow(), mouse_callback);
+        glfwSetCursorPosCallback(_window->GetWindow(), cursor_position_callback);
+    }
 
     Renderer::TextureDesc debugTexture;
     debugTexture.path = "Data/textures/DebugTexture.bmp";
     
-    _renderer = new Renderer::RendererVK(debugTexture);
+    if (_headless)
+    {
+        _renderer = new Renderer::RendererNull();
+    }
+    else
+    {
+        _renderer = new Renderer::RendererVK(debugTexture);
+    }
     _renderer->InitWindow(_window);
     ServiceLocator::SetRenderer(_renderer);
 
     CreatePermanentResources();
     _uiRenderer = new UIRenderer(_renderer);
     _terrainRenderer = new TerrainRenderer(_renderer);
+    CreateRenderGraph();
 
     _inputManager->RegisterKeybind("ToggleDebugDraw", GLFW_KEY_F1, KEYBIND_ACTION_PRESS, KEYBIND_MOD_ANY, [this](Window* window, std::shared_ptr<Keybind> keybind)
     {
@@ -78,19 +96,32 @@ ClientRenderer::ClientRenderer()
         {
             _debugDrawingMode = 0;
         }
+
+        // Changing what we present changes which passes get culled
+        _renderGraph->ClearOutputs();
+        _renderGraph->AddOutput(GetPresentImage());
         return true;
     });
 }
 
+ClientRenderer::~ClientRenderer()
+{
+    delete _renderGraphTaskflow;
+}
+
 bool ClientRenderer::UpdateWindow(f32 deltaTime)
 {
+    if (_headless)
+        return true; // Without a window nobody can close it, the exit console command still works
+
     return _window->Update(deltaTime);
 }
 
 void ClientRenderer::Update(f32 deltaTime)
 {
-    // Reset the memory in the frameAllocator
+    // Reset the memory in the frameAllocator, the render layers keep their drawcalls in it so they get reset with it
     _frameAllocator->Reset();
+    _renderer->ResetRenderLayers(_frameAllocator);
 
     // Update the camera movement
     _camera->Update(deltaTime);
@@ -99,13 +130,8 @@ void ClientRenderer::Update(f32 deltaTime)
     _viewConstantBuffer->resource.viewMatrix = _camera->GetViewMatrix();
     _viewConstantBuffer->Apply(_frameIndex);
 
-    // Register models to be rendered TODO: Push this to the ECS later
-    Renderer::RenderLayer& depthPrepassLayer = _renderer->GetRenderLayer(DEPTH_PREPASS_RENDER_LAYER);
-    depthPrepassLayer.Reset(); // Reset the layer first so we don't just infinitely grow our layer
-
     // Register models to be rendered TODO: Push this to the ECS later
     Renderer::RenderLayer& mainLayer = _renderer->GetRenderLayer(MAIN_RENDER_LAYER);
-    mainLayer.Reset(); // Reset the layer first so we don't just infinitely grow our layer
     mainLayer.RegisterModel(_cubeModel, &_cubeModelInstance);
 
     _terrainRenderer->Update(deltaTime);
@@ -113,11 +139,51 @@ void ClientRenderer::Update(f32 deltaTime)
 }
 
 void ClientRenderer::Render()
+{
+    // Everything has registered its models by now, sort the layers front to back and by state
+    vec3 cameraPosition = _camera->GetPosition();
+    _renderer->GetRenderLayer(DEPTH_PREPASS_RENDER_LAYER).Sort(cameraPosition);
+    _renderer->GetRenderLayer(MAIN_RENDER_LAYER).Sort(cameraPosition);
+    _terrainRenderer->SortLayers(cameraPosition);
+
+    // Upload this frame's instance data in one go before any pass reads it
+    _renderer->GetInstanceBuffer()->Apply(_frameIndex);
+
+    // The rendergraph persists between frames, it only needs to be setup again when something invalidated it
+    if (!_renderGraph->IsValid())
+    {
+        _renderGraph->Setup();
+    }
+    _renderGraph->Execute(_frameIndex);
+    
+    _renderer->Present(_window, GetPresentImage());
+
+    // Step to the next frame in flight, the renderer advances its own frame index in Present so they stay in lockstep
+    _frameIndex = (_frameIndex + 1) % Renderer::FRAMES_IN_FLIGHT;
+}
+
+Renderer::ImageID ClientRenderer::GetPresentImage()
+{
+    if (_debugDrawingMode == 1)
+    {
+        return _debugTextureID;
+    }
+    else if (_debugDrawingMode == 2)
+    {
+        return _debugAlphaMap;
+    }
+
+    return _mainColor;
+}
+
+void ClientRenderer::CreateRenderGraph()
 {
     // Create rendergraph
     Renderer::RenderGraphDesc renderGraphDesc;
-    renderGraphDesc.allocator = _frameAllocator; // We need to give our rendergraph an allocator to use
-    Renderer::RenderGraph renderGraph = _renderer->CreateRenderGraph(renderGraphDesc);
+    renderGraphDesc.allocator = _renderGraphAllocator; // We need to give our rendergraph an allocator to use, it has to live as long as the rendergraph
+    renderGraphDesc.frameAllocator = _frameAllocator; // This one gets reset every frame, the rendergraph uses it for commandlists
+    renderGraphDesc.taskflow = _renderGraphTaskflow; // This lets the rendergraph record its passes in parallel
+    _renderGraph = _renderer->CreateRenderGraph(renderGraphDesc);
 
     // Depth Prepass
     {
@@ -126,104 +192,101 @@ void ClientRenderer::Render()
             Renderer::RenderPassMutableResource mainDepth;
         };
 
-        renderGraph.AddPass<DepthPrepassData>("Depth Prepass",
+        _renderGraph->AddPass<DepthPrepassData>("Depth Prepass",
             [=](DepthPrepassData& data, Renderer::RenderGraphBuilder& builder) // Setup
         {
+            // Main depth is transient, nothing reads it after the graph so the backend may alias its memory
+            _mainDepth = builder.Create(_mainDepthDesc);
             data.mainDepth = builder.Write(_mainDepth, Renderer::RenderGraphBuilder::WriteMode::WRITE_MODE_RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::LOAD_MODE_CLEAR);
 
             return true;
         },
-            [&](DepthPrepassData& data, Renderer::CommandList& commandList) // Execute
+            [this](DepthPrepassData& data, Renderer::CommandList& commandList) // Execute
         {
-            Renderer::GraphicsPipelineDesc pipelineDesc;
-            renderGraph.InitializePipelineDesc(pipelineDesc);
-
-            // Shaders
-            Renderer::VertexShaderDesc vertexShaderDesc;
-            vertexShaderDesc.path = "Data/shaders/depthprepass.vert.spv";
-            pipelineDesc.states.vertexShader = _renderer->LoadShader(vertexShaderDesc);
-
-            // Constant buffers  TODO: Improve on this, if I set state 0 and 3 it won't work etc...
-            pipelineDesc.states.constantBufferStates[0].enabled = true; // ViewCB
-            pipelineDesc.states.constantBufferStates[0].shaderVisibility = Renderer::ShaderVisibility::SHADER_VISIBILITY_VERTEX;
-            pipelineDesc.states.constantBufferStates[1].enabled = true; // ModelCB
-            pipelineDesc.states.constantBufferStates[1].shaderVisibility = Renderer::ShaderVisibility::SHADER_VISIBILITY_VERTEX;
-
-            // Input layouts TODO: Improve on this, if I set state 0 and 3 it won't work etc... Maybe responsibility for this should be moved to ModelHandler and the cooker?
-            pipelineDesc.states.inputLayouts[0].enabled = true;
-            pipelineDesc.states.inputLayouts[0].SetName("POSITION");
-            pipelineDesc.states.inputLayouts[0].format = Renderer::InputFormat::INPUT_FORMAT_R32G32B32_FLOAT;
-            pipelineDesc.states.inputLayouts[0].inputClassification = Renderer::InputClassification::INPUT_CLASSIFICATION_PER_VERTEX;
-            pipelineDesc.states.inputLayouts[1].enabled = true;
-            pipelineDesc.states.inputLayouts[1].SetName("NORMAL");
-            pipelineDesc.states.inputLayouts[1].format = Renderer::InputFormat::INPUT_FORMAT_R32G32B32_FLOAT;
-            pipelineDesc.states.inputLayouts[1].inputClassification = Renderer::InputClassification::INPUT_CLASSIFICATION_PER_VERTEX;
-            pipelineDesc.states.inputLayouts[2].enabled = true;
-            pipelineDesc.states.inputLayouts[2].SetName("TEXCOORD");
-            pipelineDesc.states.inputLayouts[2].format = Renderer::InputFormat::INPUT_FORMAT_R32G32_FLOAT;
-            pipelineDesc.states.inputLayouts[2].inputClassification = Renderer::InputClassification::INPUT_CLASSIFICATION_PER_VERTEX;
-
-            // Viewport
-            pipelineDesc.states.viewport.topLeftX = 0;
-            pipelineDesc.states.viewport.topLeftY = 0;
-            pipelineDesc.states.viewport.width = static_cast<f32>(WIDTH);
-            pipelineDesc.states.viewport.height = static_cast<f32>(HEIGHT);
-            pipelineDesc.states.viewport.minDepth = 0.0f;
-            pipelineDesc.states.viewport.maxDepth = 1.0f;
-
-            // ScissorRect
-            pipelineDesc.states.scissorRect.left = 0;
-            pipelineDesc.states.scissorRect.right = WIDTH;
-            pipelineDesc.states.scissorRect.top = 0;
-            pipelineDesc.states.scissorRect.bottom = HEIGHT;
-
-            // Depth state
-            pipelineDesc.states.depthStencilState.depthEnable = true;
-            pipelineDesc.states.depthStencilState.depthWriteEnable = true;
-            pipelineDesc.states.depthStencilState.depthFunc = Renderer::ComparisonFunc::COMPARISON_FUNC_LESS;
-
-            // Rasterizer state
-            pipelineDesc.states.rasterizerState.cullMode = Renderer::CullMode::CULL_MODE_BACK;
-            pipelineDesc.states.rasterizerState.frontFaceMode = Renderer::FrontFaceState::FRONT_FACE_STATE_COUNTERCLOCKWISE;
-
-            // Render targets
-            pipelineDesc.depthStencil = data.mainDepth;
+            if (_depthPrepassPipelineSetup != _renderGraph->GetSetupCount())
+            {
+                Renderer::GraphicsPipelineDesc pipelineDesc;
+                _renderGraph->InitializePipelineDesc(pipelineDesc);
+
+                // Shaders
+                Renderer::VertexShaderDesc vertexShaderDesc;
+                vertexShaderDesc.path = "Data/shaders/depthprepass.vert.spv";
+                pipelineDesc.states.vertexShader = _renderer->LoadShader(vertexShaderDesc);
+
+                // Constant buffers  TODO: Improve on this, if I set state 0 and 3 it won't work etc...
+                pipelineDesc.states.constantBufferStates[0].enabled = true; // ViewCB
+                pipelineDesc.states.constantBufferStates[0].shaderVisibility = Renderer::ShaderVisibility::SHADER_VISIBILITY_VERTEX;
+
+                // Input layouts TODO: Improve on this, if I set state 0 and 3 it won't work etc... Maybe responsibility for this should be moved to ModelHandler and the cooker?
+                pipelineDesc.states.inputLayouts[0].enabled = true;
+                pipelineDesc.states.inputLayouts[0].SetName("POSITION");
+                pipelineDesc.states.inputLayouts[0].format = Renderer::InputFormat::INPUT_FORMAT_R32G32B32_FLOAT;
+                pipelineDesc.states.inputLayouts[0].inputClassification = Renderer::InputClassification::INPUT_CLASSIFICATION_PER_VERTEX;
+                pipelineDesc.states.inputLayouts[1].enabled = true;
+                pipelineDesc.states.inputLayouts[1].SetName("NORMAL");
+                pipelineDesc.states.inputLayouts[1].format = Renderer::InputFormat::INPUT_FORMAT_R32G32B32_FLOAT;
+                pipelineDesc.states.inputLayouts[1].inputClassification = Renderer::InputClassification::INPUT_CLASSIFICATION_PER_VERTEX;
+                pipelineDesc.states.inputLayouts[2].enabled = true;
+                pipelineDesc.states.inputLayouts[2].SetName("TEXCOORD");
+                pipelineDesc.states.inputLayouts[2].format = Renderer::InputFormat::INPUT_FORMAT_R32G32_FLOAT;
+                pipelineDesc.states.inputLayouts[2].inputClassification = Renderer::InputClassification::INPUT_CLASSIFICATION_PER_VERTEX;
+
+                // Viewport
+                pipelineDesc.states.viewport.topLeftX = 0;
+                pipelineDesc.states.viewport.topLeftY = 0;
+                pipelineDesc.states.viewport.width = static_cast<f32>(WIDTH);
+                pipelineDesc.states.viewport.height = static_cast<f32>(HEIGHT);
+                pipelineDesc.states.viewport.minDepth = 0.0f;
+                pipelineDesc.states.viewport.maxDepth = 1.0f;
+
+                // ScissorRect
+                pipelineDesc.states.scissorRect.left = 0;
+                pipelineDesc.states.scissorRect.right = WIDTH;
+                pipelineDesc.states.scissorRect.top = 0;
+                pipelineDesc.states.scissorRect.bottom = HEIGHT;
+
+                // Depth state
+                pipelineDesc.states.depthStencilState.depthEnable = true;
+                pipelineDesc.states.depthStencilState.depthWriteEnable = true;
+                pipelineDesc.states.depthStencilState.depthFunc = Renderer::ComparisonFunc::COMPARISON_FUNC_LESS;
+
+                // Rasterizer state
+                pipelineDesc.states.rasterizerState.cullMode = Renderer::CullMode::CULL_MODE_BACK;
+                pipelineDesc.states.rasterizerState.frontFaceMode = Renderer::FrontFaceState::FRONT_FACE_STATE_COUNTERCLOCKWISE;
+
+                // Render targets
+                pipelineDesc.depthStencil = data.mainDepth;
+
+                // Set pipeline
+                _depthPrepassPipeline = _renderer->CreatePipeline(pipelineDesc);
+                _depthPrepassPipelineSetup = _renderGraph->GetSetupCount();
+            }
 
             // Clear mainColor TODO: This should be handled by the parameter in Setup, and it should definitely not act on ImageID and DepthImageID
-            commandList.Clear(_mainDepth, 1.0f);
+            commandList.Clear(_renderGraph->GetBuilder()->GetDepthImage(data.mainDepth), 1.0f);
 
-            // Set pipeline
-            Renderer::GraphicsPipelineID pipeline = _renderer->CreatePipeline(pipelineDesc); // This will compile the pipeline and return the ID, or just return ID of cached pipeline
-            commandList.BeginPipeline(pipeline);
+            commandList.BeginPipeline(_depthPrepassPipeline);
 
             // Set view constant buffer
             commandList.SetConstantBuffer(0, _viewConstantBuffer->GetDescriptor(_frameIndex), _frameIndex);
 
+            // Set instance storage buffer, every model reads its instance from here through its baseInstance
+            commandList.SetStorageBuffer(1, _renderer->GetInstanceBuffer()->GetDescriptor(_frameIndex), _frameIndex);
+
             // Render depth prepass layer
             Renderer::RenderLayer& layer = _renderer->GetRenderLayer(DEPTH_PREPASS_RENDER_LAYER);
 
-            for (auto const& model : layer.GetModels())
+            for (auto const& drawCall : layer.GetDrawCalls())
             {
-                auto const& modelID = Renderer::ModelID(model.first);
-                auto const& instances = model.second;
-
-                for (auto const& instance : instances)
-                {
-                    instance->Apply(_frameIndex);
-
-                    // Set model constant buffer
-                    commandList.SetConstantBuffer(1, instance->GetDescriptor(_frameIndex), _frameIndex);
-
-                    // Draw
-                    commandList.Draw(modelID);
-                }
+                // Draw
+                commandList.Draw(drawCall.modelID, drawCall.instanceData->GetInstanceID());
             }
-            commandList.EndPipeline(pipeline);
+            commandList.EndPipeline(_depthPrepassPipeline);
         });
     }
 
     // Terrain depth prepass
-    _terrainRenderer->AddTerrainDepthPrepass(&renderGraph, _viewConstantBuffer, _mainDepth, _frameIndex);
+    _terrainRenderer->AddTerrainDepthPrepass(_renderGraph, _viewConstantBuffer, _mainDepth, _frameIndex);
 
     // Main Pass
     {
@@ -234,92 +297,98 @@ void ClientRenderer::Render()
             Renderer::RenderPassResource cubeTexture;
         };
 
-        renderGraph.AddPass<MainPassData>("Main Pass",
+        _renderGraph->AddPass<MainPassData>("Main Pass",
             [=](MainPassData& data, Renderer::RenderGraphBuilder& builder) // Setup
         {
             data.mainColor = builder.Write(_mainColor, Renderer::RenderGraphBuilder::WriteMode::WRITE_MODE_RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::LOAD_MODE_CLEAR);
-            data.mainDepth = builder.Write(_mainDepth, Renderer::RenderGraphBuilder::WriteMode::WRITE_MODE_RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::LOAD_MODE_CLEAR);
+            data.mainDepth = builder.Write(_mainDepth, Renderer::RenderGraphBuilder::WriteMode::WRITE_MODE_RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::LOAD_MODE_LOAD);
             data.cubeTexture = builder.Read(_cubeTexture, Renderer::RenderGraphBuilder::ShaderStage::SHADER_STAGE_PIXEL);
 
             return true; // Return true from setup to enable this pass, return false to disable it
         },
-            [&](MainPassData& data, Renderer::CommandList& commandList) // Execute
+            [this](MainPassData& data, Renderer::CommandList& commandList) // Execute
         {
-            Renderer::GraphicsPipelineDesc pipelineDesc;
-            renderGraph.InitializePipelineDesc(pipelineDesc);
-
-            // Shaders
-            Renderer::VertexShaderDesc vertexShaderDesc;
-            vertexShaderDesc.path = "Data/shaders/test.vert.spv";
-            pipelineDesc.states.vertexShader = _renderer->LoadShader(vertexShaderDesc);
-
-            Renderer::PixelShaderDesc pixelShaderDesc;
-            pixelShaderDesc.path = "Data/shaders/test.frag.spv";
-            pipelineDesc.states.pixelShader = _renderer->LoadShader(pixelShaderDesc);
-
-            // Constant buffers  TODO: Improve on this, if I set state 0 and 3 it won't work etc...
-            pipelineDesc.states.constantBufferStates[0].enabled = true; // ViewCB
-            pipelineDesc.states.constantBufferStates[0].shaderVisibility = Renderer::ShaderVisibility::SHADER_VISIBILITY_VERTEX;
-            pipelineDesc.states.constantBufferStates[1].enabled = true; // ModelCB
-            pipelineDesc.states.constantBufferStates[1].shaderVisibility = Renderer::ShaderVisibility::SHADER_VISIBILITY_VERTEX;
-
-            // Input layouts TODO: Improve on this, if I set state 0 and 3 it won't work etc... Maybe responsibility for this should be moved to ModelHandler and the cooker?
-            pipelineDesc.states.inputLayouts[0].enabled = true;
-            pipelineDesc.states.inputLayouts[0].SetName("POSITION");
-            pipelineDesc.states.inputLayouts[0].format = Renderer::InputFormat::INPUT_FORMAT_R32G32B32_FLOAT;
-            pipelineDesc.states.inputLayouts[0].inputClassification = Renderer::InputClassification::INPUT_CLASSIFICATION_PER_VERTEX;
-            pipelineDesc.states.inputLayouts[1].enabled = true;
-            pipelineDesc.states.inputLayouts[1].SetName("NORMAL");
-            pipelineDesc.states.inputLayouts[1].format = Renderer::InputFormat::INPUT_FORMAT_R32G32B32_FLOAT;
-            pipelineDesc.states.inputLayouts[1].inputClassification = Renderer::InputClassification::INPUT_CLASSIFICATION_PER_VERTEX;
-            pipelineDesc.states.inputLayouts[2].enabled = true;
-            pipelineDesc.states.inputLayouts[2].SetName("TEXCOORD");
-            pipelineDesc.states.inputLayouts[2].format = Renderer::InputFormat::INPUT_FORMAT_R32G32_FLOAT;
-            pipelineDesc.states.inputLayouts[2].inputClassification = Renderer::InputClassification::INPUT_CLASSIFICATION_PER_VERTEX;
-
-            // Viewport
-            pipelineDesc.states.viewport.topLeftX = 0;
-            pipelineDesc.states.viewport.topLeftY = 0;
-            pipelineDesc.states.viewport.width = static_cast<f32>(WIDTH);
-            pipelineDesc.states.viewport.height = static_cast<f32>(HEIGHT);
-            pipelineDesc.states.viewport.minDepth = 0.0f;
-            pipelineDesc.states.viewport.maxDepth = 1.0f;
-
-            // ScissorRect
-            pipelineDesc.states.scissorRect.left = 0;
-            pipelineDesc.states.scissorRect.right = WIDTH;
-            pipelineDesc.states.scissorRect.top = 0;
-            pipelineDesc.states.scissorRect.bottom = HEIGHT;
-
-            // Depth state
-            pipelineDesc.states.depthStencilState.depthEnable = true;
-            pipelineDesc.states.depthStencilState.depthFunc = Renderer::ComparisonFunc::COMPARISON_FUNC_EQUAL;
-
-            // Rasterizer state
-            pipelineDesc.states.rasterizerState.cullMode = Renderer::CullMode::CULL_MODE_BACK;
-            pipelineDesc.states.rasterizerState.frontFaceMode = Renderer::FrontFaceState::FRONT_FACE_STATE_COUNTERCLOCKWISE;
-
-            // Samplers TODO: We don't care which samplers we have here, we just need the number of samplers
-            pipelineDesc.states.samplers[0].enabled = true;
-
-            // Textures TODO: We don't care which textures we have here, we just need the number of textures
-            pipelineDesc.textures[0] = data.cubeTexture;
-
-            // Render targets
-            pipelineDesc.renderTargets[0] = data.mainColor;
-
-            pipelineDesc.depthStencil = data.mainDepth;
+            if (_mainPassPipelineSetup != _renderGraph->GetSetupCount())
+            {
+                Renderer::GraphicsPipelineDesc pipelineDesc;
+                _renderGraph->InitializePipelineDesc(pipelineDesc);
+
+                // Shaders
+                Renderer::VertexShaderDesc vertexShaderDesc;
+                vertexShaderDesc.path = "Data/shaders/test.vert.spv";
+                pipelineDesc.states.vertexShader = _renderer->LoadShader(vertexShaderDesc);
+
+                Renderer::PixelShaderDesc pixelShaderDesc;
+                pixelShaderDesc.path = "Data/shaders/test.frag.spv";
+                pipelineDesc.states.pixelShader = _renderer->LoadShader(pixelShaderDesc);
+
+                // Constant buffers  TODO: Improve on this, if I set state 0 and 3 it won't work etc...
+                pipelineDesc.states.constantBufferStates[0].enabled = true; // ViewCB
+                pipelineDesc.states.constantBufferStates[0].shaderVisibility = Renderer::ShaderVisibility::SHADER_VISIBILITY_VERTEX;
+
+                // Input layouts TODO: Improve on this, if I set state 0 and 3 it won't work etc... Maybe responsibility for this should be moved to ModelHandler and the cooker?
+                pipelineDesc.states.inputLayouts[0].enabled = true;
+                pipelineDesc.states.inputLayouts[0].SetName("POSITION");
+                pipelineDesc.states.inputLayouts[0].format = Renderer::InputFormat::INPUT_FORMAT_R32G32B32_FLOAT;
+                pipelineDesc.states.inputLayouts[0].inputClassification = Renderer::InputClassification::INPUT_CLASSIFICATION_PER_VERTEX;
+                pipelineDesc.states.inputLayouts[1].enabled = true;
+                pipelineDesc.states.inputLayouts[1].SetName("NORMAL");
+                pipelineDesc.states.inputLayouts[1].format = Renderer::InputFormat::INPUT_FORMAT_R32G32B32_FLOAT;
+                pipelineDesc.states.inputLayouts[1].inputClassification = Renderer::InputClassification::INPUT_CLASSIFICATION_PER_VERTEX;
+                pipelineDesc.states.inputLayouts[2].enabled = true;
+                pipelineDesc.states.inputLayouts[2].SetName("TEXCOORD");
+                pipelineDesc.states.inputLayouts[2].format = Renderer::InputFormat::INPUT_FORMAT_R32G32_FLOAT;
+                pipelineDesc.states.inputLayouts[2].inputClassification = Renderer::InputClassification::INPUT_CLASSIFICATION_PER_VERTEX;
+
+                // Viewport
+                pipelineDesc.states.viewport.topLeftX = 0;
+                pipelineDesc.states.viewport.topLeftY = 0;
+                pipelineDesc.states.viewport.width = static_cast<f32>(WIDTH);
+                pipelineDesc.states.viewport.height = static_cast<f32>(HEIGHT);
+                pipelineDesc.states.viewport.minDepth = 0.0f;
+                pipelineDesc.states.viewport.maxDepth = 1.0f;
+
+                // ScissorRect
+                pipelineDesc.states.scissorRect.left = 0;
+                pipelineDesc.states.scissorRect.right = WIDTH;
+                pipelineDesc.states.scissorRect.top = 0;
+                pipelineDesc.states.scissorRect.bottom = HEIGHT;
+
+                // Depth state
+                pipelineDesc.states.depthStencilState.depthEnable = true;
+                pipelineDesc.states.depthStencilState.depthFunc = Renderer::ComparisonFunc::COMPARISON_FUNC_EQUAL;
+
+                // Rasterizer state
+                pipelineDesc.states.rasterizerState.cullMode = Renderer::CullMode::CULL_MODE_BACK;
+                pipelineDesc.states.rasterizerState.frontFaceMode = Renderer::FrontFaceState::FRONT_FACE_STATE_COUNTERCLOCKWISE;
+
+                // Samplers TODO: We don't care which samplers we have here, we just need the number of samplers
+                pipelineDesc.states.samplers[0].enabled = true;
+
+                // Textures TODO: We don't care which textures we have here, we just need the number of textures
+                pipelineDesc.textures[0] = data.cubeTexture;
+
+                // Render targets
+                pipelineDesc.renderTargets[0] = data.mainColor;
+
+                pipelineDesc.depthStencil = data.mainDepth;
+
+                // Set pipeline
+                _mainPassPipeline = _renderer->CreatePipeline(pipelineDesc);
+                _mainPassPipelineSetup = _renderGraph->GetSetupCount();
+            }
 
             // Clear mainColor TODO: This should be handled by the parameter in Setup, and it should definitely not act on ImageID and DepthImageID
             commandList.Clear(_mainColor, Color(0, 0, 0, 1));
 
-            // Set pipeline
-            Renderer::GraphicsPipelineID pipeline = _renderer->CreatePipeline(pipelineDesc); // This will compile the pipeline and return the ID, or just return ID of cached pipeline
-            commandList.BeginPipeline(pipeline);
+            commandList.BeginPipeline(_mainPassPipeline);
 
             // Set view constant buffer
             commandList.SetConstantBuffer(0, _viewConstantBuffer->GetDescriptor(_frameIndex), _frameIndex);
 
+            // Set instance storage buffer
+            commandList.SetStorageBuffer(1, _renderer->GetInstanceBuffer()->GetDescriptor(_frameIndex), _frameIndex);
+
             // Set sampler and texture
             commandList.SetSampler(2, _linearSampler);
             commandList.SetTexture(3, _cubeTexture);
@@ -327,47 +396,21 @@ void ClientRenderer::Render()
             // Render main layer
             Renderer::RenderLayer& mainLayer = _renderer->GetRenderLayer(MAIN_RENDER_LAYER);
 
-            for (auto const& model : mainLayer.GetModels())
+            for (auto const& drawCall : mainLayer.GetDrawCalls())
             {
-                auto const& modelID = Renderer::ModelID(model.first);
-                auto const& instances = model.second;
-
-                for (auto const& instance : instances)
-                {
-                    // Set model constant buffer
-                    commandList.SetConstantBuffer(1, instance->GetDescriptor(_frameIndex), _frameIndex);
-
-                    // Draw
-                    commandList.Draw(modelID);
-                }
+                // Draw
+                commandList.Draw(drawCall.modelID, drawCall.instanceData->GetInstanceID());
             }
-            commandList.EndPipeline(pipeline);
+            commandList.EndPipeline(_mainPassPipeline);
         });
     }
 
-    _terrainRenderer->AddTerrainPass(&renderGraph, _viewConstantBuffer, _mainColor, _mainDepth, _frameIndex);
-    _terrainRenderer->AddTerrainDebugPass(&renderGraph, _viewConstantBuffer, _debugTextureID, _debugAlphaMap, _mainDepth, _frameIndex);
-    _uiRenderer->AddUIPass(&renderGraph, _mainColor, _frameIndex);
-
-    renderGraph.Setup();
-    renderGraph.Execute();
-    
-    if (_debugDrawingMode == 0)
-    {
-        _renderer->Present(_window, _mainColor);
-    }
-    else if (_debugDrawingMode == 1)
-    {
-        _renderer->Present(_window, _debugTextureID);
-    }
-    else
-    {
-        _renderer->Present(_window, _debugAlphaMap);
-    }
-    
+    _terrainRenderer->AddTerrainPass(_renderGraph, _viewConstantBuffer, _mainColor, _mainDepth, _frameIndex);
+    _terrainRenderer->AddTerrainDebugPass(_renderGraph, _viewConstantBuffer, _debugTextureID, _debugAlphaMap, _mainDepth, _frameIndex);
+    _uiRenderer->AddUIPass(_renderGraph, _mainColor, _frameIndex);
 
-    // Flip the frameIndex between 0 and 1
-    _frameIndex = !_frameIndex;
+    // Only the image we present is needed, passes that don't contribute to it get culled
+    _renderGraph->AddOutput(GetPresentImage());
 }
 
 void ClientRenderer::CreatePermanentResources()
@@ -388,14 +431,11 @@ void ClientRenderer::CreatePermanentResources()
     mainColorDesc.debugName = "DebugTextureID";
     _debugTextureID = _renderer->CreateImage(mainColorDesc);
 
-    // Main depth rendertarget
-    Renderer::DepthImageDesc mainDepthDesc;
-    mainDepthDesc.debugName = "MainDepth";
-    mainDepthDesc.dimensions = ivec2(WIDTH, HEIGHT);
-    mainDepthDesc.format = Renderer::DEPTH_IMAGE_FORMAT_D32_FLOAT;
-    mainDepthDesc.sampleCount = Renderer::SAMPLE_COUNT_1;
-
-    _mainDepth = _renderer->CreateDepthImage(mainDepthDesc);
+    // Main depth rendertarget, the depth prepass creates it as a transient every time the graph is setup
+    _mainDepthDesc.debugName = "MainDepth";
+    _mainDepthDesc.dimensions = ivec2(WIDTH, HEIGHT);
+    _mainDepthDesc.format = Renderer::DEPTH_IMAGE_FORMAT_D32_FLOAT;
+    _mainDepthDesc.sampleCount = Renderer::SAMPLE_COUNT_1;
 
     // Cube model TODO: This is unnecessary once we have some kind of Scene abstraction
     Renderer::ModelDesc modelDesc;
@@ -431,14 +471,21 @@ void ClientRenderer::CreatePermanentResources()
 
         projMatrix = glm::perspective(fov, aspectRatio, nearClip, farClip);
 
-        _viewConstantBuffer->Apply(0);
-        _viewConstantBuffer->Apply(1);
+        _viewConstantBuffer->ApplyAll();
     }
 
-    // Model Constant Buffer (for per-model data)
+    // Cube instance, this gets a slot in the shared instance buffer
     _cubeModelInstance.Init(_renderer);
+    _cubeModelInstance.Apply();
 
     // Frame allocator, this is a fast allocator for data that is only needed this frame
     _frameAllocator = new Memory::StackAllocator(FRAME_ALLOCATOR_SIZE);
     _frameAllocator->Init();
+
+    // The rendergraph passes live in here, it never gets reset
+    _renderGraphAllocator = new Memory::StackAllocator(RENDER_GRAPH_ALLOCATOR_SIZE);
+    _renderGraphAllocator->Init();
+
+    // Taskflow used to record the rendergraph passes in parallel
+    _renderGraphTaskflow = new tf::Taskflow();
 }
@@ -13,6 +13,7 @@
 namespace Renderer
 {
     class Renderer;
+    class RenderGraph;
 }
 
 namespace Memory
@@ -20,6 +21,11 @@ namespace Memory
     class StackAllocator;
 }
 
+namespace tf
+{
+    class Taskflow;
+}
+
 class Window;
 class Camera;
 class UIRenderer;
@@ -29,7 +35,8 @@ class InputManager;
 class ClientRenderer
 {
 public:
-    ClientRenderer();
+    ClientRenderer(bool headless);
+    ~ClientRenderer();
 
     bool UpdateWindow(f32 deltaTime);
     void Update(f32 deltaTime);
@@ -39,6 +46,9 @@ public:
     UIRenderer* GetUIRenderer() { return _uiRenderer; }
 private:
     void CreatePermanentResources();
+    void CreateRenderGraph();
+
+    Renderer::ImageID GetPresentImage();
 
 private:
     Window* _window;
@@ -46,7 +56,11 @@ private:
     InputManager* _inputManager;
     Renderer::Renderer* _renderer;
     Memory::StackAllocator* _frameAllocator;
+    Memory::StackAllocator* _renderGraphAllocator;
+    Renderer::RenderGraph* _renderGraph = nullptr;
+    tf::Taskflow* _renderGraphTaskflow;
 
+    bool _headless; // There is no window when we run headless, everything renders with RendererNull
     u8 _frameIndex = 0;
 
     // Permanent resources
@@ -54,7 +68,8 @@ private:
     Renderer::ImageID _debugTextureID;
     Renderer::ImageID _debugAlphaMap;
 
-    Renderer::DepthImageID _mainDepth;
+    Renderer::DepthImageDesc _mainDepthDesc;
+    Renderer::DepthImageID _mainDepth; // Transient, only valid for Read/Write calls while the graph is setup
 
     Renderer::ModelID _cubeModel;
     Renderer::TextureID _cubeTexture;
@@ -63,6 +78,13 @@ private:
 
     Renderer::ConstantBuffer<ViewConstantBuffer>* _viewConstantBuffer;
 
+    // Only built and compiled the first time their pass runs after the RenderGraph was set up, after that we reuse the ID so executing the pass doesn't hash anything
+    // Setting the graph up again can hand the pass different transient images, and evicting the old ones destroys their pipelines, so we resolve the ID again then
+    Renderer::GraphicsPipelineID _depthPrepassPipeline = Renderer::GraphicsPipelineID::Invalid();
+    Renderer::GraphicsPipelineID _mainPassPipeline = Renderer::GraphicsPipelineID::Invalid();
+    u32 _depthPrepassPipelineSetup = 0; // The RenderGraph::GetSetupCount the pipeline was resolved for
+    u32 _mainPassPipelineSetup = 0;
+
     // Sub renderers
     UIRenderer* _uiRenderer;
     TerrainRenderer* _terrainRenderer;
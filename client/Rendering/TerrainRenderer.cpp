@@ -5,6 +5,7 @@
 #include "../ECS/Components/Singletons/MapSingleton.h"
 
 #include <Renderer/Renderer.h>
+#include <Utils/DebugHandler.h>
 #include <glm/gtc/matrix_transform.hpp>
 
 const int WIDTH = 1920;
@@ -16,10 +17,15 @@ TerrainRenderer::TerrainRenderer(Renderer::Renderer* renderer)
     CreatePermanentResources();
 }
 
+void TerrainRenderer::SortLayers(const vec3& cameraPosition)
+{
+    Renderer::RenderLayer& terrainLayer = _renderer->GetRenderLayer("Terrain"_h);
+    terrainLayer.Sort(cameraPosition);
+}
+
 void TerrainRenderer::Update(f32 deltaTime)
 {
     Renderer::RenderLayer& terrainLayer = _renderer->GetRenderLayer("Terrain"_h);
-    terrainLayer.Reset();
 
     u32 numInstances = static_cast<u32>(_chunkModelInstances.size());
     for (size_t i = 0; i < numInstances; i++)
@@ -28,7 +34,7 @@ void TerrainRenderer::Update(f32 deltaTime)
     }
 }
 
-void TerrainRenderer::AddTerrainDepthPrepass(Renderer::RenderGraph* renderGraph, Renderer::ConstantBuffer<ViewConstantBuffer>* viewConstantBuffer, Renderer::DepthImageID depthTarget, u8 frameIndex)
+void TerrainRenderer::AddTerrainDepthPrepass(Renderer::RenderGraph* renderGraph, Renderer::ConstantBuffer<ViewConstantBuffer>* viewConstantBuffer, Renderer::DepthImageID& depthTarget, u8& frameIndex)
 {
     // Terrain Depth Prepass
     {
@@ -37,65 +43,73 @@ void TerrainRenderer::AddTerrainDepthPrepass(Renderer::RenderGraph* renderGraph,
             Renderer::RenderPassMutableResource mainDepth;
         };
         renderGraph->AddPass<TerrainDepthPrepassData>("TerrainDepth",
-            [=](TerrainDepthPrepassData& data, Renderer::RenderGraphBuilder& builder) // Setup
+            [=, &depthTarget](TerrainDepthPrepassData& data, Renderer::RenderGraphBuilder& builder) // Setup
         {
-            data.mainDepth = builder.Write(depthTarget, Renderer::RenderGraphBuilder::WriteMode::WRITE_MODE_RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::LOAD_MODE_CLEAR);
+            data.mainDepth = builder.Write(depthTarget, Renderer::RenderGraphBuilder::WriteMode::WRITE_MODE_RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::LOAD_MODE_LOAD);
             
             return true;// Return true from setup to enable this pass, return false to disable it
         },
-            [=, &renderGraph](TerrainDepthPrepassData& data, Renderer::CommandList& commandList) // Execute
+            [=, &frameIndex](TerrainDepthPrepassData& data, Renderer::CommandList& commandList) // Execute
         {
-            Renderer::GraphicsPipelineDesc pipelineDesc;
-            renderGraph->InitializePipelineDesc(pipelineDesc);
-
-            // Shader
-            Renderer::VertexShaderDesc vertexShaderDesc;
-            vertexShaderDesc.path = "Data/shaders/terrain.vert.spv";
-            pipelineDesc.states.vertexShader = _renderer->LoadShader(vertexShaderDesc);
-
-            // Constant buffers  TODO: Improve on this, if I set state 0 and 3 it won't work etc...
-            pipelineDesc.states.constantBufferStates[0].enabled = true; // ViewCB
-            pipelineDesc.states.constantBufferStates[0].shaderVisibility = Renderer::ShaderVisibility::SHADER_VISIBILITY_VERTEX;
-            pipelineDesc.states.constantBufferStates[1].enabled = true; // ModelCB
-            pipelineDesc.states.constantBufferStates[1].shaderVisibility = Renderer::ShaderVisibility::SHADER_VISIBILITY_VERTEX;
-
-            // Input layouts TODO: Improve on this, if I set state 0 and 3 it won't work etc... Maybe responsibility for this should be moved to ModelHandler and the cooker?
-            pipelineDesc.states.inputLayouts[0].enabled = true;
-            pipelineDesc.states.inputLayouts[0].SetName("INSTANCEID");
-            pipelineDesc.states.inputLayouts[0].format = Renderer::InputFormat::INPUT_FORMAT_R32_UINT;
-            pipelineDesc.states.inputLayouts[0].inputClassification = Renderer::InputClassification::INPUT_CLASSIFICATION_PER_INSTANCE;
-
-            // Viewport
-            pipelineDesc.states.viewport.topLeftX = 0;
-            pipelineDesc.states.viewport.topLeftY = 0;
-            pipelineDesc.states.viewport.width = static_cast<f32>(WIDTH);
-            pipelineDesc.states.viewport.height = static_cast<f32>(HEIGHT);
-            pipelineDesc.states.viewport.minDepth = 0.0f;
-            pipelineDesc.states.viewport.maxDepth = 1.0f;
-
-            // ScissorRect
-            pipelineDesc.states.scissorRect.left = 0;
-            pipelineDesc.states.scissorRect.right = WIDTH;
-            pipelineDesc.states.scissorRect.top = 0;
-            pipelineDesc.states.scissorRect.bottom = HEIGHT;
-
-            // Depth state
-            pipelineDesc.states.depthStencilState.depthEnable = true;
-            pipelineDesc.states.depthStencilState.depthWriteEnable = true;
-            pipelineDesc.states.depthStencilState.depthFunc = Renderer::ComparisonFunc::COMPARISON_FUNC_LESS;
-
-            // Rasterizer state
-            pipelineDesc.states.rasterizerState.cullMode = Renderer::CullMode::CULL_MODE_BACK;
-            pipelineDesc.states.rasterizerState.frontFaceMode = Renderer::FrontFaceState::FRONT_FACE_STATE_COUNTERCLOCKWISE;
-
-            // Samplers TODO: We don't care which samplers we have here, we just need the number of samplers
-            pipelineDesc.states.samplers[0].enabled = true;
-
-            pipelineDesc.depthStencil = data.mainDepth;
-
-            // Set pipeline
-            Renderer::GraphicsPipelineID pipeline = _renderer->CreatePipeline(pipelineDesc); // This will compile the pipeline and return the ID, or just return ID of cached pipeline
-            commandList.BeginPipeline(pipeline);
+            if (_depthPrepassPipelineSetup != renderGraph->GetSetupCount())
+            {
+                Renderer::GraphicsPipelineDesc pipelineDesc;
+                renderGraph->InitializePipelineDesc(pipelineDesc);
+
+                // Shader
+                Renderer::VertexShaderDesc vertexShaderDesc;
+                vertexShaderDesc.path = "Data/shaders/terrain.vert.spv";
+                pipelineDesc.states.vertexShader = _renderer->LoadShader(vertexShaderDesc);
+
+                // Constant buffers  TODO: Improve on this, if I set state 0 and 3 it won't work etc...
+                pipelineDesc.states.constantBufferStates[0].enabled = true; // ViewCB
+                pipelineDesc.states.constantBufferStates[0].shaderVisibility = Renderer::ShaderVisibility::SHADER_VISIBILITY_VERTEX;
+
+                // Push constants
+                pipelineDesc.states.pushConstantRanges[0].enabled = true; // TerrainDrawConstants
+                pipelineDesc.states.pushConstantRanges[0].shaderVisibility = Renderer::ShaderVisibility::SHADER_VISIBILITY_VERTEX;
+                pipelineDesc.states.pushConstantRanges[0].size = sizeof(TerrainDrawConstants);
+
+                // Input layouts TODO: Improve on this, if I set state 0 and 3 it won't work etc... Maybe responsibility for this should be moved to ModelHandler and the cooker?
+                pipelineDesc.states.inputLayouts[0].enabled = true;
+                pipelineDesc.states.inputLayouts[0].SetName("INSTANCEID");
+                pipelineDesc.states.inputLayouts[0].format = Renderer::InputFormat::INPUT_FORMAT_R32_UINT;
+                pipelineDesc.states.inputLayouts[0].inputClassification = Renderer::InputClassification::INPUT_CLASSIFICATION_PER_INSTANCE;
+
+                // Viewport
+                pipelineDesc.states.viewport.topLeftX = 0;
+                pipelineDesc.states.viewport.topLeftY = 0;
+                pipelineDesc.states.viewport.width = static_cast<f32>(WIDTH);
+                pipelineDesc.states.viewport.height = static_cast<f32>(HEIGHT);
+                pipelineDesc.states.viewport.minDepth = 0.0f;
+                pipelineDesc.states.viewport.maxDepth = 1.0f;
+
+                // ScissorRect
+                pipelineDesc.states.scissorRect.left = 0;
+                pipelineDesc.states.scissorRect.right = WIDTH;
+                pipelineDesc.states.scissorRect.top = 0;
+                pipelineDesc.states.scissorRect.bottom = HEIGHT;
+
+                // Depth state
+                pipelineDesc.states.depthStencilState.depthEnable = true;
+                pipelineDesc.states.depthStencilState.depthWriteEnable = true;
+                pipelineDesc.states.depthStencilState.depthFunc = Renderer::ComparisonFunc::COMPARISON_FUNC_LESS;
+
+                // Rasterizer state
+                pipelineDesc.states.rasterizerState.cullMode = Renderer::CullMode::CULL_MODE_BACK;
+                pipelineDesc.states.rasterizerState.frontFaceMode = Renderer::FrontFaceState::FRONT_FACE_STATE_COUNTERCLOCKWISE;
+
+                // Samplers TODO: We don't care which samplers we have here, we just need the number of samplers
+                pipelineDesc.states.samplers[0].enabled = true;
+
+                pipelineDesc.depthStencil = data.mainDepth;
+
+                // Set pipeline
+                _depthPrepassPipeline = _renderer->CreatePipeline(pipelineDesc);
+                _depthPrepassPipelineSetup = renderGraph->GetSetupCount();
+            }
+
+            commandList.BeginPipeline(_depthPrepassPipeline);
 
             // Set instance buffer
             commandList.SetBuffer(0, _terrainInstanceIDs->GetBuffer(frameIndex));
@@ -103,33 +117,31 @@ void TerrainRenderer::AddTerrainDepthPrepass(Renderer::RenderGraph* renderGraph,
             // Set view constant buffer
             commandList.SetConstantBuffer(0, viewConstantBuffer->GetDescriptor(frameIndex), frameIndex);
 
+            // Set vertex storage buffer, every loaded chunk has its vertices in it
+            commandList.SetStorageBuffer(1, _vertexBuffer->GetDescriptor(frameIndex), frameIndex);
+
             // Render main layer
             Renderer::RenderLayer& mainLayer = _renderer->GetRenderLayer("Terrain"_h);
 
-            for (auto const& model : mainLayer.GetModels())
+            for (auto const& drawCall : mainLayer.GetDrawCalls())
             {
-                auto const& instances = model.second;
+                TerrainInstanceData* terrainInstanceData = drawCall.instanceData->GetOptional<TerrainInstanceData>();
 
-                for (auto const& instance : instances)
-                {
-                    // Set model constant buffer
-                    commandList.SetConstantBuffer(1, instance->GetDescriptor(frameIndex), frameIndex);
-
-                    TerrainInstanceData* terrainInstanceData = instance->GetOptional<TerrainInstanceData>();
+                // Tell the shaders where this chunk starts in the chunk data and vertex buffers
+                TerrainDrawConstants drawConstants;
+                drawConstants.chunkDataIndex = static_cast<u32>(terrainInstanceData->chunkDataRange.offset / sizeof(TerrainChunkData));
+                drawConstants.vertexOffset = static_cast<u32>(terrainInstanceData->vertexRange.offset / sizeof(TerrainVertex));
+                commandList.PushConstant(&drawConstants, 0, sizeof(TerrainDrawConstants));
 
-                    // Set vertex storage buffer
-                    commandList.SetStorageBuffer(2, terrainInstanceData->vertexBuffer->GetDescriptor(frameIndex), frameIndex);
-
-                    // Draw
-                    commandList.DrawIndexedBindless(_chunkModel, Terrain::NUM_INDICES_PER_CHUNK, Terrain::MAP_CELLS_PER_CHUNK);
-                }
+                // Draw
+                commandList.DrawIndexedBindless(_chunkModel, Terrain::NUM_INDICES_PER_CHUNK, Terrain::MAP_CELLS_PER_CHUNK);
             }
-            commandList.EndPipeline(pipeline);
+            commandList.EndPipeline(_depthPrepassPipeline);
         });
     }
 }
 
-void TerrainRenderer::AddTerrainPass(Renderer::RenderGraph* renderGraph, Renderer::ConstantBuffer<ViewConstantBuffer>* viewConstantBuffer, Renderer::ImageID renderTarget, Renderer::DepthImageID depthTarget, u8 frameIndex)
+void TerrainRenderer::AddTerrainPass(Renderer::RenderGraph* renderGraph, Renderer::ConstantBuffer<ViewConstantBuffer>* viewConstantBuffer, Renderer::ImageID renderTarget, Renderer::DepthImageID& depthTarget, u8& frameIndex)
 {
     // Terrain Pass
     {
@@ -140,72 +152,86 @@ void TerrainRenderer::AddTerrainPass(Renderer::RenderGraph* renderGraph, Rendere
         };
 
         renderGraph->AddPass<TerrainPassData>("Terrain Pass",
-            [=](TerrainPassData& data, Renderer::RenderGraphBuilder& builder) // Setup
+            [=, &depthTarget](TerrainPassData& data, Renderer::RenderGraphBuilder& builder) // Setup
         {
-            data.mainColor = builder.Write(renderTarget, Renderer::RenderGraphBuilder::WriteMode::WRITE_MODE_RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::LOAD_MODE_CLEAR);
-            data.mainDepth = builder.Write(depthTarget, Renderer::RenderGraphBuilder::WriteMode::WRITE_MODE_RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::LOAD_MODE_CLEAR);
+            data.mainColor = builder.Write(renderTarget, Renderer::RenderGraphBuilder::WriteMode::WRITE_MODE_RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::LOAD_MODE_LOAD);
+            data.mainDepth = builder.Write(depthTarget, Renderer::RenderGraphBuilder::WriteMode::WRITE_MODE_RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::LOAD_MODE_LOAD);
 
             return true; // Return true from setup to enable this pass, return false to disable it
         },
-            [=, &renderGraph](TerrainPassData& data, Renderer::CommandList& commandList) // Execute
+            [=, &frameIndex](TerrainPassData& data, Renderer::CommandList& commandList) // Execute
         {
-            Renderer::GraphicsPipelineDesc pipelineDesc;
-            renderGraph->InitializePipelineDesc(pipelineDesc);
-
-            // Shaders
-            Renderer::VertexShaderDesc vertexShaderDesc;
-            vertexShaderDesc.path = "Data/shaders/terrain.vert.spv";
-            pipelineDesc.states.vertexShader = _renderer->LoadShader(vertexShaderDesc);
-
-            Renderer::PixelShaderDesc pixelShaderDesc;
-            pixelShaderDesc.path = "Data/shaders/terrain.frag.spv";
-            pipelineDesc.states.pixelShader = _renderer->LoadShader(pixelShaderDesc);
-
-            // Constant buffers  TODO: Improve on this, if I set state 0 and 3 it won't work etc...
-            pipelineDesc.states.constantBufferStates[0].enabled = true; // ViewCB
-            pipelineDesc.states.constantBufferStates[0].shaderVisibility = Renderer::ShaderVisibility::SHADER_VISIBILITY_VERTEX;
-            pipelineDesc.states.constantBufferStates[1].enabled = true; // ModelCB
-            pipelineDesc.states.constantBufferStates[1].shaderVisibility = Renderer::ShaderVisibility::SHADER_VISIBILITY_VERTEX;
-
-            // Input layouts TODO: Improve on this, if I set state 0 and 3 it won't work etc... Maybe responsibility for this should be moved to ModelHandler and the cooker?
-            pipelineDesc.states.inputLayouts[0].enabled = true;
-            pipelineDesc.states.inputLayouts[0].SetName("INSTANCEID");
-            pipelineDesc.states.inputLayouts[0].format = Renderer::InputFormat::INPUT_FORMAT_R32_UINT;
-            pipelineDesc.states.inputLayouts[0].inputClassification = Renderer::InputClassification::INPUT_CLASSIFICATION_PER_INSTANCE;
-
-            // Viewport
-            pipelineDesc.states.viewport.topLeftX = 0;
-            pipelineDesc.states.viewport.topLeftY = 0;
-            pipelineDesc.states.viewport.width = static_cast<f32>(WIDTH);
-            pipelineDesc.states.viewport.height = static_cast<f32>(HEIGHT);
-            pipelineDesc.states.viewport.minDepth = 0.0f;
-            pipelineDesc.states.viewport.maxDepth = 1.0f;
-
-            // ScissorRect
-            pipelineDesc.states.scissorRect.left = 0;
-            pipelineDesc.states.scissorRect.right = WIDTH;
-            pipelineDesc.states.scissorRect.top = 0;
-            pipelineDesc.states.scissorRect.bottom = HEIGHT;
-
-            // Depth state
-            pipelineDesc.states.depthStencilState.depthEnable = true;
-            pipelineDesc.states.depthStencilState.depthFunc = Renderer::ComparisonFunc::COMPARISON_FUNC_EQUAL;
-
-            // Rasterizer state
-            pipelineDesc.states.rasterizerState.cullMode = Renderer::CullMode::CULL_MODE_BACK;
-            pipelineDesc.states.rasterizerState.frontFaceMode = Renderer::FrontFaceState::FRONT_FACE_STATE_COUNTERCLOCKWISE;
-
-            // Samplers TODO: We don't care which samplers we have here, we just need the number of samplers
-            pipelineDesc.states.samplers[0].enabled = true;
-
-            // Render targets
-            pipelineDesc.renderTargets[0] = data.mainColor;
-
-            pipelineDesc.depthStencil = data.mainDepth;
-
-            // Set pipeline
-            Renderer::GraphicsPipelineID pipeline = _renderer->CreatePipeline(pipelineDesc); // This will compile the pipeline and return the ID, or just return ID of cached pipeline
-            commandList.BeginPipeline(pipeline);
+            if (_terrainPipelineSetup != renderGraph->GetSetupCount())
+            {
+                Renderer::GraphicsPipelineDesc pipelineDesc;
+                renderGraph->InitializePipelineDesc(pipelineDesc);
+
+                // Shaders
+                Renderer::VertexShaderDesc vertexShaderDesc;
+                vertexShaderDesc.path = "Data/shaders/terrain.vert.spv";
+                pipelineDesc.states.vertexShader = _renderer->LoadShader(vertexShaderDesc);
+
+                Renderer::PixelShaderDesc pixelShaderDesc;
+                pixelShaderDesc.path = "Data/shaders/terrain.frag.spv";
+                pipelineDesc.states.pixelShader = _renderer->LoadShader(pixelShaderDesc);
+
+                // Specialization constants
+                pipelineDesc.states.specializationConstants[0].enabled = true; // NUM_TERRAIN_LAYERS
+                pipelineDesc.states.specializationConstants[0].shaderVisibility = Renderer::ShaderVisibility::SHADER_VISIBILITY_PIXEL;
+                pipelineDesc.states.specializationConstants[0].constantID = 0;
+                pipelineDesc.states.specializationConstants[0].SetValue(Terrain::NUM_TERRAIN_LAYERS);
+
+                // Constant buffers  TODO: Improve on this, if I set state 0 and 3 it won't work etc...
+                pipelineDesc.states.constantBufferStates[0].enabled = true; // ViewCB
+                pipelineDesc.states.constantBufferStates[0].shaderVisibility = Renderer::ShaderVisibility::SHADER_VISIBILITY_VERTEX;
+
+                // Push constants
+                pipelineDesc.states.pushConstantRanges[0].enabled = true; // TerrainDrawConstants
+                pipelineDesc.states.pushConstantRanges[0].shaderVisibility = Renderer::ShaderVisibility::SHADER_VISIBILITY_VERTEX;
+                pipelineDesc.states.pushConstantRanges[0].size = sizeof(TerrainDrawConstants);
+
+                // Input layouts TODO: Improve on this, if I set state 0 and 3 it won't work etc... Maybe responsibility for this should be moved to ModelHandler and the cooker?
+                pipelineDesc.states.inputLayouts[0].enabled = true;
+                pipelineDesc.states.inputLayouts[0].SetName("INSTANCEID");
+                pipelineDesc.states.inputLayouts[0].format = Renderer::InputFormat::INPUT_FORMAT_R32_UINT;
+                pipelineDesc.states.inputLayouts[0].inputClassification = Renderer::InputClassification::INPUT_CLASSIFICATION_PER_INSTANCE;
+
+                // Viewport
+                pipelineDesc.states.viewport.topLeftX = 0;
+                pipelineDesc.states.viewport.topLeftY = 0;
+                pipelineDesc.states.viewport.width = static_cast<f32>(WIDTH);
+                pipelineDesc.states.viewport.height = static_cast<f32>(HEIGHT);
+                pipelineDesc.states.viewport.minDepth = 0.0f;
+                pipelineDesc.states.viewport.maxDepth = 1.0f;
+
+                // ScissorRect
+                pipelineDesc.states.scissorRect.left = 0;
+                pipelineDesc.states.scissorRect.right = WIDTH;
+                pipelineDesc.states.scissorRect.top = 0;
+                pipelineDesc.states.scissorRect.bottom = HEIGHT;
+
+                // Depth state
+                pipelineDesc.states.depthStencilState.depthEnable = true;
+                pipelineDesc.states.depthStencilState.depthFunc = Renderer::ComparisonFunc::COMPARISON_FUNC_EQUAL;
+
+                // Rasterizer state
+                pipelineDesc.states.rasterizerState.cullMode = Renderer::CullMode::CULL_MODE_BACK;
+                pipelineDesc.states.rasterizerState.frontFaceMode = Renderer::FrontFaceState::FRONT_FACE_STATE_COUNTERCLOCKWISE;
+
+                // Samplers TODO: We don't care which samplers we have here, we just need the number of samplers
+                pipelineDesc.states.samplers[0].enabled = true;
+
+                // Render targets
+                pipelineDesc.renderTargets[0] = data.mainColor;
+
+                pipelineDesc.depthStencil = data.mainDepth;
+
+                // Set pipeline
+                _terrainPipeline = _renderer->CreatePipeline(pipelineDesc);
+                _terrainPipelineSetup = renderGraph->GetSetupCount();
+            }
+
+            commandList.BeginPipeline(_terrainPipeline);
 
             // Set instance buffer
             commandList.SetBuffer(0, _terrainInstanceIDs->GetBuffer(frameIndex));
@@ -213,44 +239,42 @@ void TerrainRenderer::AddTerrainPass(Renderer::RenderGraph* renderGraph, Rendere
             // Set view constant buffer
             commandList.SetConstantBuffer(0, viewConstantBuffer->GetDescriptor(frameIndex), frameIndex);
 
+            // Set vertex storage buffer, every loaded chunk has its vertices in it
+            commandList.SetStorageBuffer(1, _vertexBuffer->GetDescriptor(frameIndex), frameIndex);
+
             // Set sampler
-            commandList.SetSampler(3, _alphaSampler);
-            commandList.SetSampler(4, _colorSampler);
+            commandList.SetSampler(2, _alphaSampler);
+            commandList.SetSampler(3, _colorSampler);
 
             // Set texture arrays
-            commandList.SetTextureArray(5, _terrainColorTextureArray);
-            commandList.SetTextureArray(6, _terrainAlphaTextureArray);
+            commandList.SetTextureArray(4, _terrainColorTextureArray);
+            commandList.SetTextureArray(5, _terrainAlphaTextureArray);
+
+            // Set chunk data storage buffer, each chunk pushes where its data starts
+            commandList.SetStorageBuffer(6, _chunkDataBuffer->GetDescriptor(frameIndex), frameIndex);
 
             // Render main layer
             Renderer::RenderLayer& mainLayer = _renderer->GetRenderLayer("Terrain"_h);
 
-            for (auto const& model : mainLayer.GetModels())
+            for (auto const& drawCall : mainLayer.GetDrawCalls())
             {
-                auto const& instances = model.second;
-
-                for (auto const& instance : instances)
-                {
-                    // Set model constant buffer
-                    commandList.SetConstantBuffer(1, instance->GetDescriptor(frameIndex), frameIndex);
+                TerrainInstanceData* terrainInstanceData = drawCall.instanceData->GetOptional<TerrainInstanceData>();
 
-                    TerrainInstanceData* terrainInstanceData = instance->GetOptional<TerrainInstanceData>();
+                // Tell the shaders where this chunk starts in the chunk data and vertex buffers
+                TerrainDrawConstants drawConstants;
+                drawConstants.chunkDataIndex = static_cast<u32>(terrainInstanceData->chunkDataRange.offset / sizeof(TerrainChunkData));
+                drawConstants.vertexOffset = static_cast<u32>(terrainInstanceData->vertexRange.offset / sizeof(TerrainVertex));
+                commandList.PushConstant(&drawConstants, 0, sizeof(TerrainDrawConstants));
 
-                    // Set vertex storage buffer
-                    commandList.SetStorageBuffer(2, terrainInstanceData->vertexBuffer->GetDescriptor(frameIndex), frameIndex);
-                    
-                    // Set constant buffer
-                    commandList.SetConstantBuffer(7, terrainInstanceData->chunkData->GetDescriptor(frameIndex), frameIndex);
-
-                    // Draw
-                    commandList.DrawIndexedBindless(_chunkModel, Terrain::NUM_INDICES_PER_CHUNK, Terrain::MAP_CELLS_PER_CHUNK);
-                }
+                // Draw
+                commandList.DrawIndexedBindless(_chunkModel, Terrain::NUM_INDICES_PER_CHUNK, Terrain::MAP_CELLS_PER_CHUNK);
             }
-            commandList.EndPipeline(pipeline);
+            commandList.EndPipeline(_terrainPipeline);
         });
     }
 }
 
-void TerrainRenderer::AddTerrainDebugPass(Renderer::RenderGraph* renderGraph, Renderer::ConstantBuffer<ViewConstantBuffer>* viewConstantBuffer, Renderer::ImageID textureIDTarget, Renderer::ImageID alphaMapTarget, Renderer::DepthImageID depthTarget, u8 frameIndex)
+void TerrainRenderer::AddTerrainDebugPass(Renderer::RenderGraph* renderGraph, Renderer::ConstantBuffer<ViewConstantBuffer>* viewConstantBuffer, Renderer::ImageID textureIDTarget, Renderer::ImageID alphaMapTarget, Renderer::DepthImageID& depthTarget, u8& frameIndex)
 {
     // Terrain Debug Pass
     {
@@ -262,77 +286,85 @@ void TerrainRenderer::AddTerrainDebugPass(Renderer::RenderGraph* renderGraph, Re
         };
 
         renderGraph->AddPass<TerrainPassData>("TerrainDebug",
-            [=](TerrainPassData& data, Renderer::RenderGraphBuilder& builder) // Setup
+            [=, &depthTarget](TerrainPassData& data, Renderer::RenderGraphBuilder& builder) // Setup
         {
             data.textureIDTarget = builder.Write(textureIDTarget, Renderer::RenderGraphBuilder::WriteMode::WRITE_MODE_RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::LOAD_MODE_CLEAR);
             data.alphaMapTarget = builder.Write(alphaMapTarget, Renderer::RenderGraphBuilder::WriteMode::WRITE_MODE_RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::LOAD_MODE_CLEAR);
-            data.mainDepth = builder.Write(depthTarget, Renderer::RenderGraphBuilder::WriteMode::WRITE_MODE_RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::LOAD_MODE_CLEAR);
+            data.mainDepth = builder.Write(depthTarget, Renderer::RenderGraphBuilder::WriteMode::WRITE_MODE_RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::LOAD_MODE_LOAD);
 
             return true; // Return true from setup to enable this pass, return false to disable it
         },
-            [=, &renderGraph](TerrainPassData& data, Renderer::CommandList& commandList) // Execute
+            [=, &frameIndex](TerrainPassData& data, Renderer::CommandList& commandList) // Execute
         {
             commandList.Clear(textureIDTarget, Color(0,0,0,0));
             commandList.Clear(alphaMapTarget, Color(0, 0, 0, 0));
 
-            Renderer::GraphicsPipelineDesc pipelineDesc;
-            renderGraph->InitializePipelineDesc(pipelineDesc);
-
-            // Shaders
-            Renderer::VertexShaderDesc vertexShaderDesc;
-            vertexShaderDesc.path = "Data/shaders/terrain.vert.spv";
-            pipelineDesc.states.vertexShader = _renderer->LoadShader(vertexShaderDesc);
-
-            Renderer::PixelShaderDesc pixelShaderDesc;
-            pixelShaderDesc.path = "Data/shaders/terrainDebug.frag.spv";
-            pipelineDesc.states.pixelShader = _renderer->LoadShader(pixelShaderDesc);
-
-            // Constant buffers  TODO: Improve on this, if I set state 0 and 3 it won't work etc...
-            pipelineDesc.states.constantBufferStates[0].enabled = true; // ViewCB
-            pipelineDesc.states.constantBufferStates[0].shaderVisibility = Renderer::ShaderVisibility::SHADER_VISIBILITY_VERTEX;
-            pipelineDesc.states.constantBufferStates[1].enabled = true; // ModelCB
-            pipelineDesc.states.constantBufferStates[1].shaderVisibility = Renderer::ShaderVisibility::SHADER_VISIBILITY_VERTEX;
-
-            // Input layouts TODO: Improve on this, if I set state 0 and 3 it won't work etc... Maybe responsibility for this should be moved to ModelHandler and the cooker?
-            pipelineDesc.states.inputLayouts[0].enabled = true;
-            pipelineDesc.states.inputLayouts[0].SetName("INSTANCEID");
-            pipelineDesc.states.inputLayouts[0].format = Renderer::InputFormat::INPUT_FORMAT_R32_UINT;
-            pipelineDesc.states.inputLayouts[0].inputClassification = Renderer::InputClassification::INPUT_CLASSIFICATION_PER_INSTANCE;
-
-            // Viewport
-            pipelineDesc.states.viewport.topLeftX = 0;
-            pipelineDesc.states.viewport.topLeftY = 0;
-            pipelineDesc.states.viewport.width = static_cast<f32>(WIDTH);
-            pipelineDesc.states.viewport.height = static_cast<f32>(HEIGHT);
-            pipelineDesc.states.viewport.minDepth = 0.0f;
-            pipelineDesc.states.viewport.maxDepth = 1.0f;
-
-            // ScissorRect
-            pipelineDesc.states.scissorRect.left = 0;
-            pipelineDesc.states.scissorRect.right = WIDTH;
-            pipelineDesc.states.scissorRect.top = 0;
-            pipelineDesc.states.scissorRect.bottom = HEIGHT;
-
-            // Depth state
-            pipelineDesc.states.depthStencilState.depthEnable = true;
-            pipelineDesc.states.depthStencilState.depthFunc = Renderer::ComparisonFunc::COMPARISON_FUNC_EQUAL;
-
-            // Rasterizer state
-            pipelineDesc.states.rasterizerState.cullMode = Renderer::CullMode::CULL_MODE_BACK;
-            pipelineDesc.states.rasterizerState.frontFaceMode = Renderer::FrontFaceState::FRONT_FACE_STATE_COUNTERCLOCKWISE;
-
-            // Samplers TODO: We don't care which samplers we have here, we just need the number of samplers
-            pipelineDesc.states.samplers[0].enabled = true;
-
-            // Render targets
-            pipelineDesc.renderTargets[0] = data.textureIDTarget;
-            pipelineDesc.renderTargets[1] = data.alphaMapTarget;
-
-            pipelineDesc.depthStencil = data.mainDepth;
-
-            // Set pipeline
-            Renderer::GraphicsPipelineID pipeline = _renderer->CreatePipeline(pipelineDesc); // This will compile the pipeline and return the ID, or just return ID of cached pipeline
-            commandList.BeginPipeline(pipeline);
+            if (_debugPipelineSetup != renderGraph->GetSetupCount())
+            {
+                Renderer::GraphicsPipelineDesc pipelineDesc;
+                renderGraph->InitializePipelineDesc(pipelineDesc);
+
+                // Shaders
+                Renderer::VertexShaderDesc vertexShaderDesc;
+                vertexShaderDesc.path = "Data/shaders/terrain.vert.spv";
+                pipelineDesc.states.vertexShader = _renderer->LoadShader(vertexShaderDesc);
+
+                Renderer::PixelShaderDesc pixelShaderDesc;
+                pixelShaderDesc.path = "Data/shaders/terrainDebug.frag.spv";
+                pipelineDesc.states.pixelShader = _renderer->LoadShader(pixelShaderDesc);
+
+                // Constant buffers  TODO: Improve on this, if I set state 0 and 3 it won't work etc...
+                pipelineDesc.states.constantBufferStates[0].enabled = true; // ViewCB
+                pipelineDesc.states.constantBufferStates[0].shaderVisibility = Renderer::ShaderVisibility::SHADER_VISIBILITY_VERTEX;
+
+                // Push constants
+                pipelineDesc.states.pushConstantRanges[0].enabled = true; // TerrainDrawConstants
+                pipelineDesc.states.pushConstantRanges[0].shaderVisibility = Renderer::ShaderVisibility::SHADER_VISIBILITY_VERTEX;
+                pipelineDesc.states.pushConstantRanges[0].size = sizeof(TerrainDrawConstants);
+
+                // Input layouts TODO: Improve on this, if I set state 0 and 3 it won't work etc... Maybe responsibility for this should be moved to ModelHandler and the cooker?
+                pipelineDesc.states.inputLayouts[0].enabled = true;
+                pipelineDesc.states.inputLayouts[0].SetName("INSTANCEID");
+                pipelineDesc.states.inputLayouts[0].format = Renderer::InputFormat::INPUT_FORMAT_R32_UINT;
+                pipelineDesc.states.inputLayouts[0].inputClassification = Renderer::InputClassification::INPUT_CLASSIFICATION_PER_INSTANCE;
+
+                // Viewport
+                pipelineDesc.states.viewport.topLeftX = 0;
+                pipelineDesc.states.viewport.topLeftY = 0;
+                pipelineDesc.states.viewport.width = static_cast<f32>(WIDTH);
+                pipelineDesc.states.viewport.height = static_cast<f32>(HEIGHT);
+                pipelineDesc.states.viewport.minDepth = 0.0f;
+                pipelineDesc.states.viewport.maxDepth = 1.0f;
+
+                // ScissorRect
+                pipelineDesc.states.scissorRect.left = 0;
+                pipelineDesc.states.scissorRect.right = WIDTH;
+                pipelineDesc.states.scissorRect.top = 0;
+                pipelineDesc.states.scissorRect.bottom = HEIGHT;
+
+                // Depth state
+                pipelineDesc.states.depthStencilState.depthEnable = true;
+                pipelineDesc.states.depthStencilState.depthFunc = Renderer::ComparisonFunc::COMPARISON_FUNC_EQUAL;
+
+                // Rasterizer state
+                pipelineDesc.states.rasterizerState.cullMode = Renderer::CullMode::CULL_MODE_BACK;
+                pipelineDesc.states.rasterizerState.frontFaceMode = Renderer::FrontFaceState::FRONT_FACE_STATE_COUNTERCLOCKWISE;
+
+                // Samplers TODO: We don't care which samplers we have here, we just need the number of samplers
+                pipelineDesc.states.samplers[0].enabled = true;
+
+                // Render targets
+                pipelineDesc.renderTargets[0] = data.textureIDTarget;
+                pipelineDesc.renderTargets[1] = data.alphaMapTarget;
+
+                pipelineDesc.depthStencil = data.mainDepth;
+
+                // Set pipeline
+                _debugPipeline = _renderer->CreatePipeline(pipelineDesc);
+                _debugPipelineSetup = renderGraph->GetSetupCount();
+            }
+
+            commandList.BeginPipeline(_debugPipeline);
 
             // Set instance buffer
             commandList.SetBuffer(0, _terrainInstanceIDs->GetBuffer(frameIndex));
@@ -340,39 +372,37 @@ void TerrainRenderer::AddTerrainDebugPass(Renderer::RenderGraph* renderGraph, Re
             // Set view constant buffer
             commandList.SetConstantBuffer(0, viewConstantBuffer->GetDescriptor(frameIndex), frameIndex);
 
+            // Set vertex storage buffer, every loaded chunk has its vertices in it
+            commandList.SetStorageBuffer(1, _vertexBuffer->GetDescriptor(frameIndex), frameIndex);
+
             // Set sampler
-            commandList.SetSampler(3, _alphaSampler);
-            commandList.SetSampler(4, _colorSampler);
+            commandList.SetSampler(2, _alphaSampler);
+            commandList.SetSampler(3, _colorSampler);
 
             // Set texture arrays
-            commandList.SetTextureArray(5, _terrainColorTextureArray);
-            commandList.SetTextureArray(6, _terrainAlphaTextureArray);
+            commandList.SetTextureArray(4, _terrainColorTextureArray);
+            commandList.SetTextureArray(5, _terrainAlphaTextureArray);
+
+            // Set chunk data storage buffer, each chunk pushes where its data starts
+            commandList.SetStorageBuffer(6, _chunkDataBuffer->GetDescriptor(frameIndex), frameIndex);
 
             // Render main layer
             Renderer::RenderLayer& mainLayer = _renderer->GetRenderLayer("Terrain"_h);
 
-            for (auto const& model : mainLayer.GetModels())
+            for (auto const& drawCall : mainLayer.GetDrawCalls())
             {
-                auto const& instances = model.second;
-
-                for (auto const& instance : instances)
-                {
-                    // Set model constant buffer
-                    commandList.SetConstantBuffer(1, instance->GetDescriptor(frameIndex), frameIndex);
-
-                    TerrainInstanceData* terrainInstanceData = instance->GetOptional<TerrainInstanceData>();
-
-                    // Set vertex storage buffer
-                    commandList.SetStorageBuffer(2, terrainInstanceData->vertexBuffer->GetDescriptor(frameIndex), frameIndex);
+                TerrainInstanceData* terrainInstanceData = drawCall.instanceData->GetOptional<TerrainInstanceData>();
 
-                    // Set constant buffer
-                    commandList.SetConstantBuffer(7, terrainInstanceData->chunkData->GetDescriptor(frameIndex), frameIndex);
+                // Tell the shaders where this chunk starts in the chunk data and vertex buffers
+                TerrainDrawConstants drawConstants;
+                drawConstants.chunkDataIndex = static_cast<u32>(terrainInstanceData->chunkDataRange.offset / sizeof(TerrainChunkData));
+                drawConstants.vertexOffset = static_cast<u32>(terrainInstanceData->vertexRange.offset / sizeof(TerrainVertex));
+                commandList.PushConstant(&drawConstants, 0, sizeof(TerrainDrawConstants));
 
-                    // Draw
-                    commandList.DrawIndexedBindless(_chunkModel, Terrain::NUM_INDICES_PER_CHUNK, Terrain::MAP_CELLS_PER_CHUNK);
-                }
+                // Draw
+                commandList.DrawIndexedBindless(_chunkModel, Terrain::NUM_INDICES_PER_CHUNK, Terrain::MAP_CELLS_PER_CHUNK);
             }
-            commandList.EndPipeline(pipeline);
+            commandList.EndPipeline(_debugPipeline);
         });
     }
 }
@@ -389,7 +419,7 @@ void TerrainRenderer::CreatePermanentResources()
     _terrainColorTextureArray = _renderer->CreateTextureArray(textureColorArrayDesc);
 
     Renderer::TextureArrayDesc textureAlphaArrayDesc;
-    textureAlphaArrayDesc.size = 196; // Max 196 loaded chunks at a time (7 chunks draw radius, 14x14 chunks),
+    textureAlphaArrayDesc.size = Terrain::MAX_LOADED_CHUNKS;
 
     _terrainAlphaTextureArray = _renderer->CreateTextureArray(textureAlphaArrayDesc);
 
@@ -478,12 +508,22 @@ void TerrainRenderer::CreatePermanentResources()
     _chunkModel = _renderer->CreatePrimitiveModel(modelDesc);
 
     // Initialize the instance IDs to go from 0 to Terrain::MAP_CELLS_PER_CHUNK
-    _terrainInstanceIDs = _renderer->CreateConstantBuffer<std::array<u32, Terrain::MAP_CELLS_PER_CHUNK>>();
+    _terrainInstanceIDs = _renderer->CreateConstantBuffer<std::array<u32, Terrain::MAP_CELLS_PER_CHUNK>>(Renderer::Backend::BufferBackend::USAGE_STATIC);
     for (u32 i = 0; i < Terrain::MAP_CELLS_PER_CHUNK; i++)
     {
         _terrainInstanceIDs->resource[i] = i;
     }
     _terrainInstanceIDs->ApplyAll();
+
+    // Chunk data for every loaded chunk, LoadChunk sub-allocates its part of this
+    const size_t chunkDataBufferSize = Terrain::MAX_LOADED_CHUNKS * Terrain::MAP_CELLS_PER_CHUNK * sizeof(TerrainChunkData);
+    _chunkDataBuffer = _renderer->CreateBuffer(chunkDataBufferSize, Renderer::Backend::BufferBackend::TYPE_STORAGE_BUFFER, Renderer::Backend::BufferBackend::USAGE_STATIC);
+    _chunkDataAllocator.Init(chunkDataBufferSize, sizeof(TerrainChunkData));
+
+    // Vertices for every loaded chunk, these never change after loading so one device local copy is shared by all frames
+    const size_t vertexBufferSize = Terrain::MAX_LOADED_CHUNKS * Terrain::NUM_VERTICES_PER_CHUNK * sizeof(TerrainVertex);
+    _vertexBuffer = _renderer->CreateBuffer(vertexBufferSize, Renderer::Backend::BufferBackend::TYPE_STORAGE_BUFFER, Renderer::Backend::BufferBackend::USAGE_STATIC);
+    _vertexAllocator.Init(vertexBufferSize, sizeof(TerrainVertex));
 }
 
 void TerrainRenderer::LoadChunk(Terrain::Map& map, u16 chunkPosX, u16 chunkPosY)
@@ -493,15 +533,27 @@ void TerrainRenderer::LoadChunk(Terrain::Map& map, u16 chunkPosX, u16 chunkPosY)
 
     Terrain::Chunk& chunk = map.chunks[chunkId];
 
-    // Create one chunk instance per chunk
+    // Create one chunk instance per chunk, this doesn't take a slot in the instance buffer since terrain.vert uses the instance rate for its cells
     Renderer::InstanceData chunkInstance;
-    chunkInstance.Init(_renderer);
 
     // Create terrain instance data
     TerrainInstanceData* terrainInstanceData = new TerrainInstanceData();
     chunkInstance.SetOptional(terrainInstanceData);
 
-    terrainInstanceData->chunkData = _renderer->CreateConstantBuffer<std::array<TerrainChunkData, Terrain::MAP_CELLS_PER_CHUNK>>();
+    std::array<TerrainChunkData, Terrain::MAP_CELLS_PER_CHUNK> chunkData;
+    if (!_chunkDataAllocator.Allocate(sizeof(chunkData), terrainInstanceData->chunkDataRange))
+    {
+        NC_LOG_FATAL("Ran out of terrain chunk data, more than %u chunks are loaded", Terrain::MAX_LOADED_CHUNKS);
+    }
+
+    // Move the chunk to its proper position, this converts from ADT grid to world space, the axises don't line up, so the next two lines might be a bit confusing
+    f32 x = (-static_cast<f32>(chunkPosY) * Terrain::MAP_CHUNK_SIZE) + (Terrain::MAP_SIZE / 2.0f);
+    f32 z = (-static_cast<f32>(chunkPosX) * Terrain::MAP_CHUNK_SIZE) + (Terrain::MAP_SIZE / 2.0f); 
+
+    vec3 chunkPosition = vec3(x, 0.0f, z);
+    const mat4x4 rotationMatrix = glm::rotate(glm::mat4(1.0f), glm::radians(-90.0f), vec3(0.0f, 1.0f, 0.0f));
+    const mat4x4 translationMatrix = glm::translate(glm::mat4(1.0f), chunkPosition);
+    chunkInstance.modelMatrix = translationMatrix * rotationMatrix; // The render layers sort on this, the vertices below get baked into world space with it
 
     // Get the vertices, indices and textureIDs of the chunk
     std::vector<TerrainVertex> chunkVertices;
@@ -530,7 +582,7 @@ void TerrainRenderer::LoadChunk(Terrain::Map& map, u16 chunkPosX, u16 chunkPosY)
             _renderer->LoadTextureIntoArray(textureDesc, _terrainColorTextureArray, diffuseID);
             assert(diffuseID < 65536); // Because of the way we pack diffuseIDs[3] and alphaID, this should never be bigger than a u16, see where we create the alpha texture below
 
-            terrainInstanceData->chunkData->resource[i].diffuseIDs[layerCount++] = diffuseID;
+            chunkData[i].diffuseIDs[layerCount++] = diffuseID;
         }
 
         const u32 cellX = i % Terrain::MAP_CELLS_PER_CHUNK_SIDE;
@@ -554,7 +606,8 @@ void TerrainRenderer::LoadChunk(Terrain::Map& map, u16 chunkPosX, u16 chunkPosY)
                 f32 vertexPosY = cell.heightData[vertex];
                 f32 vertexPosZ = (((static_cast<f32>(row) * 0.5f) / 8.0f) * Terrain::CELL_SIZE) - (Terrain::CELL_SIZE / 2.0f);
 
-                chunkVertices[vertex + cellOffset].position = vec4(vertexPosX + cellPosX, vertexPosY, vertexPosZ + cellPosZ, 0.0f);
+                vec4 worldPosition = chunkInstance.modelMatrix * vec4(vertexPosX + cellPosX, vertexPosY, vertexPosZ + cellPosZ, 1.0f);
+                chunkVertices[vertex + cellOffset].position = vec4(vec3(worldPosition), 0.0f);
 
                 vec2 uv = vec2(static_cast<f32>(vertex % 17), Math::Floor(static_cast<f32>(vertex) / 17.0f));
 
@@ -589,7 +642,7 @@ void TerrainRenderer::LoadChunk(Terrain::Map& map, u16 chunkPosX, u16 chunkPosY)
 
     constexpr u32 numChannels = 4;
     const u32 chunkAlphaMapSize = chunkAlphaMapDesc.width * chunkAlphaMapDesc.height * chunkAlphaMapDesc.layers * numChannels; // 4 channels per pixel, 1 byte per channel
-    chunkAlphaMapDesc.data = new u8[chunkAlphaMapSize]{ 0 }; // Allocate the data needed for it // TODO: Delete this...
+    chunkAlphaMapDesc.data = new u8[chunkAlphaMapSize]{ 0 }; // The renderer takes ownership, it copies the data into its staging ring and deletes it before CreateDataTextureIntoArray returns
 
     const u32 cellAlphaMapSize = 64 * 64; // This is the size of the per-cell alphamap
     for (u32 i = 0; i < Terrain::MAP_CELLS_PER_CHUNK; i++)
@@ -618,39 +671,45 @@ void TerrainRenderer::LoadChunk(Terrain::Map& map, u16 chunkPosX, u16 chunkPosY)
     // [3333] diffuseIDs[2]
     // [AA44] diffuseIDs[3] Alpha is read from the most significant bits, the fourth diffuseID read from the least 
     u32 alphaID;
-    _renderer->CreateDataTextureIntoArray(chunkAlphaMapDesc, _terrainAlphaTextureArray, alphaID);
-    assert(alphaID < 65536); // Because of the way we pack diffuseIDs[3] and alphaID, this should never be bigger than a u16
+    terrainInstanceData->alphaTexture = _renderer->CreateDataTextureIntoArray(chunkAlphaMapDesc, _terrainAlphaTextureArray, alphaID);
+    terrainInstanceData->alphaID = alphaID;
+    assert(alphaID < Terrain::MAX_LOADED_CHUNKS); // terrain.frag and terrainDebug.frag declare terrainAlphaTextures[196], this also keeps it within the u16 we pack it into
 
     // TODO: alphaID is only needed on a per-chunk basis, not per-cell, so it should not be inside of chunkData I believe
     for (u32 i = 0; i < Terrain::MAP_CELLS_PER_CHUNK; i++)
     {
         // This line packs alphaID into the most significant bits of diffuseIDs[3]
-        terrainInstanceData->chunkData->resource[i].diffuseIDs[3] = (alphaID << 16) | terrainInstanceData->chunkData->resource[i].diffuseIDs[3];
+        chunkData[i].diffuseIDs[3] = (alphaID << 16) | chunkData[i].diffuseIDs[3];
     }
 
-    // Move the chunk to its proper position, this converts from ADT grid to world space, the axises don't line up, so the next two lines might be a bit confusing
-    f32 x = (-static_cast<f32>(chunkPosY) * Terrain::MAP_CHUNK_SIZE) + (Terrain::MAP_SIZE / 2.0f);
-    f32 z = (-static_cast<f32>(chunkPosX) * Terrain::MAP_CHUNK_SIZE) + (Terrain::MAP_SIZE / 2.0f); 
-
-    vec3 chunkPosition = vec3(x, 0.0f, z);
-    const mat4x4 rotationMatrix = glm::rotate(glm::mat4(1.0f), glm::radians(-90.0f), vec3(0.0f, 1.0f, 0.0f));
-    const mat4x4 translationMatrix = glm::translate(glm::mat4(1.0f), chunkPosition);
-    chunkInstance.modelMatrix = translationMatrix * rotationMatrix;
-
-    // Create vertex and index (constant) buffers
-    terrainInstanceData->vertexBuffer = _renderer->CreateStorageBuffer<std::array<TerrainVertex, Terrain::NUM_VERTICES_PER_CHUNK>>();
-
-    // Set vertex and index buffers to the vectors we created above
-    memcpy(terrainInstanceData->vertexBuffer->resource.data(), chunkVertices.data(), chunkVertices.size() * sizeof(TerrainVertex));
+    // Sub-allocate the vertices from the shared vertex buffer
+    const size_t vertexDataSize = chunkVertices.size() * sizeof(TerrainVertex);
+    if (!_vertexAllocator.Allocate(vertexDataSize, terrainInstanceData->vertexRange))
+    {
+        NC_LOG_FATAL("Ran out of terrain vertices, more than %u chunks are loaded", Terrain::MAX_LOADED_CHUNKS);
+    }
 
-    // Apply buffers
-    chunkInstance.ApplyAll();
-    terrainInstanceData->vertexBuffer->ApplyAll();
-    terrainInstanceData->chunkData->ApplyAll();
+    // Apply buffers, static buffers share one copy between frames so frame 0 covers all of them
+    _vertexBuffer->ApplyRange(0, terrainInstanceData->vertexRange.offset, chunkVertices.data(), vertexDataSize);
+    _chunkDataBuffer->ApplyRange(0, terrainInstanceData->chunkDataRange.offset, chunkData.data(), sizeof(chunkData));
     
     _chunkModelInstances.push_back(chunkInstance);
 }
 
+void TerrainRenderer::ClearChunks()
+{
+    for (Renderer::InstanceData& chunkInstance : _chunkModelInstances)
+    {
+        TerrainInstanceData* terrainInstanceData = chunkInstance.GetOptional<TerrainInstanceData>();
+        _chunkDataAllocator.Free(terrainInstanceData->chunkDataRange);
+        _vertexAllocator.Free(terrainInstanceData->vertexRange);
+        _renderer->DestroyTexture(terrainInstanceData->alphaTexture); // Frees its slot in the alpha texture array for the next chunk
+
+        delete terrainInstanceData;
+    }
+    _chunkModelInstances.clear();
+}
+
 void TerrainRenderer::LoadChunksAround(Terrain::Map& map, ivec2 middleChunk, u16 drawDistance)
 {
     // Middle position has to be within map grid
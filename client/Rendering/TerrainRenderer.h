@@ -11,6 +11,7 @@
 #include <Renderer/Descriptors/SamplerDesc.h>
 #include <Renderer/ConstantBuffer.h>
 #include <Renderer/StorageBuffer.h>
+#include <Renderer/BufferRangeAllocator.h>
 
 #include "../Gameplay/Map/Chunk.h"
 #include "Renderer/InstanceData.h"
@@ -22,6 +23,8 @@ namespace Terrain
 
     constexpr u32 NUM_VERTICES_PER_CHUNK = Terrain::CELL_TOTAL_GRID_SIZE * Terrain::MAP_CELLS_PER_CHUNK;
     constexpr u32 NUM_INDICES_PER_CHUNK = 768;
+    constexpr u32 MAX_LOADED_CHUNKS = 196; // 7 chunks draw radius, 14x14 chunks, terrain.frag and terrainDebug.frag size terrainAlphaTextures to match
+    constexpr u32 NUM_TERRAIN_LAYERS = 4; // Diffuse layers blended per chunk, fed to terrain.frag as a specialization constant
 }
 
 namespace Renderer
@@ -36,20 +39,23 @@ public:
     TerrainRenderer(Renderer::Renderer* renderer);
 
     void Update(f32 deltaTime);
+    void SortLayers(const vec3& cameraPosition);
 
-    void AddTerrainDepthPrepass(Renderer::RenderGraph* renderGraph, Renderer::ConstantBuffer<ViewConstantBuffer>* viewConstantBuffer, Renderer::DepthImageID depthTarget, u8 frameIndex);
-    void AddTerrainPass(Renderer::RenderGraph* renderGraph, Renderer::ConstantBuffer<ViewConstantBuffer>* viewConstantBuffer, Renderer::ImageID renderTarget, Renderer::DepthImageID depthTarget, u8 frameIndex);
-    void AddTerrainDebugPass(Renderer::RenderGraph* renderGraph, Renderer::ConstantBuffer<ViewConstantBuffer>* viewConstantBuffer, Renderer::ImageID textureIDTarget, Renderer::ImageID alphaMapTarget, Renderer::DepthImageID depthTarget, u8 frameIndex);
+    void AddTerrainDepthPrepass(Renderer::RenderGraph* renderGraph, Renderer::ConstantBuffer<ViewConstantBuffer>* viewConstantBuffer, Renderer::DepthImageID& depthTarget, u8& frameIndex);
+    void AddTerrainPass(Renderer::RenderGraph* renderGraph, Renderer::ConstantBuffer<ViewConstantBuffer>* viewConstantBuffer, Renderer::ImageID renderTarget, Renderer::DepthImageID& depthTarget, u8& frameIndex);
+    void AddTerrainDebugPass(Renderer::RenderGraph* renderGraph, Renderer::ConstantBuffer<ViewConstantBuffer>* viewConstantBuffer, Renderer::ImageID textureIDTarget, Renderer::ImageID alphaMapTarget, Renderer::DepthImageID& depthTarget, u8& frameIndex);
+
+    void LoadChunk(Terrain::Map& map, u16 chunkPosX, u16 chunkPosY);
+    void ClearChunks(); // Stops rendering every loaded chunk and gives back their buffer ranges and alpha texture array slots
 
 private:
     void CreatePermanentResources();
-    void LoadChunk(Terrain::Map& map, u16 chunkPosX, u16 chunkPosY);
     void LoadChunksAround(Terrain::Map& map, ivec2 middleChunk, u16 drawDistance);
 
     struct TerrainVertex
     {
         vec4 position = vec4(0, 0, 0, 0);
-        vec4 texCoord = vec4(0, 0, 0, 0);
+        vec4 texCoord = vec4(0, 0, 0, 0); // xy is the UV
     };
 
     struct TerrainChunkData
@@ -59,8 +65,17 @@ private:
 
     struct TerrainInstanceData
     {
-        Renderer::StorageBuffer<std::array<TerrainVertex, Terrain::NUM_VERTICES_PER_CHUNK>>* vertexBuffer = nullptr;
-        Renderer::ConstantBuffer<std::array<TerrainChunkData, Terrain::MAP_CELLS_PER_CHUNK>>* chunkData = nullptr;
+        Renderer::BufferRange vertexRange;
+        Renderer::BufferRange chunkDataRange;
+        Renderer::TextureID alphaTexture = Renderer::TextureID::Invalid();
+        u32 alphaID = 0; // The alpha texture's slot in _terrainAlphaTextureArray
+    };
+
+    // Pushed before every chunk is drawn, matches PushConstants in terrain.vert
+    struct TerrainDrawConstants
+    {
+        u32 chunkDataIndex = 0; // Where the chunk starts in _chunkDataBuffer, counted in TerrainChunkData
+        u32 vertexOffset = 0; // Where the chunk starts in _vertexBuffer, counted in TerrainVertex
     };
 
 private:
@@ -70,10 +85,26 @@ private:
     std::vector<Renderer::InstanceData> _chunkModelInstances;
 
     Renderer::ConstantBuffer<std::array<u32, Terrain::MAP_CELLS_PER_CHUNK>>* _terrainInstanceIDs = nullptr;
+
+    // Every loaded chunk gets a range of this for its per-cell data, so it can be bound once per pass
+    Renderer::Backend::BufferBackend* _chunkDataBuffer = nullptr;
+    Renderer::BufferRangeAllocator _chunkDataAllocator;
+
+    // Same for the vertices, so we bind them once per pass instead of once per chunk
+    Renderer::Backend::BufferBackend* _vertexBuffer = nullptr;
+    Renderer::BufferRangeAllocator _vertexAllocator;
     
     Renderer::TextureArrayID _terrainColorTextureArray = Renderer::TextureArrayID::Invalid();
     Renderer::TextureArrayID _terrainAlphaTextureArray = Renderer::TextureArrayID::Invalid();
 
     Renderer::SamplerID _alphaSampler;
     Renderer::SamplerID _colorSampler;
+
+    // Created the first time their pass runs after each RenderGraph setup, same as the ClientRenderer pipelines
+    Renderer::GraphicsPipelineID _depthPrepassPipeline = Renderer::GraphicsPipelineID::Invalid();
+    Renderer::GraphicsPipelineID _terrainPipeline = Renderer::GraphicsPipelineID::Invalid();
+    Renderer::GraphicsPipelineID _debugPipeline = Renderer::GraphicsPipelineID::Invalid();
+    u32 _depthPrepassPipelineSetup = 0;
+    u32 _terrainPipelineSetup = 0;
+    u32 _debugPipelineSetup = 0;
 };
\ No newline at end of file
@@ -16,7 +16,6 @@
 #include "../Scripting/Classes/UI/asInputfield.h"
 
 #include <Renderer/Renderer.h>
-#include <Renderer/Renderers/Vulkan/RendererVK.h>
 #include <Renderer/Descriptors/FontDesc.h>
 #include <Window/Window.h>
 #include <InputManager.h>
@@ -80,17 +79,6 @@ void UIRenderer::Update(f32 deltaTime)
                 // (Re)load texture
                 renderable.textureID = ReloadTexture(renderable.texture);
 
-                // Create constant buffer if necessary
-                auto constantBuffer = renderable.constantBuffer;
-                if (constantBuffer == nullptr)
-                {
-                    constantBuffer = _renderer->CreateConstantBuffer<UIRenderable::RenderableConstantBuffer>();
-                    renderable.constantBuffer = constantBuffer;
-                }
-                constantBuffer->resource.color = renderable.color;
-                constantBuffer->Apply(0);
-                constantBuffer->Apply(1);
-
                 renderable.isDirty = false;
             }
 
@@ -148,6 +136,15 @@ void UIRenderer::Update(f32 deltaTime)
             size_t glyphCount = text.models.size();
             if (glyphCount != textLengthWithoutSpaces)
             {
+                // Destroy the glyph models we don't need anymore before dropping their IDs
+                for (size_t i = textLengthWithoutSpaces; i < glyphCount; i++)
+                {
+                    if (text.models[i] != Renderer::ModelID::Invalid())
+                    {
+                        _renderer->DestroyModel(text.models[i]);
+                    }
+                }
+
                 text.models.resize(textLengthWithoutSpaces);
                 for (size_t i = glyphCount; i < textLengthWithoutSpaces; i++)
                 {
@@ -211,23 +208,12 @@ void UIRenderer::Update(f32 deltaTime)
                 glyph++;
             }
 
-            // Create constant buffer if necessary
-            if (text.constantBuffer == nullptr)
-            {
-                text.constantBuffer = _renderer->CreateConstantBuffer<UIText::TextConstantBuffer>();
-            }
-            text.constantBuffer->resource.textColor = text.color;
-            text.constantBuffer->resource.outlineColor = text.outlineColor;
-            text.constantBuffer->resource.outlineWidth = text.outlineWidth;
-            text.constantBuffer->Apply(0);
-            text.constantBuffer->Apply(1);
-
             transform.isDirty = false;
             text.isDirty = false;
         });
 }
 
-void UIRenderer::AddUIPass(Renderer::RenderGraph* renderGraph, Renderer::ImageID renderTarget, u8 frameIndex)
+void UIRenderer::AddUIPass(Renderer::RenderGraph* renderGraph, Renderer::ImageID renderTarget, u8& frameIndex)
 {
     // UI Pass
 
@@ -237,132 +223,151 @@ void UIRenderer::AddUIPass(Renderer::RenderGraph* renderGraph, Renderer::ImageID
     };
 
     renderGraph->AddPass<UIPassData>("UI Pass",
-        [&](UIPassData& data, Renderer::RenderGraphBuilder& builder) // Setup
+        [=](UIPassData& data, Renderer::RenderGraphBuilder& builder) // Setup
         {
             data.renderTarget = builder.Write(renderTarget, Renderer::RenderGraphBuilder::WriteMode::WRITE_MODE_RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::LOAD_MODE_LOAD);
 
             return true; // Return true from setup to enable this pass, return false to disable it
         },
-        [&](UIPassData& data, Renderer::CommandList& commandList) // Execute
+        [=, &frameIndex](UIPassData& data, Renderer::CommandList& commandList) // Execute
         {
-            Renderer::GraphicsPipelineDesc pipelineDesc;
-            renderGraph->InitializePipelineDesc(pipelineDesc);
-
-            // Shaders
-            Renderer::VertexShaderDesc vertexShaderDesc;
-            vertexShaderDesc.path = "Data/shaders/panel.vert.spv";
-            pipelineDesc.states.vertexShader = _renderer->LoadShader(vertexShaderDesc);
-
-            Renderer::PixelShaderDesc pixelShaderDesc;
-            pixelShaderDesc.path = "Data/shaders/panel.frag.spv";
-            pipelineDesc.states.pixelShader = _renderer->LoadShader(pixelShaderDesc);
-
-            // Input layouts TODO: Improve on this, if I set state 0 and 3 it won't work etc... Maybe responsibility for this should be moved to ModelHandler and the cooker?
-            pipelineDesc.states.inputLayouts[0].enabled = true;
-            pipelineDesc.states.inputLayouts[0].SetName("POSITION");
-            pipelineDesc.states.inputLayouts[0].format = Renderer::InputFormat::INPUT_FORMAT_R32G32B32_FLOAT;
-            pipelineDesc.states.inputLayouts[0].inputClassification = Renderer::InputClassification::INPUT_CLASSIFICATION_PER_VERTEX;
-            pipelineDesc.states.inputLayouts[1].enabled = true;
-            pipelineDesc.states.inputLayouts[1].SetName("NORMAL");
-            pipelineDesc.states.inputLayouts[1].format = Renderer::InputFormat::INPUT_FORMAT_R32G32B32_FLOAT;
-            pipelineDesc.states.inputLayouts[1].inputClassification = Renderer::InputClassification::INPUT_CLASSIFICATION_PER_VERTEX;
-            pipelineDesc.states.inputLayouts[2].enabled = true;
-            pipelineDesc.states.inputLayouts[2].SetName("TEXCOORD");
-            pipelineDesc.states.inputLayouts[2].format = Renderer::InputFormat::INPUT_FORMAT_R32G32_FLOAT;
-            pipelineDesc.states.inputLayouts[2].inputClassification = Renderer::InputClassification::INPUT_CLASSIFICATION_PER_VERTEX;
-
-            // Viewport
-            pipelineDesc.states.viewport.topLeftX = 0;
-            pipelineDesc.states.viewport.topLeftY = 0;
-            pipelineDesc.states.viewport.width = static_cast<f32>(WIDTH);
-            pipelineDesc.states.viewport.height = static_cast<f32>(HEIGHT);
-            pipelineDesc.states.viewport.minDepth = 0.0f;
-            pipelineDesc.states.viewport.maxDepth = 1.0f;
-
-            // ScissorRect
-            pipelineDesc.states.scissorRect.left = 0;
-            pipelineDesc.states.scissorRect.right = WIDTH;
-            pipelineDesc.states.scissorRect.top = 0;
-            pipelineDesc.states.scissorRect.bottom = HEIGHT;
-
-            // Rasterizer state
-            pipelineDesc.states.rasterizerState.cullMode = Renderer::CullMode::CULL_MODE_BACK;
-
-            // Samplers TODO: We don't care which samplers we have here, we just need the number of samplers
-            pipelineDesc.states.samplers[0].enabled = true;
-
-            // Textures TODO: We don't care which textures we have here, we just need the number of textures
-            pipelineDesc.textures[0] = Renderer::RenderPassResource(1);
-
-            // Render targets
-            pipelineDesc.renderTargets[0] = data.renderTarget;
-
-            // Blending
-            pipelineDesc.states.blendState.renderTargets[0].blendEnable = true;
-            pipelineDesc.states.blendState.renderTargets[0].srcBlend = Renderer::BlendMode::BLEND_MODE_SRC_ALPHA;
-            pipelineDesc.states.blendState.renderTargets[0].destBlend = Renderer::BlendMode::BLEND_MODE_INV_SRC_ALPHA;
-            pipelineDesc.states.blendState.renderTargets[0].srcBlendAlpha = Renderer::BlendMode::BLEND_MODE_ZERO;
-            pipelineDesc.states.blendState.renderTargets[0].destBlendAlpha = Renderer::BlendMode::BLEND_MODE_ONE;
-
-            // Set pipeline
-            Renderer::GraphicsPipelineID pipeline = _renderer->CreatePipeline(pipelineDesc); // This will compile the pipeline and return the ID, or just return ID of cached pipeline
-            commandList.BeginPipeline(pipeline);
+            if (_uiPipelineSetup != renderGraph->GetSetupCount())
+            {
+                Renderer::GraphicsPipelineDesc pipelineDesc;
+                renderGraph->InitializePipelineDesc(pipelineDesc);
+
+                // Shaders
+                Renderer::VertexShaderDesc vertexShaderDesc;
+                vertexShaderDesc.path = "Data/shaders/ui.vert.spv";
+                pipelineDesc.states.vertexShader = _renderer->LoadShader(vertexShaderDesc);
+
+                Renderer::PixelShaderDesc pixelShaderDesc;
+                pixelShaderDesc.path = "Data/shaders/ui.frag.spv";
+                pipelineDesc.states.pixelShader = _renderer->LoadShader(pixelShaderDesc);
+
+                // Specialization constants
+                pipelineDesc.states.specializationConstants[0].enabled = true; // UI_SHADER_MODE
+                pipelineDesc.states.specializationConstants[0].shaderVisibility = Renderer::ShaderVisibility::SHADER_VISIBILITY_PIXEL;
+                pipelineDesc.states.specializationConstants[0].constantID = 0;
+                pipelineDesc.states.specializationConstants[0].SetValue(UI_SHADER_MODE_PANEL);
+
+                // Input layouts TODO: Improve on this, if I set state 0 and 3 it won't work etc... Maybe responsibility for this should be moved to ModelHandler and the cooker?
+                pipelineDesc.states.inputLayouts[0].enabled = true;
+                pipelineDesc.states.inputLayouts[0].SetName("POSITION");
+                pipelineDesc.states.inputLayouts[0].format = Renderer::InputFormat::INPUT_FORMAT_R32G32B32_FLOAT;
+                pipelineDesc.states.inputLayouts[0].inputClassification = Renderer::InputClassification::INPUT_CLASSIFICATION_PER_VERTEX;
+                pipelineDesc.states.inputLayouts[1].enabled = true;
+                pipelineDesc.states.inputLayouts[1].SetName("NORMAL");
+                pipelineDesc.states.inputLayouts[1].format = Renderer::InputFormat::INPUT_FORMAT_R32G32B32_FLOAT;
+                pipelineDesc.states.inputLayouts[1].inputClassification = Renderer::InputClassification::INPUT_CLASSIFICATION_PER_VERTEX;
+                pipelineDesc.states.inputLayouts[2].enabled = true;
+                pipelineDesc.states.inputLayouts[2].SetName("TEXCOORD");
+                pipelineDesc.states.inputLayouts[2].format = Renderer::InputFormat::INPUT_FORMAT_R32G32_FLOAT;
+                pipelineDesc.states.inputLayouts[2].inputClassification = Renderer::InputClassification::INPUT_CLASSIFICATION_PER_VERTEX;
+
+                // Viewport
+                pipelineDesc.states.viewport.topLeftX = 0;
+                pipelineDesc.states.viewport.topLeftY = 0;
+                pipelineDesc.states.viewport.width = static_cast<f32>(WIDTH);
+                pipelineDesc.states.viewport.height = static_cast<f32>(HEIGHT);
+                pipelineDesc.states.viewport.minDepth = 0.0f;
+                pipelineDesc.states.viewport.maxDepth = 1.0f;
+
+                // ScissorRect
+                pipelineDesc.states.scissorRect.left = 0;
+                pipelineDesc.states.scissorRect.right = WIDTH;
+                pipelineDesc.states.scissorRect.top = 0;
+                pipelineDesc.states.scissorRect.bottom = HEIGHT;
+
+                // Rasterizer state
+                pipelineDesc.states.rasterizerState.cullMode = Renderer::CullMode::CULL_MODE_BACK;
+
+                // Push constants
+                pipelineDesc.states.pushConstantRanges[0].enabled = true; // ui.frag declares the text constants, panels only push their color at the start
+                pipelineDesc.states.pushConstantRanges[0].shaderVisibility = Renderer::ShaderVisibility::SHADER_VISIBILITY_PIXEL;
+                pipelineDesc.states.pushConstantRanges[0].size = sizeof(UIText::TextPushConstants);
+
+                // Samplers TODO: We don't care which samplers we have here, we just need the number of samplers
+                pipelineDesc.states.samplers[0].enabled = true;
+
+                // Textures TODO: We don't care which textures we have here, we just need the number of textures
+                pipelineDesc.textures[0] = Renderer::RenderPassResource(1);
+
+                // Render targets
+                pipelineDesc.renderTargets[0] = data.renderTarget;
+
+                // Blending
+                pipelineDesc.states.blendState.renderTargets[0].blendEnable = true;
+                pipelineDesc.states.blendState.renderTargets[0].srcBlend = Renderer::BlendMode::BLEND_MODE_SRC_ALPHA;
+                pipelineDesc.states.blendState.renderTargets[0].destBlend = Renderer::BlendMode::BLEND_MODE_INV_SRC_ALPHA;
+                pipelineDesc.states.blendState.renderTargets[0].srcBlendAlpha = Renderer::BlendMode::BLEND_MODE_ZERO;
+                pipelineDesc.states.blendState.renderTargets[0].destBlendAlpha = Renderer::BlendMode::BLEND_MODE_ONE;
+
+                // Set pipeline
+                _panelPipeline = _renderer->CreatePipeline(pipelineDesc);
+                _uiPipelineSetup = renderGraph->GetSetupCount();
+
+                // Text uses the same pipeline state and shaders, only the specialization differs
+                pipelineDesc.states.specializationConstants[0].SetValue(UI_SHADER_MODE_TEXT);
+
+                _textPipeline = _renderer->CreatePipeline(pipelineDesc);
+            }
+
+            commandList.BeginPipeline(_panelPipeline);
 
             // Draw all the panels
             entt::registry* registry = ServiceLocator::GetUIRegistry();
             auto renderableView = registry->view<UITransform, UIRenderable>();
-            renderableView.each([this, &commandList, frameIndex](const auto, UITransform& transform, UIRenderable& renderable)
+            renderableView.each([this, &commandList](const auto, UITransform& transform, UIRenderable& renderable)
                 {
-                    if (!renderable.constantBuffer)
+                    if (renderable.textureID == Renderer::TextureID::Invalid())
                         return;
 
                     commandList.PushMarker("Renderable", Color(0.0f, 0.1f, 0.0f));
 
-                    // Set constant buffer
-                    commandList.SetConstantBuffer(0, renderable.constantBuffer->GetDescriptor(frameIndex), frameIndex);
+                    // Push color
+                    UIRenderable::RenderablePushConstants pushConstants;
+                    pushConstants.color = renderable.color;
+                    commandList.PushConstant(&pushConstants, 0, sizeof(pushConstants));
 
                     // Set Sampler and texture.
-                    commandList.SetSampler(1, _linearSampler);
-                    commandList.SetTexture(2, renderable.textureID);
+                    commandList.SetSampler(0, _linearSampler);
+                    commandList.SetTexture(1, renderable.textureID);
 
                     // Draw
                     commandList.Draw(renderable.modelID);
 
                     commandList.PopMarker();
                 });
-            commandList.EndPipeline(pipeline);
+            commandList.EndPipeline(_panelPipeline);
 
             // Draw text
-            vertexShaderDesc.path = "Data/shaders/text.vert.spv";
-            pipelineDesc.states.vertexShader = _renderer->LoadShader(vertexShaderDesc);
-
-            pixelShaderDesc.path = "Data/shaders/text.frag.spv";
-            pipelineDesc.states.pixelShader = _renderer->LoadShader(pixelShaderDesc);
-
-            // Set pipeline
-            pipeline = _renderer->CreatePipeline(pipelineDesc); // This will compile the pipeline and return the ID, or just return ID of cached pipeline
-            commandList.BeginPipeline(pipeline);
+            commandList.BeginPipeline(_textPipeline);
 
             auto textView = registry->view<UITransform, UIText>();
-            textView.each([this, &commandList, frameIndex](const auto, UITransform& transform, UIText& text)
+            textView.each([this, &commandList](const auto, UITransform& transform, UIText& text)
                 {
-                    if (!text.constantBuffer)
+                    if (text.models.empty())
                         return;
 
                     commandList.PushMarker("Text", Color(0.0f, 0.1f, 0.0f));
 
-                    // Set constant buffer
-                    commandList.SetConstantBuffer(0, text.constantBuffer->GetDescriptor(frameIndex), frameIndex);
+                    // Push colors
+                    UIText::TextPushConstants pushConstants;
+                    pushConstants.textColor = text.color;
+                    pushConstants.outlineColor = text.outlineColor;
+                    pushConstants.outlineWidth = text.outlineWidth;
+                    commandList.PushConstant(&pushConstants, 0, sizeof(pushConstants));
 
                     // Set sampler
-                    commandList.SetSampler(1, _linearSampler);
+                    commandList.SetSampler(0, _linearSampler);
 
                     // Each glyph in the label has it's own plane and texture, this could be optimized in the future.
                     size_t glyphs = text.models.size();
                     for (u32 i = 0; i < glyphs; i++)
                     {
                         // Set texture
-                        commandList.SetTexture(2, text.textures[i]);
+                        commandList.SetTexture(1, text.textures[i]);
 
                         // Draw
                         commandList.Draw(text.models[i]);
@@ -371,7 +376,7 @@ void UIRenderer::AddUIPass(Renderer::RenderGraph* renderGraph, Renderer::ImageID
                     commandList.PopMarker();
                 });
 
-            commandList.EndPipeline(pipeline);
+            commandList.EndPipeline(_textPipeline);
         });
 }
 
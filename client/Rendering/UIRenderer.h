@@ -23,7 +23,7 @@ public:
     void InitRegistry();
 
     void Update(f32 deltaTime);
-    void AddUIPass(Renderer::RenderGraph* renderGraph, Renderer::ImageID renderTarget, u8 frameIndex);
+    void AddUIPass(Renderer::RenderGraph* renderGraph, Renderer::ImageID renderTarget, u8& frameIndex);
     bool OnMouseClick(Window* window, std::shared_ptr<Keybind> keybind);
     void OnMousePositionUpdate(Window* window, f32 x, f32 y);
     bool OnKeyboardInput(Window* window, i32 key, i32 actionMask, i32 modifierMask);
@@ -37,9 +37,18 @@ private:
     void CalculateVertices(const vec3& pos, const vec2& size, std::vector<Renderer::Vertex>& vertices);
 
 private:
+    // Fed to ui.frag as a specialization constant, picks between drawing panels and text
+    static constexpr u32 UI_SHADER_MODE_PANEL = 0;
+    static constexpr u32 UI_SHADER_MODE_TEXT = 1;
+
     Renderer::Renderer* _renderer;
 
     Renderer::SamplerID _linearSampler;
 
+    // Created the first time the UI pass runs after each RenderGraph setup, same as the ClientRenderer pipelines
+    Renderer::GraphicsPipelineID _panelPipeline = Renderer::GraphicsPipelineID::Invalid();
+    Renderer::GraphicsPipelineID _textPipeline = Renderer::GraphicsPipelineID::Invalid();
+    u32 _uiPipelineSetup = 0; // Both pipelines render into the same target, so they share this
+
     entt::entity _focusedWidget;
 };
\ No newline at end of file
@@ -20,3 +20,15 @@ Model& EntityUtils::CreateModelComponent(entt::registry& registry, entt::entity&
 
     return model;
 }
+
+void EntityUtils::DestroyModelComponent(entt::registry& registry, entt::entity& entity)
+{
+    Renderer::Renderer* renderer = ServiceLocator::GetRenderer();
+
+    Model& model = registry.get<Model>(entity);
+    renderer->DestroyModel(model.modelId);
+    model.instanceData.Free();
+
+    registry.remove<Model>(entity);
+    registry.remove_if_exists<VisibleModel>(entity);
+}
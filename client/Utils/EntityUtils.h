@@ -7,4 +7,7 @@ namespace EntityUtils
 {
     // This function modifies the registry thus it should only be called from the main thread (entt:registry is not thread-safe)
     Model& CreateModelComponent(entt::registry& registry, entt::entity& entity, std::string modelPath);
+
+    // Destroys the model and frees its instance before removing the component, same threading rules as above
+    void DestroyModelComponent(entt::registry& registry, entt::entity& entity);
 }
\ No newline at end of file
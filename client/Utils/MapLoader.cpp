@@ -83,6 +83,11 @@ bool MapLoader::ExtractChunkData(FileReader& reader, Terrain::Chunk& chunk, Stri
     Bytebuffer buffer(nullptr, reader.Length());
     reader.Read(buffer, buffer.size);
 
+    return ExtractChunkData(buffer, chunk, stringTable);
+}
+
+bool MapLoader::ExtractChunkData(Bytebuffer& buffer, Terrain::Chunk& chunk, StringTable& stringTable)
+{
     buffer.Get<Terrain::ChunkHeader>(chunk.chunkHeader);
     buffer.Get<Terrain::HeightHeader>(chunk.heightHeader);
     buffer.Get<Terrain::HeightBox>(chunk.heightBox);
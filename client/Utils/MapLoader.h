@@ -29,6 +29,7 @@
 
 //#include "../Gameplay/Map/Map.h"
 
+class Bytebuffer;
 class StringTable;
 namespace Terrain
 {
@@ -40,6 +41,7 @@ class MapLoader
 public:
     MapLoader() {}
     static bool Load(entt::registry& registry);
+    static bool ExtractChunkData(Bytebuffer& buffer, Terrain::Chunk& chunk, StringTable& stringTable);
 
 private:
     static bool ExtractChunkData(FileReader& reader, Terrain::Chunk& chunk, StringTable& stringTable);
@@ -9,18 +9,29 @@
 #include <Windows.h>
 #endif
 #include <future>
+#include <cstring>
 
 //The name of the console window.
 #define WINDOWNAME "Client"
 
-i32 main()
+i32 main(i32 argc, char* argv[])
 {
     /* Set up console window title */
 #ifdef _WIN32 //Windows
     SetConsoleTitle(WINDOWNAME);
 #endif
 
-    EngineLoop engineLoop;
+    // --headless runs without a window on the null renderer, so the client can run on machines without a GPU
+    bool headless = false;
+    for (i32 i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--headless") == 0)
+        {
+            headless = true;
+        }
+    }
+
+    EngineLoop engineLoop(headless);
     engineLoop.Start();
 
     ConsoleCommandHandler consoleCommandHandler;
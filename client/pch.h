@@ -2,7 +2,6 @@
 #include <filesystem>
 #include <NovusTypes.h>
 #include <vector>
-#include <vulkan/vulkan.h>
 #include <memory>
 #include <fstream>
 #include <iostream>
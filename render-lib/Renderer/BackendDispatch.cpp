@@ -2,9 +2,13 @@
 #include "Renderer.h"
 
 #include "Commands/Clear.h"
+#include "Commands/ImageBarrier.h"
+#include "Commands/BufferBarrier.h"
 #include "Commands/Draw.h"
 #include "Commands/DrawBindless.h"
 #include "Commands/DrawIndexedBindless.h"
+#include "Commands/DrawIndirect.h"
+#include "Commands/DrawIndexedIndirect.h"
 #include "Commands/PopMarker.h"
 #include "Commands/PushMarker.h"
 #include "Commands/SetPipeline.h"
@@ -15,6 +19,9 @@
 #include "Commands/SetVertexBuffer.h"
 #include "Commands/SetIndexBuffer.h"
 #include "Commands/SetBuffer.h"
+#include "Commands/PushConstant.h"
+#include "Commands/SetStorageImage.h"
+#include "Commands/Dispatch.h"
 
 namespace Renderer
 {
@@ -29,10 +36,27 @@ namespace Renderer
         renderer->Clear(commandList, actualData->image, actualData->flags, actualData->depth, actualData->stencil);
     }
 
+    void BackendDispatch::ImageBarrier(Renderer* renderer, CommandListID commandList, const void* data)
+    {
+        const Commands::ImageBarrier* actualData = static_cast<const Commands::ImageBarrier*>(data);
+        renderer->ImageBarrier(commandList, actualData->image, actualData->srcAccess, actualData->dstAccess);
+    }
+    void BackendDispatch::DepthImageBarrier(Renderer* renderer, CommandListID commandList, const void* data)
+    {
+        const Commands::DepthImageBarrier* actualData = static_cast<const Commands::DepthImageBarrier*>(data);
+        renderer->ImageBarrier(commandList, actualData->image, actualData->srcAccess, actualData->dstAccess);
+    }
+
+    void BackendDispatch::BufferBarrier(Renderer* renderer, CommandListID commandList, const void* data)
+    {
+        const Commands::BufferBarrier* actualData = static_cast<const Commands::BufferBarrier*>(data);
+        renderer->BufferBarrier(commandList, actualData->buffer, actualData->srcAccess, actualData->dstAccess);
+    }
+
     void BackendDispatch::Draw(Renderer* renderer, CommandListID commandList, const void* data)
     {
         const Commands::Draw* actualData = static_cast<const Commands::Draw*>(data);
-        renderer->Draw(commandList, actualData->model);
+        renderer->Draw(commandList, actualData->model, actualData->baseInstance, actualData->numInstances);
     }
 
     void BackendDispatch::DrawBindless(Renderer * renderer, CommandListID commandList, const void* data)
@@ -47,6 +71,42 @@ namespace Renderer
         renderer->DrawIndexedBindless(commandList, actualData->modelID, actualData->numVertices, actualData->numInstances);
     }
 
+    void BackendDispatch::DrawIndirect(Renderer* renderer, CommandListID commandList, const void* data)
+    {
+        const Commands::DrawIndirect* actualData = static_cast<const Commands::DrawIndirect*>(data);
+        renderer->DrawIndirect(commandList, actualData->argumentBuffer, actualData->argumentBufferOffset, actualData->drawCount);
+    }
+
+    void BackendDispatch::DrawIndirectCount(Renderer* renderer, CommandListID commandList, const void* data)
+    {
+        const Commands::DrawIndirectCount* actualData = static_cast<const Commands::DrawIndirectCount*>(data);
+        renderer->DrawIndirectCount(commandList, actualData->argumentBuffer, actualData->argumentBufferOffset, actualData->drawCountBuffer, actualData->drawCountBufferOffset, actualData->maxDrawCount);
+    }
+
+    void BackendDispatch::DrawIndexedIndirect(Renderer* renderer, CommandListID commandList, const void* data)
+    {
+        const Commands::DrawIndexedIndirect* actualData = static_cast<const Commands::DrawIndexedIndirect*>(data);
+        renderer->DrawIndexedIndirect(commandList, actualData->modelID, actualData->argumentBuffer, actualData->argumentBufferOffset, actualData->drawCount);
+    }
+
+    void BackendDispatch::DrawIndexedIndirectCount(Renderer* renderer, CommandListID commandList, const void* data)
+    {
+        const Commands::DrawIndexedIndirectCount* actualData = static_cast<const Commands::DrawIndexedIndirectCount*>(data);
+        renderer->DrawIndexedIndirectCount(commandList, actualData->modelID, actualData->argumentBuffer, actualData->argumentBufferOffset, actualData->drawCountBuffer, actualData->drawCountBufferOffset, actualData->maxDrawCount);
+    }
+
+    void BackendDispatch::Dispatch(Renderer* renderer, CommandListID commandList, const void* data)
+    {
+        const Commands::Dispatch* actualData = static_cast<const Commands::Dispatch*>(data);
+        renderer->Dispatch(commandList, actualData->threadGroupCountX, actualData->threadGroupCountY, actualData->threadGroupCountZ);
+    }
+
+    void BackendDispatch::DispatchIndirect(Renderer* renderer, CommandListID commandList, const void* data)
+    {
+        const Commands::DispatchIndirect* actualData = static_cast<const Commands::DispatchIndirect*>(data);
+        renderer->DispatchIndirect(commandList, actualData->argumentBuffer, actualData->argumentBufferOffset);
+    }
+
     void BackendDispatch::PopMarker(Renderer* renderer, CommandListID commandList, const void* /*data*/)
     {
         renderer->PopMarker(commandList);
@@ -118,6 +178,12 @@ namespace Renderer
         renderer->SetTextureArray(commandList, actualData->slot, actualData->textureArray);
     }
 
+    void BackendDispatch::SetStorageImage(Renderer* renderer, CommandListID commandList, const void* data)
+    {
+        const Commands::SetStorageImage* actualData = static_cast<const Commands::SetStorageImage*>(data);
+        renderer->SetStorageImage(commandList, actualData->slot, actualData->image);
+    }
+
     void BackendDispatch::SetVertexBuffer(Renderer* renderer, CommandListID commandList, const void* data)
     {
         const Commands::SetVertexBuffer* actualData = static_cast<const Commands::SetVertexBuffer*>(data);
@@ -135,4 +201,10 @@ namespace Renderer
         const Commands::SetBuffer* actualData = static_cast<const Commands::SetBuffer*>(data);
         renderer->SetBuffer(commandList, actualData->slot, actualData->buffer);
     }
+
+    void BackendDispatch::PushConstant(Renderer* renderer, CommandListID commandList, const void* data)
+    {
+        const Commands::PushConstant* actualData = static_cast<const Commands::PushConstant*>(data);
+        renderer->PushConstant(commandList, actualData->data, actualData->offset, actualData->size);
+    }
 }
\ No newline at end of file
@@ -13,9 +13,19 @@ namespace Renderer
         static void ClearImage(Renderer* renderer, CommandListID commandList, const void* data);
         static void ClearDepthImage(Renderer* renderer, CommandListID commandList, const void* data);
 
+        static void ImageBarrier(Renderer* renderer, CommandListID commandList, const void* data);
+        static void DepthImageBarrier(Renderer* renderer, CommandListID commandList, const void* data);
+        static void BufferBarrier(Renderer* renderer, CommandListID commandList, const void* data);
+
         static void Draw(Renderer* renderer, CommandListID commandList, const void* data);
         static void DrawBindless(Renderer* renderer, CommandListID commandList, const void* data);
         static void DrawIndexedBindless(Renderer* renderer, CommandListID commandList, const void* data);
+        static void DrawIndirect(Renderer* renderer, CommandListID commandList, const void* data);
+        static void DrawIndirectCount(Renderer* renderer, CommandListID commandList, const void* data);
+        static void DrawIndexedIndirect(Renderer* renderer, CommandListID commandList, const void* data);
+        static void DrawIndexedIndirectCount(Renderer* renderer, CommandListID commandList, const void* data);
+        static void Dispatch(Renderer* renderer, CommandListID commandList, const void* data);
+        static void DispatchIndirect(Renderer* renderer, CommandListID commandList, const void* data);
 
         static void PopMarker(Renderer* renderer, CommandListID commandList, const void* data);
         static void PushMarker(Renderer* renderer, CommandListID commandList, const void* data);
@@ -32,8 +42,10 @@ namespace Renderer
         static void SetSampler(Renderer* renderer, CommandListID commandList, const void* data);
         static void SetTexture(Renderer* renderer, CommandListID commandList, const void* data);
         static void SetTextureArray(Renderer* renderer, CommandListID commandList, const void* data);
+        static void SetStorageImage(Renderer* renderer, CommandListID commandList, const void* data);
         static void SetVertexBuffer(Renderer* renderer, CommandListID commandList, const void* data);
         static void SetIndexBuffer(Renderer* renderer, CommandListID commandList, const void* data);
         static void SetBuffer(Renderer* renderer, CommandListID commandList, const void* data);
+        static void PushConstant(Renderer* renderer, CommandListID commandList, const void* data);
     };
 }
\ No newline at end of file
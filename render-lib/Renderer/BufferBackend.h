@@ -12,10 +12,21 @@ namespace Renderer
                 TYPE_STORAGE_BUFFER
             };
 
+            enum Usage
+            {
+                USAGE_DYNAMIC, // One host visible copy per frame, for data that gets written while frames are in flight
+                USAGE_STATIC // One device local copy that every frame shares, uploaded through a staging buffer, for data that doesn't change after loading
+            };
+
             virtual ~BufferBackend() {}
             virtual void Apply(u32 frameIndex, void* data, size_t size) = 0;
+            virtual void ApplyRange(u32 frameIndex, size_t offset, void* data, size_t size) = 0; // Writes size bytes starting at offset, the rest of the buffer is untouched
             virtual void* GetDescriptor(u32 frameIndex) = 0;
             virtual void* GetBuffer(u32 frameIndex) = 0;
+
+            // Buffers stay mapped for their whole lifetime, data can be written in place and then flushed for the range that changed
+            virtual void* GetMappedData(u32 frameIndex) = 0;
+            virtual void Flush(u32 frameIndex, size_t offset, size_t size) = 0;
         };
     }
 }
\ No newline at end of file
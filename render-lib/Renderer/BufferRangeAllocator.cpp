@@ -0,0 +1,92 @@
+#include "BufferRangeAllocator.h"
+#include <cassert>
+
+namespace Renderer
+{
+    void BufferRangeAllocator::Init(size_t size, size_t alignment)
+    {
+        assert(alignment > 0 && (alignment & (alignment - 1)) == 0); // Alignment needs to be a power of two
+
+        _size = size;
+        _alignment = alignment;
+        Reset();
+    }
+
+    bool BufferRangeAllocator::Allocate(size_t size, BufferRange& range)
+    {
+        assert(size > 0);
+        size_t alignedSize = (size + _alignment - 1) & ~(_alignment - 1);
+
+        // Every free range starts aligned since we only ever hand out aligned sizes, so the first one that fits is good
+        for (size_t i = 0; i < _freeRanges.size(); i++)
+        {
+            BufferRange& freeRange = _freeRanges[i];
+            if (freeRange.size < alignedSize)
+                continue;
+
+            range.offset = freeRange.offset;
+            range.size = alignedSize;
+
+            freeRange.offset += alignedSize;
+            freeRange.size -= alignedSize;
+
+            if (freeRange.size == 0)
+            {
+                _freeRanges.erase(_freeRanges.begin() + i);
+            }
+
+            _allocatedSize += alignedSize;
+            return true;
+        }
+
+        return false;
+    }
+
+    void BufferRangeAllocator::Free(const BufferRange& range)
+    {
+        assert(range.offset + range.size <= _size);
+        assert(range.size <= _allocatedSize); // Freeing something that was never allocated
+
+        // Find the first free range after this one
+        size_t insertIndex = 0;
+        while (insertIndex < _freeRanges.size() && _freeRanges[insertIndex].offset < range.offset)
+        {
+            insertIndex++;
+        }
+
+        bool mergesWithPrevious = insertIndex > 0 && (_freeRanges[insertIndex - 1].offset + _freeRanges[insertIndex - 1].size) == range.offset;
+        bool mergesWithNext = insertIndex < _freeRanges.size() && (range.offset + range.size) == _freeRanges[insertIndex].offset;
+
+        if (mergesWithPrevious && mergesWithNext)
+        {
+            _freeRanges[insertIndex - 1].size += range.size + _freeRanges[insertIndex].size;
+            _freeRanges.erase(_freeRanges.begin() + insertIndex);
+        }
+        else if (mergesWithPrevious)
+        {
+            _freeRanges[insertIndex - 1].size += range.size;
+        }
+        else if (mergesWithNext)
+        {
+            _freeRanges[insertIndex].offset = range.offset;
+            _freeRanges[insertIndex].size += range.size;
+        }
+        else
+        {
+            _freeRanges.insert(_freeRanges.begin() + insertIndex, range);
+        }
+
+        _allocatedSize -= range.size;
+    }
+
+    void BufferRangeAllocator::Reset()
+    {
+        _freeRanges.clear();
+
+        BufferRange& wholeBuffer = _freeRanges.emplace_back();
+        wholeBuffer.offset = 0;
+        wholeBuffer.size = _size;
+
+        _allocatedSize = 0;
+    }
+}
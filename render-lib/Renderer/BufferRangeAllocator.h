@@ -0,0 +1,33 @@
+#pragma once
+#include <NovusTypes.h>
+#include <vector>
+
+namespace Renderer
+{
+    struct BufferRange
+    {
+        size_t offset = 0;
+        size_t size = 0;
+    };
+
+    // Hands out ranges of one big buffer so we don't need an allocation per tiny buffer, it only tracks offsets and never touches the buffer itself
+    // Allocating first-fit from the free list and never calling Free makes it a linear allocator, Reset drops every range at once
+    class BufferRangeAllocator
+    {
+    public:
+        void Init(size_t size, size_t alignment = 16);
+
+        bool Allocate(size_t size, BufferRange& range); // Returns false if there is no free range big enough
+        void Free(const BufferRange& range);
+        void Reset();
+
+        size_t GetSize() { return _size; }
+        size_t GetAllocatedSize() { return _allocatedSize; }
+
+    private:
+        std::vector<BufferRange> _freeRanges; // Sorted by offset and never touching, Free merges neighbours
+        size_t _size = 0;
+        size_t _alignment = 16;
+        size_t _allocatedSize = 0;
+    };
+}
@@ -1,22 +1,92 @@
 #pragma once
 #include "CommandList.h"
 #include "Renderer.h"
+#include <Utils/DebugHandler.h>
+#include <cstring>
 
 namespace Renderer
 {
     void CommandList::Execute()
     {
-        assert(_markerScope == 0); // We need to pop all markers that we push
-
         CommandListID commandList = _renderer->BeginCommandList();
+        Record(commandList);
+        _renderer->EndCommandList(commandList);
+    }
+
+    void CommandList::Record(CommandListID commandListID)
+    {
+        assert(_markerScope == 0); // We need to pop all markers that we push
 
         // Execute each command
-        for (int i = 0; i < _functions.Count(); i++)
+        for (CommandBlock* block = _firstBlock; block != nullptr; block = block->next)
         {
-            _functions[i](_renderer, commandList, _data[i]);
+            size_t offset = 0;
+            while (offset < block->used)
+            {
+                const CommandHeader* header = reinterpret_cast<const CommandHeader*>(&block->data[offset]);
+                header->function(_renderer, commandListID, &block->data[offset + COMMAND_HEADER_SIZE]);
+
+                offset += header->size;
+            }
         }
+    }
 
-        _renderer->EndCommandList(commandList);
+    u8* CommandList::AllocateCommandMemory(size_t size)
+    {
+        assert(_allocator != nullptr);
+        assert(size <= COMMAND_BLOCK_SIZE); // This command is too big to ever fit in a block
+
+        if (_lastBlock == nullptr || _lastBlock->used + size > COMMAND_BLOCK_SIZE)
+        {
+            if (GetUsedMemory() + COMMAND_BLOCK_STRIDE > _allocatorSize)
+            {
+                NC_LOG_FATAL("CommandList ran out of memory after %zu command blocks (%zu bytes), raise RenderGraphDesc::passAllocatorSize", _numBlocks, _allocatorSize);
+            }
+
+            CommandBlock* block = Memory::Allocator::New<CommandBlock>(_allocator);
+            _numBlocks++;
+            if (_lastBlock == nullptr)
+            {
+                _firstBlock = block;
+            }
+            else
+            {
+                _lastBlock->next = block;
+            }
+            _lastBlock = block;
+        }
+
+        u8* memory = &_lastBlock->data[_lastBlock->used];
+        _lastBlock->used += size;
+
+        return memory;
+    }
+
+    void CommandList::ResetBoundState()
+    {
+        for (u32 i = 0; i < MAX_TRACKED_SLOTS; i++)
+        {
+            _boundDescriptorSlots[i] = BoundSlot();
+            _boundVertexBufferSlots[i] = BoundSlot();
+        }
+        _boundIndexBuffer = ModelID::Invalid();
+        _hasScissorRect = false;
+        _hasViewport = false;
+    }
+
+    bool CommandList::BindSlot(BoundSlot* slots, u32 slot, BindingType type, u64 value, u64 extra)
+    {
+        if (slot >= MAX_TRACKED_SLOTS)
+            return true;
+
+        BoundSlot& boundSlot = slots[slot];
+        if (boundSlot.type == type && boundSlot.value == value && boundSlot.extra == extra)
+            return false;
+
+        boundSlot.type = type;
+        boundSlot.value = value;
+        boundSlot.extra = extra;
+        return true;
     }
 
     void CommandList::PushMarker(std::string marker, Color color)
@@ -39,27 +109,46 @@ namespace Renderer
 
     void CommandList::BeginPipeline(GraphicsPipelineID pipelineID)
     {
+        ResetBoundState(); // Binding a new pipeline might invalidate what was bound before
         Commands::BeginGraphicsPipeline* command = AddCommand<Commands::BeginGraphicsPipeline>();
         command->pipeline = pipelineID;
     }
 
     void CommandList::EndPipeline(GraphicsPipelineID pipelineID)
     {
+        ResetBoundState();
         Commands::EndGraphicsPipeline* command = AddCommand<Commands::EndGraphicsPipeline>();
         command->pipeline = pipelineID;
     }
 
+    void CommandList::SetPipeline(ComputePipelineID pipelineID)
+    {
+        assert(pipelineID != ComputePipelineID::Invalid());
+        ResetBoundState(); // Compute has its own bind point, nothing bound for graphics carries over
+        Commands::SetComputePipeline* command = AddCommand<Commands::SetComputePipeline>();
+        command->pipeline = pipelineID;
+    }
+
     void CommandList::SetScissorRect(u32 left, u32 right, u32 top, u32 bottom)
     {
+        if (_hasScissorRect && _boundScissorRect.left == static_cast<i32>(left) && _boundScissorRect.right == static_cast<i32>(right) && _boundScissorRect.top == static_cast<i32>(top) && _boundScissorRect.bottom == static_cast<i32>(bottom))
+            return;
+
         Commands::SetScissorRect* command = AddCommand<Commands::SetScissorRect>();
         command->scissorRect.left = left;
         command->scissorRect.right = right;
         command->scissorRect.top = top;
         command->scissorRect.bottom = bottom;
+
+        _hasScissorRect = true;
+        _boundScissorRect = command->scissorRect;
     }
 
     void CommandList::SetViewport(f32 topLeftX, f32 topLeftY, f32 width, f32 height, f32 minDepth, f32 maxDepth)
     {
+        if (_hasViewport && _boundViewport.topLeftX == topLeftX && _boundViewport.topLeftY == topLeftY && _boundViewport.width == width && _boundViewport.height == height && _boundViewport.minDepth == minDepth && _boundViewport.maxDepth == maxDepth)
+            return;
+
         Commands::SetViewport* command = AddCommand<Commands::SetViewport>();
         command->viewport.topLeftX = topLeftX;
         command->viewport.topLeftY = topLeftY;
@@ -67,10 +156,16 @@ namespace Renderer
         command->viewport.height = height;
         command->viewport.minDepth = minDepth;
         command->viewport.maxDepth = maxDepth;
+
+        _hasViewport = true;
+        _boundViewport = command->viewport;
     }
 
     void CommandList::SetConstantBuffer(u32 slot, void* descriptor, size_t frameIndex)
     {
+        if (!BindSlot(_boundDescriptorSlots, slot, BINDING_TYPE_CONSTANT_BUFFER, reinterpret_cast<u64>(descriptor), frameIndex))
+            return;
+
         Commands::SetConstantBuffer* command = AddCommand<Commands::SetConstantBuffer>();
         command->slot = slot;
         command->descriptor = descriptor;
@@ -79,6 +174,9 @@ namespace Renderer
 
     void CommandList::SetStorageBuffer(u32 slot, void* descriptor, size_t frameIndex)
     {
+        if (!BindSlot(_boundDescriptorSlots, slot, BINDING_TYPE_STORAGE_BUFFER, reinterpret_cast<u64>(descriptor), frameIndex))
+            return;
+
         Commands::SetStorageBuffer* command = AddCommand<Commands::SetStorageBuffer>();
         command->slot = slot;
         command->descriptor = descriptor;
@@ -87,6 +185,10 @@ namespace Renderer
 
     void CommandList::SetSampler(u32 slot, SamplerID sampler)
     {
+        using type = type_safe::underlying_type<SamplerID>;
+        if (!BindSlot(_boundDescriptorSlots, slot, BINDING_TYPE_SAMPLER, static_cast<type>(sampler)))
+            return;
+
         Commands::SetSampler* command = AddCommand<Commands::SetSampler>();
         command->slot = slot;
         command->sampler = sampler;
@@ -94,6 +196,10 @@ namespace Renderer
 
     void CommandList::SetTexture(u32 slot, TextureID texture)
     {
+        using type = type_safe::underlying_type<TextureID>;
+        if (!BindSlot(_boundDescriptorSlots, slot, BINDING_TYPE_TEXTURE, static_cast<type>(texture)))
+            return;
+
         Commands::SetTexture* command = AddCommand<Commands::SetTexture>();
         command->slot = slot;
         command->texture = texture;
@@ -101,13 +207,32 @@ namespace Renderer
 
     void CommandList::SetTextureArray(u32 slot, TextureArrayID textureArray)
     {
+        using type = type_safe::underlying_type<TextureArrayID>;
+        if (!BindSlot(_boundDescriptorSlots, slot, BINDING_TYPE_TEXTURE_ARRAY, static_cast<type>(textureArray)))
+            return;
+
         Commands::SetTextureArray* command = AddCommand<Commands::SetTextureArray>();
         command->slot = slot;
         command->textureArray = textureArray;
     }
 
+    void CommandList::SetStorageImage(u32 slot, ImageID image)
+    {
+        using type = type_safe::underlying_type<ImageID>;
+        if (!BindSlot(_boundDescriptorSlots, slot, BINDING_TYPE_STORAGE_IMAGE, static_cast<type>(image)))
+            return;
+
+        Commands::SetStorageImage* command = AddCommand<Commands::SetStorageImage>();
+        command->slot = slot;
+        command->image = image;
+    }
+
     void CommandList::SetVertexBuffer(u32 slot, ModelID model)
     {
+        using type = type_safe::underlying_type<ModelID>;
+        if (!BindSlot(_boundVertexBufferSlots, slot, BINDING_TYPE_VERTEX_BUFFER, static_cast<type>(model)))
+            return;
+
         Commands::SetVertexBuffer* command = AddCommand<Commands::SetVertexBuffer>();
         command->slot = slot;
         command->modelID = model;
@@ -115,17 +240,36 @@ namespace Renderer
 
     void CommandList::SetIndexBuffer(ModelID model)
     {
+        if (_boundIndexBuffer == model)
+            return;
+        _boundIndexBuffer = model;
+
         Commands::SetIndexBuffer* command = AddCommand<Commands::SetIndexBuffer>();
         command->modelID = model;
     }
 
     void CommandList::SetBuffer(u32 slot, void* buffer)
     {
+        if (!BindSlot(_boundVertexBufferSlots, slot, BINDING_TYPE_BUFFER, reinterpret_cast<u64>(buffer)))
+            return;
+
         Commands::SetBuffer* command = AddCommand<Commands::SetBuffer>();
         command->slot = slot;
         command->buffer = buffer;
     }
 
+    void CommandList::PushConstant(void* data, u32 offset, u32 size)
+    {
+        assert(data != nullptr);
+        assert(size > 0 && offset + size <= MAX_PUSH_CONSTANT_SIZE); // Push constants are limited to MAX_PUSH_CONSTANT_SIZE bytes
+        assert((offset % 4) == 0 && (size % 4) == 0); // Vulkan requires push constant offsets and sizes to be multiples of 4
+
+        Commands::PushConstant* command = AddCommand<Commands::PushConstant>();
+        command->offset = offset;
+        command->size = size;
+        memcpy(command->data, data, size);
+    }
+
     void CommandList::Clear(ImageID imageID, Color color)
     {
         Commands::ClearImage* command = AddCommand<Commands::ClearImage>();                                                                                                       
@@ -142,11 +286,44 @@ namespace Renderer
         command->stencil = stencil;
     }
 
-    void CommandList::Draw(ModelID modelID)
+    void CommandList::ImageBarrier(ImageID imageID, ResourceAccess srcAccess, ResourceAccess dstAccess)
+    {
+        Commands::ImageBarrier* command = AddCommand<Commands::ImageBarrier>();
+        command->image = imageID;
+        command->srcAccess = srcAccess;
+        command->dstAccess = dstAccess;
+    }
+
+    void CommandList::ImageBarrier(DepthImageID imageID, ResourceAccess srcAccess, ResourceAccess dstAccess)
+    {
+        Commands::DepthImageBarrier* command = AddCommand<Commands::DepthImageBarrier>();
+        command->image = imageID;
+        command->srcAccess = srcAccess;
+        command->dstAccess = dstAccess;
+    }
+
+    void CommandList::BufferBarrier(void* buffer, ResourceAccess srcAccess, ResourceAccess dstAccess)
+    {
+        assert(buffer != nullptr);
+        Commands::BufferBarrier* command = AddCommand<Commands::BufferBarrier>();
+        command->buffer = buffer;
+        command->srcAccess = srcAccess;
+        command->dstAccess = dstAccess;
+    }
+
+    void CommandList::Draw(ModelID modelID, u32 baseInstance, u32 numInstances)
     {
         assert(modelID != ModelID::Invalid());
+        assert(numInstances > 0);
+        // The backend binds the model's vertex and index buffers for this draw, so that's what is bound afterwards
+        using type = type_safe::underlying_type<ModelID>;
+        BindSlot(_boundVertexBufferSlots, 0, BINDING_TYPE_VERTEX_BUFFER, static_cast<type>(modelID));
+        _boundIndexBuffer = modelID;
+
         Commands::Draw* command = AddCommand<Commands::Draw>();
         command->model = modelID;
+        command->baseInstance = baseInstance;
+        command->numInstances = numInstances;
     }
 
     void CommandList::DrawBindless(u32 numVertices, u32 numInstances)
@@ -163,9 +340,83 @@ namespace Renderer
         assert(modelID != ModelID::Invalid());
         assert(numVertices > 0);
         assert(numInstances > 0);
+        _boundIndexBuffer = modelID; // The backend binds the model's index buffer for this draw
+
         Commands::DrawIndexedBindless* command = AddCommand<Commands::DrawIndexedBindless>();
         command->modelID = modelID;
         command->numVertices = numVertices;
         command->numInstances = numInstances;
     }
+
+    void CommandList::DrawIndirect(void* argumentBuffer, u32 argumentBufferOffset, u32 drawCount)
+    {
+        assert(argumentBuffer != nullptr);
+        assert(drawCount > 0);
+        Commands::DrawIndirect* command = AddCommand<Commands::DrawIndirect>();
+        command->argumentBuffer = argumentBuffer;
+        command->argumentBufferOffset = argumentBufferOffset;
+        command->drawCount = drawCount;
+    }
+
+    void CommandList::DrawIndexedIndirect(ModelID modelID, void* argumentBuffer, u32 argumentBufferOffset, u32 drawCount)
+    {
+        assert(modelID != ModelID::Invalid());
+        assert(argumentBuffer != nullptr);
+        assert(drawCount > 0);
+        _boundIndexBuffer = modelID; // The backend binds the model's index buffer for this draw
+
+        Commands::DrawIndexedIndirect* command = AddCommand<Commands::DrawIndexedIndirect>();
+        command->modelID = modelID;
+        command->argumentBuffer = argumentBuffer;
+        command->argumentBufferOffset = argumentBufferOffset;
+        command->drawCount = drawCount;
+    }
+
+    void CommandList::DrawIndirectCount(void* argumentBuffer, u32 argumentBufferOffset, void* drawCountBuffer, u32 drawCountBufferOffset, u32 maxDrawCount)
+    {
+        assert(argumentBuffer != nullptr);
+        assert(drawCountBuffer != nullptr);
+        assert(maxDrawCount > 0);
+        Commands::DrawIndirectCount* command = AddCommand<Commands::DrawIndirectCount>();
+        command->argumentBuffer = argumentBuffer;
+        command->argumentBufferOffset = argumentBufferOffset;
+        command->drawCountBuffer = drawCountBuffer;
+        command->drawCountBufferOffset = drawCountBufferOffset;
+        command->maxDrawCount = maxDrawCount;
+    }
+
+    void CommandList::DrawIndexedIndirectCount(ModelID modelID, void* argumentBuffer, u32 argumentBufferOffset, void* drawCountBuffer, u32 drawCountBufferOffset, u32 maxDrawCount)
+    {
+        assert(modelID != ModelID::Invalid());
+        assert(argumentBuffer != nullptr);
+        assert(drawCountBuffer != nullptr);
+        assert(maxDrawCount > 0);
+        _boundIndexBuffer = modelID; // The backend binds the model's index buffer for this draw
+
+        Commands::DrawIndexedIndirectCount* command = AddCommand<Commands::DrawIndexedIndirectCount>();
+        command->modelID = modelID;
+        command->argumentBuffer = argumentBuffer;
+        command->argumentBufferOffset = argumentBufferOffset;
+        command->drawCountBuffer = drawCountBuffer;
+        command->drawCountBufferOffset = drawCountBufferOffset;
+        command->maxDrawCount = maxDrawCount;
+    }
+
+    void CommandList::Dispatch(u32 threadGroupCountX, u32 threadGroupCountY, u32 threadGroupCountZ)
+    {
+        assert(threadGroupCountX > 0 && threadGroupCountY > 0 && threadGroupCountZ > 0);
+        Commands::Dispatch* command = AddCommand<Commands::Dispatch>();
+        command->threadGroupCountX = threadGroupCountX;
+        command->threadGroupCountY = threadGroupCountY;
+        command->threadGroupCountZ = threadGroupCountZ;
+    }
+
+    void CommandList::DispatchIndirect(void* argumentBuffer, u32 argumentBufferOffset)
+    {
+        assert(argumentBuffer != nullptr);
+        assert((argumentBufferOffset % 4) == 0); // Vulkan requires indirect argument offsets to be multiples of 4
+        Commands::DispatchIndirect* command = AddCommand<Commands::DispatchIndirect>();
+        command->argumentBuffer = argumentBuffer;
+        command->argumentBufferOffset = argumentBufferOffset;
+    }
 }
\ No newline at end of file
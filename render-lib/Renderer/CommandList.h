@@ -3,14 +3,19 @@
 #include "BackendDispatch.h"
 #include "Descriptors/CommandListDesc.h"
 #include <vector>
+#include <new>
 #include <Memory/StackAllocator.h>
 #include <Containers/DynamicArray.h>
 
 // Commands
 #include "Commands/Clear.h"
+#include "Commands/ImageBarrier.h"
+#include "Commands/BufferBarrier.h"
 #include "Commands/Draw.h"
 #include "Commands/DrawBindless.h"
 #include "Commands/DrawIndexedBindless.h"
+#include "Commands/DrawIndirect.h"
+#include "Commands/DrawIndexedIndirect.h"
 #include "Commands/PopMarker.h"
 #include "Commands/PushMarker.h"
 #include "Commands/SetConstantBuffer.h"
@@ -24,20 +29,22 @@
 #include "Commands/SetVertexBuffer.h"
 #include "Commands/SetIndexBuffer.h"
 #include "Commands/SetBuffer.h"
+#include "Commands/PushConstant.h"
+#include "Commands/SetStorageImage.h"
+#include "Commands/Dispatch.h"
 
 namespace Renderer
 {
     class CommandList
     {
     public:
-        CommandList(Renderer* renderer, Memory::Allocator* allocator)
+        CommandList(Renderer* renderer, Memory::Allocator* allocator, size_t allocatorSize)
             : _renderer(renderer)
             , _allocator(allocator)
+            , _allocatorSize(allocatorSize)
             , _markerScope(0)
-            , _functions(allocator, 32)
-            , _data(allocator, 32)
         {
-
+            ResetBoundState();
         }
 
         void PushMarker(std::string marker, Color color);
@@ -45,6 +52,7 @@ namespace Renderer
 
         void BeginPipeline(GraphicsPipelineID pipelineID);
         void EndPipeline(GraphicsPipelineID pipelineID);
+        void SetPipeline(ComputePipelineID pipelineID); // Compute pipelines have no renderpass, so this can't be called between BeginPipeline and EndPipeline
 
         void SetScissorRect(u32 left, u32 right, u32 top, u32 bottom);
         void SetViewport(f32 topLeftX, f32 topLeftY, f32 width, f32 height, f32 minDepth, f32 maxDepth);
@@ -53,57 +61,120 @@ namespace Renderer
         void SetSampler(u32 slot, SamplerID sampler);
         void SetTexture(u32 slot, TextureID texture);
         void SetTextureArray(u32 slot, TextureArrayID textureArray);
+        void SetStorageImage(u32 slot, ImageID image); // Binds the image for shader writes (UAV), the pass needs to write it with WRITE_MODE_UAV
         void SetVertexBuffer(u32 slot, ModelID model);
         void SetIndexBuffer(ModelID model);
         void SetBuffer(u32 slot, void* buffer);
+        void PushConstant(void* data, u32 offset, u32 size); // The range needs to be declared in the bound pipeline's pushConstantRanges
 
         void Clear(ImageID imageID, Color color);
         void Clear(DepthImageID imageID, f32 depth, DepthClearFlags flags = DepthClearFlags::DEPTH_CLEAR_DEPTH, u8 stencil = 0);
 
-        void Draw(ModelID modelID);
+        void ImageBarrier(ImageID imageID, ResourceAccess srcAccess, ResourceAccess dstAccess);
+        void ImageBarrier(DepthImageID imageID, ResourceAccess srcAccess, ResourceAccess dstAccess);
+        void BufferBarrier(void* buffer, ResourceAccess srcAccess, ResourceAccess dstAccess); // Only needed for buffers the RenderGraph doesn't track through RenderGraphBuilder::Read/Write
+
+        void Draw(ModelID modelID, u32 baseInstance = 0, u32 numInstances = 1); // baseInstance is the first slot read from the InstanceBuffer
         void DrawBindless(u32 numVertices, u32 numInstances);
         void DrawIndexedBindless(ModelID modelID, u32 numVertices, u32 numInstances);
 
+        // Indirect draws read their DrawIndirectArguments/DrawIndexedIndirectArguments from a buffer, buffers come from BufferBackend::GetBuffer
+        void DrawIndirect(void* argumentBuffer, u32 argumentBufferOffset, u32 drawCount);
+        void DrawIndexedIndirect(ModelID modelID, void* argumentBuffer, u32 argumentBufferOffset, u32 drawCount);
+        // The count variants read the number of draws as a u32 from drawCountBuffer, arguments past that count must have an instanceCount of 0 since backends without count support draw all maxDrawCount of them
+        void DrawIndirectCount(void* argumentBuffer, u32 argumentBufferOffset, void* drawCountBuffer, u32 drawCountBufferOffset, u32 maxDrawCount);
+        void DrawIndexedIndirectCount(ModelID modelID, void* argumentBuffer, u32 argumentBufferOffset, void* drawCountBuffer, u32 drawCountBufferOffset, u32 maxDrawCount);
+
+        void Dispatch(u32 threadGroupCountX, u32 threadGroupCountY, u32 threadGroupCountZ);
+        void DispatchIndirect(void* argumentBuffer, u32 argumentBufferOffset); // Reads DispatchIndirectArguments from the buffer
+
     private:
-        // Execute gets friend-called from RenderGraph
+        // Execute and Record gets friend-called from RenderGraph
         void Execute();
+        void Record(CommandListID commandListID); // Translates the commands into an already begun backend commandlist, this is safe to call in parallel for different commandlists
 
-        template<typename Command>
-        Command* AddCommand()
+        // Commands are packed linearly into blocks, each command is a small header followed by the command itself
+        struct CommandHeader
         {
-            Command* command = AllocateCommand<Command>();
+            BackendDispatchFunction function;
+            u32 size; // Size of header + command, this is the offset to the next header
+        };
 
-            AddFunction(Command::DISPATCH_FUNCTION);
-            AddData(command);
+        static constexpr size_t COMMAND_BLOCK_SIZE = 16 * 1024; // 16 KB
+        static constexpr size_t COMMAND_ALIGNMENT = 16;
+        static constexpr size_t COMMAND_HEADER_SIZE = (sizeof(CommandHeader) + COMMAND_ALIGNMENT - 1) & ~(COMMAND_ALIGNMENT - 1);
 
-            return command;
-        }
+        struct CommandBlock
+        {
+            alignas(COMMAND_ALIGNMENT) u8 data[COMMAND_BLOCK_SIZE];
+            size_t used = 0;
+            CommandBlock* next = nullptr;
+        };
 
         template<typename Command>
-        Command* AllocateCommand()
+        Command* AddCommand()
         {
-            assert(_allocator != nullptr);
+            static_assert(alignof(Command) <= COMMAND_ALIGNMENT, "Commands can't have a bigger alignment than COMMAND_ALIGNMENT");
+            constexpr size_t size = (COMMAND_HEADER_SIZE + sizeof(Command) + COMMAND_ALIGNMENT - 1) & ~(COMMAND_ALIGNMENT - 1);
 
-            return Memory::Allocator::New<Command>(_allocator);
-        }
+            u8* memory = AllocateCommandMemory(size);
 
-        void AddFunction(const BackendDispatchFunction& function)
-        {
-            _functions.Insert(function);
+            CommandHeader* header = new (memory) CommandHeader();
+            header->function = Command::DISPATCH_FUNCTION;
+            header->size = static_cast<u32>(size);
+
+            return new (memory + COMMAND_HEADER_SIZE) Command();
         }
 
-        void AddData(void* data)
+        u8* AllocateCommandMemory(size_t size);
+
+        // How much of the allocator the command blocks take up, including the worst case alignment padding of every block
+        static constexpr size_t COMMAND_BLOCK_STRIDE = sizeof(CommandBlock) + alignof(CommandBlock);
+        size_t GetUsedMemory() const { return _numBlocks * COMMAND_BLOCK_STRIDE; }
+
+        // Bound state tracking, binds that wouldn't change anything never make it into the commandlist
+        enum BindingType : u8
         {
-            _data.Insert(data);
-        }
+            BINDING_TYPE_NONE,
+            BINDING_TYPE_CONSTANT_BUFFER,
+            BINDING_TYPE_STORAGE_BUFFER,
+            BINDING_TYPE_SAMPLER,
+            BINDING_TYPE_TEXTURE,
+            BINDING_TYPE_TEXTURE_ARRAY,
+            BINDING_TYPE_STORAGE_IMAGE,
+            BINDING_TYPE_VERTEX_BUFFER,
+            BINDING_TYPE_BUFFER
+        };
+
+        struct BoundSlot
+        {
+            BindingType type = BINDING_TYPE_NONE;
+            u64 value = 0;
+            u64 extra = 0;
+        };
+
+        static constexpr u32 MAX_TRACKED_SLOTS = 16; // Slots above this are never considered redundant
+
+        void ResetBoundState();
+        bool BindSlot(BoundSlot* slots, u32 slot, BindingType type, u64 value, u64 extra = 0); // Returns false if the bind is redundant
 
     private:
         Memory::Allocator* _allocator;
+        size_t _allocatorSize; // We can't ask the allocator if it has room, so we check this before adding a block
         Renderer* _renderer;
         u32 _markerScope;
 
-        DynamicArray<BackendDispatchFunction> _functions;
-        DynamicArray<void*> _data;
+        CommandBlock* _firstBlock = nullptr;
+        CommandBlock* _lastBlock = nullptr;
+        size_t _numBlocks = 0;
+
+        BoundSlot _boundDescriptorSlots[MAX_TRACKED_SLOTS];
+        BoundSlot _boundVertexBufferSlots[MAX_TRACKED_SLOTS];
+        ModelID _boundIndexBuffer = ModelID::Invalid();
+        bool _hasScissorRect = false;
+        ScissorRect _boundScissorRect;
+        bool _hasViewport = false;
+        Viewport _boundViewport;
 
         friend class RenderGraph;
     };
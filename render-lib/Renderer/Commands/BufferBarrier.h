@@ -0,0 +1,18 @@
+#pragma once
+#include <NovusTypes.h>
+#include "../RenderStates.h"
+
+namespace Renderer
+{
+    namespace Commands
+    {
+        struct BufferBarrier
+        {
+            static const BackendDispatchFunction DISPATCH_FUNCTION;
+
+            void* buffer = nullptr;
+            ResourceAccess srcAccess = ResourceAccess::RESOURCE_ACCESS_UNKNOWN;
+            ResourceAccess dstAccess = ResourceAccess::RESOURCE_ACCESS_UNKNOWN;
+        };
+    }
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <NovusTypes.h>
+
+namespace Renderer
+{
+    // Layout of one dispatch in an argument buffer, matches VkDispatchIndirectCommand
+    struct DispatchIndirectArguments
+    {
+        u32 threadGroupCountX = 0;
+        u32 threadGroupCountY = 0;
+        u32 threadGroupCountZ = 0;
+    };
+
+    namespace Commands
+    {
+        struct Dispatch
+        {
+            static const BackendDispatchFunction DISPATCH_FUNCTION;
+
+            u32 threadGroupCountX = 0;
+            u32 threadGroupCountY = 0;
+            u32 threadGroupCountZ = 0;
+        };
+
+        struct DispatchIndirect
+        {
+            static const BackendDispatchFunction DISPATCH_FUNCTION;
+
+            void* argumentBuffer = nullptr;
+            u32 argumentBufferOffset = 0;
+        };
+    }
+}
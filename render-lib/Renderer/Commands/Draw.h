@@ -11,6 +11,8 @@ namespace Renderer
             static const BackendDispatchFunction DISPATCH_FUNCTION;
 
             ModelID model = ModelID::Invalid();
+            u32 baseInstance = 0;
+            u32 numInstances = 1;
         };
     }
 }
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+#include <NovusTypes.h>
+#include "../Descriptors/ModelDesc.h"
+
+namespace Renderer
+{
+    // Layout of one draw in an argument buffer, matches VkDrawIndexedIndirectCommand
+    struct DrawIndexedIndirectArguments
+    {
+        u32 indexCount = 0;
+        u32 instanceCount = 0;
+        u32 firstIndex = 0;
+        i32 vertexOffset = 0;
+        u32 firstInstance = 0;
+    };
+
+    namespace Commands
+    {
+        struct DrawIndexedIndirect
+        {
+            static const BackendDispatchFunction DISPATCH_FUNCTION;
+
+            ModelID modelID = ModelID::Invalid(); // Only used for its index buffer
+            void* argumentBuffer = nullptr;
+            u32 argumentBufferOffset = 0;
+            u32 drawCount = 0;
+        };
+
+        struct DrawIndexedIndirectCount
+        {
+            static const BackendDispatchFunction DISPATCH_FUNCTION;
+
+            ModelID modelID = ModelID::Invalid(); // Only used for its index buffer
+            void* argumentBuffer = nullptr;
+            u32 argumentBufferOffset = 0;
+            void* drawCountBuffer = nullptr;
+            u32 drawCountBufferOffset = 0;
+            u32 maxDrawCount = 0;
+        };
+    }
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <NovusTypes.h>
+
+namespace Renderer
+{
+    // Layout of one draw in an argument buffer, matches VkDrawIndirectCommand
+    struct DrawIndirectArguments
+    {
+        u32 vertexCount = 0;
+        u32 instanceCount = 0;
+        u32 firstVertex = 0;
+        u32 firstInstance = 0;
+    };
+
+    namespace Commands
+    {
+        struct DrawIndirect
+        {
+            static const BackendDispatchFunction DISPATCH_FUNCTION;
+
+            void* argumentBuffer = nullptr;
+            u32 argumentBufferOffset = 0;
+            u32 drawCount = 0;
+        };
+
+        struct DrawIndirectCount
+        {
+            static const BackendDispatchFunction DISPATCH_FUNCTION;
+
+            void* argumentBuffer = nullptr;
+            u32 argumentBufferOffset = 0;
+            void* drawCountBuffer = nullptr;
+            u32 drawCountBufferOffset = 0;
+            u32 maxDrawCount = 0;
+        };
+    }
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <NovusTypes.h>
+#include "../Descriptors/ImageDesc.h"
+#include "../Descriptors/DepthImageDesc.h"
+
+namespace Renderer
+{
+    namespace Commands
+    {
+        struct ImageBarrier
+        {
+            static const BackendDispatchFunction DISPATCH_FUNCTION;
+
+            ImageID image = ImageID::Invalid();
+            ResourceAccess srcAccess = ResourceAccess::RESOURCE_ACCESS_UNKNOWN;
+            ResourceAccess dstAccess = ResourceAccess::RESOURCE_ACCESS_UNKNOWN;
+        };
+
+        struct DepthImageBarrier
+        {
+            static const BackendDispatchFunction DISPATCH_FUNCTION;
+
+            DepthImageID image = DepthImageID::Invalid();
+            ResourceAccess srcAccess = ResourceAccess::RESOURCE_ACCESS_UNKNOWN;
+            ResourceAccess dstAccess = ResourceAccess::RESOURCE_ACCESS_UNKNOWN;
+        };
+    }
+}
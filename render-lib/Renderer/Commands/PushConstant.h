@@ -0,0 +1,18 @@
+#pragma once
+#include <NovusTypes.h>
+#include "../RenderStates.h"
+
+namespace Renderer
+{
+    namespace Commands
+    {
+        struct PushConstant
+        {
+            static const BackendDispatchFunction DISPATCH_FUNCTION;
+
+            u32 offset = 0;
+            u32 size = 0;
+            u8 data[MAX_PUSH_CONSTANT_SIZE]; // The data gets copied into the command since the caller's copy is usually gone by the time we record
+        };
+    }
+}
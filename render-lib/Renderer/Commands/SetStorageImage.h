@@ -0,0 +1,17 @@
+#pragma once
+#include <NovusTypes.h>
+#include "../Descriptors/ImageDesc.h"
+
+namespace Renderer
+{
+    namespace Commands
+    {
+        struct SetStorageImage
+        {
+            static const BackendDispatchFunction DISPATCH_FUNCTION;
+
+            u32 slot = 0;
+            ImageID image = ImageID::Invalid();
+        };
+    }
+}
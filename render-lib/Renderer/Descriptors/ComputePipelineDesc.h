@@ -1,6 +1,7 @@
 #pragma once
 #include <NovusTypes.h>
 #include <Utils/StrongTypedef.h>
+#include "../RenderStates.h"
 
 #include "ComputeShaderDesc.h"
 
@@ -8,7 +9,14 @@ namespace Renderer
 {
     struct ComputePipelineDesc
     {
+        static const int MAX_PUSH_CONSTANT_RANGES = 2;
+        static const int MAX_SPECIALIZATION_CONSTANTS = 8;
+
         ComputeShaderID computeShader = ComputeShaderID::Invalid();
+
+        // Compute only has the one stage, so the shaderVisibility of these is ignored
+        PushConstantRange pushConstantRanges[MAX_PUSH_CONSTANT_RANGES];
+        SpecializationConstant specializationConstants[MAX_SPECIALIZATION_CONSTANTS];
     };
 
     // Lets strong-typedef an ID type with the underlying type of u16
@@ -21,6 +21,8 @@ namespace Renderer
         static const int MAX_CONSTANT_BUFFERS = 8;
         static const int MAX_INPUT_LAYOUTS = 8;
         static const int MAX_BOUND_TEXTURES = 8;
+        static const int MAX_PUSH_CONSTANT_RANGES = 2;
+        static const int MAX_SPECIALIZATION_CONSTANTS = 8;
 
         GraphicsPipelineDesc()
         {
@@ -36,6 +38,8 @@ namespace Renderer
             DepthStencilState depthStencilState;
             BlendState blendState;
             ConstantBufferState constantBufferStates[MAX_CONSTANT_BUFFERS];
+            PushConstantRange pushConstantRanges[MAX_PUSH_CONSTANT_RANGES];
+            SpecializationConstant specializationConstants[MAX_SPECIALIZATION_CONSTANTS]; // Part of the hash, so every permutation gets its own pipeline
             InputLayout inputLayouts[MAX_INPUT_LAYOUTS];
             Viewport viewport; // TODO: Dynamic viewport
             ScissorRect scissorRect; // TODO: Dynamic ScissorRect
@@ -47,7 +51,7 @@ namespace Renderer
         };
         States states;
 
-        // Everything below this isn't hashable in the PipelineHandler since it will depend on the RenderGraph (which gets recreated every frame)
+        // Everything below this isn't hashed as-is since it refers to RenderGraph resources, the PipelineHandler resolves the rendertargets and depthstencil through these functions and hashes the ImageIDs they resolve to, textures are only hashed by how many there are
         std::function<ImageID(RenderPassResource resource)> ResourceToImageID = nullptr;
         std::function<DepthImageID(RenderPassResource resource)> ResourceToDepthImageID = nullptr;
         std::function<ImageID(RenderPassMutableResource resource)> MutableResourceToImageID = nullptr;
@@ -7,12 +7,21 @@ namespace Memory
     class Allocator;
 }
 
+namespace tf
+{
+    class Taskflow;
+}
+
 namespace Renderer
 {
     class Renderer;
 
     struct RenderGraphDesc
     {
-        Memory::Allocator* allocator;
+        Memory::Allocator* allocator; // Used for the passes, needs to outlive the rendergraph
+        Memory::Allocator* frameAllocator = nullptr; // Used for the per-frame commandlists, the owner should reset it every frame
+        size_t compileAllocatorSize = 1 * 1024 * 1024; // 1 MB, the rendergraph compiles into its own allocator of this size
+        size_t passAllocatorSize = 1 * 1024 * 1024; // 1 MB, every pass records its commands into its own allocator of at least this size, it grows to twice what the pass has needed so far
+        tf::Taskflow* taskflow = nullptr; // Optional, if set the passes will be executed and recorded into their own commandlists in parallel
     };
 }
\ No newline at end of file
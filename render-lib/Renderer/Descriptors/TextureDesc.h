@@ -18,7 +18,7 @@ namespace Renderer
 
         ImageFormat format;
         
-        u8* data = nullptr;
+        u8* data = nullptr; // Allocated with new[], the renderer takes ownership and deletes it once the data has been staged
         std::string debugName = "";
     };
 
@@ -1,7 +1,20 @@
 #pragma once
+#include <NovusTypes.h>
 #include <array>
 
-template <typename T, size_t NumFrames>
+// How many frames the CPU may record ahead of the GPU, set it with the RENDERER_FRAMES_IN_FLIGHT CMake option
+// Every per-frame resource keeps this many copies, more frames means more CPU/GPU overlap but also more latency and memory
+#ifndef NOVUSCORE_RENDERER_FRAMES_IN_FLIGHT
+#define NOVUSCORE_RENDERER_FRAMES_IN_FLIGHT 2
+#endif
+
+namespace Renderer
+{
+    constexpr u32 FRAMES_IN_FLIGHT = NOVUSCORE_RENDERER_FRAMES_IN_FLIGHT;
+    static_assert(FRAMES_IN_FLIGHT >= 1 && FRAMES_IN_FLIGHT <= 8, "FRAMES_IN_FLIGHT needs to fit in the 8 bit dirty masks");
+}
+
+template <typename T, size_t NumFrames = Renderer::FRAMES_IN_FLIGHT>
 struct FrameResource
 {
     T& Get(size_t frame)
@@ -12,4 +25,4 @@ struct FrameResource
     std::array<T, NumFrames> items = { 0 };
 
     static constexpr size_t Num = NumFrames;
-};
\ No newline at end of file
+};
@@ -0,0 +1,58 @@
+#include "InstanceBuffer.h"
+#include "Renderer.h"
+
+namespace Renderer
+{
+    InstanceBuffer::InstanceBuffer(Renderer* renderer)
+    {
+        _buffer = renderer->CreateStorageBuffer<std::array<ModelCB, MAX_INSTANCES>>();
+    }
+
+    u32 InstanceBuffer::Allocate()
+    {
+        u32 instanceID;
+        if (!_freeInstanceIDs.empty())
+        {
+            instanceID = _freeInstanceIDs.back();
+            _freeInstanceIDs.pop_back();
+        }
+        else
+        {
+            assert(_numInstances < MAX_INSTANCES); // Out of instance slots, bump MAX_INSTANCES
+            instanceID = _numInstances++;
+        }
+
+        _buffer->resource[instanceID] = ModelCB();
+        MarkDirty();
+
+        return instanceID;
+    }
+
+    void InstanceBuffer::Free(u32 instanceID)
+    {
+        assert(instanceID < _numInstances);
+        _freeInstanceIDs.push_back(instanceID);
+    }
+
+    ModelCB& InstanceBuffer::Get(u32 instanceID)
+    {
+        assert(instanceID < _numInstances);
+        return _buffer->resource[instanceID];
+    }
+
+    void InstanceBuffer::Apply(u32 frameIndex)
+    {
+        u8 frameBit = 1 << frameIndex;
+        if ((_dirtyFrames & frameBit) == 0 || _numInstances == 0)
+            return;
+
+        // Each frame has its own copy of the buffer, so a change has to be uploaded once for every frame
+        _buffer->backend->Apply(frameIndex, _buffer->resource.data(), _numInstances * sizeof(ModelCB));
+        _dirtyFrames &= ~frameBit;
+    }
+
+    void* InstanceBuffer::GetDescriptor(u32 frameIndex)
+    {
+        return _buffer->GetDescriptor(frameIndex);
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <NovusTypes.h>
+#include <vector>
+#include <array>
+#include "StorageBuffer.h"
+#include "FrameResource.h"
+
+namespace Renderer
+{
+    class Renderer;
+
+    // This matches the Instance struct in the shaders, it's std430 so it doesn't need padding anymore
+    struct ModelCB
+    {
+        vec4 colorMultiplier = vec4(1, 1, 1, 1); // 16 bytes
+        mat4x4 modelMatrix = mat4x4(1.0f); // 64 bytes
+    };
+
+    // All InstanceDatas write into slots of this one storage buffer, shaders index it with gl_InstanceIndex
+    // Freed slots get reused, and the used part of the buffer gets uploaded at most once per frame
+    class InstanceBuffer
+    {
+    public:
+        static constexpr u32 MAX_INSTANCES = 16384;
+
+        InstanceBuffer(Renderer* renderer);
+
+        u32 Allocate();
+        void Free(u32 instanceID);
+
+        ModelCB& Get(u32 instanceID);
+        void MarkDirty() { _dirtyFrames = ALL_FRAMES_DIRTY; }
+
+        // Call this once per frame before executing the rendergraph
+        void Apply(u32 frameIndex);
+
+        void* GetDescriptor(u32 frameIndex);
+        u32 GetNumInstances() { return _numInstances; }
+
+    private:
+        static constexpr u8 ALL_FRAMES_DIRTY = static_cast<u8>((1u << FRAMES_IN_FLIGHT) - 1); // One bit per frame in flight
+
+        StorageBuffer<std::array<ModelCB, MAX_INSTANCES>>* _buffer = nullptr;
+        std::vector<u32> _freeInstanceIDs;
+        u32 _numInstances = 0; // The highest slot ever used + 1, only this part of the buffer gets uploaded
+        u8 _dirtyFrames = 0;
+    };
+}
@@ -1,42 +1,31 @@
 #include "InstanceData.h"
+#include "InstanceBuffer.h"
 #include "Renderer.h"
 
 namespace Renderer
 {
     void InstanceData::Init(Renderer* renderer)
     {
-        _cb = renderer->CreateConstantBuffer<ModelCB>();
+        _instanceBuffer = renderer->GetInstanceBuffer();
+        _instanceID = _instanceBuffer->Allocate();
     }
 
-    void InstanceData::Apply(u32 frameIndex)
+    void InstanceData::Free()
     {
-        assert(_cb != nullptr); // Check if we have initialized
+        assert(_instanceBuffer != nullptr); // Check if we have initialized
 
-        _cb->resource.colorMultiplier = colorMultiplier;
-        _cb->resource.modelMatrix = modelMatrix;
-        _cb->Apply(frameIndex);
+        _instanceBuffer->Free(_instanceID);
+        _instanceBuffer = nullptr;
+        _instanceID = 0;
     }
 
-    void InstanceData::ApplyAll()
+    void InstanceData::Apply()
     {
-        for (u32 i = 0; i < 2; i++)
-        {
-            Apply(i);
-        }
-    }
-
-    void* InstanceData::GetDescriptor(u32 frameIndex)
-    {
-        assert(_cb != nullptr); // Check if we have initialized
-
-        return _cb->GetDescriptor(frameIndex);
-    }
-
-    void* InstanceData::GetBuffer(u32 frameIndex)
-    {
-        assert(_cb != nullptr); // Check if we have initialized
+        assert(_instanceBuffer != nullptr); // Check if we have initialized
 
-        return _cb->GetBuffer(frameIndex);
+        ModelCB& instance = _instanceBuffer->Get(_instanceID);
+        instance.colorMultiplier = colorMultiplier;
+        instance.modelMatrix = modelMatrix;
+        _instanceBuffer->MarkDirty();
     }
-
 }
\ No newline at end of file
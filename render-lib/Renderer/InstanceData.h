@@ -1,24 +1,10 @@
 #pragma once
 #include <NovusTypes.h>
-#include "ConstantBuffer.h"
 
 namespace Renderer
 {
     class Renderer;
-
-    struct ModelCB
-    {
-        vec4 colorMultiplier = vec4(1, 1, 1, 1); // 16 bytes
-        mat4x4 modelMatrix = mat4x4(1.0f); // 64 bytes
-
-        u8 padding[176] = {};
-    };
-
-    struct InstanceDataBackend
-    {
-        ConstantBuffer<ModelCB>* cb = nullptr;
-        void* optional = nullptr;
-    };
+    class InstanceBuffer;
 
     class InstanceData
     {
@@ -27,25 +13,25 @@ namespace Renderer
         mat4x4 modelMatrix = mat4x4(1.0f);
 
         void Init(Renderer* renderer);
-        void Apply(u32 frameIndex);
-        void ApplyAll();
-        void* GetDescriptor(u32 frameIndex);
-        void* GetBuffer(u32 frameIndex);
+        void Free(); // Gives the instance slot back to the InstanceBuffer, call Init again before using this
+        void Apply();
+        u32 GetInstanceID() { return _instanceID; }
 
         template<typename T>
         void SetOptional(T* optional)
         {
-            _backend.optional = static_cast<void*>(optional);
+            _optional = static_cast<void*>(optional);
         }
 
         template<typename T>
         T* GetOptional()
         {
-            return static_cast<T*>(_backend.optional);
+            return static_cast<T*>(_optional);
         }
 
     private:
-        InstanceDataBackend _backend;
-        ConstantBuffer<ModelCB>* _cb = nullptr;
+        InstanceBuffer* _instanceBuffer = nullptr;
+        u32 _instanceID = 0;
+        void* _optional = nullptr;
     };
 }
\ No newline at end of file
@@ -2,6 +2,8 @@
 #include "RenderGraphBuilder.h"
 
 #include "Renderer.h"
+#include <taskflow/taskflow.hpp>
+#include <algorithm>
 
 namespace Renderer
 {
@@ -9,8 +11,10 @@ namespace Renderer
     {
         _desc = desc;
         assert(desc.allocator != nullptr); // You need to set an allocator
+        assert(desc.frameAllocator != nullptr); // You need to set a frame allocator
 
-        _renderGraphBuilder = Memory::Allocator::New<RenderGraphBuilder>(desc.allocator, desc.allocator, _renderer);
+        _compileAllocator = new Memory::StackAllocator(desc.compileAllocatorSize);
+        _compileAllocator->Init();
 
         return true;
     }
@@ -21,6 +25,18 @@ namespace Renderer
         {
             pass->DeInit();
         }
+
+        if (_renderGraphBuilder != nullptr)
+        {
+            _renderGraphBuilder->ReleaseTransients();
+        }
+
+        delete _compileAllocator;
+
+        for (PassAllocator& passAllocator : _passAllocators)
+        {
+            delete passAllocator.allocator;
+        }
     }
 
     /*void RenderGraph::AddPass(RenderPass& pass)
@@ -28,28 +44,189 @@ namespace Renderer
         _passes.push_back(pass);
     }*/
 
+    void RenderGraph::AddOutput(ImageID image)
+    {
+        _outputImages.push_back(image);
+        Invalidate();
+    }
+
+    void RenderGraph::AddOutput(DepthImageID image)
+    {
+        _outputDepthImages.push_back(image);
+        Invalidate();
+    }
+
+    void RenderGraph::ClearOutputs()
+    {
+        _outputImages.clear();
+        _outputDepthImages.clear();
+        Invalidate();
+    }
+
     void RenderGraph::Setup()
     {
-        for (IRenderPass* pass : _passes)
+        // Throw away the last compile, the builder only owns its transient images outside of the compile allocator
+        // Releasing them first is fine, the backend keeps them around for a while so this compile will get the same ones back
+        if (_renderGraphBuilder != nullptr)
+        {
+            _renderGraphBuilder->ReleaseTransients();
+        }
+        _compileAllocator->Reset();
+        _renderGraphBuilder = Memory::Allocator::New<RenderGraphBuilder>(_compileAllocator, _compileAllocator, _renderer);
+
+        for (ImageID image : _outputImages)
+        {
+            _renderGraphBuilder->AddOutput(image);
+        }
+        for (DepthImageID image : _outputDepthImages)
+        {
+            _renderGraphBuilder->AddOutput(image);
+        }
+
+        for (u32 i = 0; i < _passes.Count(); i++)
+        {
+            _renderGraphBuilder->BeginPass(i);
+            bool enabled = _passes[i]->Setup(_renderGraphBuilder);
+            _renderGraphBuilder->EndPass(enabled);
+        }
+
+        // Cull unused passes and work out the barriers between the ones that are left
+        _renderGraphBuilder->Compile();
+
+        _setupCount++;
+        _isValid = true;
+    }
+
+    void RenderGraph::Execute(u32 frameIndex)
+    {
+        assert(_isValid); // Setup needs to be called after the graph has been invalidated
+
+        // Every pass gets its own CommandList, this lets us execute them and translate them into backend commandlists independently
+        DynamicArray<CommandList*> commandLists(_desc.frameAllocator, _passes.Count());
+        DynamicArray<u32> passIndices(_desc.frameAllocator, _passes.Count());
+        for (u32 i = 0; i < _passes.Count(); i++)
+        {
+            if (!_renderGraphBuilder->ShouldExecute(i))
+                continue;
+
+            // The commands go into an allocator owned by this pass, the frame allocator is not threadsafe
+            Memory::StackAllocator* passAllocator = GetPassAllocator(i);
+            passAllocator->Reset();
+
+            CommandList* commandList = Memory::Allocator::New<CommandList>(_desc.frameAllocator, _renderer, passAllocator, _passAllocators[i].size);
+            commandLists.Insert(commandList);
+            passIndices.Insert(i);
+        }
+
+        const size_t numPasses = commandLists.Count();
+        if (numPasses == 0)
+            return;
+
+        const bool parallel = _desc.taskflow != nullptr && numPasses > 1;
+
+        // Execute the passes, in parallel if we were given a taskflow
+        if (parallel)
+        {
+            tf::Framework framework;
+            for (size_t i = 0; i < numPasses; i++)
+            {
+                framework.emplace([this, &commandLists, &passIndices, frameIndex, i]()
+                {
+                    ExecutePass(passIndices[i], frameIndex, *commandLists[i]);
+                });
+            }
+
+            _desc.taskflow->run(framework);
+            _desc.taskflow->wait_for_all();
+        }
+        else
+        {
+            for (size_t i = 0; i < numPasses; i++)
+            {
+                ExecutePass(passIndices[i], frameIndex, *commandLists[i]);
+            }
+        }
+
+        // From now on the barriers know how the previous frame left the resources
+        _renderGraphBuilder->MarkExecuted();
+
+        for (size_t i = 0; i < numPasses; i++)
+        {
+            PassAllocator& passAllocator = _passAllocators[passIndices[i]];
+            passAllocator.highWaterMark = std::max(passAllocator.highWaterMark, commandLists[i]->GetUsedMemory());
+        }
+
+        // Begin the backend commandlists up front, the backend is not threadsafe when it comes to acquiring commandlists
+        DynamicArray<CommandListID> commandListIDs(_desc.frameAllocator, numPasses);
+        for (size_t i = 0; i < numPasses; i++)
         {
-            if (pass->Setup(_renderGraphBuilder))
+            commandListIDs.Insert(_renderer->BeginCommandList());
+        }
+
+        // Record the commandlists, this has to wait for every pass to execute since executing can still create pipelines that recording reads
+        if (parallel)
+        {
+            tf::Framework framework;
+            for (size_t i = 0; i < numPasses; i++)
             {
-                _executingPasses.Insert(pass);
+                framework.emplace([&commandLists, &commandListIDs, i]()
+                {
+                    commandLists[i]->Record(commandListIDs[i]);
+                });
             }
+
+            _desc.taskflow->run(framework);
+            _desc.taskflow->wait_for_all();
+        }
+        else
+        {
+            for (size_t i = 0; i < numPasses; i++)
+            {
+                commandLists[i]->Record(commandListIDs[i]);
+            }
+        }
+
+        // Submit them in graph order
+        for (size_t i = 0; i < numPasses; i++)
+        {
+            _renderer->EndCommandList(commandListIDs[i]);
         }
     }
 
-    void RenderGraph::Execute()
+    void RenderGraph::ExecutePass(u32 passIndex, u32 frameIndex, CommandList& commandList)
     {
-        // TODO: Parallel_for this
-        CommandList commandList(_renderer, _desc.allocator);
+        // Markers can't span backend commandlists, so every pass opens its own RenderGraph marker
         commandList.PushMarker("RenderGraph", Color(0.0f, 0.0f, 0.4f));
-        for (IRenderPass* pass : _executingPasses)
+
+        _renderGraphBuilder->InsertBarriers(passIndex, false, frameIndex, commandList);
+        _passes[passIndex]->Execute(commandList);
+        _renderGraphBuilder->InsertBarriers(passIndex, true, frameIndex, commandList);
+
+        commandList.PopMarker();
+    }
+
+    Memory::StackAllocator* RenderGraph::GetPassAllocator(u32 passIndex)
+    {
+        if (_passAllocators.size() <= passIndex)
         {
-            pass->Execute(commandList);
+            _passAllocators.resize(passIndex + 1);
         }
-        commandList.PopMarker();
-        commandList.Execute();
+
+        PassAllocator& passAllocator = _passAllocators[passIndex];
+
+        // Keep twice the most the pass has ever recorded, so a pass that grows gets a bigger allocator before it runs out
+        size_t size = std::max(_desc.passAllocatorSize, passAllocator.highWaterMark * 2);
+        if (passAllocator.allocator == nullptr || size > passAllocator.size)
+        {
+            // The commands recorded into the old allocator have been recorded into backend commandlists by now
+            delete passAllocator.allocator;
+
+            passAllocator.allocator = new Memory::StackAllocator(size);
+            passAllocator.allocator->Init();
+            passAllocator.size = size;
+        }
+
+        return passAllocator.allocator;
     }
 
     void RenderGraph::InitializePipelineDesc(GraphicsPipelineDesc& desc) const
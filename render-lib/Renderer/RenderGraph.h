@@ -4,6 +4,7 @@
 #include "RenderPass.h"
 #include <Memory/StackAllocator.h>
 #include <Containers/DynamicArray.h>
+#include <vector>
 
 namespace Memory
 {
@@ -24,12 +25,24 @@ namespace Renderer
         template <typename PassData>
         void AddPass(std::string name, std::function<bool(PassData&, RenderGraphBuilder&)> onSetup, std::function<void(PassData&, CommandList&)> onExecute)
         {
-            IRenderPass* pass = Memory::Allocator::New<RenderPass<PassData>>(_desc.allocator, name, onSetup, onExecute);
+            IRenderPass* pass = Memory::Allocator::New<RenderPass<PassData>>(_desc.allocator, name, std::move(onSetup), std::move(onExecute));
             _passes.Insert(pass);
+
+            Invalidate();
         }
 
+        // The graph stays compiled between frames, only call Setup again after it has been invalidated
+        bool IsValid() const { return _isValid; }
+        void Invalidate() { _isValid = false; }
+
         void Setup();
-        void Execute();
+        u32 GetSetupCount() const { return _setupCount; } // Changes every Setup, anything resolved from the graph's resources has to be resolved again when it does
+        void Execute(u32 frameIndex); // frameIndex picks which copy of the tracked dynamic buffers the barriers go on
+
+        // Outputs are the images that get used after the graph has executed, passes that don't contribute to them get culled
+        void AddOutput(ImageID image);
+        void AddOutput(DepthImageID image);
+        void ClearOutputs();
 
         RenderGraphBuilder* GetBuilder() { return _renderGraphBuilder; }
 
@@ -40,12 +53,21 @@ namespace Renderer
             : _renderer(renderer)
             , _renderGraphBuilder(nullptr)
             , _passes(allocator, 32)
-            , _executingPasses(allocator, 32)
         {
         
         } // This gets friend-created by Renderer
         bool Init(RenderGraphDesc& desc);
 
+        void ExecutePass(u32 passIndex, u32 frameIndex, CommandList& commandList);
+        Memory::StackAllocator* GetPassAllocator(u32 passIndex);
+
+        struct PassAllocator
+        {
+            Memory::StackAllocator* allocator = nullptr;
+            size_t size = 0;
+            size_t highWaterMark = 0; // The most memory the pass has recorded into in any frame so far
+        };
+
     private:
         RenderGraphDesc _desc;
 
@@ -53,10 +75,15 @@ namespace Renderer
         //std::vector<IRenderPass*> _executingPasses;
 
         DynamicArray<IRenderPass*> _passes;
-        DynamicArray<IRenderPass*> _executingPasses;
+        std::vector<ImageID> _outputImages;
+        std::vector<DepthImageID> _outputDepthImages;
 
         Renderer* _renderer;
         RenderGraphBuilder* _renderGraphBuilder;
+        Memory::StackAllocator* _compileAllocator = nullptr; // The builder and everything it compiles lives here, it gets reset when we setup again
+        std::vector<PassAllocator> _passAllocators; // One per pass so the passes can record in parallel, they get reset every Execute and grow with the pass
+        bool _isValid = false;
+        u32 _setupCount = 0;
 
         friend class Renderer; // To have access to the constructor
     };
@@ -1,65 +1,573 @@
 #include "RenderGraphBuilder.h"
 #include "Renderer.h"
 #include "RenderGraph.h"
+#include "CommandList.h"
+#include "BufferBackend.h"
+#include <algorithm>
 
 namespace Renderer
 {
     RenderGraphBuilder::RenderGraphBuilder(Memory::Allocator* allocator, Renderer* renderer)
-        : _renderer(renderer)
+        : _allocator(allocator)
+        , _renderer(renderer)
         , _trackedImages(allocator, 32)
         , _trackedTextures(allocator, 32)
         , _trackedDepthImages(allocator, 32)
+        , _trackedBuffers(allocator, 32)
+        , _passes(allocator, 32)
+        , _accesses(allocator, 256)
+        , _barriers(allocator, 256)
+        , _outputImages(allocator, 8)
+        , _outputDepthImages(allocator, 8)
+        , _transientImages(allocator, 16)
+        , _transientDepthImages(allocator, 16)
     {
 
     }
 
-    void RenderGraphBuilder::Compile(CommandList* /*commandList*/)
+    void RenderGraphBuilder::BeginPass(u32 passIndex)
     {
+        assert(passIndex == _passes.Count()); // Passes need to be setup in order
+        _currentPass = passIndex;
+        _passes.Insert(PassInfo());
+    }
+
+    void RenderGraphBuilder::EndPass(bool enabled)
+    {
+        _passes[_currentPass].enabled = enabled;
+    }
+
+    void RenderGraphBuilder::AddOutput(ImageID id)
+    {
+        _outputImages.Insert(GetResource(id));
+    }
+
+    void RenderGraphBuilder::AddOutput(DepthImageID id)
+    {
+        _outputDepthImages.Insert(GetResource(id));
+    }
+
+    void RenderGraphBuilder::Compile()
+    {
+        CullPasses();
+        AllocateTransients();
+        CalculateBarriers();
+    }
+
+    bool RenderGraphBuilder::ShouldExecute(u32 passIndex)
+    {
+        const PassInfo& pass = _passes[passIndex];
+        return pass.enabled && !pass.culled;
+    }
+
+    void RenderGraphBuilder::InsertBarriers(u32 passIndex, bool afterPass, u32 frameIndex, CommandList& commandList)
+    {
+        for (ResourceBarrier& barrier : _barriers)
+        {
+            if (barrier.pass != passIndex || barrier.afterPass != afterPass)
+                continue;
+
+            ResourceAccess srcAccess = barrier.srcAccess;
+            if (barrier.crossFrame)
+            {
+                if (!_hasExecuted)
+                {
+                    srcAccess = ResourceAccess::RESOURCE_ACCESS_UNKNOWN;
+                }
+                else if (barrier.firstExecuteOnly)
+                {
+                    continue;
+                }
+            }
+
+            if (barrier.type == RESOURCE_TYPE_IMAGE)
+            {
+                commandList.ImageBarrier(_trackedImages[barrier.resource], srcAccess, barrier.dstAccess);
+            }
+            else if (barrier.type == RESOURCE_TYPE_DEPTH_IMAGE)
+            {
+                commandList.ImageBarrier(_trackedDepthImages[barrier.resource], srcAccess, barrier.dstAccess);
+            }
+            else
+            {
+                commandList.BufferBarrier(_trackedBuffers[barrier.resource]->GetBuffer(frameIndex), srcAccess, barrier.dstAccess);
+            }
+        }
+    }
+
+    void RenderGraphBuilder::CullPasses()
+    {
+        // Without outputs we can't tell what is used, so everything runs
+        if (_outputImages.Count() == 0 && _outputDepthImages.Count() == 0)
+            return;
+
+        // Walk the passes backwards, a resource is live if a later pass (or the output) needs its contents
+        DynamicArray<bool> liveImages(_allocator, _trackedImages.Count());
+        for (size_t i = 0; i < _trackedImages.Count(); i++)
+        {
+            liveImages.Insert(false);
+        }
+        DynamicArray<bool> liveDepthImages(_allocator, _trackedDepthImages.Count());
+        for (size_t i = 0; i < _trackedDepthImages.Count(); i++)
+        {
+            liveDepthImages.Insert(false);
+        }
+        // Buffers can't be outputs and might get read after the graph, so passes writing them never get culled because of it
+        DynamicArray<bool> liveBuffers(_allocator, _trackedBuffers.Count());
+        for (size_t i = 0; i < _trackedBuffers.Count(); i++)
+        {
+            liveBuffers.Insert(true);
+        }
+
+        auto isLive = [&](ResourceAccessInfo& access) -> bool&
+        {
+            if (access.type == RESOURCE_TYPE_IMAGE)
+                return liveImages[access.resource];
+            if (access.type == RESOURCE_TYPE_DEPTH_IMAGE)
+                return liveDepthImages[access.resource];
+
+            return liveBuffers[access.resource];
+        };
+
+        using type = type_safe::underlying_type<RenderPassResource>;
+        for (RenderPassResource& output : _outputImages)
+        {
+            liveImages[static_cast<type>(output)] = true;
+        }
+        for (RenderPassResource& output : _outputDepthImages)
+        {
+            liveDepthImages[static_cast<type>(output)] = true;
+        }
+
+        for (i32 passIndex = static_cast<i32>(_passes.Count()) - 1; passIndex >= 0; passIndex--)
+        {
+            PassInfo& pass = _passes[passIndex];
+            if (!pass.enabled)
+                continue;
+
+            bool hasWrites = false;
+            bool writesLiveResource = false;
+            for (ResourceAccessInfo& access : _accesses)
+            {
+                if (access.pass != static_cast<u32>(passIndex) || !access.isWrite)
+                    continue;
+
+                hasWrites = true;
+                writesLiveResource |= isLive(access);
+            }
+
+            // Passes without writes have side effects we can't see, keep them
+            if (hasWrites && !writesLiveResource)
+            {
+                pass.culled = true;
+                continue;
+            }
+
+            // Clearing or discarding writes don't depend on earlier contents
+            for (ResourceAccessInfo& access : _accesses)
+            {
+                if (access.pass != static_cast<u32>(passIndex) || !access.isWrite || access.loadMode == LOAD_MODE_LOAD)
+                    continue;
+
+                isLive(access) = false;
+            }
+
+            // Reads and loading writes need whatever earlier passes wrote
+            for (ResourceAccessInfo& access : _accesses)
+            {
+                if (access.pass != static_cast<u32>(passIndex) || (access.isWrite && access.loadMode != LOAD_MODE_LOAD))
+                    continue;
+
+                isLive(access) = true;
+            }
+        }
+    }
+
+    void RenderGraphBuilder::AllocateTransients()
+    {
+        struct TransientLifetime
+        {
+            ResourceType type;
+            u32 index; // Index into _transientImages or _transientDepthImages
+            u32 firstPass;
+            u32 lastPass;
+        };
+
+        DynamicArray<TransientLifetime> lifetimes(_allocator, _transientImages.Count() + _transientDepthImages.Count() + 1);
+        auto addLifetime = [&](ResourceType type, u32 index, u16 resource)
+        {
+            TransientLifetime lifetime = { type, index, 0xFFFFFFFF, 0 };
+            for (ResourceAccessInfo& access : _accesses)
+            {
+                if (access.type != type || access.resource != resource || !ShouldExecute(access.pass))
+                    continue;
+
+                lifetime.firstPass = std::min(lifetime.firstPass, access.pass);
+                lifetime.lastPass = std::max(lifetime.lastPass, access.pass);
+            }
+
+            // Transients that only got used by culled passes never need memory
+            if (lifetime.firstPass != 0xFFFFFFFF)
+            {
+                lifetimes.Insert(lifetime);
+            }
+        };
+
+        for (u32 i = 0; i < _transientImages.Count(); i++)
+        {
+            addLifetime(RESOURCE_TYPE_IMAGE, i, _transientImages[i].resource);
+        }
+        for (u32 i = 0; i < _transientDepthImages.Count(); i++)
+        {
+            addLifetime(RESOURCE_TYPE_DEPTH_IMAGE, i, _transientDepthImages[i].resource);
+        }
+
+        if (lifetimes.Count() == 0)
+            return;
+
+        std::sort(&lifetimes[0], &lifetimes[0] + lifetimes.Count(), [](const TransientLifetime& a, const TransientLifetime& b)
+        {
+            return a.firstPass < b.firstPass;
+        });
+
+        // Greedily pack lifetimes into alias slots, a slot can be reused once the previous transient in it is done
+        DynamicArray<u32> slotLastPass(_allocator, lifetimes.Count());
+        for (TransientLifetime& lifetime : lifetimes)
+        {
+            u32 slot = 0;
+            for (; slot < slotLastPass.Count(); slot++)
+            {
+                if (slotLastPass[slot] < lifetime.firstPass)
+                    break;
+            }
+
+            if (slot == slotLastPass.Count())
+            {
+                slotLastPass.Insert(lifetime.lastPass);
+            }
+            else
+            {
+                slotLastPass[slot] = lifetime.lastPass;
+            }
+
+            if (lifetime.type == RESOURCE_TYPE_IMAGE)
+            {
+                TransientImage& transient = _transientImages[lifetime.index];
+                _trackedImages[transient.resource] = _renderer->AcquireTransientImage(transient.desc, slot);
+                transient.acquired = true;
+            }
+            else
+            {
+                TransientDepthImage& transient = _transientDepthImages[lifetime.index];
+                _trackedDepthImages[transient.resource] = _renderer->AcquireTransientDepthImage(transient.desc, slot);
+                transient.acquired = true;
+            }
+        }
+    }
+
+    void RenderGraphBuilder::ReleaseTransients()
+    {
+        for (TransientImage& transient : _transientImages)
+        {
+            if (transient.acquired)
+            {
+                _renderer->ReleaseTransientImage(_trackedImages[transient.resource]);
+                transient.acquired = false;
+            }
+        }
+
+        for (TransientDepthImage& transient : _transientDepthImages)
+        {
+            if (transient.acquired)
+            {
+                _renderer->ReleaseTransientDepthImage(_trackedDepthImages[transient.resource]);
+                transient.acquired = false;
+            }
+        }
+    }
+
+    void RenderGraphBuilder::CalculateBarriers()
+    {
+        struct ResourceState
+        {
+            bool used = false;
+            bool isWrite = false;
+            bool firstIsWrite = false;
+            bool carriesOver = true; // Nothing outside of the graph touches it between executes, so every frame starts how the last one left it
+            ResourceAccess access = ResourceAccess::RESOURCE_ACCESS_UNKNOWN;
+            u32 lastPass = 0;
+            size_t firstBarrier = 0; // Index into _barriers
+        };
+
+        DynamicArray<ResourceState> imageStates(_allocator, _trackedImages.Count());
+        for (size_t i = 0; i < _trackedImages.Count(); i++)
+        {
+            imageStates.Insert(ResourceState());
+        }
+        DynamicArray<ResourceState> depthImageStates(_allocator, _trackedDepthImages.Count());
+        for (size_t i = 0; i < _trackedDepthImages.Count(); i++)
+        {
+            depthImageStates.Insert(ResourceState());
+        }
+        DynamicArray<ResourceState> bufferStates(_allocator, _trackedBuffers.Count());
+        for (size_t i = 0; i < _trackedBuffers.Count(); i++)
+        {
+            bufferStates.Insert(ResourceState());
+        }
+
+        // Transient memory might have belonged to another image, so their first barrier throws away the contents
+        for (TransientImage& transient : _transientImages)
+        {
+            imageStates[transient.resource].access = ResourceAccess::RESOURCE_ACCESS_DISCARD;
+            imageStates[transient.resource].carriesOver = false;
+        }
+        for (TransientDepthImage& transient : _transientDepthImages)
+        {
+            depthImageStates[transient.resource].access = ResourceAccess::RESOURCE_ACCESS_DISCARD;
+            depthImageStates[transient.resource].carriesOver = false;
+        }
+
+        // Outputs get used after the graph (presenting for example), we can't know how that left them
+        using type = type_safe::underlying_type<RenderPassResource>;
+        for (RenderPassResource& output : _outputImages)
+        {
+            imageStates[static_cast<type>(output)].carriesOver = false;
+        }
+        for (RenderPassResource& output : _outputDepthImages)
+        {
+            depthImageStates[static_cast<type>(output)].carriesOver = false;
+        }
+
+        // Accesses are recorded in pass order, so a single forward walk gives us every hazard
+        for (ResourceAccessInfo& access : _accesses)
+        {
+            if (!ShouldExecute(access.pass))
+                continue;
+
+            ResourceState& state = (access.type == RESOURCE_TYPE_IMAGE) ? imageStates[access.resource] : (access.type == RESOURCE_TYPE_DEPTH_IMAGE) ? depthImageStates[access.resource] : bufferStates[access.resource];
+
+            ResourceBarrier barrier;
+            barrier.pass = access.pass;
+            barrier.type = access.type;
+            barrier.resource = access.resource;
+            barrier.srcAccess = state.access;
+            barrier.dstAccess = access.access;
+
+            if (!state.used)
+            {
+                // First use, where it carries over we fill in how the end of the frame leaves it once the walk is done
+                barrier.crossFrame = state.carriesOver;
+                state.firstIsWrite = access.isWrite;
+                state.firstBarrier = _barriers.Count();
+                _barriers.Insert(barrier);
+                state.access = access.access;
+            }
+            else if (state.isWrite || access.isWrite)
+            {
+                // Read-after-write, write-after-write or write-after-read
+                _barriers.Insert(barrier);
+                state.access = access.access;
+            }
+            else if ((state.access & access.access) != access.access)
+            {
+                // Read-after-read from a stage the previous barrier didn't cover
+                barrier.dstAccess = static_cast<ResourceAccess>(state.access | access.access);
+                _barriers.Insert(barrier);
+                state.access = barrier.dstAccess;
+            }
+
+            state.used = true;
+            state.isWrite = access.isWrite;
+            state.lastPass = access.pass;
+        }
+
+        // Depth images rest in their attachment layout between frames, move read-only ones back after their last use
+        for (u16 i = 0; i < depthImageStates.Count(); i++)
+        {
+            ResourceState& state = depthImageStates[i];
+            if (!state.used || state.isWrite)
+                continue;
+
+            ResourceBarrier barrier;
+            barrier.pass = state.lastPass;
+            barrier.afterPass = true;
+            barrier.type = RESOURCE_TYPE_DEPTH_IMAGE;
+            barrier.resource = i;
+            barrier.srcAccess = state.access;
+            barrier.dstAccess = ResourceAccess::RESOURCE_ACCESS_RENDERTARGET;
+            _barriers.Insert(barrier);
+
+            state.access = barrier.dstAccess;
+        }
+
+        // The first barrier of a resource that carries over waits on how the previous frame left it instead of on everything
+        auto carryOver = [&](DynamicArray<ResourceState>& states)
+        {
+            for (ResourceState& state : states)
+            {
+                if (!state.used || !state.carriesOver)
+                    continue;
+
+                ResourceBarrier& barrier = _barriers[state.firstBarrier];
+                barrier.srcAccess = state.access;
+                barrier.firstExecuteOnly = !state.isWrite && !state.firstIsWrite && (state.access & barrier.dstAccess) == barrier.dstAccess;
+            }
+        };
+        carryOver(imageStates);
+        carryOver(depthImageStates);
+        carryOver(bufferStates);
+    }
+
+    void RenderGraphBuilder::TrackAccess(ResourceType type, u16 resource, ResourceAccess access, bool isWrite, LoadMode loadMode)
+    {
+        // Merge multiple accesses to the same resource within a pass
+        for (ResourceAccessInfo& info : _accesses)
+        {
+            if (info.pass == _currentPass && info.type == type && info.resource == resource)
+            {
+                info.access = static_cast<ResourceAccess>(info.access | access);
+                info.isWrite |= isWrite;
+                if (isWrite)
+                {
+                    info.loadMode = loadMode;
+                }
+                return;
+            }
+        }
+
+        ResourceAccessInfo info;
+        info.pass = _currentPass;
+        info.type = type;
+        info.resource = resource;
+        info.access = access;
+        info.isWrite = isWrite;
+        info.loadMode = loadMode;
+        _accesses.Insert(info);
+    }
+
+    static ResourceAccess ToResourceAccess(RenderGraphBuilder::ShaderStage shaderStage)
+    {
+        u32 access = ResourceAccess::RESOURCE_ACCESS_UNKNOWN;
+        if (shaderStage & RenderGraphBuilder::SHADER_STAGE_VERTEX)
+            access |= ResourceAccess::RESOURCE_ACCESS_VERTEX_READ;
+        if (shaderStage & RenderGraphBuilder::SHADER_STAGE_PIXEL)
+            access |= ResourceAccess::RESOURCE_ACCESS_PIXEL_READ;
+        if (shaderStage & RenderGraphBuilder::SHADER_STAGE_COMPUTE)
+            access |= ResourceAccess::RESOURCE_ACCESS_COMPUTE_READ;
+        if (shaderStage & RenderGraphBuilder::SHADER_STAGE_INDIRECT)
+            access |= ResourceAccess::RESOURCE_ACCESS_INDIRECT_READ;
+
+        return static_cast<ResourceAccess>(access);
+    }
+
+    static ResourceAccess ToResourceAccess(RenderGraphBuilder::WriteMode writeMode)
+    {
+        switch (writeMode)
+        {
+            case RenderGraphBuilder::WRITE_MODE_RENDERTARGET: return ResourceAccess::RESOURCE_ACCESS_RENDERTARGET;
+            case RenderGraphBuilder::WRITE_MODE_UAV: return ResourceAccess::RESOURCE_ACCESS_UAV;
+            default:
+                assert(false); // Invalid WriteMode, did we just add a new one?
+        }
 
+        return ResourceAccess::RESOURCE_ACCESS_UNKNOWN;
     }
 
-    ImageID RenderGraphBuilder::Create(ImageDesc& /*desc*/)
+    ImageID RenderGraphBuilder::Create(ImageDesc& desc)
     {
-        return ImageID::Invalid();
+        // Hand out placeholder IDs counting down from the top of the ID range, Compile swaps them for real images
+        using type = type_safe::underlying_type<ImageID>;
+        ImageID placeholder = ImageID(static_cast<type>(ImageID::MaxValue() - 1 - _transientImages.Count()));
+
+        using resourceType = type_safe::underlying_type<RenderPassResource>;
+        TransientImage transient;
+        transient.desc = desc;
+        transient.resource = static_cast<resourceType>(GetResource(placeholder));
+        _transientImages.Insert(transient);
+
+        return placeholder;
     }
 
-    DepthImageID RenderGraphBuilder::Create(DepthImageDesc& /*desc*/)
+    DepthImageID RenderGraphBuilder::Create(DepthImageDesc& desc)
     {
-        return DepthImageID::Invalid();
+        // Hand out placeholder IDs counting down from the top of the ID range, Compile swaps them for real images
+        using type = type_safe::underlying_type<DepthImageID>;
+        DepthImageID placeholder = DepthImageID(static_cast<type>(DepthImageID::MaxValue() - 1 - _transientDepthImages.Count()));
+
+        using resourceType = type_safe::underlying_type<RenderPassResource>;
+        TransientDepthImage transient;
+        transient.desc = desc;
+        transient.resource = static_cast<resourceType>(GetResource(placeholder));
+        _transientDepthImages.Insert(transient);
+
+        return placeholder;
     }
 
-    RenderPassResource RenderGraphBuilder::Read(ImageID id, ShaderStage /*shaderStage*/)
+    RenderPassResource RenderGraphBuilder::Read(ImageID id, ShaderStage shaderStage)
     {
         RenderPassResource resource = GetResource(id);
 
+        using type = type_safe::underlying_type<RenderPassResource>;
+        TrackAccess(RESOURCE_TYPE_IMAGE, static_cast<type>(resource), ToResourceAccess(shaderStage), false, LOAD_MODE_LOAD);
+
         return resource;
     }
 
     RenderPassResource RenderGraphBuilder::Read(TextureID id, ShaderStage /*shaderStage*/)
     {
-        RenderPassResource resource = GetResource(id);
+        RenderPassResource resource = GetResource(id); // Textures are immutable after loading, they don't need barriers
 
         return resource;
     }
 
-    RenderPassResource RenderGraphBuilder::Read(DepthImageID id, ShaderStage /*shaderStage*/)
+    RenderPassResource RenderGraphBuilder::Read(DepthImageID id, ShaderStage shaderStage)
     {
         RenderPassResource resource = GetResource(id);
 
+        using type = type_safe::underlying_type<RenderPassResource>;
+        TrackAccess(RESOURCE_TYPE_DEPTH_IMAGE, static_cast<type>(resource), ToResourceAccess(shaderStage), false, LOAD_MODE_LOAD);
+
+        return resource;
+    }
+
+    RenderPassResource RenderGraphBuilder::Read(Backend::BufferBackend* buffer, ShaderStage shaderStage)
+    {
+        RenderPassResource resource = GetResource(buffer);
+
+        using type = type_safe::underlying_type<RenderPassResource>;
+        TrackAccess(RESOURCE_TYPE_BUFFER, static_cast<type>(resource), ToResourceAccess(shaderStage), false, LOAD_MODE_LOAD);
+
         return resource;
     }
 
-    RenderPassMutableResource RenderGraphBuilder::Write(ImageID id, WriteMode /*writeMode*/, LoadMode /*loadMode*/)
+    RenderPassMutableResource RenderGraphBuilder::Write(ImageID id, WriteMode writeMode, LoadMode loadMode)
     {
         RenderPassMutableResource resource = GetMutableResource(id);
 
+        using type = type_safe::underlying_type<RenderPassMutableResource>;
+        TrackAccess(RESOURCE_TYPE_IMAGE, static_cast<type>(resource), ToResourceAccess(writeMode), true, loadMode);
+
         return resource;
     }
 
-    RenderPassMutableResource RenderGraphBuilder::Write(DepthImageID id, WriteMode /*writeMode*/, LoadMode /*loadMode*/)
+    RenderPassMutableResource RenderGraphBuilder::Write(DepthImageID id, WriteMode writeMode, LoadMode loadMode)
     {
         RenderPassMutableResource resource = GetMutableResource(id);
 
+        using type = type_safe::underlying_type<RenderPassMutableResource>;
+        TrackAccess(RESOURCE_TYPE_DEPTH_IMAGE, static_cast<type>(resource), ToResourceAccess(writeMode), true, loadMode);
+
+        return resource;
+    }
+
+    RenderPassMutableResource RenderGraphBuilder::Write(Backend::BufferBackend* buffer, WriteMode writeMode)
+    {
+        assert(writeMode == WRITE_MODE_UAV); // Buffers can't be rendertargets
+        RenderPassMutableResource resource = GetMutableResource(buffer);
+
+        using type = type_safe::underlying_type<RenderPassMutableResource>;
+        TrackAccess(RESOURCE_TYPE_BUFFER, static_cast<type>(resource), ToResourceAccess(writeMode), true, LOAD_MODE_LOAD);
+
         return resource;
     }
 
@@ -144,6 +652,25 @@ namespace Renderer
         return RenderPassResource(i);
     }
 
+    RenderPassResource RenderGraphBuilder::GetResource(Backend::BufferBackend* buffer)
+    {
+        assert(buffer != nullptr);
+
+        u16 i = 0;
+        for (Backend::BufferBackend* trackedBuffer : _trackedBuffers)
+        {
+            if (trackedBuffer == buffer)
+            {
+                return RenderPassResource(i);
+            }
+
+            i++;
+        }
+
+        _trackedBuffers.Insert(buffer);
+        return RenderPassResource(i);
+    }
+
     RenderPassMutableResource RenderGraphBuilder::GetMutableResource(ImageID id)
     {
         using _type = type_safe::underlying_type<ImageID>;
@@ -181,4 +708,23 @@ namespace Renderer
         _trackedDepthImages.Insert(id);
         return RenderPassMutableResource(i);
     }
+
+    RenderPassMutableResource RenderGraphBuilder::GetMutableResource(Backend::BufferBackend* buffer)
+    {
+        assert(buffer != nullptr);
+
+        u16 i = 0;
+        for (Backend::BufferBackend* trackedBuffer : _trackedBuffers)
+        {
+            if (trackedBuffer == buffer)
+            {
+                return RenderPassMutableResource(i);
+            }
+
+            i++;
+        }
+
+        _trackedBuffers.Insert(buffer);
+        return RenderPassMutableResource(i);
+    }
 }
\ No newline at end of file
@@ -19,6 +19,11 @@ namespace Memory
 
 namespace Renderer
 {
+    namespace Backend
+    {
+        struct BufferBackend;
+    }
+
     class Renderer;
     class CommandList;
     class RenderGraph;
@@ -46,10 +51,11 @@ namespace Renderer
             SHADER_STAGE_NONE = 0,
             SHADER_STAGE_VERTEX = 1,
             SHADER_STAGE_PIXEL = 2,
-            SHADER_STAGE_COMPUTE = 4
+            SHADER_STAGE_COMPUTE = 4,
+            SHADER_STAGE_INDIRECT = 8 // Buffers only, read as arguments by indirect draws and dispatches
         };
 
-        // Create transient resources
+        // Create transient resources, the returned ID is only valid for Read/Write calls during setup, use GetImage/GetDepthImage to resolve it when executing
         ImageID Create(ImageDesc& desc);
         DepthImageID Create(DepthImageDesc& desc);
 
@@ -57,10 +63,12 @@ namespace Renderer
         RenderPassResource Read(ImageID id, ShaderStage shaderStage);
         RenderPassResource Read(TextureID id, ShaderStage shaderStage);
         RenderPassResource Read(DepthImageID id, ShaderStage shaderStage);
+        RenderPassResource Read(Backend::BufferBackend* buffer, ShaderStage shaderStage);
 
         // Writes
         RenderPassMutableResource Write(ImageID id, WriteMode writeMode, LoadMode loadMode);
         RenderPassMutableResource Write(DepthImageID id, WriteMode writeMode, LoadMode loadMode);
+        RenderPassMutableResource Write(Backend::BufferBackend* buffer, WriteMode writeMode); // Buffers can only be written as UAVs
 
         // Render states
         void SetRasterizerState(RasterizerState& rasterizerState) { _rasterizerState = rasterizerState; }
@@ -72,13 +80,78 @@ namespace Renderer
         DepthImageID GetDepthImage(RenderPassMutableResource resource);
 
     private:
-        void Compile(CommandList* commandList);
+        enum ResourceType
+        {
+            RESOURCE_TYPE_IMAGE,
+            RESOURCE_TYPE_DEPTH_IMAGE,
+            RESOURCE_TYPE_BUFFER
+        };
+
+        struct ResourceAccessInfo
+        {
+            u32 pass = 0;
+            ResourceType type = RESOURCE_TYPE_IMAGE;
+            u16 resource = 0;
+            ResourceAccess access = ResourceAccess::RESOURCE_ACCESS_UNKNOWN;
+            bool isWrite = false;
+            LoadMode loadMode = LOAD_MODE_LOAD;
+        };
+
+        struct ResourceBarrier
+        {
+            u32 pass = 0;
+            bool afterPass = false; // Barriers are inserted before the pass executes unless this is set
+            bool crossFrame = false; // srcAccess is how the previous Execute left the resource, the first Execute after compiling doesn't know that
+            bool firstExecuteOnly = false; // A crossFrame read-after-read, once we know the previous state it needs no barrier
+            ResourceType type = RESOURCE_TYPE_IMAGE;
+            u16 resource = 0;
+            ResourceAccess srcAccess = ResourceAccess::RESOURCE_ACCESS_UNKNOWN;
+            ResourceAccess dstAccess = ResourceAccess::RESOURCE_ACCESS_UNKNOWN;
+        };
+
+        struct TransientImage
+        {
+            ImageDesc desc;
+            u16 resource = 0;
+            bool acquired = false; // Transients of culled passes never get acquired
+        };
+
+        struct TransientDepthImage
+        {
+            DepthImageDesc desc;
+            u16 resource = 0;
+            bool acquired = false; // Transients of culled passes never get acquired
+        };
+
+        struct PassInfo
+        {
+            bool enabled = false; // Setup returned true
+            bool culled = false; // Nothing uses what this pass writes
+        };
+
+        // These get friend-called from RenderGraph
+        void BeginPass(u32 passIndex);
+        void EndPass(bool enabled);
+        void AddOutput(ImageID id);
+        void AddOutput(DepthImageID id);
+        void Compile();
+        bool ShouldExecute(u32 passIndex);
+        void InsertBarriers(u32 passIndex, bool afterPass, u32 frameIndex, CommandList& commandList);
+        void MarkExecuted() { _hasExecuted = true; }
+
+        void CullPasses();
+        void AllocateTransients();
+        void ReleaseTransients(); // Hands the transient images back to the backend, call it before the builder gets thrown away
+        void CalculateBarriers();
+        void TrackAccess(ResourceType type, u16 resource, ResourceAccess access, bool isWrite, LoadMode loadMode);
         
         RenderPassResource GetResource(ImageID id);
         RenderPassResource GetResource(TextureID id);
         RenderPassResource GetResource(DepthImageID id);
+        RenderPassResource GetResource(Backend::BufferBackend* buffer);
         RenderPassMutableResource GetMutableResource(ImageID id);
         RenderPassMutableResource GetMutableResource(DepthImageID id);
+        RenderPassMutableResource GetMutableResource(Backend::BufferBackend* buffer);
 
     private:
         Memory::Allocator* _allocator;
@@ -89,5 +162,18 @@ namespace Renderer
         DynamicArray<ImageID> _trackedImages;
         DynamicArray<TextureID> _trackedTextures;
         DynamicArray<DepthImageID> _trackedDepthImages;
+        DynamicArray<Backend::BufferBackend*> _trackedBuffers;
+
+        u32 _currentPass = 0;
+        DynamicArray<PassInfo> _passes;
+        DynamicArray<ResourceAccessInfo> _accesses;
+        DynamicArray<ResourceBarrier> _barriers;
+        DynamicArray<RenderPassResource> _outputImages;
+        DynamicArray<RenderPassResource> _outputDepthImages;
+        DynamicArray<TransientImage> _transientImages;
+        DynamicArray<TransientDepthImage> _transientDepthImages;
+        bool _hasExecuted = false; // Until then we don't know how the last frame left our resources
+
+        friend class RenderGraph;
     };
 }
\ No newline at end of file
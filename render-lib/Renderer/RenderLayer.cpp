@@ -1,6 +1,135 @@
 #include "RenderLayer.h"
+#include <Memory/StackAllocator.h>
+#include <cstring>
+#include <utility>
 
 namespace Renderer
 {
+    void RenderLayer::RegisterModel(ModelID modelID, InstanceData* instanceData, u16 pipeline, u8 pass)
+    {
+        // The material is the model for now, models with the same ID share buffers and textures
+        u16 material = static_cast<_ModelID>(modelID);
 
-}
\ No newline at end of file
+        DrawCall drawCall;
+        drawCall.sortKey = (static_cast<u64>(pass) << PASS_SHIFT) | (static_cast<u64>(pipeline) << PIPELINE_SHIFT) | (static_cast<u64>(material) << MATERIAL_SHIFT);
+        drawCall.modelID = modelID;
+        drawCall.instanceData = instanceData;
+
+        DynamicArray<DrawCall>& drawCalls = GetDrawCalls();
+        if (drawCalls.Count() == _capacity)
+        {
+            // Outgrew this frame's array, move to one twice as big, the old one gets reclaimed with the rest of the frame
+            _capacity *= 2;
+            DynamicArray<DrawCall>* grownDrawCalls = AllocateDrawCalls(_capacity);
+            for (DrawCall& oldDrawCall : drawCalls)
+            {
+                grownDrawCalls->Insert(oldDrawCall);
+            }
+            _drawCalls = grownDrawCalls;
+        }
+
+        _drawCalls->Insert(drawCall);
+    }
+
+    void RenderLayer::Reset(Memory::Allocator* frameAllocator)
+    {
+        assert(frameAllocator != nullptr);
+
+        if (_drawCalls != nullptr)
+        {
+            _lastFrameCount = _drawCalls->Count();
+        }
+
+        // The old array lived in the frame allocator, its owner already reclaimed it so we just forget about it
+        _frameAllocator = frameAllocator;
+        _drawCalls = nullptr;
+        _capacity = 0;
+    }
+
+    DynamicArray<RenderLayer::DrawCall>& RenderLayer::GetDrawCalls()
+    {
+        if (_drawCalls == nullptr)
+        {
+            size_t capacity = _lastFrameCount + _lastFrameCount / 4;
+            _capacity = capacity < MIN_CAPACITY ? MIN_CAPACITY : capacity;
+            _drawCalls = AllocateDrawCalls(_capacity);
+        }
+
+        return *_drawCalls;
+    }
+
+    DynamicArray<RenderLayer::DrawCall>* RenderLayer::AllocateDrawCalls(size_t capacity)
+    {
+        assert(_frameAllocator != nullptr); // Reset needs to be called with the frame allocator before registering models each frame
+
+        return Memory::Allocator::New<DynamicArray<DrawCall>>(_frameAllocator, _frameAllocator, capacity);
+    }
+
+    void RenderLayer::Sort(const vec3& cameraPosition)
+    {
+        DynamicArray<DrawCall>& drawCalls = GetDrawCalls();
+
+        const size_t numDrawCalls = drawCalls.Count();
+        if (numDrawCalls < 2)
+            return;
+
+        for (DrawCall& drawCall : drawCalls)
+        {
+            const mat4x4& modelMatrix = drawCall.instanceData->modelMatrix;
+            f32 x = modelMatrix[3].x - cameraPosition.x;
+            f32 y = modelMatrix[3].y - cameraPosition.y;
+            f32 z = modelMatrix[3].z - cameraPosition.z;
+            f32 distanceSquared = x * x + y * y + z * z;
+
+            // Positive floats sort the same as their bit patterns, keep the top 24 bits below the sign bit
+            u32 distanceBits;
+            memcpy(&distanceBits, &distanceSquared, sizeof(u32));
+            u64 depth = (distanceBits >> 7) & DEPTH_MASK;
+
+            drawCall.sortKey = (drawCall.sortKey & ~DEPTH_MASK) | depth;
+        }
+
+        // LSD radix sort, one byte per pass, the scratch array gets filled up front so it has the right count if the result ends up in it
+        DynamicArray<DrawCall>* sortScratch = AllocateDrawCalls(_capacity);
+        for (DrawCall& drawCall : drawCalls)
+        {
+            sortScratch->Insert(drawCall);
+        }
+
+        DrawCall* src = &drawCalls[0];
+        DrawCall* dst = &(*sortScratch)[0];
+
+        for (u32 shift = 0; shift < 64; shift += 8)
+        {
+            size_t counts[256] = { 0 };
+            for (size_t i = 0; i < numDrawCalls; i++)
+            {
+                counts[(src[i].sortKey >> shift) & 0xFF]++;
+            }
+
+            // Every key has the same byte here, this pass wouldn't move anything
+            if (counts[(src[0].sortKey >> shift) & 0xFF] == numDrawCalls)
+                continue;
+
+            size_t offset = 0;
+            for (size_t i = 0; i < 256; i++)
+            {
+                size_t count = counts[i];
+                counts[i] = offset;
+                offset += count;
+            }
+
+            for (size_t i = 0; i < numDrawCalls; i++)
+            {
+                dst[counts[(src[i].sortKey >> shift) & 0xFF]++] = src[i];
+            }
+
+            std::swap(src, dst);
+        }
+
+        if (src != &drawCalls[0])
+        {
+            _drawCalls = sortScratch;
+        }
+    }
+}
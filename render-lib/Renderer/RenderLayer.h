@@ -1,45 +1,58 @@
 #pragma once
 #include <NovusTypes.h>
-#include <vector>
-#include <robin_hood.h>
-#include <unordered_map>
+#include <Containers/DynamicArray.h>
 #include "InstanceData.h"
 #include "Descriptors/ModelDesc.h"
 
+namespace Memory
+{
+    class Allocator;
+}
+
 namespace Renderer
 {
-    // A RenderLayer is just a collection of models to be drawn at certain positions
+    // A RenderLayer is just a collection of models to be drawn at certain positions, sorted to minimize state changes
+    // The drawcalls live in a flat array in the frame allocator, so registering is an append and resetting is free
     class RenderLayer
     {
     public:
-        typedef std::vector<InstanceData*> Instances;
         typedef type_safe::underlying_type<ModelID> _ModelID;
 
-        void RegisterModel(ModelID modelID, InstanceData* instanceData) { _models[static_cast<_ModelID>(modelID)].push_back(instanceData); }
-        void Reset() 
+        // Sort keys sort ascending by pass, then pipeline, then material and last front-to-back depth
+        // | pass 8 bits | pipeline 16 bits | material 16 bits | depth 24 bits |
+        struct DrawCall
         {
-            for (auto& model : _models)
-            {
-                model.second.clear();
-            }
+            u64 sortKey = 0;
+            ModelID modelID = ModelID::Invalid();
+            InstanceData* instanceData = nullptr;
+        };
+
+        void RegisterModel(ModelID modelID, InstanceData* instanceData, u16 pipeline = 0, u8 pass = 0);
+
+        // Drops this frame's drawcalls, the frameAllocator has to be reset by its owner before it gets passed in again
+        void Reset(Memory::Allocator* frameAllocator);
 
-            _models.clear(); 
-        }
+        // Fills in the depth part of the keys and radix sorts the drawcalls, call this after everything for the frame has been registered
+        void Sort(const vec3& cameraPosition);
 
-        //robin_hood::unordered_map<_ModelID, Instances>& GetModels() { return _models; }
-        robin_hood::unordered_map<_ModelID, Instances>& GetModels() { return _models; }
+        DynamicArray<DrawCall>& GetDrawCalls();
 
         RenderLayer() {}
-        ~RenderLayer()
-        {
-            Reset();
-        }
 
     private:
-        
+        DynamicArray<DrawCall>* AllocateDrawCalls(size_t capacity);
+
+    private:
+        static constexpr size_t MIN_CAPACITY = 256;
+        static constexpr u64 PASS_SHIFT = 56;
+        static constexpr u64 PIPELINE_SHIFT = 40;
+        static constexpr u64 MATERIAL_SHIFT = 24;
+        static constexpr u64 DEPTH_MASK = 0xFFFFFF;
 
     private:
-        robin_hood::unordered_map<_ModelID, Instances> _models;
-        //std::unordered_map<_ModelID, Instances> _models;
+        Memory::Allocator* _frameAllocator = nullptr;
+        DynamicArray<DrawCall>* _drawCalls = nullptr;
+        size_t _capacity = 0;
+        size_t _lastFrameCount = 0; // Used to size the next frame's array so it doesn't need to grow
     };
-}
\ No newline at end of file
+}
@@ -30,8 +30,8 @@ namespace Renderer
         typedef std::function<void(PassData&, CommandList&)> ExecuteFunction;
     
         RenderPass(std::string& name, SetupFunction onSetup, ExecuteFunction onExecute)
-            : _onSetup(onSetup)
-            , _onExecute(onExecute)
+            : _onSetup(std::move(onSetup))
+            , _onExecute(std::move(onExecute))
         {
             if (name.length() >= 16)
             {
@@ -2,10 +2,12 @@
 #include <NovusTypes.h>
 #include <Utils/DebugHandler.h>
 #include <cassert>
+#include <cstring>
 
 namespace Renderer
 {
     static const int MAX_RENDER_TARGETS = 8;
+    static const int MAX_PUSH_CONSTANT_SIZE = 128; // The smallest maxPushConstantsSize Vulkan guarantees
 
     enum FillMode
     {
@@ -203,6 +205,28 @@ namespace Renderer
         ShaderVisibility shaderVisibility = SHADER_VISIBILITY_ALL;
     };
 
+    struct PushConstantRange
+    {
+        bool enabled = false;
+        ShaderVisibility shaderVisibility = SHADER_VISIBILITY_ALL;
+        u32 offset = 0; // In bytes, needs to be a multiple of 4
+        u32 size = 0; // In bytes, needs to be a multiple of 4
+    };
+
+    // Lets one shader file cover several permutations, the driver compiles the branches a constant disables away
+    struct SpecializationConstant
+    {
+        bool enabled = false;
+        ShaderVisibility shaderVisibility = SHADER_VISIBILITY_ALL;
+        u32 constantID = 0; // Matches layout(constant_id = X) in the shader
+        u32 value = 0; // The raw 32 bits of the constant, use SetValue so floats and bools end up in the right format
+
+        void SetValue(u32 newValue) { value = newValue; }
+        void SetValue(i32 newValue) { memcpy(&value, &newValue, sizeof(u32)); }
+        void SetValue(f32 newValue) { memcpy(&value, &newValue, sizeof(u32)); }
+        void SetValue(bool newValue) { value = newValue ? 1 : 0; } // Shaders read bool constants as a VkBool32
+    };
+
     enum InputFormat
     {
         INPUT_FORMAT_UNKNOWN,
@@ -278,6 +302,19 @@ namespace Renderer
         DEPTH_CLEAR_BOTH
     };
 
+    // How a pass accesses an image or buffer, these are flags and can be combined
+    enum ResourceAccess
+    {
+        RESOURCE_ACCESS_UNKNOWN = 0, // We don't know how it was last used, synchronize against everything
+        RESOURCE_ACCESS_RENDERTARGET = 1,
+        RESOURCE_ACCESS_UAV = 2,
+        RESOURCE_ACCESS_VERTEX_READ = 4,
+        RESOURCE_ACCESS_PIXEL_READ = 8,
+        RESOURCE_ACCESS_COMPUTE_READ = 16,
+        RESOURCE_ACCESS_DISCARD = 32, // Like UNKNOWN but the contents are thrown away, used when aliased memory changes owner
+        RESOURCE_ACCESS_INDIRECT_READ = 64 // Buffers only, read as arguments by indirect draws and dispatches
+    };
+
     struct Viewport
     {
         f32 topLeftX = 0;
@@ -5,18 +5,53 @@ namespace Renderer
     Renderer::~Renderer()
     {
         _renderLayers.clear();
+        delete _instanceBuffer;
     }
 
-    RenderGraph Renderer::CreateRenderGraph(RenderGraphDesc& desc)
+    RenderGraph* Renderer::CreateRenderGraph(RenderGraphDesc& desc)
     {
-        RenderGraph renderGraph(desc.allocator, this);
-        renderGraph.Init(desc);
+        RenderGraph* renderGraph = new RenderGraph(desc.allocator, this);
+        renderGraph->Init(desc);
 
         return renderGraph;
     }
 
     RenderLayer& Renderer::GetRenderLayer(u32 layerHash)
     {
-        return _renderLayers[layerHash];
+        std::scoped_lock lock(_renderLayersMutex);
+
+        auto it = _renderLayers.find(layerHash);
+        if (it != _renderLayers.end())
+            return it->second;
+
+        // Layers created in the middle of a frame still need this frame's allocator
+        RenderLayer& renderLayer = _renderLayers[layerHash];
+        if (_renderLayerAllocator != nullptr)
+        {
+            renderLayer.Reset(_renderLayerAllocator);
+        }
+
+        return renderLayer;
+    }
+
+    void Renderer::ResetRenderLayers(Memory::Allocator* frameAllocator)
+    {
+        _renderLayerAllocator = frameAllocator;
+
+        for (auto& renderLayer : _renderLayers)
+        {
+            renderLayer.second.Reset(frameAllocator);
+        }
+    }
+
+    InstanceBuffer* Renderer::GetInstanceBuffer()
+    {
+        // This can't be created in the constructor since the backend has to be ready to create buffers
+        if (_instanceBuffer == nullptr)
+        {
+            _instanceBuffer = new InstanceBuffer(this);
+        }
+
+        return _instanceBuffer;
     }
 }
\ No newline at end of file
@@ -2,12 +2,14 @@
 #include <NovusTypes.h>
 #include <Utils/StringUtils.h>
 #include <robin_hood.h>
+#include <mutex>
 #include "RenderGraph.h"
 #include "RenderGraphBuilder.h"
 #include "RenderLayer.h"
 #include "RenderPass.h"
 #include "ConstantBuffer.h"
 #include "StorageBuffer.h"
+#include "InstanceBuffer.h"
 #include "RenderStates.h"
 #include "Font.h"
 
@@ -37,32 +39,49 @@ namespace Renderer
 
         virtual ~Renderer();
 
-        RenderGraph CreateRenderGraph(RenderGraphDesc& desc);
+        RenderGraph* CreateRenderGraph(RenderGraphDesc& desc);
         RenderLayer& GetRenderLayer(u32 layerHash);
+        void ResetRenderLayers(Memory::Allocator* frameAllocator); // Call this once per frame after resetting the frameAllocator, before anything registers models
+        InstanceBuffer* GetInstanceBuffer();
 
         // Creation
         virtual ImageID CreateImage(ImageDesc& desc) = 0;
         virtual DepthImageID CreateDepthImage(DepthImageDesc& desc) = 0;
 
+        // Transient images are owned by the backend, images that share an alias slot may share memory
+        virtual ImageID AcquireTransientImage(ImageDesc& desc, u32 aliasSlot) = 0;
+        virtual DepthImageID AcquireTransientDepthImage(DepthImageDesc& desc, u32 aliasSlot) = 0;
+        // Every acquire needs a release, the backend frees transient images a while after the last release
+        virtual void ReleaseTransientImage(ImageID image) = 0;
+        virtual void ReleaseTransientDepthImage(DepthImageID image) = 0;
+
         virtual SamplerID CreateSampler(SamplerDesc& sampler) = 0;
 
         virtual GraphicsPipelineID CreatePipeline(GraphicsPipelineDesc& desc) = 0;
         virtual ComputePipelineID CreatePipeline(ComputePipelineDesc& desc) = 0;
 
         template <typename T>
-        ConstantBuffer<T>* CreateConstantBuffer()
+        ConstantBuffer<T>* CreateConstantBuffer(Backend::BufferBackend::Usage usage = Backend::BufferBackend::USAGE_DYNAMIC)
         {
             ConstantBuffer<T>* buffer = new ConstantBuffer<T>();
-            buffer->backend = CreateBufferBackend(buffer->GetSize(), Backend::BufferBackend::TYPE_CONSTANT_BUFFER);
+            buffer->usage = usage;
+            buffer->backend = CreateBufferBackend(buffer->GetSize(), Backend::BufferBackend::TYPE_CONSTANT_BUFFER, usage);
 
             return buffer;
         }
 
+        // Runtime sized buffers, use a BufferRangeAllocator to hand out ranges of them
+        Backend::BufferBackend* CreateBuffer(size_t size, Backend::BufferBackend::Type type, Backend::BufferBackend::Usage usage = Backend::BufferBackend::USAGE_DYNAMIC)
+        {
+            return CreateBufferBackend(size, type, usage);
+        }
+
         template <typename T>
-        StorageBuffer<T>* CreateStorageBuffer()
+        StorageBuffer<T>* CreateStorageBuffer(Backend::BufferBackend::Usage usage = Backend::BufferBackend::USAGE_DYNAMIC)
         {
             StorageBuffer<T>* buffer = new StorageBuffer<T>();
-            buffer->backend = CreateBufferBackend(buffer->GetSize(), Backend::BufferBackend::TYPE_STORAGE_BUFFER);
+            buffer->usage = usage;
+            buffer->backend = CreateBufferBackend(buffer->GetSize(), Backend::BufferBackend::TYPE_STORAGE_BUFFER, usage);
 
             return buffer;
         }
@@ -85,14 +104,56 @@ namespace Renderer
         virtual PixelShaderID LoadShader(PixelShaderDesc& desc) = 0;
         virtual ComputeShaderID LoadShader(ComputeShaderDesc& desc) = 0;
 
+        // Destruction, the IDs can be reused right away but the backend keeps the resources alive until the frames that used them have retired
+        virtual void DestroyImage(ImageID image) = 0; // Graphics pipelines rendering to the image get destroyed with it
+        virtual void DestroyDepthImage(DepthImageID image) = 0;
+
+        virtual void DestroySampler(SamplerID sampler) = 0;
+
+        virtual void DestroyPipeline(GraphicsPipelineID pipeline) = 0;
+        virtual void DestroyPipeline(ComputePipelineID pipeline) = 0;
+
+        template <typename T>
+        void DestroyConstantBuffer(ConstantBuffer<T>* buffer)
+        {
+            DestroyBufferBackend(buffer->backend);
+            delete buffer;
+        }
+
+        void DestroyBuffer(Backend::BufferBackend* buffer)
+        {
+            DestroyBufferBackend(buffer);
+        }
+
+        template <typename T>
+        void DestroyStorageBuffer(StorageBuffer<T>* buffer)
+        {
+            DestroyBufferBackend(buffer->backend);
+            delete buffer;
+        }
+
+        virtual void DestroyModel(ModelID model) = 0;
+
+        virtual void DestroyTexture(TextureID texture) = 0; // Texture array slots holding it fall back to the debug texture
+        virtual void DestroyTextureArray(TextureArrayID textureArray) = 0; // The textures in the array are not destroyed
+
         // Command List Functions
         virtual CommandListID BeginCommandList() = 0;
         virtual void EndCommandList(CommandListID commandList) = 0;
         virtual void Clear(CommandListID commandList, ImageID image, Color color) = 0;
         virtual void Clear(CommandListID commandList, DepthImageID image, DepthClearFlags clearFlags, f32 depth, u8 stencil) = 0;
-        virtual void Draw(CommandListID commandList, ModelID modelID) = 0;
+        virtual void ImageBarrier(CommandListID commandList, ImageID image, ResourceAccess srcAccess, ResourceAccess dstAccess) = 0;
+        virtual void ImageBarrier(CommandListID commandList, DepthImageID image, ResourceAccess srcAccess, ResourceAccess dstAccess) = 0;
+        virtual void BufferBarrier(CommandListID commandList, void* buffer, ResourceAccess srcAccess, ResourceAccess dstAccess) = 0;
+        virtual void Draw(CommandListID commandList, ModelID modelID, u32 baseInstance, u32 numInstances) = 0;
         virtual void DrawBindless(CommandListID commandList, u32 numVertices, u32 numInstances) = 0;
         virtual void DrawIndexedBindless(CommandListID commandList, ModelID modelID, u32 numVertices, u32 numInstances) = 0;
+        virtual void DrawIndirect(CommandListID commandList, void* argumentBuffer, u32 argumentBufferOffset, u32 drawCount) = 0;
+        virtual void DrawIndexedIndirect(CommandListID commandList, ModelID modelID, void* argumentBuffer, u32 argumentBufferOffset, u32 drawCount) = 0;
+        virtual void DrawIndirectCount(CommandListID commandList, void* argumentBuffer, u32 argumentBufferOffset, void* drawCountBuffer, u32 drawCountBufferOffset, u32 maxDrawCount) = 0;
+        virtual void DrawIndexedIndirectCount(CommandListID commandList, ModelID modelID, void* argumentBuffer, u32 argumentBufferOffset, void* drawCountBuffer, u32 drawCountBufferOffset, u32 maxDrawCount) = 0;
+        virtual void Dispatch(CommandListID commandList, u32 threadGroupCountX, u32 threadGroupCountY, u32 threadGroupCountZ) = 0;
+        virtual void DispatchIndirect(CommandListID commandList, void* argumentBuffer, u32 argumentBufferOffset) = 0;
         virtual void PopMarker(CommandListID commandList) = 0;
         virtual void PushMarker(CommandListID commandList, Color color, std::string name) = 0;
         virtual void SetConstantBuffer(CommandListID commandListID, u32 slot, void* descriptor, size_t frameIndex) = 0;
@@ -105,9 +166,11 @@ namespace Renderer
         virtual void SetSampler(CommandListID commandList, u32 slot, SamplerID sampler) = 0;
         virtual void SetTexture(CommandListID commandList, u32 slot, TextureID texture) = 0;
         virtual void SetTextureArray(CommandListID commandList, u32 slot, TextureArrayID textureArray) = 0;
+        virtual void SetStorageImage(CommandListID commandList, u32 slot, ImageID image) = 0;
         virtual void SetVertexBuffer(CommandListID commandList, u32 slot, ModelID modelID) = 0;
         virtual void SetIndexBuffer(CommandListID commandList, ModelID modelID) = 0;
         virtual void SetBuffer(CommandListID commandList, u32 slot, void* buffer) = 0;
+        virtual void PushConstant(CommandListID commandList, const void* data, u32 offset, u32 size) = 0;
 
         // Non-commandlist based present functions
         virtual void Present(Window* window, ImageID image) = 0;
@@ -116,9 +179,14 @@ namespace Renderer
     protected:
         Renderer() {}; // Pure virtual class, disallow creation of it
 
-        virtual Backend::BufferBackend* CreateBufferBackend(size_t size, Backend::BufferBackend::Type type) = 0;
+        virtual Backend::BufferBackend* CreateBufferBackend(size_t size, Backend::BufferBackend::Type type, Backend::BufferBackend::Usage usage) = 0;
+        virtual void DestroyBufferBackend(Backend::BufferBackend* buffer) = 0;
 
     protected:
         robin_hood::unordered_map<u32, RenderLayer> _renderLayers;
+        std::mutex _renderLayersMutex; // RenderGraph passes execute in parallel and look up their layers
+        std::mutex _creationMutex; // RenderGraph passes execute in parallel and create their pipelines and shaders the first time they run
+        Memory::Allocator* _renderLayerAllocator = nullptr;
+        InstanceBuffer* _instanceBuffer = nullptr;
     };
 }
\ No newline at end of file
@@ -0,0 +1,46 @@
+#include "BufferBackendNull.h"
+#include <cassert>
+#include <cstring>
+
+namespace Renderer
+{
+    namespace Backend
+    {
+        void BufferBackendNull::Apply(u32 frameIndex, void* srcData, size_t size)
+        {
+            ApplyRange(frameIndex, 0, srcData, size);
+        }
+
+        void BufferBackendNull::ApplyRange(u32 frameIndex, size_t offset, void* srcData, size_t size)
+        {
+            assert(frameIndex < FRAMES_IN_FLIGHT); // We only have FRAMES_IN_FLIGHT frames worth of data
+            assert(offset + size <= bufferSize); // Don't write past the end of the buffer
+
+            memcpy(data[GetCopyIndex(frameIndex)].data() + offset, srcData, size);
+        }
+
+        void* BufferBackendNull::GetDescriptor(u32 /*frameIndex*/)
+        {
+            // There are no descriptors without a GPU, but the pointer still needs to identify the buffer
+            return this;
+        }
+
+        void* BufferBackendNull::GetBuffer(u32 frameIndex)
+        {
+            return data[GetCopyIndex(frameIndex)].data();
+        }
+
+        void* BufferBackendNull::GetMappedData(u32 frameIndex)
+        {
+            assert(usage == BufferBackend::Usage::USAGE_DYNAMIC); // Static buffers are not host visible on the GPU backends, so they can't be here either
+            return data[frameIndex].data();
+        }
+
+        void BufferBackendNull::Flush(u32 /*frameIndex*/, size_t offset, size_t size)
+        {
+            // System memory is always coherent, but we still catch flushes the GPU backends would reject
+            assert(usage == BufferBackend::Usage::USAGE_DYNAMIC);
+            assert(offset + size <= bufferSize);
+        }
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <NovusTypes.h>
+#include <vector>
+#include "../../BufferBackend.h"
+#include "../../FrameResource.h"
+
+namespace Renderer
+{
+    namespace Backend
+    {
+        // Keeps the buffer contents in system memory, this lets us run everything without a GPU
+        struct BufferBackendNull : public BufferBackend
+        {
+            BufferBackendNull(size_t size, BufferBackend::Type bufferType, BufferBackend::Usage bufferUsage)
+                : bufferSize(size)
+                , type(bufferType)
+                , usage(bufferUsage)
+            {
+                // Static buffers share the first copy between frames, like they do on the GPU
+                u32 numCopies = (usage == BufferBackend::Usage::USAGE_STATIC) ? 1 : FRAMES_IN_FLIGHT;
+                for (u32 i = 0; i < numCopies; i++)
+                {
+                    data[i].resize(size);
+                }
+            }
+
+            std::vector<u8> data[FRAMES_IN_FLIGHT];
+
+            size_t bufferSize;
+            BufferBackend::Type type;
+            BufferBackend::Usage usage;
+        private:
+            void Apply(u32 frameIndex, void* srcData, size_t size) override;
+            void ApplyRange(u32 frameIndex, size_t offset, void* srcData, size_t size) override;
+
+            void* GetDescriptor(u32 frameIndex) override;
+            void* GetBuffer(u32 frameIndex) override;
+
+            void* GetMappedData(u32 frameIndex) override;
+            void Flush(u32 frameIndex, size_t offset, size_t size) override;
+
+            u32 GetCopyIndex(u32 frameIndex) { return (usage == BufferBackend::Usage::USAGE_STATIC) ? 0 : frameIndex; }
+        };
+    }
+}
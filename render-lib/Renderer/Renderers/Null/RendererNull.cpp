@@ -0,0 +1,715 @@
+#include "RendererNull.h"
+#include <Utils/DebugHandler.h>
+#include <Utils/XXHash64.h>
+#include "BufferBackendNull.h"
+
+namespace Renderer
+{
+    // Drops cache entries pointing at a destroyed ID, so loading the same thing again creates a new one
+    template <typename ID>
+    void EraseCachedID(robin_hood::unordered_map<u64, ID>& cache, ID id)
+    {
+        for (auto it = cache.begin(); it != cache.end();)
+        {
+            if (it->second == id)
+            {
+                it = cache.erase(it);
+            }
+            else
+            {
+                it++;
+            }
+        }
+    }
+
+    RendererNull::RendererNull()
+    {
+
+    }
+
+    void RendererNull::InitWindow(Window* /*window*/)
+    {
+        // There is no swapchain to create, Present only ends the frame
+    }
+
+    void RendererNull::Deinit()
+    {
+        _commandLists.clear();
+        _availableCommandLists = std::queue<CommandListID>();
+    }
+
+    ImageID RendererNull::CreateImage(ImageDesc& desc)
+    {
+        using type = type_safe::underlying_type<ImageID>;
+
+        size_t nextID = _images.size();
+        assert(nextID < ImageID::MaxValue()); // Same limit as the real backends
+
+        _images.push_back(desc);
+        return ImageID(static_cast<type>(nextID));
+    }
+
+    DepthImageID RendererNull::CreateDepthImage(DepthImageDesc& desc)
+    {
+        using type = type_safe::underlying_type<DepthImageID>;
+
+        size_t nextID = _depthImages.size();
+        assert(nextID < DepthImageID::MaxValue()); // Same limit as the real backends
+
+        _depthImages.push_back(desc);
+        return DepthImageID(static_cast<type>(nextID));
+    }
+
+    ImageID RendererNull::AcquireTransientImage(ImageDesc& desc, u32 aliasSlot)
+    {
+        u64 hashData[5] = { static_cast<u64>(desc.dimensions.x), static_cast<u64>(desc.dimensions.y), desc.depth, static_cast<u64>(desc.format) << 32 | desc.sampleCount, aliasSlot };
+        u64 hash = XXHash64::hash(hashData, sizeof(hashData), 0);
+
+        auto it = _transientImages.find(hash);
+        if (it != _transientImages.end())
+            return it->second;
+
+        ImageID id = CreateImage(desc);
+        _transientImages[hash] = id;
+
+        return id;
+    }
+
+    DepthImageID RendererNull::AcquireTransientDepthImage(DepthImageDesc& desc, u32 aliasSlot)
+    {
+        u64 hashData[4] = { static_cast<u64>(desc.dimensions.x), static_cast<u64>(desc.dimensions.y), static_cast<u64>(desc.format) << 32 | desc.sampleCount, aliasSlot };
+        u64 hash = XXHash64::hash(hashData, sizeof(hashData), 0);
+
+        auto it = _transientDepthImages.find(hash);
+        if (it != _transientDepthImages.end())
+            return it->second;
+
+        DepthImageID id = CreateDepthImage(desc);
+        _transientDepthImages[hash] = id;
+
+        return id;
+    }
+
+    void RendererNull::ReleaseTransientImage(ImageID image)
+    {
+        // There is no memory behind the transient images here, so they stay cached
+        assert(static_cast<type_safe::underlying_type<ImageID>>(image) < _images.size()); // Releasing an image that was never created
+    }
+
+    void RendererNull::ReleaseTransientDepthImage(DepthImageID image)
+    {
+        assert(static_cast<type_safe::underlying_type<DepthImageID>>(image) < _depthImages.size()); // Releasing an image that was never created
+    }
+
+    SamplerID RendererNull::CreateSampler(SamplerDesc& desc)
+    {
+        using type = type_safe::underlying_type<SamplerID>;
+
+        size_t nextID = _samplers.size();
+        assert(nextID < SamplerID::MaxValue()); // Same limit as the real backends
+
+        _samplers.push_back(desc);
+        return SamplerID(static_cast<type>(nextID));
+    }
+
+    GraphicsPipelineID RendererNull::CreatePipeline(GraphicsPipelineDesc& desc)
+    {
+        std::scoped_lock lock(_creationMutex);
+
+        using type = type_safe::underlying_type<GraphicsPipelineID>;
+
+        assert(desc.MutableResourceToImageID != nullptr); // You need to bind this function pointer before creating pipeline, maybe use RenderGraph::InitializePipelineDesc?
+        assert(desc.MutableResourceToDepthImageID != nullptr); // You need to bind this function pointer before creating pipeline, maybe use RenderGraph::InitializePipelineDesc?
+
+        // Hash the same things the Vulkan backend caches pipelines on, so the number of pipelines matches
+        struct CacheDesc
+        {
+            GraphicsPipelineDesc::States states;
+            ImageID renderTargets[MAX_RENDER_TARGETS];
+            DepthImageID depthStencil = DepthImageID::Invalid();
+        };
+
+        CacheDesc cacheDesc;
+        memset(&cacheDesc, 0, sizeof(cacheDesc));
+        cacheDesc.states = desc.states;
+
+        for (int i = 0; i < MAX_RENDER_TARGETS; i++)
+        {
+            cacheDesc.renderTargets[i] = ImageID::Invalid();
+            if (desc.renderTargets[i] == RenderPassMutableResource::Invalid())
+                continue;
+
+            cacheDesc.renderTargets[i] = desc.MutableResourceToImageID(desc.renderTargets[i]);
+        }
+
+        cacheDesc.depthStencil = DepthImageID::Invalid();
+        if (desc.depthStencil != RenderPassMutableResource::Invalid())
+        {
+            cacheDesc.depthStencil = desc.MutableResourceToDepthImageID(desc.depthStencil);
+        }
+
+        u64 hash = XXHash64::hash(&cacheDesc, sizeof(cacheDesc), 0);
+
+        auto it = _graphicsPipelines.find(hash);
+        if (it != _graphicsPipelines.end())
+            return it->second;
+
+        assert(_numGraphicsPipelines < GraphicsPipelineID::MaxValue()); // Same limit as the real backends
+
+        GraphicsPipelineID id = GraphicsPipelineID(static_cast<type>(_numGraphicsPipelines++));
+        _graphicsPipelines[hash] = id;
+
+        return id;
+    }
+
+    ComputePipelineID RendererNull::CreatePipeline(ComputePipelineDesc& desc)
+    {
+        std::scoped_lock lock(_creationMutex);
+
+        using type = type_safe::underlying_type<ComputePipelineID>;
+
+        assert(desc.computeShader != ComputeShaderID::Invalid()); // A compute pipeline needs a compute shader
+
+        // The Vulkan backend caches compute pipelines on the whole desc
+        u64 hash = XXHash64::hash(&desc, sizeof(desc), 0);
+
+        auto it = _computePipelines.find(hash);
+        if (it != _computePipelines.end())
+            return it->second;
+
+        assert(_numComputePipelines < ComputePipelineID::MaxValue()); // Same limit as the real backends
+
+        ComputePipelineID id = ComputePipelineID(static_cast<type>(_numComputePipelines++));
+        _computePipelines[hash] = id;
+
+        return id;
+    }
+
+    ModelID RendererNull::CreatePrimitiveModel(PrimitiveModelDesc& /*desc*/)
+    {
+        using type = type_safe::underlying_type<ModelID>;
+
+        assert(_numModels < ModelID::MaxValue()); // Same limit as the real backends
+        return ModelID(static_cast<type>(_numModels++));
+    }
+
+    void RendererNull::UpdatePrimitiveModel(ModelID modelID, PrimitiveModelDesc& /*desc*/)
+    {
+        assert(static_cast<type_safe::underlying_type<ModelID>>(modelID) < _numModels); // Trying to update a model that was never created
+    }
+
+    TextureArrayID RendererNull::CreateTextureArray(TextureArrayDesc& desc)
+    {
+        using type = type_safe::underlying_type<TextureArrayID>;
+
+        assert(desc.size > 0);
+
+        size_t nextID = _textureArrays.size();
+        assert(nextID < TextureArrayID::MaxValue()); // Same limit as the real backends
+
+        TextureArray& array = _textureArrays.emplace_back();
+        array.size = desc.size;
+        return TextureArrayID(static_cast<type>(nextID));
+    }
+
+    TextureID RendererNull::CreateDataTexture(DataTextureDesc& desc)
+    {
+        using type = type_safe::underlying_type<TextureID>;
+
+        // We own the data like the real backends do, there is nothing to upload so it goes right away
+        delete[] desc.data;
+        desc.data = nullptr;
+
+        assert(_numTextures < TextureID::MaxValue()); // Same limit as the real backends
+        return TextureID(static_cast<type>(_numTextures++));
+    }
+
+    TextureID RendererNull::CreateDataTextureIntoArray(DataTextureDesc& desc, TextureArrayID textureArray, u32& arrayIndex)
+    {
+        TextureID texture = CreateDataTexture(desc);
+        arrayIndex = AddToTextureArray(textureArray, texture);
+        return texture;
+    }
+
+    ModelID RendererNull::LoadModel(ModelDesc& /*desc*/)
+    {
+        // ModelHandlerVK loads the file again every time, so every call gets a new model
+        PrimitiveModelDesc primitiveDesc;
+        return CreatePrimitiveModel(primitiveDesc);
+    }
+
+    TextureID RendererNull::LoadTexture(TextureDesc& desc)
+    {
+        u64 hash = HashPath(desc.path);
+
+        auto it = _loadedTextures.find(hash);
+        if (it != _loadedTextures.end())
+            return it->second;
+
+        DataTextureDesc dataDesc;
+        TextureID id = CreateDataTexture(dataDesc);
+        _loadedTextures[hash] = id;
+
+        return id;
+    }
+
+    TextureID RendererNull::LoadTextureIntoArray(TextureDesc& desc, TextureArrayID textureArray, u32& arrayIndex)
+    {
+        TextureID texture = LoadTexture(desc);
+        arrayIndex = AddToTextureArray(textureArray, texture);
+        return texture;
+    }
+
+    void RendererNull::DestroyImage(ImageID image)
+    {
+        assert(static_cast<type_safe::underlying_type<ImageID>>(image) < _images.size()); // Trying to destroy an image that was never created
+
+        for (auto& transientImage : _transientImages)
+        {
+            if (transientImage.second == image)
+            {
+                NC_LOG_FATAL("Tried to destroy transient image (%s), transient images are owned by the backend", _images[static_cast<type_safe::underlying_type<ImageID>>(image)].debugName.c_str());
+            }
+        }
+    }
+
+    void RendererNull::DestroyDepthImage(DepthImageID image)
+    {
+        assert(static_cast<type_safe::underlying_type<DepthImageID>>(image) < _depthImages.size()); // Trying to destroy a depth image that was never created
+
+        for (auto& transientImage : _transientDepthImages)
+        {
+            if (transientImage.second == image)
+            {
+                NC_LOG_FATAL("Tried to destroy transient depth image (%s), transient images are owned by the backend", _depthImages[static_cast<type_safe::underlying_type<DepthImageID>>(image)].debugName.c_str());
+            }
+        }
+    }
+
+    void RendererNull::DestroySampler(SamplerID sampler)
+    {
+        assert(static_cast<type_safe::underlying_type<SamplerID>>(sampler) < _samplers.size()); // Trying to destroy a sampler that was never created
+    }
+
+    void RendererNull::DestroyPipeline(GraphicsPipelineID pipeline)
+    {
+        assert(static_cast<type_safe::underlying_type<GraphicsPipelineID>>(pipeline) < _numGraphicsPipelines); // Trying to destroy a pipeline that was never created
+        EraseCachedID(_graphicsPipelines, pipeline);
+    }
+
+    void RendererNull::DestroyPipeline(ComputePipelineID pipeline)
+    {
+        assert(static_cast<type_safe::underlying_type<ComputePipelineID>>(pipeline) < _numComputePipelines); // Trying to destroy a pipeline that was never created
+        EraseCachedID(_computePipelines, pipeline);
+    }
+
+    void RendererNull::DestroyModel(ModelID model)
+    {
+        assert(static_cast<type_safe::underlying_type<ModelID>>(model) < _numModels); // Trying to destroy a model that was never created
+    }
+
+    void RendererNull::DestroyTexture(TextureID texture)
+    {
+        assert(static_cast<type_safe::underlying_type<TextureID>>(texture) < _numTextures); // Trying to destroy a texture that was never created
+        EraseCachedID(_loadedTextures, texture);
+
+        // Free up the array slots holding it
+        for (TextureArray& array : _textureArrays)
+        {
+            for (TextureID& arrayTexture : array.textures)
+            {
+                if (arrayTexture == texture)
+                {
+                    arrayTexture = TextureID::Invalid();
+                }
+            }
+        }
+    }
+
+    void RendererNull::DestroyTextureArray(TextureArrayID textureArray)
+    {
+        assert(static_cast<type_safe::underlying_type<TextureArrayID>>(textureArray) < _textureArrays.size()); // Trying to destroy a texture array that was never created
+    }
+
+    VertexShaderID RendererNull::LoadShader(VertexShaderDesc& desc)
+    {
+        std::scoped_lock lock(_creationMutex);
+
+        using type = type_safe::underlying_type<VertexShaderID>;
+        u64 hash = HashPath(desc.path);
+
+        auto it = _vertexShaders.find(hash);
+        if (it != _vertexShaders.end())
+            return it->second;
+
+        size_t nextID = _vertexShaders.size();
+        assert(nextID < VertexShaderID::MaxValue()); // Same limit as the real backends
+
+        VertexShaderID id = VertexShaderID(static_cast<type>(nextID));
+        _vertexShaders[hash] = id;
+
+        return id;
+    }
+
+    PixelShaderID RendererNull::LoadShader(PixelShaderDesc& desc)
+    {
+        std::scoped_lock lock(_creationMutex);
+
+        using type = type_safe::underlying_type<PixelShaderID>;
+        u64 hash = HashPath(desc.path);
+
+        auto it = _pixelShaders.find(hash);
+        if (it != _pixelShaders.end())
+            return it->second;
+
+        size_t nextID = _pixelShaders.size();
+        assert(nextID < PixelShaderID::MaxValue()); // Same limit as the real backends
+
+        PixelShaderID id = PixelShaderID(static_cast<type>(nextID));
+        _pixelShaders[hash] = id;
+
+        return id;
+    }
+
+    ComputeShaderID RendererNull::LoadShader(ComputeShaderDesc& desc)
+    {
+        std::scoped_lock lock(_creationMutex);
+
+        using type = type_safe::underlying_type<ComputeShaderID>;
+        u64 hash = HashPath(desc.path);
+
+        auto it = _computeShaders.find(hash);
+        if (it != _computeShaders.end())
+            return it->second;
+
+        size_t nextID = _computeShaders.size();
+        assert(nextID < ComputeShaderID::MaxValue()); // Same limit as the real backends
+
+        ComputeShaderID id = ComputeShaderID(static_cast<type>(nextID));
+        _computeShaders[hash] = id;
+
+        return id;
+    }
+
+    CommandListID RendererNull::BeginCommandList()
+    {
+        using type = type_safe::underlying_type<CommandListID>;
+
+        CommandListID id;
+        if (!_availableCommandLists.empty())
+        {
+            id = _availableCommandLists.front();
+            _availableCommandLists.pop();
+        }
+        else
+        {
+            size_t nextID = _commandLists.size();
+            assert(nextID < CommandListID::MaxValue()); // Same limit as the real backends
+
+            id = CommandListID(static_cast<type>(nextID));
+            _commandLists.emplace_back();
+        }
+
+        RecordedCommandList& commandList = _commandLists[static_cast<type>(id)];
+        commandList.commands.clear();
+        commandList.isRecording = true;
+        commandList.openPipelines = 0;
+
+        return id;
+    }
+
+    void RendererNull::EndCommandList(CommandListID commandListID)
+    {
+        using type = type_safe::underlying_type<CommandListID>;
+        assert(static_cast<type>(commandListID) < _commandLists.size());
+
+        RecordedCommandList& commandList = _commandLists[static_cast<type>(commandListID)];
+        assert(commandList.isRecording); // Ending a commandlist that was never begun
+        assert(commandList.openPipelines == 0); // Every BeginPipeline needs a matching EndPipeline before the commandlist ends
+
+        // Submission order is the order the lists end in, just like the real backend
+        _frameCommands.insert(_frameCommands.end(), commandList.commands.begin(), commandList.commands.end());
+        _frameStats.numCommandLists++;
+
+        commandList.isRecording = false;
+        _availableCommandLists.push(commandListID);
+    }
+
+    void RendererNull::Clear(CommandListID commandListID, ImageID image, Color /*color*/)
+    {
+        Record(commandListID, RECORDED_COMMAND_CLEAR_IMAGE, 0, static_cast<type_safe::underlying_type<ImageID>>(image));
+    }
+
+    void RendererNull::Clear(CommandListID commandListID, DepthImageID image, DepthClearFlags /*clearFlags*/, f32 /*depth*/, u8 /*stencil*/)
+    {
+        Record(commandListID, RECORDED_COMMAND_CLEAR_DEPTH_IMAGE, 0, static_cast<type_safe::underlying_type<DepthImageID>>(image));
+    }
+
+    void RendererNull::ImageBarrier(CommandListID commandListID, ImageID image, ResourceAccess srcAccess, ResourceAccess dstAccess)
+    {
+        Record(commandListID, RECORDED_COMMAND_IMAGE_BARRIER, static_cast<u32>(srcAccess) << 16 | dstAccess, static_cast<type_safe::underlying_type<ImageID>>(image));
+    }
+
+    void RendererNull::ImageBarrier(CommandListID commandListID, DepthImageID image, ResourceAccess srcAccess, ResourceAccess dstAccess)
+    {
+        Record(commandListID, RECORDED_COMMAND_DEPTH_IMAGE_BARRIER, static_cast<u32>(srcAccess) << 16 | dstAccess, static_cast<type_safe::underlying_type<DepthImageID>>(image));
+    }
+
+    void RendererNull::BufferBarrier(CommandListID commandListID, void* buffer, ResourceAccess srcAccess, ResourceAccess dstAccess)
+    {
+        Record(commandListID, RECORDED_COMMAND_BUFFER_BARRIER, static_cast<u32>(srcAccess) << 16 | dstAccess, reinterpret_cast<u64>(buffer));
+    }
+
+    void RendererNull::Draw(CommandListID commandListID, ModelID modelID, u32 /*baseInstance*/, u32 numInstances)
+    {
+        Record(commandListID, RECORDED_COMMAND_DRAW, numInstances, static_cast<type_safe::underlying_type<ModelID>>(modelID));
+    }
+
+    void RendererNull::DrawBindless(CommandListID commandListID, u32 numVertices, u32 numInstances)
+    {
+        Record(commandListID, RECORDED_COMMAND_DRAW_BINDLESS, numInstances, numVertices);
+    }
+
+    void RendererNull::DrawIndexedBindless(CommandListID commandListID, ModelID /*modelID*/, u32 numVertices, u32 numInstances)
+    {
+        Record(commandListID, RECORDED_COMMAND_DRAW_INDEXED_BINDLESS, numInstances, numVertices);
+    }
+
+    void RendererNull::DrawIndirect(CommandListID commandListID, void* argumentBuffer, u32 /*argumentBufferOffset*/, u32 drawCount)
+    {
+        Record(commandListID, RECORDED_COMMAND_DRAW_INDIRECT, drawCount, reinterpret_cast<u64>(argumentBuffer));
+    }
+
+    void RendererNull::DrawIndexedIndirect(CommandListID commandListID, ModelID /*modelID*/, void* argumentBuffer, u32 /*argumentBufferOffset*/, u32 drawCount)
+    {
+        Record(commandListID, RECORDED_COMMAND_DRAW_INDEXED_INDIRECT, drawCount, reinterpret_cast<u64>(argumentBuffer));
+    }
+
+    void RendererNull::DrawIndirectCount(CommandListID commandListID, void* argumentBuffer, u32 /*argumentBufferOffset*/, void* /*drawCountBuffer*/, u32 /*drawCountBufferOffset*/, u32 maxDrawCount)
+    {
+        Record(commandListID, RECORDED_COMMAND_DRAW_INDIRECT_COUNT, maxDrawCount, reinterpret_cast<u64>(argumentBuffer));
+    }
+
+    void RendererNull::DrawIndexedIndirectCount(CommandListID commandListID, ModelID /*modelID*/, void* argumentBuffer, u32 /*argumentBufferOffset*/, void* /*drawCountBuffer*/, u32 /*drawCountBufferOffset*/, u32 maxDrawCount)
+    {
+        Record(commandListID, RECORDED_COMMAND_DRAW_INDEXED_INDIRECT_COUNT, maxDrawCount, reinterpret_cast<u64>(argumentBuffer));
+    }
+
+    void RendererNull::Dispatch(CommandListID commandListID, u32 threadGroupCountX, u32 threadGroupCountY, u32 threadGroupCountZ)
+    {
+        Record(commandListID, RECORDED_COMMAND_DISPATCH, 0, static_cast<u64>(threadGroupCountX) * threadGroupCountY * threadGroupCountZ);
+    }
+
+    void RendererNull::DispatchIndirect(CommandListID commandListID, void* argumentBuffer, u32 /*argumentBufferOffset*/)
+    {
+        Record(commandListID, RECORDED_COMMAND_DISPATCH_INDIRECT, 0, reinterpret_cast<u64>(argumentBuffer));
+    }
+
+    void RendererNull::PopMarker(CommandListID commandListID)
+    {
+        Record(commandListID, RECORDED_COMMAND_POP_MARKER, 0, 0);
+    }
+
+    void RendererNull::PushMarker(CommandListID commandListID, Color /*color*/, std::string /*name*/)
+    {
+        Record(commandListID, RECORDED_COMMAND_PUSH_MARKER, 0, 0);
+    }
+
+    void RendererNull::SetConstantBuffer(CommandListID commandListID, u32 slot, void* descriptor, size_t /*frameIndex*/)
+    {
+        Record(commandListID, RECORDED_COMMAND_SET_CONSTANT_BUFFER, slot, reinterpret_cast<u64>(descriptor));
+    }
+
+    void RendererNull::SetStorageBuffer(CommandListID commandListID, u32 slot, void* descriptor, size_t /*frameIndex*/)
+    {
+        Record(commandListID, RECORDED_COMMAND_SET_STORAGE_BUFFER, slot, reinterpret_cast<u64>(descriptor));
+    }
+
+    void RendererNull::BeginPipeline(CommandListID commandListID, GraphicsPipelineID pipeline)
+    {
+        Record(commandListID, RECORDED_COMMAND_BEGIN_PIPELINE, 0, static_cast<type_safe::underlying_type<GraphicsPipelineID>>(pipeline));
+        _commandLists[static_cast<type_safe::underlying_type<CommandListID>>(commandListID)].openPipelines++;
+    }
+
+    void RendererNull::EndPipeline(CommandListID commandListID, GraphicsPipelineID pipeline)
+    {
+        Record(commandListID, RECORDED_COMMAND_END_PIPELINE, 0, static_cast<type_safe::underlying_type<GraphicsPipelineID>>(pipeline));
+
+        RecordedCommandList& commandList = _commandLists[static_cast<type_safe::underlying_type<CommandListID>>(commandListID)];
+        assert(commandList.openPipelines > 0); // EndPipeline without a matching BeginPipeline
+        commandList.openPipelines--;
+    }
+
+    void RendererNull::SetPipeline(CommandListID commandListID, ComputePipelineID pipeline)
+    {
+        assert(_commandLists[static_cast<type_safe::underlying_type<CommandListID>>(commandListID)].openPipelines == 0); // Compute pipelines can't be set between BeginPipeline and EndPipeline
+        Record(commandListID, RECORDED_COMMAND_SET_COMPUTE_PIPELINE, 0, static_cast<type_safe::underlying_type<ComputePipelineID>>(pipeline));
+    }
+
+    void RendererNull::SetScissorRect(CommandListID commandListID, ScissorRect /*scissorRect*/)
+    {
+        Record(commandListID, RECORDED_COMMAND_SET_SCISSOR_RECT, 0, 0);
+    }
+
+    void RendererNull::SetViewport(CommandListID commandListID, Viewport /*viewport*/)
+    {
+        Record(commandListID, RECORDED_COMMAND_SET_VIEWPORT, 0, 0);
+    }
+
+    void RendererNull::SetSampler(CommandListID commandListID, u32 slot, SamplerID samplerID)
+    {
+        Record(commandListID, RECORDED_COMMAND_SET_SAMPLER, slot, static_cast<type_safe::underlying_type<SamplerID>>(samplerID));
+    }
+
+    void RendererNull::SetTexture(CommandListID commandListID, u32 slot, TextureID texture)
+    {
+        Record(commandListID, RECORDED_COMMAND_SET_TEXTURE, slot, static_cast<type_safe::underlying_type<TextureID>>(texture));
+    }
+
+    void RendererNull::SetTextureArray(CommandListID commandListID, u32 slot, TextureArrayID textureArray)
+    {
+        Record(commandListID, RECORDED_COMMAND_SET_TEXTURE_ARRAY, slot, static_cast<type_safe::underlying_type<TextureArrayID>>(textureArray));
+    }
+
+    void RendererNull::SetStorageImage(CommandListID commandListID, u32 slot, ImageID image)
+    {
+        assert(static_cast<type_safe::underlying_type<ImageID>>(image) < _images.size()); // Binding an image that was never created
+        assert(_images[static_cast<type_safe::underlying_type<ImageID>>(image)].sampleCount == SAMPLE_COUNT_1); // Multisampled images can't be bound as storage images
+        Record(commandListID, RECORDED_COMMAND_SET_STORAGE_IMAGE, slot, static_cast<type_safe::underlying_type<ImageID>>(image));
+    }
+
+    void RendererNull::SetVertexBuffer(CommandListID commandListID, u32 slot, ModelID modelID)
+    {
+        Record(commandListID, RECORDED_COMMAND_SET_VERTEX_BUFFER, slot, static_cast<type_safe::underlying_type<ModelID>>(modelID));
+    }
+
+    void RendererNull::SetIndexBuffer(CommandListID commandListID, ModelID modelID)
+    {
+        Record(commandListID, RECORDED_COMMAND_SET_INDEX_BUFFER, 0, static_cast<type_safe::underlying_type<ModelID>>(modelID));
+    }
+
+    void RendererNull::SetBuffer(CommandListID commandListID, u32 slot, void* buffer)
+    {
+        Record(commandListID, RECORDED_COMMAND_SET_BUFFER, slot, reinterpret_cast<u64>(buffer));
+    }
+
+    void RendererNull::PushConstant(CommandListID commandListID, const void* data, u32 offset, u32 size)
+    {
+        assert(data != nullptr);
+        assert(offset + size <= MAX_PUSH_CONSTANT_SIZE); // Push constants are limited to MAX_PUSH_CONSTANT_SIZE bytes
+        Record(commandListID, RECORDED_COMMAND_PUSH_CONSTANT, offset, size);
+    }
+
+    void RendererNull::Present(Window* /*window*/, ImageID image)
+    {
+        assert(static_cast<type_safe::underlying_type<ImageID>>(image) < _images.size()); // Presenting an image that was never created
+        EndFrame();
+    }
+
+    void RendererNull::Present(Window* /*window*/, DepthImageID image)
+    {
+        assert(static_cast<type_safe::underlying_type<DepthImageID>>(image) < _depthImages.size()); // Presenting an image that was never created
+        EndFrame();
+    }
+
+    Backend::BufferBackend* RendererNull::CreateBufferBackend(size_t size, Backend::BufferBackend::Type type, Backend::BufferBackend::Usage usage)
+    {
+        return new Backend::BufferBackendNull(size, type, usage);
+    }
+
+    void RendererNull::DestroyBufferBackend(Backend::BufferBackend* buffer)
+    {
+        delete buffer;
+    }
+
+    void RendererNull::Record(CommandListID commandListID, RecordedCommandType type, u32 slot, u64 value)
+    {
+        using idType = type_safe::underlying_type<CommandListID>;
+        assert(static_cast<idType>(commandListID) < _commandLists.size());
+
+        RecordedCommandList& commandList = _commandLists[static_cast<idType>(commandListID)];
+        assert(commandList.isRecording); // Recording into a commandlist that was never begun
+
+        RecordedCommand& command = commandList.commands.emplace_back();
+        command.type = type;
+        command.slot = slot;
+        command.value = value;
+    }
+
+    void RendererNull::EndFrame()
+    {
+        for (RecordedCommand& command : _frameCommands)
+        {
+            _frameStats.commandCounts[command.type]++;
+
+            if (command.type == RECORDED_COMMAND_DRAW)
+            {
+                _frameStats.numDrawCalls++;
+                _frameStats.numInstances += command.slot;
+            }
+            else if (command.type == RECORDED_COMMAND_DRAW_BINDLESS || command.type == RECORDED_COMMAND_DRAW_INDEXED_BINDLESS)
+            {
+                _frameStats.numDrawCalls++;
+                _frameStats.numVertices += command.value * command.slot;
+                _frameStats.numInstances += command.slot;
+            }
+            else if (command.type >= RECORDED_COMMAND_DRAW_INDIRECT && command.type <= RECORDED_COMMAND_DRAW_INDEXED_INDIRECT_COUNT)
+            {
+                // The arguments live in a buffer we never read, so only the submission gets counted
+                _frameStats.numDrawCalls++;
+            }
+            else if (command.type == RECORDED_COMMAND_DISPATCH || command.type == RECORDED_COMMAND_DISPATCH_INDIRECT)
+            {
+                _frameStats.numDispatches++;
+            }
+        }
+        _frameStats.numCommands = static_cast<u32>(_frameCommands.size());
+
+        _lastFrameStats = _frameStats;
+        _frameStats = FrameStats();
+
+        // Swap instead of copy so both vectors keep their capacity between frames
+        std::swap(_lastFrameCommands, _frameCommands);
+        _frameCommands.clear();
+
+        _frameCount++;
+    }
+
+    u32 RendererNull::AddToTextureArray(TextureArrayID textureArray, TextureID texture)
+    {
+        using type = type_safe::underlying_type<TextureArrayID>;
+        assert(static_cast<type>(textureArray) < _textureArrays.size());
+
+        TextureArray& array = _textureArrays[static_cast<type>(textureArray)];
+
+        // Loaded textures are cached, so loading one again gets its old slot back
+        for (u32 arrayIndex = 0; arrayIndex < array.textures.size(); arrayIndex++)
+        {
+            if (array.textures[arrayIndex] == texture)
+                return arrayIndex;
+        }
+
+        for (u32 arrayIndex = 0; arrayIndex < array.textures.size(); arrayIndex++)
+        {
+            if (array.textures[arrayIndex] == TextureID::Invalid())
+            {
+                array.textures[arrayIndex] = texture;
+                return arrayIndex;
+            }
+        }
+
+        u32 arrayIndex = static_cast<u32>(array.textures.size());
+        if (arrayIndex >= array.size)
+        {
+            NC_LOG_FATAL("Texture array is full, it only has %u slots", array.size);
+        }
+
+        array.textures.push_back(texture);
+        return arrayIndex;
+    }
+
+    u64 RendererNull::HashPath(const std::string& path)
+    {
+        return XXHash64::hash(path.c_str(), path.length(), 0);
+    }
+}
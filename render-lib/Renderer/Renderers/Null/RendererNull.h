@@ -0,0 +1,215 @@
+#pragma once
+#include "../../Renderer.h"
+#include <queue>
+
+namespace Renderer
+{
+    // A renderer that never touches a GPU, it hands out IDs, tracks resources and records what the commandlists would have done
+    class RendererNull : public Renderer
+    {
+    public:
+        enum RecordedCommandType : u8
+        {
+            RECORDED_COMMAND_CLEAR_IMAGE,
+            RECORDED_COMMAND_CLEAR_DEPTH_IMAGE,
+            RECORDED_COMMAND_IMAGE_BARRIER,
+            RECORDED_COMMAND_DEPTH_IMAGE_BARRIER,
+            RECORDED_COMMAND_DRAW,
+            RECORDED_COMMAND_DRAW_BINDLESS,
+            RECORDED_COMMAND_DRAW_INDEXED_BINDLESS,
+            RECORDED_COMMAND_DRAW_INDIRECT,
+            RECORDED_COMMAND_DRAW_INDEXED_INDIRECT,
+            RECORDED_COMMAND_DRAW_INDIRECT_COUNT,
+            RECORDED_COMMAND_DRAW_INDEXED_INDIRECT_COUNT,
+            RECORDED_COMMAND_PUSH_MARKER,
+            RECORDED_COMMAND_POP_MARKER,
+            RECORDED_COMMAND_SET_CONSTANT_BUFFER,
+            RECORDED_COMMAND_SET_STORAGE_BUFFER,
+            RECORDED_COMMAND_BEGIN_PIPELINE,
+            RECORDED_COMMAND_END_PIPELINE,
+            RECORDED_COMMAND_SET_COMPUTE_PIPELINE,
+            RECORDED_COMMAND_SET_SCISSOR_RECT,
+            RECORDED_COMMAND_SET_VIEWPORT,
+            RECORDED_COMMAND_SET_SAMPLER,
+            RECORDED_COMMAND_SET_TEXTURE,
+            RECORDED_COMMAND_SET_TEXTURE_ARRAY,
+            RECORDED_COMMAND_SET_VERTEX_BUFFER,
+            RECORDED_COMMAND_SET_INDEX_BUFFER,
+            RECORDED_COMMAND_SET_BUFFER,
+            RECORDED_COMMAND_PUSH_CONSTANT,
+            RECORDED_COMMAND_BUFFER_BARRIER,
+            RECORDED_COMMAND_SET_STORAGE_IMAGE,
+            RECORDED_COMMAND_DISPATCH,
+            RECORDED_COMMAND_DISPATCH_INDIRECT,
+
+            RECORDED_COMMAND_COUNT
+        };
+
+        struct RecordedCommand
+        {
+            RecordedCommandType type;
+            u32 slot = 0;
+            u64 value = 0; // The ID, pointer or count the command was called with
+        };
+
+        struct FrameStats
+        {
+            u32 numCommandLists = 0;
+            u32 numCommands = 0;
+            u32 numDrawCalls = 0;
+            u32 numDispatches = 0;
+            u64 numVertices = 0;
+            u64 numInstances = 0;
+            u32 commandCounts[RECORDED_COMMAND_COUNT] = {};
+        };
+
+        RendererNull();
+
+        void InitWindow(Window* window) override;
+        void Deinit() override;
+
+        // Creation
+        ImageID CreateImage(ImageDesc& desc) override;
+        DepthImageID CreateDepthImage(DepthImageDesc& desc) override;
+
+        ImageID AcquireTransientImage(ImageDesc& desc, u32 aliasSlot) override;
+        DepthImageID AcquireTransientDepthImage(DepthImageDesc& desc, u32 aliasSlot) override;
+        void ReleaseTransientImage(ImageID image) override;
+        void ReleaseTransientDepthImage(DepthImageID image) override;
+
+        SamplerID CreateSampler(SamplerDesc& desc) override;
+
+        GraphicsPipelineID CreatePipeline(GraphicsPipelineDesc& desc) override;
+        ComputePipelineID CreatePipeline(ComputePipelineDesc& desc) override;
+
+        ModelID CreatePrimitiveModel(PrimitiveModelDesc& desc) override;
+        void UpdatePrimitiveModel(ModelID modelID, PrimitiveModelDesc& desc) override;
+
+        TextureArrayID CreateTextureArray(TextureArrayDesc& desc) override;
+
+        TextureID CreateDataTexture(DataTextureDesc& desc) override;
+        TextureID CreateDataTextureIntoArray(DataTextureDesc& desc, TextureArrayID textureArray, u32& arrayIndex) override;
+
+        // Loading
+        ModelID LoadModel(ModelDesc& desc) override;
+
+        TextureID LoadTexture(TextureDesc& desc) override;
+        TextureID LoadTextureIntoArray(TextureDesc& desc, TextureArrayID textureArray, u32& arrayIndex) override;
+
+        VertexShaderID LoadShader(VertexShaderDesc& desc) override;
+        PixelShaderID LoadShader(PixelShaderDesc& desc) override;
+        ComputeShaderID LoadShader(ComputeShaderDesc& desc) override;
+
+        // Destruction, nothing is ever in flight so resources go away right away
+        void DestroyImage(ImageID image) override;
+        void DestroyDepthImage(DepthImageID image) override;
+
+        void DestroySampler(SamplerID sampler) override;
+
+        void DestroyPipeline(GraphicsPipelineID pipeline) override;
+        void DestroyPipeline(ComputePipelineID pipeline) override;
+
+        void DestroyModel(ModelID model) override;
+
+        void DestroyTexture(TextureID texture) override;
+        void DestroyTextureArray(TextureArrayID textureArray) override;
+
+        // Command List Functions
+        CommandListID BeginCommandList() override;
+        void EndCommandList(CommandListID commandListID) override;
+        void Clear(CommandListID commandListID, ImageID image, Color color) override;
+        void Clear(CommandListID commandListID, DepthImageID image, DepthClearFlags clearFlags, f32 depth, u8 stencil) override;
+        void ImageBarrier(CommandListID commandListID, ImageID image, ResourceAccess srcAccess, ResourceAccess dstAccess) override;
+        void ImageBarrier(CommandListID commandListID, DepthImageID image, ResourceAccess srcAccess, ResourceAccess dstAccess) override;
+        void BufferBarrier(CommandListID commandListID, void* buffer, ResourceAccess srcAccess, ResourceAccess dstAccess) override;
+        void Draw(CommandListID commandListID, ModelID modelID, u32 baseInstance, u32 numInstances) override;
+        void DrawBindless(CommandListID commandList, u32 numVertices, u32 numInstances) override;
+        void DrawIndexedBindless(CommandListID commandList, ModelID modelID, u32 numVertices, u32 numInstances) override;
+        void DrawIndirect(CommandListID commandList, void* argumentBuffer, u32 argumentBufferOffset, u32 drawCount) override;
+        void DrawIndexedIndirect(CommandListID commandList, ModelID modelID, void* argumentBuffer, u32 argumentBufferOffset, u32 drawCount) override;
+        void DrawIndirectCount(CommandListID commandList, void* argumentBuffer, u32 argumentBufferOffset, void* drawCountBuffer, u32 drawCountBufferOffset, u32 maxDrawCount) override;
+        void DrawIndexedIndirectCount(CommandListID commandList, ModelID modelID, void* argumentBuffer, u32 argumentBufferOffset, void* drawCountBuffer, u32 drawCountBufferOffset, u32 maxDrawCount) override;
+        void Dispatch(CommandListID commandListID, u32 threadGroupCountX, u32 threadGroupCountY, u32 threadGroupCountZ) override;
+        void DispatchIndirect(CommandListID commandListID, void* argumentBuffer, u32 argumentBufferOffset) override;
+        void PopMarker(CommandListID commandListID) override;
+        void PushMarker(CommandListID commandListID, Color color, std::string name) override;
+        void SetConstantBuffer(CommandListID commandListID, u32 slot, void* descriptor, size_t frameIndex) override;
+        void SetStorageBuffer(CommandListID commandListID, u32 slot, void* descriptor, size_t frameIndex) override;
+        void BeginPipeline(CommandListID commandListID, GraphicsPipelineID pipeline) override;
+        void EndPipeline(CommandListID commandListID, GraphicsPipelineID pipeline) override;
+        void SetPipeline(CommandListID commandListID, ComputePipelineID pipeline) override;
+        void SetScissorRect(CommandListID commandListID, ScissorRect scissorRect) override;
+        void SetViewport(CommandListID commandListID, Viewport viewport) override;
+        void SetSampler(CommandListID commandListID, u32 slot, SamplerID samplerID) override;
+        void SetTexture(CommandListID commandList, u32 slot, TextureID texture) override;
+        void SetTextureArray(CommandListID commandList, u32 slot, TextureArrayID textureArray) override;
+        void SetStorageImage(CommandListID commandListID, u32 slot, ImageID image) override;
+        void SetVertexBuffer(CommandListID commandList, u32 slot, ModelID modelID) override;
+        void SetIndexBuffer(CommandListID commandList, ModelID modelID) override;
+        void SetBuffer(CommandListID commandList, u32 slot, void* buffer) override;
+        void PushConstant(CommandListID commandList, const void* data, u32 offset, u32 size) override;
+
+        // Non-commandlist based present functions
+        void Present(Window* window, ImageID image) override;
+        void Present(Window* window, DepthImageID image) override;
+
+        // Inspection, these are only valid after Present has been called
+        const FrameStats& GetLastFrameStats() { return _lastFrameStats; }
+        const std::vector<RecordedCommand>& GetLastFrameCommands() { return _lastFrameCommands; }
+        u32 GetFrameCount() { return _frameCount; }
+
+    protected:
+        Backend::BufferBackend* CreateBufferBackend(size_t size, Backend::BufferBackend::Type type, Backend::BufferBackend::Usage usage) override;
+        void DestroyBufferBackend(Backend::BufferBackend* buffer) override;
+
+    private:
+        struct RecordedCommandList
+        {
+            std::vector<RecordedCommand> commands;
+            bool isRecording = false;
+            i32 openPipelines = 0;
+        };
+
+        void Record(CommandListID commandListID, RecordedCommandType type, u32 slot, u64 value);
+        void EndFrame();
+
+        u32 AddToTextureArray(TextureArrayID textureArray, TextureID texture); // Returns the slot it went into
+        u64 HashPath(const std::string& path);
+
+    private:
+        std::vector<ImageDesc> _images;
+        std::vector<DepthImageDesc> _depthImages;
+        robin_hood::unordered_map<u64, ImageID> _transientImages;
+        robin_hood::unordered_map<u64, DepthImageID> _transientDepthImages;
+
+        std::vector<SamplerDesc> _samplers;
+        u32 _numGraphicsPipelines = 0;
+        robin_hood::unordered_map<u64, GraphicsPipelineID> _graphicsPipelines;
+        u32 _numComputePipelines = 0;
+        robin_hood::unordered_map<u64, ComputePipelineID> _computePipelines;
+
+        u32 _numModels = 0;
+        u32 _numTextures = 0;
+        robin_hood::unordered_map<u64, TextureID> _loadedTextures;
+        struct TextureArray
+        {
+            std::vector<TextureID> textures; // TextureID::Invalid() for slots whose texture got destroyed, like TextureHandlerVK we reuse them
+            u32 size = 0;
+        };
+        std::vector<TextureArray> _textureArrays;
+
+        u32 _numShaders = 0;
+        robin_hood::unordered_map<u64, VertexShaderID> _vertexShaders;
+        robin_hood::unordered_map<u64, PixelShaderID> _pixelShaders;
+        robin_hood::unordered_map<u64, ComputeShaderID> _computeShaders;
+
+        std::vector<RecordedCommandList> _commandLists;
+        std::queue<CommandListID> _availableCommandLists;
+
+        FrameStats _frameStats;
+        FrameStats _lastFrameStats;
+        std::vector<RecordedCommand> _frameCommands;
+        std::vector<RecordedCommand> _lastFrameCommands;
+        u32 _frameCount = 0;
+    };
+}
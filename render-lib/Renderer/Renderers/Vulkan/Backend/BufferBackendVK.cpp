@@ -7,10 +7,22 @@ namespace Renderer
     {
         void BufferBackendVK::Apply(u32 frameIndex, void* data, size_t size)
         {
-            void* destData;
-            vmaMapMemory(device->_allocator, allocations.Get(frameIndex), &destData);
-            memcpy(destData, data, size);
-            vmaUnmapMemory(device->_allocator, allocations.Get(frameIndex));
+            ApplyRange(frameIndex, 0, data, size);
+        }
+
+        void BufferBackendVK::ApplyRange(u32 frameIndex, size_t offset, void* data, size_t size)
+        {
+            assert(offset + size <= bufferSize); // Don't write past the end of the buffer
+
+            if (usage == BufferBackend::Usage::USAGE_STATIC)
+            {
+                // Static buffers live in device local memory, every frame shares it so frameIndex doesn't matter
+                device->UploadToBuffer(buffers.Get(0), offset, data, size);
+                return;
+            }
+
+            memcpy(static_cast<u8*>(mappedData.Get(frameIndex)) + offset, data, size);
+            Flush(frameIndex, offset, size);
         }
 
         void* BufferBackendVK::GetDescriptor(u32 frameIndex)
@@ -22,5 +34,20 @@ namespace Renderer
         {
             return static_cast<void*>(&buffers.Get(frameIndex));
         }
+
+        void* BufferBackendVK::GetMappedData(u32 frameIndex)
+        {
+            assert(usage == BufferBackend::Usage::USAGE_DYNAMIC); // Static buffers are not host visible, use Apply to upload them
+            return mappedData.Get(frameIndex);
+        }
+
+        void BufferBackendVK::Flush(u32 frameIndex, size_t offset, size_t size)
+        {
+            assert(usage == BufferBackend::Usage::USAGE_DYNAMIC); // Static buffers are not host visible, use Apply to upload them
+            assert(offset + size <= bufferSize);
+
+            // VMA skips this for HOST_COHERENT memory, and rounds the range to nonCoherentAtomSize otherwise
+            vmaFlushAllocation(device->_allocator, allocations.Get(frameIndex), offset, size);
+        }
     }
 }
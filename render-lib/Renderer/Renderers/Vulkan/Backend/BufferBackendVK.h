@@ -3,6 +3,7 @@
 #include "../../../BufferBackend.h"
 #include "../../../FrameResource.h"
 #include <vulkan/vulkan.h>
+#include <mutex>
 #include "vk_mem_alloc.h"
 
 namespace Renderer
@@ -21,19 +22,26 @@ namespace Renderer
 
             RenderDeviceVK* device;
 
-            FrameResource<VkBuffer, 2> buffers;
-            FrameResource<VmaAllocation, 2> allocations;
+            FrameResource<VkBuffer> buffers;
+            FrameResource<VmaAllocation> allocations;
+            FrameResource<void*> mappedData; // Created with VMA_ALLOCATION_CREATE_MAPPED_BIT, these stay valid until the buffer is destroyed
 
             VkDescriptorPool descriptorPool = 0;
-            FrameResource<VkDescriptorSet, 2> descriptorSet;
+            FrameResource<VkDescriptorSet> descriptorSet;
+            std::mutex descriptorMutex; // Guards the lazy creation of the descriptors above
 
             size_t bufferSize;
             BufferBackend::Type type;
+            BufferBackend::Usage usage;
         private:
             void Apply(u32 frameIndex, void* data, size_t size) override;
+            void ApplyRange(u32 frameIndex, size_t offset, void* data, size_t size) override;
 
             void* GetDescriptor(u32 frameIndex) override;
             void* GetBuffer(u32 frameIndex) override;
+
+            void* GetMappedData(u32 frameIndex) override;
+            void Flush(u32 frameIndex, size_t offset, size_t size) override;
         };
     }
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include <Utils/DebugHandler.h>
 #include <cassert>
 #include "RenderDeviceVK.h"
+#include "UploadHandlerVK.h"
 
 namespace Renderer
 {
@@ -72,10 +73,9 @@ namespace Renderer
             submitInfo.commandBufferCount = 1;
             submitInfo.pCommandBuffers = &commandList.commandBuffer;
 
+            VkPipelineStageFlags dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT; // Needs to outlive the if below, vkQueueSubmit reads it
             if (commandList.waitSemaphore != NULL)
             {
-                VkPipelineStageFlags dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-
                 submitInfo.waitSemaphoreCount = 1;
                 submitInfo.pWaitSemaphores = &commandList.waitSemaphore;
                 submitInfo.pWaitDstStageMask = &dstStageMask;
@@ -87,16 +87,33 @@ namespace Renderer
                 submitInfo.pSignalSemaphores = &commandList.signalSemaphore;
             }
 
-            vkQueueSubmit(device->_graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
-            
-            // Do syncing stuff
-            vkQueueWaitIdle(device->_graphicsQueue);
+            // Anything this command list reads might still be sitting in the upload batch, so that goes first
+            device->_uploadHandler->SubmitUploads();
+
+            if (vkQueueSubmit(device->_graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS)
+            {
+                NC_LOG_FATAL("Failed to submit command buffer!");
+            }
 
             commandList.waitSemaphore = NULL;
             commandList.signalSemaphore = NULL;
             commandList.boundGraphicsPipeline = GraphicsPipelineID::Invalid();
+            commandList.boundComputePipeline = ComputePipelineID::Invalid();
+            commandList.renderPassOpenCount = 0;
+
+            // The GPU might still be executing this, so we can't reset its pool until the frame fence tells us it's done
+            _pendingCommandLists[device->GetFrameIndex()].push_back(id);
+        }
 
-            _availableCommandLists.push(id);
+        void CommandListHandlerVK::RecycleCommandLists(u32 frameIndex)
+        {
+            std::vector<CommandListID>& pendingCommandLists = _pendingCommandLists[frameIndex];
+
+            for (CommandListID id : pendingCommandLists)
+            {
+                _availableCommandLists.push(id);
+            }
+            pendingCommandLists.clear();
         }
 
         VkCommandBuffer CommandListHandlerVK::GetCommandBuffer(CommandListID id)
@@ -189,6 +206,50 @@ namespace Renderer
             return _commandLists[static_cast<type>(id)].boundGraphicsPipeline;
         }
 
+        void CommandListHandlerVK::SetBoundComputePipeline(CommandListID id, ComputePipelineID pipelineID)
+        {
+            using type = type_safe::underlying_type<CommandListID>;
+
+            // Lets make sure this id exists
+            assert(_commandLists.size() > static_cast<type>(id));
+
+            CommandList& commandList = _commandLists[static_cast<type>(id)];
+
+            commandList.boundComputePipeline = pipelineID;
+        }
+
+        ComputePipelineID CommandListHandlerVK::GetBoundComputePipeline(CommandListID id)
+        {
+            using type = type_safe::underlying_type<CommandListID>;
+
+            // Lets make sure this id exists
+            assert(_commandLists.size() > static_cast<type>(id));
+
+            return _commandLists[static_cast<type>(id)].boundComputePipeline;
+        }
+
+        void CommandListHandlerVK::SetRenderPassOpenCount(CommandListID id, i8 count)
+        {
+            using type = type_safe::underlying_type<CommandListID>;
+
+            // Lets make sure this id exists
+            assert(_commandLists.size() > static_cast<type>(id));
+
+            CommandList& commandList = _commandLists[static_cast<type>(id)];
+
+            commandList.renderPassOpenCount = count;
+        }
+
+        i8 CommandListHandlerVK::GetRenderPassOpenCount(CommandListID id)
+        {
+            using type = type_safe::underlying_type<CommandListID>;
+
+            // Lets make sure this id exists
+            assert(_commandLists.size() > static_cast<type>(id));
+
+            return _commandLists[static_cast<type>(id)].renderPassOpenCount;
+        }
+
         CommandListID CommandListHandlerVK::CreateCommandList(RenderDeviceVK* device)
         {
             size_t id = _commandLists.size();
@@ -4,8 +4,11 @@
 #include <queue>
 #include <vulkan/vulkan.h>
 
+#include "../../../FrameResource.h"
+
 #include "../../../Descriptors/CommandListDesc.h"
 #include "../../../Descriptors/GraphicsPipelineDesc.h"
+#include "../../../Descriptors/ComputePipelineDesc.h"
 
 
 namespace Renderer
@@ -23,6 +26,9 @@ namespace Renderer
             CommandListID BeginCommandList(RenderDeviceVK* device);
             void EndCommandList(RenderDeviceVK* device, CommandListID id);
 
+            // Makes the command lists submitted during frameIndex available again, only call this once that frame has retired on the GPU
+            void RecycleCommandLists(u32 frameIndex);
+
             VkCommandBuffer GetCommandBuffer(CommandListID id);
 
             bool GetWaitSemaphore(CommandListID id, VkSemaphore& semaphore);
@@ -34,6 +40,12 @@ namespace Renderer
             void SetBoundGraphicsPipeline(CommandListID id, GraphicsPipelineID pipelineID);
             GraphicsPipelineID GetBoundGraphicsPipeline(CommandListID id);
 
+            void SetBoundComputePipeline(CommandListID id, ComputePipelineID pipelineID);
+            ComputePipelineID GetBoundComputePipeline(CommandListID id);
+
+            void SetRenderPassOpenCount(CommandListID id, i8 count);
+            i8 GetRenderPassOpenCount(CommandListID id);
+
         private:
             struct CommandList
             {
@@ -43,6 +55,8 @@ namespace Renderer
                 VkCommandPool commandPool;
 
                 GraphicsPipelineID boundGraphicsPipeline = GraphicsPipelineID::Invalid();
+                ComputePipelineID boundComputePipeline = ComputePipelineID::Invalid(); // Only one of the two is valid at a time, it decides where descriptors get bound
+                i8 renderPassOpenCount = 0; // Tracked per commandlist since commandlists can be recorded in parallel
             };
 
             CommandListID CreateCommandList(RenderDeviceVK* device);
@@ -52,6 +66,7 @@ namespace Renderer
         private:
             std::vector<CommandList> _commandLists;
             std::queue<CommandListID> _availableCommandLists;
+            std::vector<CommandListID> _pendingCommandLists[FRAMES_IN_FLIGHT]; // Submitted but maybe still executing, indexed by the frame that submitted them
         };
     }
 }
\ No newline at end of file
@@ -344,6 +344,85 @@ namespace Renderer
 
                 return VK_STENCIL_OP_KEEP;
             }
+
+            static inline VkShaderStageFlags ToVkShaderStageFlags(const ShaderVisibility shaderVisibility)
+            {
+                switch (shaderVisibility)
+                {
+                case ShaderVisibility::SHADER_VISIBILITY_ALL: return VK_SHADER_STAGE_ALL_GRAPHICS;
+                case ShaderVisibility::SHADER_VISIBILITY_VERTEX: return VK_SHADER_STAGE_VERTEX_BIT;
+                case ShaderVisibility::SHADER_VISIBILITY_HULL: return VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT;
+                case ShaderVisibility::SHADER_VISIBILITY_DOMAIN: return VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
+                case ShaderVisibility::SHADER_VISIBILITY_GEOMETRY: return VK_SHADER_STAGE_GEOMETRY_BIT;
+                case ShaderVisibility::SHADER_VISIBILITY_PIXEL: return VK_SHADER_STAGE_FRAGMENT_BIT;
+                default:
+                    NC_LOG_FATAL("This should never hit, did we forget to update this function after adding more shader visibilities?");
+                }
+
+                return VK_SHADER_STAGE_ALL_GRAPHICS;
+            }
+
+            static inline VkPipelineStageFlags ToVkPipelineStageFlags(const ResourceAccess access, const bool isDepth)
+            {
+                if (access == ResourceAccess::RESOURCE_ACCESS_UNKNOWN || (access & ResourceAccess::RESOURCE_ACCESS_DISCARD))
+                    return VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+
+                VkPipelineStageFlags stageFlags = 0;
+                if (access & ResourceAccess::RESOURCE_ACCESS_RENDERTARGET)
+                {
+                    // Rendertargets might get cleared with a transfer at the start of a pass
+                    stageFlags |= VK_PIPELINE_STAGE_TRANSFER_BIT;
+                    stageFlags |= (isDepth) ? VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT : VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+                }
+                if (access & ResourceAccess::RESOURCE_ACCESS_UAV)
+                    stageFlags |= VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+                if (access & ResourceAccess::RESOURCE_ACCESS_VERTEX_READ)
+                    stageFlags |= VK_PIPELINE_STAGE_VERTEX_SHADER_BIT;
+                if (access & ResourceAccess::RESOURCE_ACCESS_PIXEL_READ)
+                    stageFlags |= VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+                if (access & ResourceAccess::RESOURCE_ACCESS_COMPUTE_READ)
+                    stageFlags |= VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+                if (access & ResourceAccess::RESOURCE_ACCESS_INDIRECT_READ)
+                    stageFlags |= VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT;
+
+                return stageFlags;
+            }
+
+            static inline VkAccessFlags ToVkAccessFlags(const ResourceAccess access, const bool isDepth)
+            {
+                if (access == ResourceAccess::RESOURCE_ACCESS_UNKNOWN || (access & ResourceAccess::RESOURCE_ACCESS_DISCARD))
+                    return VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+
+                VkAccessFlags accessFlags = 0;
+                if (access & ResourceAccess::RESOURCE_ACCESS_RENDERTARGET)
+                {
+                    accessFlags |= VK_ACCESS_TRANSFER_WRITE_BIT;
+                    accessFlags |= (isDepth) ? VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT : VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+                }
+                if (access & ResourceAccess::RESOURCE_ACCESS_UAV)
+                    accessFlags |= VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+                if (access & (ResourceAccess::RESOURCE_ACCESS_VERTEX_READ | ResourceAccess::RESOURCE_ACCESS_PIXEL_READ | ResourceAccess::RESOURCE_ACCESS_COMPUTE_READ))
+                    accessFlags |= VK_ACCESS_SHADER_READ_BIT;
+                if (access & ResourceAccess::RESOURCE_ACCESS_INDIRECT_READ)
+                    accessFlags |= VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+
+                return accessFlags;
+            }
+
+            static inline VkImageLayout ToVkImageLayout(const ResourceAccess access, const bool isDepth)
+            {
+                // Color images always live in GENERAL, depth images live in DEPTH_STENCIL_ATTACHMENT_OPTIMAL unless they are only getting read
+                if (access & ResourceAccess::RESOURCE_ACCESS_DISCARD)
+                    return VK_IMAGE_LAYOUT_UNDEFINED;
+
+                if (!isDepth)
+                    return VK_IMAGE_LAYOUT_GENERAL;
+
+                if (access == ResourceAccess::RESOURCE_ACCESS_UNKNOWN || (access & ResourceAccess::RESOURCE_ACCESS_RENDERTARGET))
+                    return VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+                return VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+            }
         };
     }
 }
\ No newline at end of file
@@ -1,9 +1,11 @@
 #include "ImageHandlerVK.h"
 #include <Utils/DebugHandler.h>
 #include <Utils/StringUtils.h>
+#include <Utils/XXHash64.h>
 #include "RenderDeviceVK.h"
 #include "FormatConverterVK.h"
 #include "DebugMarkerUtilVK.h"
+#include "PipelineHandlerVK.h"
 
 namespace Renderer
 {
@@ -21,10 +23,348 @@ namespace Renderer
 
         ImageID ImageHandlerVK::CreateImage(RenderDeviceVK* device, const ImageDesc& desc)
         {
+            return CreateImage(device, desc, ALIAS_SLOT_NONE);
+        }
+
+        DepthImageID ImageHandlerVK::CreateDepthImage(RenderDeviceVK* device, const DepthImageDesc& desc)
+        {
+            return CreateDepthImage(device, desc, ALIAS_SLOT_NONE);
+        }
+
+        ImageID ImageHandlerVK::AcquireTransientImage(RenderDeviceVK* device, const ImageDesc& desc, u32 aliasSlot)
+        {
+            // The debug name is left out of the hash on purpose, it doesn't change what memory the image needs
+            u64 hashData[5] = { static_cast<u64>(desc.dimensions.x), static_cast<u64>(desc.dimensions.y), desc.depth, static_cast<u64>(desc.format) << 32 | desc.sampleCount, aliasSlot };
+            u64 hash = XXHash64::hash(hashData, sizeof(hashData), 0);
+
+            TransientImage& transient = _transientImages[hash];
+            if (transient.id == ImageID::Invalid())
+            {
+                transient.id = CreateImage(device, desc, aliasSlot);
+                _images[static_cast<type_safe::underlying_type<ImageID>>(transient.id)].transientHash = hash;
+            }
+
+            transient.refCount++;
+            transient.framesUnused = 0;
+
+            return transient.id;
+        }
+
+        DepthImageID ImageHandlerVK::AcquireTransientDepthImage(RenderDeviceVK* device, const DepthImageDesc& desc, u32 aliasSlot)
+        {
+            // The debug name is left out of the hash on purpose, it doesn't change what memory the image needs
+            u64 hashData[4] = { static_cast<u64>(desc.dimensions.x), static_cast<u64>(desc.dimensions.y), static_cast<u64>(desc.format) << 32 | desc.sampleCount, aliasSlot };
+            u64 hash = XXHash64::hash(hashData, sizeof(hashData), 0);
+
+            TransientDepthImage& transient = _transientDepthImages[hash];
+            if (transient.id == DepthImageID::Invalid())
+            {
+                transient.id = CreateDepthImage(device, desc, aliasSlot);
+                _depthImages[static_cast<type_safe::underlying_type<DepthImageID>>(transient.id)].transientHash = hash;
+            }
+
+            transient.refCount++;
+            transient.framesUnused = 0;
+
+            return transient.id;
+        }
+
+        void ImageHandlerVK::ReleaseTransientImage(ImageID imageID)
+        {
+            using type = type_safe::underlying_type<ImageID>;
+            assert(_images.size() > static_cast<type>(imageID));
+
+            const Image& image = _images[static_cast<type>(imageID)];
+            assert(image.transientHeap != TRANSIENT_HEAP_NONE); // Only transient images can be released
+
+            auto it = _transientImages.find(image.transientHash);
+            assert(it != _transientImages.end());
+            assert(it->second.refCount > 0); // Released more times than it was acquired
+
+            it->second.refCount--;
+        }
+
+        void ImageHandlerVK::ReleaseTransientDepthImage(DepthImageID imageID)
+        {
+            using type = type_safe::underlying_type<DepthImageID>;
+            assert(_depthImages.size() > static_cast<type>(imageID));
+
+            const DepthImage& image = _depthImages[static_cast<type>(imageID)];
+            assert(image.transientHeap != TRANSIENT_HEAP_NONE); // Only transient images can be released
+
+            auto it = _transientDepthImages.find(image.transientHash);
+            assert(it != _transientDepthImages.end());
+            assert(it->second.refCount > 0); // Released more times than it was acquired
+
+            it->second.refCount--;
+        }
+
+        void ImageHandlerVK::EvictUnusedTransientImages(RenderDeviceVK* device, PipelineHandlerVK* pipelineHandler)
+        {
+            for (auto it = _transientImages.begin(); it != _transientImages.end();)
+            {
+                TransientImage& transient = it->second;
+                if (transient.refCount > 0 || ++transient.framesUnused < TRANSIENT_IMAGE_EVICTION_FRAMES)
+                {
+                    it++;
+                    continue;
+                }
+
+                // The pipelines render straight into it, so they can't outlive it
+                pipelineHandler->DestroyPipelinesUsingImage(device, transient.id);
+                FreeImage(device, transient.id);
+
+                it = _transientImages.erase(it);
+            }
+
+            for (auto it = _transientDepthImages.begin(); it != _transientDepthImages.end();)
+            {
+                TransientDepthImage& transient = it->second;
+                if (transient.refCount > 0 || ++transient.framesUnused < TRANSIENT_IMAGE_EVICTION_FRAMES)
+                {
+                    it++;
+                    continue;
+                }
+
+                pipelineHandler->DestroyPipelinesUsingImage(device, transient.id);
+                FreeDepthImage(device, transient.id);
+
+                it = _transientDepthImages.erase(it);
+            }
+        }
+
+        void ImageHandlerVK::DestroyImage(RenderDeviceVK* device, ImageID imageID)
+        {
+            using type = type_safe::underlying_type<ImageID>;
+
+            // Lets make sure this id exists
+            assert(_images.size() > static_cast<type>(imageID));
+
+            Image& image = _images[static_cast<type>(imageID)];
+            assert(!image.isDestroyed); // Destroying an image twice
+
+            if (image.transientHeap != TRANSIENT_HEAP_NONE)
+            {
+                NC_LOG_FATAL("Tried to destroy transient image (%s), transient images are owned by the backend", image.desc.debugName.c_str());
+            }
+
+            FreeImage(device, imageID);
+        }
+
+        void ImageHandlerVK::FreeImage(RenderDeviceVK* device, ImageID imageID)
+        {
+            using type = type_safe::underlying_type<ImageID>;
+            Image& image = _images[static_cast<type>(imageID)];
+
+            if (image.transientHeap != TRANSIENT_HEAP_NONE)
+            {
+                ReleaseTransientHeap(device, image.transientHeap);
+            }
+
+            VkImage vkImage = image.image;
+            VmaAllocation allocation = image.allocation;
+            VkImageView colorView = image.colorView;
+            VkDescriptorPool storageDescriptorPool = image.storageDescriptorPool;
+
+            device->DeferDestroy([device, vkImage, allocation, colorView, storageDescriptorPool]()
+            {
+                if (storageDescriptorPool != VK_NULL_HANDLE)
+                {
+                    vkDestroyDescriptorPool(device->_device, storageDescriptorPool, nullptr);
+                }
+
+                vkDestroyImageView(device->_device, colorView, nullptr);
+                vmaDestroyImage(device->_allocator, vkImage, allocation);
+            });
+
+            image = Image();
+            image.isDestroyed = true;
+
+            _freeImageHandles.push_back(static_cast<type>(imageID));
+        }
+
+        void ImageHandlerVK::DestroyDepthImage(RenderDeviceVK* device, DepthImageID imageID)
+        {
+            using type = type_safe::underlying_type<DepthImageID>;
+
+            // Lets make sure this id exists
+            assert(_depthImages.size() > static_cast<type>(imageID));
+
+            DepthImage& image = _depthImages[static_cast<type>(imageID)];
+            assert(!image.isDestroyed); // Destroying a depth image twice
+
+            if (image.transientHeap != TRANSIENT_HEAP_NONE)
+            {
+                NC_LOG_FATAL("Tried to destroy transient depth image (%s), transient images are owned by the backend", image.desc.debugName.c_str());
+            }
+
+            FreeDepthImage(device, imageID);
+        }
+
+        void ImageHandlerVK::FreeDepthImage(RenderDeviceVK* device, DepthImageID imageID)
+        {
+            using type = type_safe::underlying_type<DepthImageID>;
+            DepthImage& image = _depthImages[static_cast<type>(imageID)];
+
+            if (image.transientHeap != TRANSIENT_HEAP_NONE)
+            {
+                ReleaseTransientHeap(device, image.transientHeap);
+            }
+
+            VkImage vkImage = image.image;
+            VmaAllocation allocation = image.allocation;
+            VkImageView depthView = image.depthView;
+
+            device->DeferDestroy([device, vkImage, allocation, depthView]()
+            {
+                vkDestroyImageView(device->_device, depthView, nullptr);
+                vmaDestroyImage(device->_allocator, vkImage, allocation);
+            });
+
+            image = DepthImage();
+            image.isDestroyed = true;
+
+            _freeDepthImageHandles.push_back(static_cast<type>(imageID));
+        }
+
+        size_t ImageHandlerVK::AcquireImageHandle()
+        {
+            if (!_freeImageHandles.empty())
+            {
+                size_t handle = _freeImageHandles.back();
+                _freeImageHandles.pop_back();
+
+                return handle;
+            }
+
             size_t nextHandle = _images.size();
 
             // Make sure we haven't exceeded the limit of the ImageID type, if this hits you need to change type of ImageID to something bigger
             assert(nextHandle < ImageID::MaxValue());
+
+            _images.emplace_back();
+            return nextHandle;
+        }
+
+        size_t ImageHandlerVK::AcquireDepthImageHandle()
+        {
+            if (!_freeDepthImageHandles.empty())
+            {
+                size_t handle = _freeDepthImageHandles.back();
+                _freeDepthImageHandles.pop_back();
+
+                return handle;
+            }
+
+            size_t nextHandle = _depthImages.size();
+
+            // Make sure we haven't exceeded the limit of the DepthImageID type, if this hits you need to change type of DepthImageID to something bigger
+            assert(nextHandle < DepthImageID::MaxValue());
+
+            _depthImages.emplace_back();
+            return nextHandle;
+        }
+
+        void ImageHandlerVK::AllocateImageMemory(RenderDeviceVK* device, const VkImageCreateInfo& imageInfo, u32 aliasSlot, VkImage& image, VmaAllocation& allocation, u32& transientHeap)
+        {
+            transientHeap = TRANSIENT_HEAP_NONE;
+
+            VmaAllocationCreateInfo allocInfo = {};
+            allocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+
+            if (aliasSlot == ALIAS_SLOT_NONE)
+            {
+                if (vmaCreateImage(device->_allocator, &imageInfo, &allocInfo, &image, &allocation, nullptr) != VK_SUCCESS)
+                {
+                    NC_LOG_FATAL("Failed to create image!");
+                }
+                return;
+            }
+
+            if (vkCreateImage(device->_device, &imageInfo, nullptr, &image) != VK_SUCCESS)
+            {
+                NC_LOG_FATAL("Failed to create transient image!");
+            }
+            allocation = VK_NULL_HANDLE;
+
+            VkMemoryRequirements memoryRequirements;
+            vkGetImageMemoryRequirements(device->_device, image, &memoryRequirements);
+
+            // Try to alias an existing heap of this slot, the RenderGraph makes sure images sharing a slot never overlap in lifetime
+            u32 freeHeap = TRANSIENT_HEAP_NONE;
+            for (u32 i = 0; i < _transientHeaps.size(); i++)
+            {
+                const TransientHeap& heap = _transientHeaps[i];
+                if (heap.allocation == VK_NULL_HANDLE)
+                {
+                    freeHeap = i;
+                    continue;
+                }
+
+                const VmaAllocationInfo& heapInfo = heap.allocationInfo;
+                if (heap.aliasSlot == aliasSlot &&
+                    heapInfo.size >= memoryRequirements.size &&
+                    (heapInfo.offset % memoryRequirements.alignment) == 0 &&
+                    (memoryRequirements.memoryTypeBits & (1u << heapInfo.memoryType)))
+                {
+                    transientHeap = i;
+                    break;
+                }
+            }
+
+            if (transientHeap == TRANSIENT_HEAP_NONE)
+            {
+                TransientHeap heap;
+                heap.aliasSlot = aliasSlot;
+
+                if (vmaAllocateMemory(device->_allocator, &memoryRequirements, &allocInfo, &heap.allocation, &heap.allocationInfo) != VK_SUCCESS)
+                {
+                    NC_LOG_FATAL("Failed to allocate transient image memory!");
+                }
+
+                if (freeHeap != TRANSIENT_HEAP_NONE)
+                {
+                    transientHeap = freeHeap;
+                    _transientHeaps[transientHeap] = heap;
+                }
+                else
+                {
+                    transientHeap = static_cast<u32>(_transientHeaps.size());
+                    _transientHeaps.push_back(heap);
+                }
+            }
+
+            TransientHeap& heap = _transientHeaps[transientHeap];
+            if (vmaBindImageMemory(device->_allocator, heap.allocation, image) != VK_SUCCESS)
+            {
+                NC_LOG_FATAL("Failed to bind transient image memory!");
+            }
+
+            heap.numImages++;
+        }
+
+        void ImageHandlerVK::ReleaseTransientHeap(RenderDeviceVK* device, u32 transientHeap)
+        {
+            TransientHeap& heap = _transientHeaps[transientHeap];
+            assert(heap.numImages > 0);
+
+            heap.numImages--;
+            if (heap.numImages > 0)
+                return;
+
+            VmaAllocation allocation = heap.allocation;
+            device->DeferDestroy([device, allocation]()
+            {
+                vmaFreeMemory(device->_allocator, allocation);
+            });
+
+            heap = TransientHeap();
+            heap.allocation = VK_NULL_HANDLE;
+        }
+
+        ImageID ImageHandlerVK::CreateImage(RenderDeviceVK* device, const ImageDesc& desc, u32 aliasSlot)
+        {
+            size_t nextHandle = AcquireImageHandle();
             using type = type_safe::underlying_type<ImageID>;
 
             Image image;
@@ -69,13 +409,7 @@ namespace Renderer
             imageInfo.pQueueFamilyIndices = nullptr;
             imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 
-            VmaAllocationCreateInfo allocInfo = {};
-            allocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
-
-            if (vmaCreateImage(device->_allocator, &imageInfo, &allocInfo, &image.image, &image.allocation, nullptr) != VK_SUCCESS)
-            {
-                NC_LOG_FATAL("Failed to create image!");
-            }
+            AllocateImageMemory(device, imageInfo, aliasSlot, image.image, image.allocation, image.transientHeap);
 
             // Create Color View
             VkImageViewCreateInfo colorViewInfo = {};
@@ -107,17 +441,92 @@ namespace Renderer
             // Transition image from VK_IMAGE_LAYOUT_UNDEFINED to VK_IMAGE_LAYOUT_GENERAL
             device->TransitionImageLayout(image.image, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL, desc.depth);
 
-            _images.push_back(image);
+            // Storage images on multisampled images needs a device feature we don't enable
+            if (desc.sampleCount == SAMPLE_COUNT_1)
+            {
+                CreateStorageDescriptorSet(device, image);
+            }
+
+            _images[nextHandle] = image;
 
             return ImageID(static_cast<type>(nextHandle));
         }
 
-        DepthImageID ImageHandlerVK::CreateDepthImage(RenderDeviceVK* device, const DepthImageDesc& desc)
+        void ImageHandlerVK::CreateStorageDescriptorSet(RenderDeviceVK* device, Image& image)
         {
-            size_t nextHandle = _depthImages.size();
+            // Create descriptor set layout
+            if (_storageDescriptorSetLayout == VK_NULL_HANDLE)
+            {
+                VkDescriptorSetLayoutBinding descriptorLayout = {};
+                descriptorLayout.binding = 0;
+                descriptorLayout.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+                descriptorLayout.descriptorCount = 1;
+                descriptorLayout.stageFlags = VK_SHADER_STAGE_ALL;
+                descriptorLayout.pImmutableSamplers = NULL;
+
+                VkDescriptorSetLayoutCreateInfo descriptorLayoutInfo = {};
+                descriptorLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+                descriptorLayoutInfo.pNext = NULL;
+                descriptorLayoutInfo.bindingCount = 1;
+                descriptorLayoutInfo.pBindings = &descriptorLayout;
+
+                if (vkCreateDescriptorSetLayout(device->_device, &descriptorLayoutInfo, NULL, &_storageDescriptorSetLayout) != VK_SUCCESS)
+                {
+                    NC_LOG_FATAL("Failed to create descriptor set layout for storage image!");
+                }
+            }
 
-            // Make sure we haven't exceeded the limit of the DepthImageID type, if this hits you need to change type of DepthImageID to something bigger
-            assert(nextHandle < DepthImageID::MaxValue());
+            // Create descriptor pool
+            VkDescriptorPoolSize poolSize = {};
+            poolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+            poolSize.descriptorCount = 1;
+
+            VkDescriptorPoolCreateInfo poolInfo = {};
+            poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+            poolInfo.poolSizeCount = 1;
+            poolInfo.pPoolSizes = &poolSize;
+            poolInfo.maxSets = 1;
+
+            if (vkCreateDescriptorPool(device->_device, &poolInfo, nullptr, &image.storageDescriptorPool) != VK_SUCCESS)
+            {
+                NC_LOG_FATAL("Failed to create descriptor pool for storage image!");
+            }
+
+            // Create descriptor set
+            VkDescriptorSetAllocateInfo descriptorAllocInfo = {};
+            descriptorAllocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+            descriptorAllocInfo.pNext = NULL;
+            descriptorAllocInfo.descriptorPool = image.storageDescriptorPool;
+            descriptorAllocInfo.descriptorSetCount = 1;
+            descriptorAllocInfo.pSetLayouts = &_storageDescriptorSetLayout;
+
+            if (vkAllocateDescriptorSets(device->_device, &descriptorAllocInfo, &image.storageDescriptorSet) != VK_SUCCESS)
+            {
+                NC_LOG_FATAL("Failed to create descriptor set for storage image!");
+            }
+
+            // Images live in VK_IMAGE_LAYOUT_GENERAL outside of renderpasses, which is what storage images need
+            VkDescriptorImageInfo descriptorInfo = {};
+            descriptorInfo.sampler = VK_NULL_HANDLE;
+            descriptorInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+            descriptorInfo.imageView = image.colorView;
+
+            VkWriteDescriptorSet descriptorWrite = {};
+            descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            descriptorWrite.pNext = NULL;
+            descriptorWrite.dstSet = image.storageDescriptorSet;
+            descriptorWrite.dstBinding = 0;
+            descriptorWrite.dstArrayElement = 0;
+            descriptorWrite.descriptorCount = 1;
+            descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+            descriptorWrite.pImageInfo = &descriptorInfo;
+
+            vkUpdateDescriptorSets(device->_device, 1, &descriptorWrite, 0, NULL);
+        }
+
+        DepthImageID ImageHandlerVK::CreateDepthImage(RenderDeviceVK* device, const DepthImageDesc& desc, u32 aliasSlot)
+        {
+            size_t nextHandle = AcquireDepthImageHandle();
             using type = type_safe::underlying_type<DepthImageID>;
 
             DepthImage image;
@@ -149,13 +558,7 @@ namespace Renderer
             imageInfo.pQueueFamilyIndices = nullptr;
             imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 
-            VmaAllocationCreateInfo allocInfo = {};
-            allocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
-
-            if (vmaCreateImage(device->_allocator, &imageInfo, &allocInfo, &image.image, &image.allocation, nullptr) != VK_SUCCESS)
-            {
-                NC_LOG_FATAL("Failed to create image!");
-            }
+            AllocateImageMemory(device, imageInfo, aliasSlot, image.image, image.allocation, image.transientHeap);
 
             // Create Depth View
             VkImageViewCreateInfo depthViewInfo = {};
@@ -184,7 +587,7 @@ namespace Renderer
             // Transition image from VK_IMAGE_LAYOUT_UNDEFINED to VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL
             device->TransitionImageLayout(image.image, VK_IMAGE_ASPECT_DEPTH_BIT, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, 1);
 
-            _depthImages.push_back(image);
+            _depthImages[nextHandle] = image;
 
             return DepthImageID(static_cast<type>(nextHandle));
         }
@@ -195,6 +598,7 @@ namespace Renderer
 
             // Lets make sure this id exists
             assert(_images.size() > static_cast<type>(id));
+            assert(!_images[static_cast<type>(id)].isDestroyed); // This image has been destroyed
             return _images[static_cast<type>(id)].desc;
         }
 
@@ -204,6 +608,7 @@ namespace Renderer
 
             // Lets make sure this id exists
             assert(_depthImages.size() > static_cast<type>(id));
+            assert(!_depthImages[static_cast<type>(id)].isDestroyed); // This depth image has been destroyed
             return _depthImages[static_cast<type>(id)].desc;
         }
 
@@ -213,6 +618,7 @@ namespace Renderer
 
             // Lets make sure this id exists
             assert(_images.size() > static_cast<type>(id));
+            assert(!_images[static_cast<type>(id)].isDestroyed); // This image has been destroyed
             return _images[static_cast<type>(id)].image;
         }
 
@@ -222,15 +628,28 @@ namespace Renderer
 
             // Lets make sure this id exists
             assert(_images.size() > static_cast<type>(id));
+            assert(!_images[static_cast<type>(id)].isDestroyed); // This image has been destroyed
             return _images[static_cast<type>(id)].colorView;
         }
 
+        VkDescriptorSet ImageHandlerVK::GetStorageDescriptorSet(const ImageID id)
+        {
+            using type = type_safe::underlying_type<ImageID>;
+
+            // Lets make sure this id exists
+            assert(_images.size() > static_cast<type>(id));
+            assert(!_images[static_cast<type>(id)].isDestroyed); // This image has been destroyed
+            assert(_images[static_cast<type>(id)].storageDescriptorSet != VK_NULL_HANDLE); // Multisampled images can't be bound as storage images
+            return _images[static_cast<type>(id)].storageDescriptorSet;
+        }
+
         VkImage ImageHandlerVK::GetImage(const DepthImageID id)
         {
             using type = type_safe::underlying_type<DepthImageID>;
 
             // Lets make sure this id exists
             assert(_depthImages.size() > static_cast<type>(id));
+            assert(!_depthImages[static_cast<type>(id)].isDestroyed); // This depth image has been destroyed
             return _depthImages[static_cast<type>(id)].image;
         }
 
@@ -240,6 +659,7 @@ namespace Renderer
 
             // Lets make sure this id exists
             assert(_depthImages.size() > static_cast<type>(id));
+            assert(!_depthImages[static_cast<type>(id)].isDestroyed); // This depth image has been destroyed
             return _depthImages[static_cast<type>(id)].depthView;
         }
     }
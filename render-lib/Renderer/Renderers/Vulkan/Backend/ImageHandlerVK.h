@@ -2,6 +2,7 @@
 #include <NovusTypes.h>
 #include <vector>
 #include <vulkan/vulkan.h>
+#include <robin_hood.h>
 #include "vk_mem_alloc.h"
 
 #include "../../../Descriptors/ImageDesc.h"
@@ -12,6 +13,7 @@ namespace Renderer
     namespace Backend
     {
         class RenderDeviceVK;
+        class PipelineHandlerVK;
 
         class ImageHandlerVK
         {
@@ -22,37 +24,113 @@ namespace Renderer
             ImageID CreateImage(RenderDeviceVK* device, const ImageDesc& desc);
             DepthImageID CreateDepthImage(RenderDeviceVK* device, const DepthImageDesc& desc);
 
+            // Transient images get cached per desc and alias slot, images sharing a slot share memory whenever it fits
+            ImageID AcquireTransientImage(RenderDeviceVK* device, const ImageDesc& desc, u32 aliasSlot);
+            DepthImageID AcquireTransientDepthImage(RenderDeviceVK* device, const DepthImageDesc& desc, u32 aliasSlot);
+            void ReleaseTransientImage(ImageID imageID);
+            void ReleaseTransientDepthImage(DepthImageID imageID);
+
+            // Call once per frame, transient images nobody has acquired for TRANSIENT_IMAGE_EVICTION_FRAMES frames get destroyed together with the pipelines rendering to them
+            void EvictUnusedTransientImages(RenderDeviceVK* device, PipelineHandlerVK* pipelineHandler);
+
+            // Transient images can't be destroyed, they are owned by the backend
+            void DestroyImage(RenderDeviceVK* device, ImageID imageID);
+            void DestroyDepthImage(RenderDeviceVK* device, DepthImageID imageID);
+
             const ImageDesc& GetImageDesc(const ImageID id);
             const DepthImageDesc& GetDepthImageDesc(const DepthImageID id);
 
             VkImage GetImage(const ImageID id);
             VkImageView GetColorView(const ImageID id);
+            VkDescriptorSet GetStorageDescriptorSet(const ImageID id);
 
             VkImage GetImage(const DepthImageID id);
             VkImageView GetDepthView(const DepthImageID id);
 
         private:
+            static constexpr u32 ALIAS_SLOT_NONE = 0xFFFFFFFF;
+            static constexpr u32 TRANSIENT_HEAP_NONE = 0xFFFFFFFF;
+            static constexpr u32 TRANSIENT_IMAGE_EVICTION_FRAMES = 300; // A couple of seconds, recompiling a graph releases its transients right before acquiring them again
+
             struct Image
             {
                 ImageDesc desc;
 
-                VmaAllocation allocation;
+                VmaAllocation allocation; // VK_NULL_HANDLE for transient images, they are bound to a TransientHeap
                 VkImage image;
                 VkImageView colorView;
+
+                u32 transientHeap = TRANSIENT_HEAP_NONE; // Index into _transientHeaps
+                u64 transientHash = 0; // Key into _transientImages
+
+                VkDescriptorPool storageDescriptorPool = VK_NULL_HANDLE;
+                VkDescriptorSet storageDescriptorSet = VK_NULL_HANDLE; // Binds the image as a storage image (UAV), only single sampled images get one
+
+                bool isDestroyed = false;
             };
 
             struct DepthImage
             {
                 DepthImageDesc desc;
 
-                VmaAllocation allocation;
+                VmaAllocation allocation; // VK_NULL_HANDLE for transient images, they are bound to a TransientHeap
                 VkImage image;
                 VkImageView depthView;
+
+                u32 transientHeap = TRANSIENT_HEAP_NONE; // Index into _transientHeaps
+                u64 transientHash = 0; // Key into _transientDepthImages
+
+                bool isDestroyed = false;
+            };
+
+            struct TransientHeap
+            {
+                u32 aliasSlot;
+                VmaAllocation allocation; // VK_NULL_HANDLE once it has been freed, the slot gets reused by the next heap
+                VmaAllocationInfo allocationInfo;
+                u32 numImages = 0; // The heap gets freed when the last image bound to it is
+            };
+
+            struct TransientImage
+            {
+                ImageID id = ImageID::Invalid();
+                u32 refCount = 0; // Every compiled RenderGraph using it holds a reference
+                u32 framesUnused = 0;
+            };
+
+            struct TransientDepthImage
+            {
+                DepthImageID id = DepthImageID::Invalid();
+                u32 refCount = 0; // Every compiled RenderGraph using it holds a reference
+                u32 framesUnused = 0;
             };
 
+        private:
+            ImageID CreateImage(RenderDeviceVK* device, const ImageDesc& desc, u32 aliasSlot);
+            DepthImageID CreateDepthImage(RenderDeviceVK* device, const DepthImageDesc& desc, u32 aliasSlot);
+
+            size_t AcquireImageHandle(); // Reuses the handle of a destroyed image if there is one
+            size_t AcquireDepthImageHandle();
+
+            void AllocateImageMemory(RenderDeviceVK* device, const VkImageCreateInfo& imageInfo, u32 aliasSlot, VkImage& image, VmaAllocation& allocation, u32& transientHeap);
+            void ReleaseTransientHeap(RenderDeviceVK* device, u32 transientHeap);
+
+            void FreeImage(RenderDeviceVK* device, ImageID imageID);
+            void FreeDepthImage(RenderDeviceVK* device, DepthImageID imageID);
+            void CreateStorageDescriptorSet(RenderDeviceVK* device, Image& image);
+
         private:
             std::vector<Image> _images;
             std::vector<DepthImage> _depthImages;
+
+            std::vector<size_t> _freeImageHandles;
+            std::vector<size_t> _freeDepthImageHandles;
+
+            VkDescriptorSetLayout _storageDescriptorSetLayout = VK_NULL_HANDLE; // Every storage image descriptor set looks the same so they share one layout
+
+            std::vector<TransientHeap> _transientHeaps;
+            robin_hood::unordered_map<u64, TransientImage> _transientImages;
+            robin_hood::unordered_map<u64, TransientDepthImage> _transientDepthImages;
         };
     }
 }
\ No newline at end of file
@@ -22,10 +22,7 @@ namespace Renderer
 
         ModelID ModelHandlerVK::CreatePrimitiveModel(RenderDeviceVK* device, const PrimitiveModelDesc& desc)
         {
-            size_t nextHandle = _models.size();
-
-            // Make sure we haven't exceeded the limit of the DepthImageID type, if this hits you need to change type of DepthImageID to something bigger
-            assert(nextHandle < ModelID::MaxValue());
+            size_t nextHandle = AcquireModelHandle();
             using type = type_safe::underlying_type<ModelID>;
 
             Model model;
@@ -39,24 +36,20 @@ namespace Renderer
 
             InitializeModel(device, model, tempData);
 
-            _models.push_back(model);
+            _models[nextHandle] = model;
             return ModelID(static_cast<type>(nextHandle));
         }
 
         void ModelHandlerVK::UpdatePrimitiveModel(RenderDeviceVK* device, ModelID modelID, const PrimitiveModelDesc& desc)
         {
-            using type = type_safe::underlying_type<ModelID>;
-            Model& model = _models[static_cast<type>(modelID)];
+            Model& model = GetModel(modelID);
             
             UpdateVertices(device, model, desc.vertices);
         }
 
         ModelID ModelHandlerVK::LoadModel(RenderDeviceVK* device, const ModelDesc& desc)
         {
-            size_t nextHandle = _models.size();
-
-            // Make sure we haven't exceeded the limit of the DepthImageID type, if this hits you need to change type of DepthImageID to something bigger
-            assert(nextHandle < ModelID::MaxValue());
+            size_t nextHandle = AcquireModelHandle();
             using type = type_safe::underlying_type<ModelID>;
 
             Model model;
@@ -67,18 +60,42 @@ namespace Renderer
             LoadFromFile(desc, tempData);
             InitializeModel(device, model, tempData);
                 
-            _models.push_back(model);
+            _models[nextHandle] = model;
             return ModelID(static_cast<type>(nextHandle));
         }
 
-        VkBuffer ModelHandlerVK::GetVertexBuffer(ModelID modelID)
+        void ModelHandlerVK::DestroyModel(RenderDeviceVK* device, ModelID modelID)
         {
             using type = type_safe::underlying_type<ModelID>;
+            Model& model = GetModel(modelID);
 
-            // Lets make sure this id exists
-            assert(_models.size() > static_cast<type>(modelID));
+            VkBuffer vertexBuffer = model.vertexBuffer;
+            VmaAllocation vertexBufferAllocation = model.vertexBufferAllocation;
+            VkBuffer indexBuffer = model.indexBuffer;
+            VmaAllocation indexBufferAllocation = model.indexBufferAllocation;
 
-            Model& model = _models[static_cast<type>(modelID)];
+            device->DeferDestroy([device, vertexBuffer, vertexBufferAllocation, indexBuffer, indexBufferAllocation]()
+            {
+                if (vertexBuffer != VK_NULL_HANDLE)
+                {
+                    vmaDestroyBuffer(device->_allocator, vertexBuffer, vertexBufferAllocation);
+                }
+
+                if (indexBuffer != VK_NULL_HANDLE)
+                {
+                    vmaDestroyBuffer(device->_allocator, indexBuffer, indexBufferAllocation);
+                }
+            });
+
+            model = Model();
+            model.isDestroyed = true;
+
+            _freeModelHandles.push_back(static_cast<type>(modelID));
+        }
+
+        VkBuffer ModelHandlerVK::GetVertexBuffer(ModelID modelID)
+        {
+            Model& model = GetModel(modelID);
             if (model.numVertices == 0)
             {
                 NC_LOG_FATAL("Tried to get the vertex buffer of model (%s) which doesn't have vertices", model.debugName);
@@ -89,17 +106,42 @@ namespace Renderer
 
         u32 ModelHandlerVK::GetNumIndices(ModelID modelID)
         {
-            using type = type_safe::underlying_type<ModelID>;
-
-            // Lets make sure this id exists
-            assert(_models.size() > static_cast<type>(modelID));
-
-            Model& model = _models[static_cast<type>(modelID)];
+            Model& model = GetModel(modelID);
 
             return model.numIndices;
         }
 
         VkBuffer ModelHandlerVK::GetIndexBuffer(ModelID modelID)
+        {
+            Model& model = GetModel(modelID);
+            if (model.numIndices == 0)
+            {
+                NC_LOG_FATAL("Tried to get the index buffer of model (%s) which doesn't have indices", model.debugName);
+            }
+
+            return model.indexBuffer;
+        }
+
+        size_t ModelHandlerVK::AcquireModelHandle()
+        {
+            if (!_freeModelHandles.empty())
+            {
+                size_t handle = _freeModelHandles.back();
+                _freeModelHandles.pop_back();
+
+                return handle;
+            }
+
+            size_t nextHandle = _models.size();
+
+            // Make sure we haven't exceeded the limit of the ModelID type, if this hits you need to change type of ModelID to something bigger
+            assert(nextHandle < ModelID::MaxValue());
+
+            _models.emplace_back();
+            return nextHandle;
+        }
+
+        ModelHandlerVK::Model& ModelHandlerVK::GetModel(ModelID modelID)
         {
             using type = type_safe::underlying_type<ModelID>;
 
@@ -107,12 +149,9 @@ namespace Renderer
             assert(_models.size() > static_cast<type>(modelID));
 
             Model& model = _models[static_cast<type>(modelID)];
-            if (model.numIndices == 0)
-            {
-                NC_LOG_FATAL("Tried to get the index buffer of model (%s) which doesn't have indices", model.debugName);
-            }
+            assert(!model.isDestroyed); // This model has been destroyed
 
-            return model.indexBuffer;
+            return model;
         }
 
         void ModelHandlerVK::LoadFromFile(const ModelDesc& desc, TempModelData& data)
@@ -254,46 +293,16 @@ namespace Renderer
 
         void ModelHandlerVK::UpdateVertices(RenderDeviceVK* device, Model& model, const std::vector<Vertex>& vertices)
         {
-            VkBuffer stagingBuffer;
-            VmaAllocation stagingBufferAllocation;
-
-            // Create a staging buffer
+            // Copy the vertex data to our vertex buffer through a staging buffer
             VkDeviceSize vertexBufferSize = sizeof(vertices[0]) * vertices.size();
-            device->CreateBuffer(vertexBufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY, stagingBuffer, stagingBufferAllocation);
-
-            // Copy our vertex data into the staging buffer
-            void* vertexData;
-            vmaMapMemory(device->_allocator, stagingBufferAllocation, &vertexData);
-            memcpy(vertexData, vertices.data(), (size_t)vertexBufferSize);
-            vmaUnmapMemory(device->_allocator, stagingBufferAllocation);
-
-            // Copy the vertex data from our staging buffer to our vertex buffer
-            device->CopyBuffer(stagingBuffer, model.vertexBuffer, vertexBufferSize);
-
-            // Destroy and free our staging buffer
-            vmaDestroyBuffer(device->_allocator, stagingBuffer, stagingBufferAllocation);
+            device->UploadToBuffer(model.vertexBuffer, 0, vertices.data(), vertexBufferSize);
         }
 
         void ModelHandlerVK::UpdateIndices(RenderDeviceVK* device, Model& model, const std::vector<u32>& indices)
         {
-            VkBuffer stagingBuffer;
-            VmaAllocation stagingBufferAllocation;
-
-            // Create a staging buffer
+            // Copy the index data to our index buffer through a staging buffer
             VkDeviceSize indexBufferSize = sizeof(indices[0]) * indices.size();
-            device->CreateBuffer(indexBufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY, stagingBuffer, stagingBufferAllocation);
-
-            // Copy our index data into the staging buffer
-            void* indexData;
-            vmaMapMemory(device->_allocator, stagingBufferAllocation, &indexData);
-            memcpy(indexData, indices.data(), (size_t)indexBufferSize);
-            vmaUnmapMemory(device->_allocator, stagingBufferAllocation);
-
-            // Copy the index data from our staging buffer to our vertex buffer
-            device->CopyBuffer(stagingBuffer, model.indexBuffer, indexBufferSize);
-
-            // Destroy and free our staging buffer
-            vmaDestroyBuffer(device->_allocator, stagingBuffer, stagingBufferAllocation);
+            device->UploadToBuffer(model.indexBuffer, 0, indices.data(), indexBufferSize);
         }
     }
 }
\ No newline at end of file
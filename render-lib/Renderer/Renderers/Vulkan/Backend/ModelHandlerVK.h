@@ -26,6 +26,8 @@ namespace Renderer
 
             ModelID LoadModel(RenderDeviceVK* device, const ModelDesc& desc);
 
+            void DestroyModel(RenderDeviceVK* device, ModelID modelID);
+
             VkBuffer GetVertexBuffer(ModelID modelID);
 
             u32 GetNumIndices(ModelID modelID);
@@ -37,16 +39,18 @@ namespace Renderer
                 ModelDesc desc;
 
                 VkBuffer vertexBuffer = VK_NULL_HANDLE;
-                VmaAllocation vertexBufferAllocation;
+                VmaAllocation vertexBufferAllocation = VK_NULL_HANDLE;
 
                 VkBuffer indexBuffer = VK_NULL_HANDLE;
-                VmaAllocation indexBufferAllocation;
+                VmaAllocation indexBufferAllocation = VK_NULL_HANDLE;
 
                 u32 numVertices = 0;
                 u32 numIndices = 0;
 
                 std::vector<VkVertexInputAttributeDescription> attributeDescriptions;
                 std::string debugName;
+
+                bool isDestroyed = false;
             };
 
             struct TempModelData
@@ -57,6 +61,9 @@ namespace Renderer
             };
 
         private:
+            size_t AcquireModelHandle(); // Reuses the handle of a destroyed model if there is one
+            Model& GetModel(ModelID modelID);
+
             void LoadFromFile(const ModelDesc& desc, TempModelData& data);
             void InitializeModel(RenderDeviceVK* device, Model& model, const TempModelData& data);
             void UpdateVertices(RenderDeviceVK* device, Model& model, const std::vector<Vertex>& vertices);
@@ -64,6 +71,7 @@ namespace Renderer
 
         private:
             std::vector<Model> _models;
+            std::vector<size_t> _freeModelHandles;
         };
     }
 }
\ No newline at end of file
@@ -1,11 +1,11 @@
 #include "PipelineHandlerVK.h"
+#include <algorithm>
 #include <Utils/DebugHandler.h>
 #include <Utils/XXHash64.h>
 #include "FormatConverterVK.h"
 #include "RenderDeviceVK.h"
 #include "ShaderHandlerVK.h"
 #include "ImageHandlerVK.h"
-#include "SpirvReflect.h"
 
 
 namespace Renderer
@@ -14,11 +14,26 @@ namespace Renderer
     {
         PipelineHandlerVK::PipelineHandlerVK()
         {
-
+            for (u32 i = 0; i < NUM_COMPILE_THREADS; i++)
+            {
+                _compileThreads.emplace_back(&PipelineHandlerVK::CompileWorker, this);
+            }
         }
 
         PipelineHandlerVK::~PipelineHandlerVK()
         {
+            {
+                std::lock_guard<std::mutex> lock(_compileMutex);
+                _stopCompiling = true;
+            }
+            _compileCondition.notify_all();
+
+            for (std::thread& thread : _compileThreads)
+            {
+                thread.join();
+            }
+            _compileThreads.clear();
+
             for (auto& pipeline : _graphicsPipelines)
             {
                 // TODO: Cleanup
@@ -45,10 +60,7 @@ namespace Renderer
             {
                 return GraphicsPipelineID(static_cast<gIDType>(nextID));
             }
-            nextID = _graphicsPipelines.size();
-
-            // Make sure we haven't exceeded the limit of the GraphicsPipelineID type, if this hits you need to change type of GraphicsPipelineID to something bigger
-            assert(nextID < GraphicsPipelineID::MaxValue());
+            nextID = AcquireGraphicsPipelineHandle();
 
             GraphicsPipeline pipeline;
             pipeline.desc = desc;
@@ -147,12 +159,14 @@ namespace Renderer
             {
                 ImageID imageID = desc.MutableResourceToImageID(desc.renderTargets[i]);
                 attachmentViews[i] = imageHandler->GetColorView(imageID);
+                pipeline.renderTargets[i] = imageID;
             }
             // Add depthstencil as attachment
             if (desc.depthStencil != RenderPassMutableResource::Invalid())
             {
                 DepthImageID depthImageID = desc.MutableResourceToDepthImageID(desc.depthStencil);
                 attachmentViews[numRenderTargets] = imageHandler->GetDepthView(depthImageID);
+                pipeline.depthStencil = depthImageID;
             }
 
             VkFramebufferCreateInfo framebufferInfo = {};
@@ -169,84 +183,31 @@ namespace Renderer
                 NC_LOG_FATAL("Failed to create framebuffer!");
             }
             
+            // -- Gather push constant ranges from the descriptor --
+            for (auto& pushConstantRange : desc.states.pushConstantRanges)
+            {
+                if (!pushConstantRange.enabled)
+                    break;
+
+                AddPushConstantRange(pushConstantRange, FormatConverterVK::ToVkShaderStageFlags(pushConstantRange.shaderVisibility), pipeline.pushConstantRanges);
+            }
+
             // -- Create Descriptor Set Layout from reflected SPIR-V --
-            std::vector<const ShaderBinary*> shaderBinaries;
             if (desc.states.vertexShader != VertexShaderID::Invalid())
             {
-                shaderBinaries.push_back(shaderHandler->GetSPIRV(desc.states.vertexShader));
+                AddShaderResources(shaderHandler->GetReflection(desc.states.vertexShader), pipeline.pushConstantRanges, pipeline.descriptorSetLayoutDatas);
             }
             if (desc.states.pixelShader != PixelShaderID::Invalid())
             {
-                shaderBinaries.push_back(shaderHandler->GetSPIRV(desc.states.pixelShader));
-            }
-
-            for (auto& shaderBinary : shaderBinaries)
-            {
-                SpvReflectShaderModule reflectModule = {};
-                SpvReflectResult result = spvReflectCreateShaderModule(shaderBinary->size(), shaderBinary->data(), &reflectModule);
-
-                if (result != SPV_REFLECT_RESULT_SUCCESS)
-                {
-                    NC_LOG_FATAL("We failed to reflect the spirv");
-                }
-
-                uint32_t count = 0;
-                result = spvReflectEnumerateDescriptorSets(&reflectModule, &count, NULL);
-                
-                if (result != SPV_REFLECT_RESULT_SUCCESS)
-                {
-                    NC_LOG_FATAL("We failed to reflect the spirv descriptor set count");
-                }
-
-                std::vector<SpvReflectDescriptorSet*> sets(count);
-                result = spvReflectEnumerateDescriptorSets(&reflectModule, &count, sets.data());
-                
-                if (result != SPV_REFLECT_RESULT_SUCCESS)
-                {
-                    NC_LOG_FATAL("We failed to reflect the spirv descriptor sets");
-                }
-
-                for (size_t set = 0; set < sets.size(); set++)
-                {
-                    const SpvReflectDescriptorSet& reflectionSet = *(sets[set]);
-
-                    DescriptorSetLayoutData& layout = GetDescriptorSet(reflectionSet.set, pipeline.descriptorSetLayoutDatas);
-
-                    for (uint32_t binding = 0; binding < reflectionSet.binding_count; binding++)
-                    {
-                        const SpvReflectDescriptorBinding& reflectionBinding = *(reflectionSet.bindings[binding]);
-
-                        layout.bindings.push_back(VkDescriptorSetLayoutBinding());
-                        VkDescriptorSetLayoutBinding& layoutBinding = layout.bindings.back();
-                        layoutBinding.binding = reflectionBinding.binding;
-                        layoutBinding.descriptorType = static_cast<VkDescriptorType>(reflectionBinding.descriptor_type);
-                        layoutBinding.descriptorCount = 1;
-
-                        for (uint32_t dim = 0; dim < reflectionBinding.array.dims_count; dim++)
-                        {
-                            layoutBinding.descriptorCount *= reflectionBinding.array.dims[dim];
-                        }
-                        layoutBinding.stageFlags = static_cast<VkShaderStageFlagBits>(reflectModule.shader_stage);
-                    }
-                    layout.setNumber = reflectionSet.set;
-                    layout.createInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-                    layout.createInfo.bindingCount = static_cast<u32>(layout.bindings.size());
-                    layout.createInfo.pBindings = layout.bindings.data();
-                }
+                AddShaderResources(shaderHandler->GetReflection(desc.states.pixelShader), pipeline.pushConstantRanges, pipeline.descriptorSetLayoutDatas);
             }
 
-            size_t numDescriptorSets = pipeline.descriptorSetLayoutDatas.size();
-            pipeline.descriptorSetLayouts.resize(numDescriptorSets);
+            CreateDescriptorSetLayouts(device, pipeline.descriptorSetLayoutDatas, pipeline.descriptorSetLayouts);
 
-            for (size_t i = 0; i < numDescriptorSets; i++)
-            {
-                if (vkCreateDescriptorSetLayout(device->_device, &pipeline.descriptorSetLayoutDatas[i].createInfo, nullptr, &pipeline.descriptorSetLayouts[i]) != VK_SUCCESS)
-                {
-                    NC_LOG_FATAL("Failed to create descriptor set layout!");
-                }
-            }
+            // Everything vkCreateGraphicsPipelines reads lives in the job since the compile finishes after we have returned
+            std::shared_ptr<GraphicsPipelineCompileJob> job = std::make_shared<GraphicsPipelineCompileJob>();
 
-            std::vector<VkPipelineShaderStageCreateInfo> shaderStages;
+            std::vector<VkPipelineShaderStageCreateInfo>& shaderStages = job->shaderStages;
             if (desc.states.vertexShader != VertexShaderID::Invalid())
             {
                 VkPipelineShaderStageCreateInfo vertShaderStageInfo = {};
@@ -255,6 +216,7 @@ namespace Renderer
 
                 vertShaderStageInfo.module = shaderHandler->GetShaderModule(desc.states.vertexShader);
                 vertShaderStageInfo.pName = "main";
+                vertShaderStageInfo.pSpecializationInfo = GetSpecializationInfo(desc.states.specializationConstants, GraphicsPipelineDesc::MAX_SPECIALIZATION_CONSTANTS, VK_SHADER_STAGE_VERTEX_BIT, job->vertexSpecialization);
 
                 shaderStages.push_back(vertShaderStageInfo);
             }
@@ -266,6 +228,7 @@ namespace Renderer
 
                 fragShaderStageInfo.module = shaderHandler->GetShaderModule(desc.states.pixelShader);
                 fragShaderStageInfo.pName = "main";
+                fragShaderStageInfo.pSpecializationInfo = GetSpecializationInfo(desc.states.specializationConstants, GraphicsPipelineDesc::MAX_SPECIALIZATION_CONSTANTS, VK_SHADER_STAGE_FRAGMENT_BIT, job->pixelSpecialization);
 
                 shaderStages.push_back(fragShaderStageInfo);
             }
@@ -295,7 +258,7 @@ namespace Renderer
             }
 
             // -- Create binding description(s) --
-            std::vector<VkVertexInputBindingDescription> inputBindingDescriptions;
+            std::vector<VkVertexInputBindingDescription>& inputBindingDescriptions = job->inputBindingDescriptions;
 
             u8 vertexBinding = 0;
             if (numVertexAttributes > 0)
@@ -321,7 +284,7 @@ namespace Renderer
                 inputBindingDescriptions.push_back(bindingDescription);
             }
 
-            std::vector<VkVertexInputAttributeDescription> attributeDescriptions;
+            std::vector<VkVertexInputAttributeDescription>& attributeDescriptions = job->attributeDescriptions;
             attributeDescriptions.reserve(numVertexAttributes + numInstanceAttributes);
 
             u8 attributeCounts[2] = { 0 };
@@ -350,20 +313,20 @@ namespace Renderer
                 attributeDescriptions.push_back(attributeDescription);
             }
 
-            VkPipelineVertexInputStateCreateInfo vertexInputInfo = {};
+            VkPipelineVertexInputStateCreateInfo& vertexInputInfo = job->vertexInputInfo;
             vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
             vertexInputInfo.vertexBindingDescriptionCount = static_cast<u32>(inputBindingDescriptions.size());
             vertexInputInfo.pVertexBindingDescriptions = inputBindingDescriptions.data();
             vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size());
             vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data();
 
-            VkPipelineInputAssemblyStateCreateInfo inputAssembly = {};
+            VkPipelineInputAssemblyStateCreateInfo& inputAssembly = job->inputAssembly;
             inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
             inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
             inputAssembly.primitiveRestartEnable = VK_FALSE;
 
             // -- Set viewport and scissor rect --
-            VkViewport viewport = {};
+            VkViewport& viewport = job->viewport;
             viewport.x = desc.states.viewport.topLeftX;
             viewport.y = desc.states.viewport.topLeftY;
             viewport.width = static_cast<f32>(desc.states.viewport.width);
@@ -371,11 +334,11 @@ namespace Renderer
             viewport.minDepth = desc.states.viewport.minDepth;
             viewport.maxDepth = desc.states.viewport.maxDepth;
 
-            VkRect2D scissor = {};
+            VkRect2D& scissor = job->scissor;
             scissor.offset = { desc.states.scissorRect.left, desc.states.scissorRect.top };
             scissor.extent = { static_cast<u32>(desc.states.scissorRect.right - desc.states.scissorRect.left), static_cast<u32>(desc.states.scissorRect.bottom - desc.states.scissorRect.top) };
 
-            VkPipelineViewportStateCreateInfo viewportState = {};
+            VkPipelineViewportStateCreateInfo& viewportState = job->viewportState;
             viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
             viewportState.viewportCount = 1;
             viewportState.pViewports = &viewport;
@@ -383,7 +346,7 @@ namespace Renderer
             viewportState.pScissors = &scissor;
 
             // -- Rasterizer --
-            VkPipelineRasterizationStateCreateInfo rasterizer = {};
+            VkPipelineRasterizationStateCreateInfo& rasterizer = job->rasterizer;
             rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
             rasterizer.depthClampEnable = VK_FALSE;
             rasterizer.rasterizerDiscardEnable = VK_FALSE;
@@ -397,7 +360,7 @@ namespace Renderer
             rasterizer.depthBiasSlopeFactor = desc.states.rasterizerState.depthBiasSlopeFactor;
 
             // -- Multisampling --
-            VkPipelineMultisampleStateCreateInfo multisampling = {};
+            VkPipelineMultisampleStateCreateInfo& multisampling = job->multisampling;
             multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
             multisampling.sampleShadingEnable = VK_FALSE;
             multisampling.rasterizationSamples = FormatConverterVK::ToVkSampleCount(desc.states.rasterizerState.sampleCount);
@@ -407,7 +370,7 @@ namespace Renderer
             multisampling.alphaToOneEnable = VK_FALSE; // Optional
 
             // -- DepthStencil --
-            VkPipelineDepthStencilStateCreateInfo depthStencil = {};
+            VkPipelineDepthStencilStateCreateInfo& depthStencil = job->depthStencil;
             depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
             depthStencil.depthTestEnable = desc.states.depthStencilState.depthEnable;
             depthStencil.depthWriteEnable = desc.states.depthStencilState.depthWriteEnable;
@@ -436,7 +399,8 @@ namespace Renderer
             //depthStencil.back.reference;
 
             // -- Blenders --
-            std::vector<VkPipelineColorBlendAttachmentState> colorBlendAttachments(numRenderTargets);
+            std::vector<VkPipelineColorBlendAttachmentState>& colorBlendAttachments = job->colorBlendAttachments;
+            colorBlendAttachments.resize(numRenderTargets);
             
             for (int i = 0; i < numRenderTargets; i++)
             {
@@ -450,7 +414,7 @@ namespace Renderer
                 colorBlendAttachments[i].colorWriteMask = FormatConverterVK::ToVkColorComponentFlags(desc.states.blendState.renderTargets[i].renderTargetWriteMask);
             }
 
-            VkPipelineColorBlendStateCreateInfo colorBlending = {};
+            VkPipelineColorBlendStateCreateInfo& colorBlending = job->colorBlending;
             colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
             colorBlending.logicOpEnable = desc.states.blendState.renderTargets[0].logicOpEnable;
             colorBlending.logicOp = FormatConverterVK::ToVkLogicOp(desc.states.blendState.renderTargets[0].logicOp);
@@ -465,15 +429,15 @@ namespace Renderer
             pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
             pipelineLayoutInfo.setLayoutCount = static_cast<u32>(pipeline.descriptorSetLayouts.size());
             pipelineLayoutInfo.pSetLayouts = pipeline.descriptorSetLayouts.data();
-            pipelineLayoutInfo.pushConstantRangeCount = 0; // Optional
-            pipelineLayoutInfo.pPushConstantRanges = nullptr; // Optional
+            pipelineLayoutInfo.pushConstantRangeCount = static_cast<u32>(pipeline.pushConstantRanges.size());
+            pipelineLayoutInfo.pPushConstantRanges = pipeline.pushConstantRanges.data();
 
             if (vkCreatePipelineLayout(device->_device, &pipelineLayoutInfo, nullptr, &pipeline.pipelineLayout) != VK_SUCCESS)
             {
                 NC_LOG_FATAL("Failed to create pipeline layout!");
             }
 
-            VkGraphicsPipelineCreateInfo pipelineInfo = {};
+            VkGraphicsPipelineCreateInfo& pipelineInfo = job->pipelineInfo;
             pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
             pipelineInfo.stageCount = static_cast<u32>(shaderStages.size());
             pipelineInfo.pStages = shaderStages.data();
@@ -491,18 +455,455 @@ namespace Renderer
             pipelineInfo.basePipelineHandle = VK_NULL_HANDLE; // Optional
             pipelineInfo.basePipelineIndex = -1; // Optional
 
-            if (vkCreateGraphicsPipelines(device->_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &pipeline.pipeline) != VK_SUCCESS)
+            // Compiling is what causes hitches, so it happens on a worker and the pipeline gets skipped by draws until it's done
+            job->device = device->_device;
+            job->pipelineCache = device->_pipelineCache;
+            pipeline.pipeline = VK_NULL_HANDLE;
+            pipeline.compileJob = job;
+
+            _graphicsPipelines[nextID] = pipeline;
+            _graphicsPipelineLookup[cacheDescHash] = nextID;
+            QueueCompile(nextID);
+
+            return GraphicsPipelineID(static_cast<gIDType>(nextID));
+        }
+
+        ComputePipelineID PipelineHandlerVK::CreatePipeline(RenderDeviceVK* device, ShaderHandlerVK* shaderHandler, ImageHandlerVK* /*imageHandler*/, const ComputePipelineDesc& desc)
+        {
+            assert(desc.computeShader != ComputeShaderID::Invalid()); // A compute pipeline needs a compute shader
+
+            // Check the cache, compute pipelines don't depend on the RenderGraph so the whole desc is hashable
+            size_t nextID;
+            u64 cacheDescHash = XXHash64::hash(&desc, sizeof(desc), 0);
+            if (TryFindExistingCPipeline(cacheDescHash, nextID))
+            {
+                return ComputePipelineID(static_cast<cIDType>(nextID));
+            }
+            nextID = AcquireComputePipelineHandle();
+
+            ComputePipeline pipeline;
+            pipeline.desc = desc;
+            pipeline.cacheDescHash = cacheDescHash;
+
+            // -- Gather push constant ranges from the descriptor, compute only has the one stage so the visibility doesn't matter --
+            for (auto& pushConstantRange : desc.pushConstantRanges)
+            {
+                if (!pushConstantRange.enabled)
+                    break;
+
+                AddPushConstantRange(pushConstantRange, VK_SHADER_STAGE_COMPUTE_BIT, pipeline.pushConstantRanges);
+            }
+
+            // -- Create Descriptor Set Layout from reflected SPIR-V --
+            AddShaderResources(shaderHandler->GetReflection(desc.computeShader), pipeline.pushConstantRanges, pipeline.descriptorSetLayoutDatas);
+            CreateDescriptorSetLayouts(device, pipeline.descriptorSetLayoutDatas, pipeline.descriptorSetLayouts);
+
+            VkPipelineLayoutCreateInfo pipelineLayoutInfo = {};
+            pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+            pipelineLayoutInfo.setLayoutCount = static_cast<u32>(pipeline.descriptorSetLayouts.size());
+            pipelineLayoutInfo.pSetLayouts = pipeline.descriptorSetLayouts.data();
+            pipelineLayoutInfo.pushConstantRangeCount = static_cast<u32>(pipeline.pushConstantRanges.size());
+            pipelineLayoutInfo.pPushConstantRanges = pipeline.pushConstantRanges.data();
+
+            if (vkCreatePipelineLayout(device->_device, &pipelineLayoutInfo, nullptr, &pipeline.pipelineLayout) != VK_SUCCESS)
+            {
+                NC_LOG_FATAL("Failed to create compute pipeline layout!");
+            }
+
+            VkPipelineShaderStageCreateInfo computeShaderStageInfo = {};
+            computeShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+            computeShaderStageInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+            computeShaderStageInfo.module = shaderHandler->GetShaderModule(desc.computeShader);
+            computeShaderStageInfo.pName = "main";
+
+            SpecializationData specialization;
+            computeShaderStageInfo.pSpecializationInfo = GetSpecializationInfo(desc.specializationConstants, ComputePipelineDesc::MAX_SPECIALIZATION_CONSTANTS, VK_SHADER_STAGE_COMPUTE_BIT, specialization);
+
+            VkComputePipelineCreateInfo pipelineInfo = {};
+            pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+            pipelineInfo.stage = computeShaderStageInfo;
+            pipelineInfo.layout = pipeline.pipelineLayout;
+            pipelineInfo.basePipelineHandle = VK_NULL_HANDLE; // Optional
+            pipelineInfo.basePipelineIndex = -1; // Optional
+
+            if (vkCreateComputePipelines(device->_device, device->_pipelineCache, 1, &pipelineInfo, nullptr, &pipeline.pipeline) != VK_SUCCESS)
+            {
+                NC_LOG_FATAL("Failed to create compute pipeline!");
+            }
+            device->_pipelineCacheDirty = true;
+
+            _computePipelines[nextID] = pipeline;
+            _computePipelineLookup[cacheDescHash] = nextID;
+
+            return ComputePipelineID(static_cast<cIDType>(nextID));
+        }
+
+        void PipelineHandlerVK::DestroyPipeline(RenderDeviceVK* device, GraphicsPipelineID id)
+        {
+            // Lets make sure this id exists
+            assert(_graphicsPipelines.size() > static_cast<gIDType>(id));
+
+            GraphicsPipeline& pipeline = _graphicsPipelines[static_cast<gIDType>(id)];
+            assert(!pipeline.isDestroyed); // Destroying a pipeline twice
+
+            // The worker might still be using the render pass and layout, so we need the compile to be done before we can destroy them
+            if (pipeline.isCompiling)
+            {
+                WaitForCompile(*pipeline.compileJob);
+                FinishCompile(device, static_cast<gIDType>(id));
+            }
+
+            VkPipeline vkPipeline = pipeline.pipeline;
+            VkPipelineLayout pipelineLayout = pipeline.pipelineLayout;
+            VkRenderPass renderPass = pipeline.renderPass;
+            VkFramebuffer framebuffer = pipeline.framebuffer;
+            std::vector<VkDescriptorSetLayout> descriptorSetLayouts = pipeline.descriptorSetLayouts;
+
+            device->DeferDestroy([device, vkPipeline, pipelineLayout, renderPass, framebuffer, descriptorSetLayouts]()
+            {
+                vkDestroyPipeline(device->_device, vkPipeline, nullptr);
+                vkDestroyPipelineLayout(device->_device, pipelineLayout, nullptr);
+
+                for (VkDescriptorSetLayout descriptorSetLayout : descriptorSetLayouts)
+                {
+                    vkDestroyDescriptorSetLayout(device->_device, descriptorSetLayout, nullptr);
+                }
+
+                vkDestroyFramebuffer(device->_device, framebuffer, nullptr);
+                vkDestroyRenderPass(device->_device, renderPass, nullptr);
+            });
+
+            _graphicsPipelineLookup.erase(pipeline.cacheDescHash);
+
+            pipeline = GraphicsPipeline();
+            pipeline.isDestroyed = true;
+
+            _freeGraphicsPipelineHandles.push_back(static_cast<gIDType>(id));
+        }
+
+        void PipelineHandlerVK::DestroyPipeline(RenderDeviceVK* device, ComputePipelineID id)
+        {
+            // Lets make sure this id exists
+            assert(_computePipelines.size() > static_cast<cIDType>(id));
+
+            ComputePipeline& pipeline = _computePipelines[static_cast<cIDType>(id)];
+            assert(!pipeline.isDestroyed); // Destroying a pipeline twice
+
+            VkPipeline vkPipeline = pipeline.pipeline;
+            VkPipelineLayout pipelineLayout = pipeline.pipelineLayout;
+            std::vector<VkDescriptorSetLayout> descriptorSetLayouts = pipeline.descriptorSetLayouts;
+
+            device->DeferDestroy([device, vkPipeline, pipelineLayout, descriptorSetLayouts]()
+            {
+                vkDestroyPipeline(device->_device, vkPipeline, nullptr);
+                vkDestroyPipelineLayout(device->_device, pipelineLayout, nullptr);
+
+                for (VkDescriptorSetLayout descriptorSetLayout : descriptorSetLayouts)
+                {
+                    vkDestroyDescriptorSetLayout(device->_device, descriptorSetLayout, nullptr);
+                }
+            });
+
+            _computePipelineLookup.erase(pipeline.cacheDescHash);
+
+            pipeline = ComputePipeline();
+            pipeline.isDestroyed = true;
+
+            _freeComputePipelineHandles.push_back(static_cast<cIDType>(id));
+        }
+
+        void PipelineHandlerVK::CollectCompiledPipelines(RenderDeviceVK* device)
+        {
+            for (size_t i = 0; i < _compilingPipelines.size();)
+            {
+                size_t id = _compilingPipelines[i];
+                GraphicsPipelineCompileJob& job = *_graphicsPipelines[id].compileJob;
+
+                if (job.isDone.load(std::memory_order_acquire))
+                {
+                    FinishCompile(device, id); // Removes it from _compilingPipelines
+                }
+                else
+                {
+                    i++;
+                }
+            }
+        }
+
+        void PipelineHandlerVK::FinishCompile(RenderDeviceVK* device, size_t id)
+        {
+            GraphicsPipeline& pipeline = _graphicsPipelines[id];
+            GraphicsPipelineCompileJob& job = *pipeline.compileJob;
+            assert(job.isDone.load(std::memory_order_acquire)); // Only finish compiles the worker is done with
+
+            if (job.result != VK_SUCCESS)
             {
                 NC_LOG_FATAL("Failed to create graphics pipeline!");
             }
 
-            _graphicsPipelines.push_back(pipeline);
-            return GraphicsPipelineID(static_cast<gIDType>(nextID));
+            // When a reloaded shader caused the compile, the pipeline it replaces might still be in flight
+            if (pipeline.pipeline != VK_NULL_HANDLE)
+            {
+                VkPipeline oldPipeline = pipeline.pipeline;
+                device->DeferDestroy([device, oldPipeline]()
+                {
+                    vkDestroyPipeline(device->_device, oldPipeline, nullptr);
+                });
+            }
+
+            pipeline.pipeline = job.pipeline;
+            pipeline.isCompiling = false;
+            device->_pipelineCacheDirty = true;
+
+            auto it = std::find(_compilingPipelines.begin(), _compilingPipelines.end(), id);
+            assert(it != _compilingPipelines.end()); // Every compiling pipeline should be in this list
+
+            *it = _compilingPipelines.back();
+            _compilingPipelines.pop_back();
         }
 
-        ComputePipelineID PipelineHandlerVK::CreatePipeline(RenderDeviceVK* device, ShaderHandlerVK* shaderHandler, ImageHandlerVK* imageHandler, const ComputePipelineDesc& desc)
+        void PipelineHandlerVK::RecompilePipelinesUsingShaders(RenderDeviceVK* device, ShaderHandlerVK* shaderHandler, const ReloadedShaders& reloadedShaders)
         {
-            return ComputePipelineID();
+            auto contains = [](const auto& ids, auto id) { return std::find(ids.begin(), ids.end(), id) != ids.end(); };
+
+            for (size_t i = 0; i < _graphicsPipelines.size(); i++)
+            {
+                GraphicsPipeline& pipeline = _graphicsPipelines[i];
+                if (pipeline.isDestroyed)
+                    continue;
+
+                const GraphicsPipelineDesc::States& states = pipeline.desc.states;
+                if (!contains(reloadedShaders.vertexShaders, states.vertexShader) && !contains(reloadedShaders.pixelShaders, states.pixelShader))
+                    continue;
+
+                // A compile that is still running reads the old shader modules, the caller destroys those after this so it has to finish even if we don't recompile
+                if (pipeline.isCompiling)
+                {
+                    WaitForCompile(*pipeline.compileJob);
+                    FinishCompile(device, i);
+                }
+
+                // Only the shader code can change, the render pass and layouts stay the same
+                std::vector<DescriptorSetLayoutData> descriptorSetLayoutDatas;
+                if (states.vertexShader != VertexShaderID::Invalid())
+                {
+                    AddShaderResources(shaderHandler->GetReflection(states.vertexShader), pipeline.pushConstantRanges, descriptorSetLayoutDatas);
+                }
+                if (states.pixelShader != PixelShaderID::Invalid())
+                {
+                    AddShaderResources(shaderHandler->GetReflection(states.pixelShader), pipeline.pushConstantRanges, descriptorSetLayoutDatas);
+                }
+
+                if (!HasSameDescriptorSets(pipeline.descriptorSetLayoutDatas, descriptorSetLayoutDatas))
+                {
+                    NC_LOG_WARNING("[Renderer]: A reloaded shader changed the descriptor sets of graphics pipeline %u, restart to pick it up", static_cast<u32>(i));
+                    continue;
+                }
+
+                GraphicsPipelineCompileJob& job = *pipeline.compileJob;
+                for (VkPipelineShaderStageCreateInfo& shaderStage : job.shaderStages)
+                {
+                    if (shaderStage.stage == VK_SHADER_STAGE_VERTEX_BIT)
+                    {
+                        shaderStage.module = shaderHandler->GetShaderModule(states.vertexShader);
+                    }
+                    else if (shaderStage.stage == VK_SHADER_STAGE_FRAGMENT_BIT)
+                    {
+                        shaderStage.module = shaderHandler->GetShaderModule(states.pixelShader);
+                    }
+                }
+
+                job.pipeline = VK_NULL_HANDLE;
+                job.result = VK_SUCCESS;
+                job.isDone.store(false, std::memory_order_release);
+
+                QueueCompile(i);
+            }
+
+            for (size_t i = 0; i < _computePipelines.size(); i++)
+            {
+                ComputePipeline& pipeline = _computePipelines[i];
+                if (pipeline.isDestroyed || !contains(reloadedShaders.computeShaders, pipeline.desc.computeShader))
+                    continue;
+
+                std::vector<DescriptorSetLayoutData> descriptorSetLayoutDatas;
+                AddShaderResources(shaderHandler->GetReflection(pipeline.desc.computeShader), pipeline.pushConstantRanges, descriptorSetLayoutDatas);
+
+                if (!HasSameDescriptorSets(pipeline.descriptorSetLayoutDatas, descriptorSetLayoutDatas))
+                {
+                    NC_LOG_WARNING("[Renderer]: A reloaded shader changed the descriptor sets of compute pipeline %u, restart to pick it up", static_cast<u32>(i));
+                    continue;
+                }
+
+                // Compute pipelines are cheap enough to recompile right away
+                VkPipelineShaderStageCreateInfo computeShaderStageInfo = {};
+                computeShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+                computeShaderStageInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+                computeShaderStageInfo.module = shaderHandler->GetShaderModule(pipeline.desc.computeShader);
+                computeShaderStageInfo.pName = "main";
+
+                SpecializationData specialization;
+                computeShaderStageInfo.pSpecializationInfo = GetSpecializationInfo(pipeline.desc.specializationConstants, ComputePipelineDesc::MAX_SPECIALIZATION_CONSTANTS, VK_SHADER_STAGE_COMPUTE_BIT, specialization);
+
+                VkComputePipelineCreateInfo pipelineInfo = {};
+                pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+                pipelineInfo.stage = computeShaderStageInfo;
+                pipelineInfo.layout = pipeline.pipelineLayout;
+                pipelineInfo.basePipelineHandle = VK_NULL_HANDLE; // Optional
+                pipelineInfo.basePipelineIndex = -1; // Optional
+
+                VkPipeline newPipeline;
+                if (vkCreateComputePipelines(device->_device, device->_pipelineCache, 1, &pipelineInfo, nullptr, &newPipeline) != VK_SUCCESS)
+                {
+                    NC_LOG_FATAL("Failed to recreate compute pipeline!");
+                }
+                device->_pipelineCacheDirty = true;
+
+                VkPipeline oldPipeline = pipeline.pipeline;
+                device->DeferDestroy([device, oldPipeline]()
+                {
+                    vkDestroyPipeline(device->_device, oldPipeline, nullptr);
+                });
+
+                pipeline.pipeline = newPipeline;
+            }
+        }
+
+        bool PipelineHandlerVK::HasSameDescriptorSets(const std::vector<DescriptorSetLayoutData>& setsA, const std::vector<DescriptorSetLayoutData>& setsB)
+        {
+            if (setsA.size() != setsB.size())
+                return false;
+
+            for (const DescriptorSetLayoutData& setA : setsA)
+            {
+                auto setB = std::find_if(setsB.begin(), setsB.end(), [&setA](const DescriptorSetLayoutData& set) { return set.setNumber == setA.setNumber; });
+                if (setB == setsB.end() || setA.bindings.size() != setB->bindings.size())
+                    return false;
+
+                for (const VkDescriptorSetLayoutBinding& bindingA : setA.bindings)
+                {
+                    auto bindingB = std::find_if(setB->bindings.begin(), setB->bindings.end(), [&bindingA](const VkDescriptorSetLayoutBinding& binding) { return binding.binding == bindingA.binding; });
+                    if (bindingB == setB->bindings.end() || bindingB->descriptorType != bindingA.descriptorType || bindingB->descriptorCount != bindingA.descriptorCount)
+                        return false;
+                }
+            }
+
+            return true;
+        }
+
+        void PipelineHandlerVK::QueueCompile(size_t id)
+        {
+            GraphicsPipeline& pipeline = _graphicsPipelines[id];
+            pipeline.isCompiling = true;
+            _compilingPipelines.push_back(id);
+
+            {
+                std::lock_guard<std::mutex> lock(_compileMutex);
+                _compileQueue.push(pipeline.compileJob);
+            }
+            _compileCondition.notify_one();
+        }
+
+        void PipelineHandlerVK::WaitForCompile(GraphicsPipelineCompileJob& job)
+        {
+            std::unique_lock<std::mutex> lock(_compileMutex);
+            _compileFinishedCondition.wait(lock, [&job]() { return job.isDone.load(std::memory_order_acquire); });
+        }
+
+        void PipelineHandlerVK::CompileWorker()
+        {
+            while (true)
+            {
+                std::shared_ptr<GraphicsPipelineCompileJob> job;
+                {
+                    std::unique_lock<std::mutex> lock(_compileMutex);
+                    _compileCondition.wait(lock, [this]() { return _stopCompiling || !_compileQueue.empty(); });
+
+                    if (_stopCompiling)
+                        return;
+
+                    job = _compileQueue.front();
+                    _compileQueue.pop();
+                }
+
+                // VkPipelineCache is internally synchronized, so the workers can share it
+                job->result = vkCreateGraphicsPipelines(job->device, job->pipelineCache, 1, &job->pipelineInfo, nullptr, &job->pipeline);
+
+                {
+                    std::lock_guard<std::mutex> lock(_compileMutex);
+                    job->isDone.store(true, std::memory_order_release);
+                }
+                _compileFinishedCondition.notify_all();
+            }
+        }
+
+        void PipelineHandlerVK::DestroyPipelinesUsingImage(RenderDeviceVK* device, ImageID imageID)
+        {
+            for (size_t i = 0; i < _graphicsPipelines.size(); i++)
+            {
+                GraphicsPipeline& pipeline = _graphicsPipelines[i];
+                if (pipeline.isDestroyed)
+                    continue;
+
+                for (ImageID renderTarget : pipeline.renderTargets)
+                {
+                    if (renderTarget == imageID)
+                    {
+                        DestroyPipeline(device, GraphicsPipelineID(static_cast<gIDType>(i)));
+                        break;
+                    }
+                }
+            }
+        }
+
+        void PipelineHandlerVK::DestroyPipelinesUsingImage(RenderDeviceVK* device, DepthImageID imageID)
+        {
+            for (size_t i = 0; i < _graphicsPipelines.size(); i++)
+            {
+                GraphicsPipeline& pipeline = _graphicsPipelines[i];
+                if (!pipeline.isDestroyed && pipeline.depthStencil == imageID)
+                {
+                    DestroyPipeline(device, GraphicsPipelineID(static_cast<gIDType>(i)));
+                }
+            }
+        }
+
+        size_t PipelineHandlerVK::AcquireGraphicsPipelineHandle()
+        {
+            if (!_freeGraphicsPipelineHandles.empty())
+            {
+                size_t handle = _freeGraphicsPipelineHandles.back();
+                _freeGraphicsPipelineHandles.pop_back();
+
+                return handle;
+            }
+
+            size_t nextHandle = _graphicsPipelines.size();
+
+            // Make sure we haven't exceeded the limit of the GraphicsPipelineID type, if this hits you need to change type of GraphicsPipelineID to something bigger
+            assert(nextHandle < GraphicsPipelineID::MaxValue());
+
+            _graphicsPipelines.emplace_back();
+            return nextHandle;
+        }
+
+        size_t PipelineHandlerVK::AcquireComputePipelineHandle()
+        {
+            if (!_freeComputePipelineHandles.empty())
+            {
+                size_t handle = _freeComputePipelineHandles.back();
+                _freeComputePipelineHandles.pop_back();
+
+                return handle;
+            }
+
+            size_t nextHandle = _computePipelines.size();
+
+            // Make sure we haven't exceeded the limit of the ComputePipelineID type, if this hits you need to change type of ComputePipelineID to something bigger
+            assert(nextHandle < ComputePipelineID::MaxValue());
+
+            _computePipelines.emplace_back();
+            return nextHandle;
         }
 
         u64 PipelineHandlerVK::CalculateCacheDescHash(const GraphicsPipelineDesc& desc)
@@ -539,34 +940,134 @@ namespace Renderer
 
         bool PipelineHandlerVK::TryFindExistingGPipeline(u64 descHash, size_t& id)
         {
-            id = 0;
+            auto it = _graphicsPipelineLookup.find(descHash);
+            if (it == _graphicsPipelineLookup.end())
+                return false;
 
-            for (auto& pipeline : _graphicsPipelines)
+            id = it->second;
+            return true;
+        }
+
+        bool PipelineHandlerVK::TryFindExistingCPipeline(u64 descHash, size_t& id)
+        {
+            auto it = _computePipelineLookup.find(descHash);
+            if (it == _computePipelineLookup.end())
+                return false;
+
+            id = it->second;
+            return true;
+        }
+
+        const VkSpecializationInfo* PipelineHandlerVK::GetSpecializationInfo(const SpecializationConstant* constants, u32 numConstants, VkShaderStageFlags stage, SpecializationData& data)
+        {
+            for (u32 i = 0; i < numConstants; i++)
             {
-                if (descHash == pipeline.cacheDescHash)
+                const SpecializationConstant& constant = constants[i];
+                if (!constant.enabled)
+                    break;
+
+                // Compute only has the one stage, so it gets every constant regardless of visibility
+                if (stage != VK_SHADER_STAGE_COMPUTE_BIT && !(FormatConverterVK::ToVkShaderStageFlags(constant.shaderVisibility) & stage))
+                    continue;
+
+                VkSpecializationMapEntry& mapEntry = data.mapEntries.emplace_back();
+                mapEntry.constantID = constant.constantID;
+                mapEntry.offset = static_cast<u32>(data.values.size() * sizeof(u32));
+                mapEntry.size = sizeof(u32);
+
+                data.values.push_back(constant.value);
+            }
+
+            if (data.mapEntries.empty())
+                return nullptr;
+
+            data.info.mapEntryCount = static_cast<u32>(data.mapEntries.size());
+            data.info.pMapEntries = data.mapEntries.data();
+            data.info.dataSize = data.values.size() * sizeof(u32);
+            data.info.pData = data.values.data();
+
+            return &data.info;
+        }
+
+        void PipelineHandlerVK::AddPushConstantRange(const PushConstantRange& pushConstantRange, VkShaderStageFlags stageFlags, std::vector<VkPushConstantRange>& ranges)
+        {
+            if (pushConstantRange.size == 0 || pushConstantRange.offset + pushConstantRange.size > MAX_PUSH_CONSTANT_SIZE)
+            {
+                NC_LOG_FATAL("Push constant ranges need a size and have to fit within MAX_PUSH_CONSTANT_SIZE bytes");
+            }
+
+            VkPushConstantRange& range = ranges.emplace_back();
+            range.stageFlags = stageFlags;
+            range.offset = pushConstantRange.offset;
+            range.size = pushConstantRange.size;
+        }
+
+        void PipelineHandlerVK::AddShaderResources(const ShaderReflection& reflection, const std::vector<VkPushConstantRange>& pushConstantRanges, std::vector<DescriptorSetLayoutData>& sets)
+        {
+            for (const ShaderReflection::DescriptorBinding& reflectionBinding : reflection.descriptorBindings)
+            {
+                DescriptorSetLayoutData& layout = GetDescriptorSet(reflectionBinding.set, sets);
+
+                // Several stages of the same pipeline can use the same binding, it only goes into the layout once
+                bool alreadyAdded = false;
+                for (const VkDescriptorSetLayoutBinding& layoutBinding : layout.bindings)
                 {
-                    return true;
+                    alreadyAdded |= layoutBinding.binding == reflectionBinding.binding;
                 }
-                id++;
+
+                if (!alreadyAdded)
+                {
+                    layout.bindings.push_back(VkDescriptorSetLayoutBinding());
+                    VkDescriptorSetLayoutBinding& layoutBinding = layout.bindings.back();
+                    layoutBinding.binding = reflectionBinding.binding;
+                    layoutBinding.descriptorType = static_cast<VkDescriptorType>(reflectionBinding.descriptorType);
+                    layoutBinding.descriptorCount = reflectionBinding.descriptorCount;
+
+                    // Descriptor sets get allocated once against whichever pipeline binds them first, visible to every stage they stay compatible with both graphics and compute layouts
+                    layoutBinding.stageFlags = VK_SHADER_STAGE_ALL;
+                }
+
+                layout.setNumber = reflectionBinding.set;
+                layout.createInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+                layout.createInfo.bindingCount = static_cast<u32>(layout.bindings.size());
             }
 
-            return false;
+            // Every push constant block a shader uses has to be covered by a range in the descriptor that is visible to that stage
+            VkShaderStageFlags shaderStage = static_cast<VkShaderStageFlags>(reflection.shaderStage);
+            for (const ShaderReflection::PushConstantBlock& pushConstantBlock : reflection.pushConstantBlocks)
+            {
+                bool isCovered = false;
+                for (const VkPushConstantRange& range : pushConstantRanges)
+                {
+                    if ((range.stageFlags & shaderStage) && range.offset <= pushConstantBlock.begin && pushConstantBlock.end <= range.offset + range.size)
+                    {
+                        isCovered = true;
+                        break;
+                    }
+                }
+
+                if (!isCovered)
+                {
+                    NC_LOG_FATAL("Shader push constant block %s (bytes %u to %u) isn't covered by any of the pipeline's pushConstantRanges", pushConstantBlock.name.c_str(), pushConstantBlock.begin, pushConstantBlock.end);
+                }
+            }
         }
 
-        bool PipelineHandlerVK::TryFindExistingCPipeline(u64 descHash, size_t& id)
+        void PipelineHandlerVK::CreateDescriptorSetLayouts(RenderDeviceVK* device, std::vector<DescriptorSetLayoutData>& sets, std::vector<VkDescriptorSetLayout>& layouts)
         {
-            id = 0;
+            size_t numDescriptorSets = sets.size();
+            layouts.resize(numDescriptorSets);
 
-            for (auto& pipeline : _computePipelines)
+            for (size_t i = 0; i < numDescriptorSets; i++)
             {
-                if (descHash == pipeline.cacheDescHash)
+                // Reflecting more shaders can grow the bindings, so only point at them once they are final
+                sets[i].createInfo.pBindings = sets[i].bindings.data();
+
+                if (vkCreateDescriptorSetLayout(device->_device, &sets[i].createInfo, nullptr, &layouts[i]) != VK_SUCCESS)
                 {
-                    return true;
+                    NC_LOG_FATAL("Failed to create descriptor set layout!");
                 }
-                id++;
             }
-
-            return false;
         }
 
         DescriptorSetLayoutData& PipelineHandlerVK::GetDescriptorSet(u32 setNumber, std::vector<DescriptorSetLayoutData>& sets)
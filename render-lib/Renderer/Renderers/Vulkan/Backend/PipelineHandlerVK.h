@@ -1,6 +1,12 @@
 #pragma once
 #include <NovusTypes.h>
 #include <vector>
+#include <queue>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include <vulkan/vulkan.h>
 #include <robin_hood.h>
 
@@ -14,6 +20,8 @@ namespace Renderer
         class RenderDeviceVK;
         class ShaderHandlerVK;
         class ImageHandlerVK;
+        struct ReloadedShaders;
+        struct ShaderReflection;
 
         struct DescriptorSetLayoutData
         {
@@ -22,6 +30,13 @@ namespace Renderer
             std::vector<VkDescriptorSetLayoutBinding> bindings;
         };
 
+        struct SpecializationData
+        {
+            std::vector<VkSpecializationMapEntry> mapEntries;
+            std::vector<u32> values;
+            VkSpecializationInfo info = {};
+        };
+
         class PipelineHandlerVK
         {
             using gIDType = type_safe::underlying_type<GraphicsPipelineID>;
@@ -33,8 +48,23 @@ namespace Renderer
             GraphicsPipelineID CreatePipeline(RenderDeviceVK* device, ShaderHandlerVK* shaderHandler, ImageHandlerVK* imageHandler, const GraphicsPipelineDesc& desc);
             ComputePipelineID CreatePipeline(RenderDeviceVK* device, ShaderHandlerVK* shaderHandler, ImageHandlerVK* imageHandler, const ComputePipelineDesc& desc);
 
+            // Pipelines are shared by everyone who created the same desc, destroying it destroys it for all of them
+            void DestroyPipeline(RenderDeviceVK* device, GraphicsPipelineID id);
+            void DestroyPipeline(RenderDeviceVK* device, ComputePipelineID id);
+
+            // Graphics pipelines own a framebuffer pointing at their render targets, so they have to go when one of those images does
+            void DestroyPipelinesUsingImage(RenderDeviceVK* device, ImageID imageID);
+            void DestroyPipelinesUsingImage(RenderDeviceVK* device, DepthImageID imageID);
+
             const GraphicsPipelineDesc& GetDescriptor(GraphicsPipelineID id) { return _graphicsPipelines[static_cast<gIDType>(id)].desc; }
-            const ComputePipelineDesc& GetDescriptor(ComputePipelineID id) { return _computePipelines[static_cast<gIDType>(id)].desc; }
+            const ComputePipelineDesc& GetDescriptor(ComputePipelineID id) { return _computePipelines[static_cast<cIDType>(id)].desc; }
+
+            // Graphics pipelines are compiled on worker threads, draws using a pipeline that isn't ready yet should be skipped
+            bool IsPipelineReady(GraphicsPipelineID id) { return _graphicsPipelines[static_cast<gIDType>(id)].pipeline != VK_NULL_HANDLE; }
+            void CollectCompiledPipelines(RenderDeviceVK* device); // Call once per frame, outside of command list recording
+
+            // The old pipelines keep being used until the recompiled ones are collected, so reloading doesn't stall the frame
+            void RecompilePipelinesUsingShaders(RenderDeviceVK* device, ShaderHandlerVK* shaderHandler, const ReloadedShaders& reloadedShaders);
 
             VkPipeline GetPipeline(GraphicsPipelineID id) { return _graphicsPipelines[static_cast<gIDType>(id)].pipeline; }
             VkRenderPass GetRenderPass(GraphicsPipelineID id) { return _graphicsPipelines[static_cast<gIDType>(id)].renderPass; }
@@ -43,9 +73,45 @@ namespace Renderer
             DescriptorSetLayoutData& GetDescriptorSetLayoutData(GraphicsPipelineID id, u32 index) { return _graphicsPipelines[static_cast<gIDType>(id)].descriptorSetLayoutDatas[index]; }
             VkDescriptorSetLayout& GetDescriptorSetLayout(GraphicsPipelineID id, u32 index) { return _graphicsPipelines[static_cast<gIDType>(id)].descriptorSetLayouts[index]; }
             VkPipelineLayout& GetPipelineLayout(GraphicsPipelineID id) { return _graphicsPipelines[static_cast<gIDType>(id)].pipelineLayout; }
+            const std::vector<VkPushConstantRange>& GetPushConstantRanges(GraphicsPipelineID id) { return _graphicsPipelines[static_cast<gIDType>(id)].pushConstantRanges; }
+
+            VkPipeline GetPipeline(ComputePipelineID id) { return _computePipelines[static_cast<cIDType>(id)].pipeline; }
+            DescriptorSetLayoutData& GetDescriptorSetLayoutData(ComputePipelineID id, u32 index) { return _computePipelines[static_cast<cIDType>(id)].descriptorSetLayoutDatas[index]; }
+            VkDescriptorSetLayout& GetDescriptorSetLayout(ComputePipelineID id, u32 index) { return _computePipelines[static_cast<cIDType>(id)].descriptorSetLayouts[index]; }
+            VkPipelineLayout& GetPipelineLayout(ComputePipelineID id) { return _computePipelines[static_cast<cIDType>(id)].pipelineLayout; }
+            const std::vector<VkPushConstantRange>& GetPushConstantRanges(ComputePipelineID id) { return _computePipelines[static_cast<cIDType>(id)].pushConstantRanges; }
 
         private:
 
+            struct GraphicsPipelineCompileJob
+            {
+                std::vector<VkPipelineShaderStageCreateInfo> shaderStages;
+                std::vector<VkVertexInputBindingDescription> inputBindingDescriptions;
+                std::vector<VkVertexInputAttributeDescription> attributeDescriptions;
+                std::vector<VkPipelineColorBlendAttachmentState> colorBlendAttachments;
+                SpecializationData vertexSpecialization;
+                SpecializationData pixelSpecialization;
+
+                VkPipelineVertexInputStateCreateInfo vertexInputInfo = {};
+                VkPipelineInputAssemblyStateCreateInfo inputAssembly = {};
+                VkViewport viewport = {};
+                VkRect2D scissor = {};
+                VkPipelineViewportStateCreateInfo viewportState = {};
+                VkPipelineRasterizationStateCreateInfo rasterizer = {};
+                VkPipelineMultisampleStateCreateInfo multisampling = {};
+                VkPipelineDepthStencilStateCreateInfo depthStencil = {};
+                VkPipelineColorBlendStateCreateInfo colorBlending = {};
+                VkGraphicsPipelineCreateInfo pipelineInfo = {};
+
+                VkDevice device = VK_NULL_HANDLE;
+                VkPipelineCache pipelineCache = VK_NULL_HANDLE;
+
+                // Written by the worker, only read these once isDone is set
+                VkPipeline pipeline = VK_NULL_HANDLE;
+                VkResult result = VK_SUCCESS;
+                std::atomic<bool> isDone{ false };
+            };
+
             struct GraphicsPipeline
             {
                 GraphicsPipelineDesc desc;
@@ -57,11 +123,20 @@ namespace Renderer
                 VkPipeline pipeline;
                 VkFramebuffer framebuffer;
 
+                std::shared_ptr<GraphicsPipelineCompileJob> compileJob; // Kept after compiling so the pipeline can be recompiled when one of its shaders is reloaded
+                bool isCompiling = false;
+
                 std::vector<DescriptorSetLayoutData> descriptorSetLayoutDatas;
                 std::vector<VkDescriptorSetLayout> descriptorSetLayouts;
+                std::vector<VkPushConstantRange> pushConstantRanges;
 
                 VkDescriptorPool descriptorPool;
                 std::vector<VkDescriptorSet> descriptorSets;
+
+                ImageID renderTargets[MAX_RENDER_TARGETS] = { ImageID::Invalid(), ImageID::Invalid(), ImageID::Invalid(), ImageID::Invalid(), ImageID::Invalid(), ImageID::Invalid(), ImageID::Invalid(), ImageID::Invalid() };
+                DepthImageID depthStencil = DepthImageID::Invalid();
+
+                bool isDestroyed = false;
             };
 
             struct GraphicsPipelineCacheDesc
@@ -76,17 +151,60 @@ namespace Renderer
             {
                 ComputePipelineDesc desc;
                 u64 cacheDescHash;
+
+                VkPipelineLayout pipelineLayout;
+                VkPipeline pipeline;
+
+                std::vector<DescriptorSetLayoutData> descriptorSetLayoutDatas;
+                std::vector<VkDescriptorSetLayout> descriptorSetLayouts;
+                std::vector<VkPushConstantRange> pushConstantRanges;
+
+                bool isDestroyed = false;
             };
 
         private:
+            size_t AcquireGraphicsPipelineHandle(); // Reuses the handle of a destroyed pipeline if there is one
+            size_t AcquireComputePipelineHandle();
+
             u64 CalculateCacheDescHash(const GraphicsPipelineDesc& desc);
             bool TryFindExistingGPipeline(u64 descHash, size_t& id);
             bool TryFindExistingCPipeline(u64 descHash, size_t& id);
             DescriptorSetLayoutData& GetDescriptorSet(u32 setNumber, std::vector<DescriptorSetLayoutData>& sets);
+
+            // Returns nullptr when none of the constants are visible to the stage
+            const VkSpecializationInfo* GetSpecializationInfo(const SpecializationConstant* constants, u32 numConstants, VkShaderStageFlags stage, SpecializationData& data);
+            void AddPushConstantRange(const PushConstantRange& pushConstantRange, VkShaderStageFlags stageFlags, std::vector<VkPushConstantRange>& ranges);
+            void AddShaderResources(const ShaderReflection& reflection, const std::vector<VkPushConstantRange>& pushConstantRanges, std::vector<DescriptorSetLayoutData>& sets); // Adds the shader's descriptor sets and validates its push constants
+            void CreateDescriptorSetLayouts(RenderDeviceVK* device, std::vector<DescriptorSetLayoutData>& sets, std::vector<VkDescriptorSetLayout>& layouts);
+
+            bool HasSameDescriptorSets(const std::vector<DescriptorSetLayoutData>& setsA, const std::vector<DescriptorSetLayoutData>& setsB);
+
+            void QueueCompile(size_t id);
+            void FinishCompile(RenderDeviceVK* device, size_t id);
+            void WaitForCompile(GraphicsPipelineCompileJob& job);
+            void CompileWorker();
             
         private:
             std::vector<GraphicsPipeline> _graphicsPipelines;
             std::vector<ComputePipeline> _computePipelines;
+
+            std::vector<size_t> _freeGraphicsPipelineHandles;
+            std::vector<size_t> _freeComputePipelineHandles;
+
+            // Maps a cacheDescHash to the pipeline created from it, destroyed pipelines are removed
+            robin_hood::unordered_map<u64, size_t> _graphicsPipelineLookup;
+            robin_hood::unordered_map<u64, size_t> _computePipelineLookup;
+
+            static const u32 NUM_COMPILE_THREADS = 2;
+
+            std::vector<std::thread> _compileThreads;
+            std::mutex _compileMutex;
+            std::condition_variable _compileCondition;
+            std::condition_variable _compileFinishedCondition;
+            std::queue<std::shared_ptr<GraphicsPipelineCompileJob>> _compileQueue;
+            bool _stopCompiling = false;
+
+            std::vector<size_t> _compilingPipelines; // Graphics pipelines that have been handed to a worker but not collected yet
         };
     }
 }
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include "DebugMarkerUtilVK.h"
 #include "SwapChainVK.h"
 #include "ShaderHandlerVK.h"
+#include "UploadHandlerVK.h"
 #include "../../../Descriptors/VertexShaderDesc.h"
 #include "../../../Descriptors/PixelShaderDesc.h"
 
@@ -16,6 +17,9 @@
 #pragma warning(pop)
 #include <map>
 #include <set>
+#include <algorithm>
+#include <fstream>
+#include <filesystem>
 
 #define NOVUSCORE_RENDERER_GPU_VALIDATION 1
 
@@ -70,21 +74,51 @@ namespace Renderer
             CreateSurface(glfwWindow, swapChain);
             CreateSwapChain(size, swapChain);
             CreateImageViews(swapChain);
+            CreateSemaphores(swapChain);
             CreateFrameBuffers(swapChain);
-            CreateBlitPipeline(shaderHandler, swapChain, "blitFloat", IMAGE_COMPONENT_TYPE_FLOAT);
-            CreateBlitPipeline(shaderHandler, swapChain, "blitUint", IMAGE_COMPONENT_TYPE_UINT);
-            CreateBlitPipeline(shaderHandler, swapChain, "blitInt", IMAGE_COMPONENT_TYPE_SINT);
+            CreateBlitPipelines(shaderHandler, swapChain);
         }
 
-        BufferBackend* RenderDeviceVK::CreateBufferBackend(size_t size, Backend::BufferBackend::Type type)
+        bool RenderDeviceVK::RecreateSwapChain(ShaderHandlerVK* shaderHandler, Window* window)
+        {
+            SwapChainVK* swapChain = static_cast<SwapChainVK*>(window->GetSwapChain());
+
+            ivec2 size;
+            glfwGetWindowSize(window->GetWindow(), &size.x, &size.y);
+
+            if (size.x == 0 || size.y == 0)
+                return false;
+
+            // The old images can still be in flight, and this is rare enough that stalling is fine
+            FlushGPU();
+
+            DestroySwapChainResources(swapChain);
+
+            CreateSwapChain(size, swapChain);
+            CreateImageViews(swapChain);
+            CreateFrameBuffers(swapChain);
+            CreateBlitPipelines(shaderHandler, swapChain);
+
+            for (u32 i = 0; i < SwapChainVK::FRAME_BUFFER_COUNT; i++)
+            {
+                swapChain->imagesInFlight[i] = VK_NULL_HANDLE;
+            }
+            swapChain->isOutOfDate = false;
+
+            return true;
+        }
+
+        BufferBackend* RenderDeviceVK::CreateBufferBackend(size_t size, Backend::BufferBackend::Type type, Backend::BufferBackend::Usage usage)
         {
             BufferBackendVK* backend = new BufferBackendVK();
             backend->device = this;
             backend->bufferSize = size;
+            backend->type = type;
+            backend->usage = usage;
 
             VkDeviceSize bufferSize = size;
 
-            VkBufferUsageFlags flags = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+            VkBufferUsageFlags flags = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT; // Any buffer can hold indirect arguments so GPU written buffers can feed draws
 
             if (type == Backend::BufferBackend::Type::TYPE_CONSTANT_BUFFER)
             {
@@ -95,9 +129,25 @@ namespace Renderer
                 flags |= VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
             }
 
+            if (usage == Backend::BufferBackend::Usage::USAGE_STATIC)
+            {
+                // One device local buffer that every frame in flight points at, so it gets bound the same way as dynamic buffers
+                CreateBuffer(bufferSize, flags | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_MEMORY_USAGE_GPU_ONLY, backend->buffers.Get(0), backend->allocations.Get(0));
+                DebugMarkerUtilVK::SetObjectName(_device, (u64)backend->buffers.Get(0), VK_DEBUG_REPORT_OBJECT_TYPE_BUFFER_EXT, "StaticBuffer");
+
+                for (int i = 1; i < backend->buffers.Num; i++)
+                {
+                    backend->buffers.Get(i) = backend->buffers.Get(0);
+                    backend->allocations.Get(i) = backend->allocations.Get(0);
+                }
+
+                _bufferBackends.push_back(backend);
+                return backend;
+            }
+
             for (int i = 0; i < backend->buffers.Num; i++)
             {
-                CreateBuffer(bufferSize, flags, VMA_MEMORY_USAGE_CPU_TO_GPU, backend->buffers.Get(i), backend->allocations.Get(i));
+                CreateMappedBuffer(bufferSize, flags, VMA_MEMORY_USAGE_CPU_TO_GPU, backend->buffers.Get(i), backend->allocations.Get(i), backend->mappedData.Get(i));
 
                 char debugName[16];
                 snprintf(debugName, sizeof(debugName), "%s%i", "ConstantBuffer", i);
@@ -108,9 +158,89 @@ namespace Renderer
             return backend;
         }
 
+        void RenderDeviceVK::DestroyBufferBackend(BufferBackend* buffer)
+        {
+            BufferBackendVK* backend = static_cast<BufferBackendVK*>(buffer);
+
+            auto it = std::find(_bufferBackends.begin(), _bufferBackends.end(), backend);
+            assert(it != _bufferBackends.end()); // Destroying a buffer that doesn't exist or was already destroyed
+            _bufferBackends.erase(it);
+
+            // Static buffers share one buffer between all frames, so only the first one is ours to destroy
+            int numBuffers = backend->usage == Backend::BufferBackend::Usage::USAGE_STATIC ? 1 : backend->buffers.Num;
+
+            DeferDestroy([this, backend, numBuffers]()
+            {
+                for (int i = 0; i < numBuffers; i++)
+                {
+                    vmaDestroyBuffer(_allocator, backend->buffers.Get(i), backend->allocations.Get(i));
+                }
+
+                if (backend->descriptorPool != VK_NULL_HANDLE)
+                {
+                    vkDestroyDescriptorPool(_device, backend->descriptorPool, nullptr); // Frees the descriptor sets as well
+                }
+
+                delete backend;
+            });
+        }
+
+        void RenderDeviceVK::DeferDestroy(std::function<void()>&& destroyFunction)
+        {
+            _deletionQueues[_frameIndex].push_back(std::move(destroyFunction));
+        }
+
+        void RenderDeviceVK::EndFrame()
+        {
+            _uploadHandler->EndFrame(_frameIndex);
+
+            // An empty submit signals the fence once everything submitted to the queue before it has finished
+            if (vkQueueSubmit(_graphicsQueue, 0, nullptr, _frameFences[_frameIndex]) != VK_SUCCESS)
+            {
+                NC_LOG_FATAL("Failed to submit frame fence!");
+            }
+
+            _frameIndex = (_frameIndex + 1) % FRAME_INDEX_COUNT;
+
+            // This is the only place the CPU waits on the GPU, it lets us record up to FRAME_INDEX_COUNT frames ahead
+            vkWaitForFences(_device, 1, &_frameFences[_frameIndex], VK_TRUE, UINT64_MAX);
+            vkResetFences(_device, 1, &_frameFences[_frameIndex]);
+
+            // The frame that filled this queue has retired, so nothing can be using these resources anymore
+            ProcessDeletionQueue(_frameIndex);
+            _uploadHandler->RecycleFrame(_frameIndex);
+
+            // Save new pipelines every now and then so a crash doesn't throw them away, but not every frame since it means writing the whole cache
+            _framesSincePipelineCacheSave++;
+            if (_pipelineCacheDirty && _framesSincePipelineCacheSave >= PIPELINE_CACHE_SAVE_INTERVAL)
+            {
+                SavePipelineCache();
+            }
+        }
+
+        void RenderDeviceVK::ProcessDeletionQueue(u32 frameIndex)
+        {
+            std::vector<std::function<void()>>& deletionQueue = _deletionQueues[frameIndex];
+
+            for (std::function<void()>& destroyFunction : deletionQueue)
+            {
+                destroyFunction();
+            }
+            deletionQueue.clear();
+        }
+
         void RenderDeviceVK::FlushGPU()
         {
+            if (_device == VK_NULL_HANDLE)
+                return;
 
+            vkDeviceWaitIdle(_device);
+
+            // Nothing is in flight anymore, so everything that is waiting to be destroyed can go right away
+            for (u32 i = 0; i < FRAME_INDEX_COUNT; i++)
+            {
+                ProcessDeletionQueue((_frameIndex + 1 + i) % FRAME_INDEX_COUNT);
+            }
         }
 
         static VKAPI_ATTR VkBool32 VKAPI_CALL DebugCallback(
@@ -152,6 +282,9 @@ namespace Renderer
             CreateAllocator();
             CreateCommandPool();
             CreateCommandBuffers();
+            CreateFrameFences();
+            CreateUploadHandler();
+            CreatePipelineCache();
 
             _initialized = true;
         }
@@ -301,6 +434,10 @@ namespace Renderer
 
             std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
             std::set<uint32_t> uniqueQueueFamilies = { indices.graphicsFamily.value(), indices.presentFamily.value() };
+            if (indices.transferFamily.has_value())
+            {
+                uniqueQueueFamilies.insert(indices.transferFamily.value());
+            }
 
             float queuePriority = 1.0f;
             for (uint32_t queueFamily : uniqueQueueFamilies) 
@@ -316,6 +453,25 @@ namespace Renderer
             //VkPhysicalDeviceFeatures deviceFeatures = {};
             //deviceFeatures.samplerAnisotropy = VK_TRUE;
 
+            // Optional features, RendererVK falls back to something slower when these aren't there
+            VkPhysicalDeviceFeatures supportedFeatures;
+            vkGetPhysicalDeviceFeatures(_physicalDevice, &supportedFeatures);
+            _hasMultiDrawIndirect = supportedFeatures.multiDrawIndirect == VK_TRUE;
+
+            uint32_t extensionCount;
+            vkEnumerateDeviceExtensionProperties(_physicalDevice, nullptr, &extensionCount, nullptr);
+
+            std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+            vkEnumerateDeviceExtensionProperties(_physicalDevice, nullptr, &extensionCount, availableExtensions.data());
+
+            for (const auto& extension : availableExtensions)
+            {
+                if (!strcmp(extension.extensionName, VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME))
+                {
+                    _hasDrawIndirectCount = true;
+                }
+            }
+
             VkPhysicalDeviceDescriptorIndexingFeaturesEXT descriptorIndexingFeatures = {};
             descriptorIndexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
             descriptorIndexingFeatures.runtimeDescriptorArray = true;
@@ -325,6 +481,7 @@ namespace Renderer
             deviceFeatures.features.samplerAnisotropy = VK_TRUE;
             deviceFeatures.features.fragmentStoresAndAtomics = VK_TRUE;
             deviceFeatures.features.vertexPipelineStoresAndAtomics = VK_TRUE;
+            deviceFeatures.features.multiDrawIndirect = _hasMultiDrawIndirect;
             deviceFeatures.pNext = &descriptorIndexingFeatures;
 
 
@@ -343,6 +500,11 @@ namespace Renderer
             }
             DebugMarkerUtilVK::AddEnabledExtension(enabledExtensions);
 
+            if (_hasDrawIndirectCount)
+            {
+                enabledExtensions.push_back(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+            }
+
             createInfo.enabledExtensionCount = static_cast<uint32_t>(enabledExtensions.size());
             createInfo.ppEnabledExtensionNames = enabledExtensions.data();
 
@@ -367,8 +529,19 @@ namespace Renderer
 
             DebugMarkerUtilVK::InitializeFunctions(_device);
 
+            if (_hasDrawIndirectCount)
+            {
+                fnCmdDrawIndirectCount = (PFN_vkCmdDrawIndirectCountKHR)vkGetDeviceProcAddr(_device, "vkCmdDrawIndirectCountKHR");
+                fnCmdDrawIndexedIndirectCount = (PFN_vkCmdDrawIndexedIndirectCountKHR)vkGetDeviceProcAddr(_device, "vkCmdDrawIndexedIndirectCountKHR");
+            }
+
             vkGetDeviceQueue(_device, indices.graphicsFamily.value(), 0, &_graphicsQueue);
             vkGetDeviceQueue(_device, indices.presentFamily.value(), 0, &_presentQueue);
+
+            if (indices.transferFamily.has_value())
+            {
+                vkGetDeviceQueue(_device, indices.transferFamily.value(), 0, &_transferQueue);
+            }
         }
 
         void RenderDeviceVK::CreateAllocator()
@@ -410,6 +583,134 @@ namespace Renderer
             }
         }
 
+        void RenderDeviceVK::CreateFrameFences()
+        {
+            VkFenceCreateInfo fenceInfo = {};
+            fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+            fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT; // Nothing has been submitted yet, so the first wait on every frame should pass right away
+
+            for (u32 i = 0; i < FRAME_INDEX_COUNT; i++)
+            {
+                if (vkCreateFence(_device, &fenceInfo, nullptr, &_frameFences[i]) != VK_SUCCESS)
+                {
+                    NC_LOG_FATAL("Failed to create frame fence!");
+                }
+            }
+        }
+
+        void RenderDeviceVK::CreateUploadHandler()
+        {
+            _uploadHandler = new UploadHandlerVK();
+            _uploadHandler->Init(this);
+        }
+
+        void RenderDeviceVK::CreatePipelineCache()
+        {
+            std::vector<u8> cacheData;
+
+            std::ifstream file(PIPELINE_CACHE_PATH, std::ios::ate | std::ios::binary);
+            if (file.is_open())
+            {
+                size_t fileSize = static_cast<size_t>(file.tellg());
+                cacheData.resize(fileSize);
+
+                file.seekg(0);
+                file.read(reinterpret_cast<char*>(cacheData.data()), fileSize);
+                file.close();
+
+                if (!IsPipelineCacheCompatible(cacheData))
+                {
+                    NC_LOG_MESSAGE("[Renderer]: Pipeline cache was created by a different GPU or driver, starting with an empty one");
+                    cacheData.clear();
+                }
+            }
+
+            VkPipelineCacheCreateInfo cacheInfo = {};
+            cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+            cacheInfo.initialDataSize = cacheData.size();
+            cacheInfo.pInitialData = cacheData.empty() ? nullptr : cacheData.data();
+
+            if (vkCreatePipelineCache(_device, &cacheInfo, nullptr, &_pipelineCache) != VK_SUCCESS)
+            {
+                NC_LOG_FATAL("Failed to create pipeline cache!");
+            }
+        }
+
+        bool RenderDeviceVK::IsPipelineCacheCompatible(const std::vector<u8>& cacheData)
+        {
+            // Drivers are supposed to reject caches that don't belong to them, but not all of them do so we check the header ourselves
+            struct PipelineCacheHeader
+            {
+                u32 headerLength;
+                u32 headerVersion;
+                u32 vendorID;
+                u32 deviceID;
+                u8 pipelineCacheUUID[VK_UUID_SIZE];
+            };
+
+            if (cacheData.size() < sizeof(PipelineCacheHeader))
+                return false;
+
+            PipelineCacheHeader header;
+            memcpy(&header, cacheData.data(), sizeof(PipelineCacheHeader));
+
+            VkPhysicalDeviceProperties deviceProperties;
+            vkGetPhysicalDeviceProperties(_physicalDevice, &deviceProperties);
+
+            if (header.headerLength < sizeof(PipelineCacheHeader) || header.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE)
+                return false;
+
+            if (header.vendorID != deviceProperties.vendorID || header.deviceID != deviceProperties.deviceID)
+                return false;
+
+            // The UUID changes with the driver version, which is what actually decides if the cached pipelines can be reused
+            return memcmp(header.pipelineCacheUUID, deviceProperties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+        }
+
+        void RenderDeviceVK::SavePipelineCache()
+        {
+            if (_pipelineCache == VK_NULL_HANDLE)
+                return;
+
+            size_t cacheSize = 0;
+            vkGetPipelineCacheData(_device, _pipelineCache, &cacheSize, nullptr);
+
+            std::vector<u8> cacheData(cacheSize);
+            if (vkGetPipelineCacheData(_device, _pipelineCache, &cacheSize, cacheData.data()) != VK_SUCCESS)
+            {
+                NC_LOG_ERROR("[Renderer]: Failed to get pipeline cache data");
+                return;
+            }
+
+            std::filesystem::path cachePath = PIPELINE_CACHE_PATH;
+            std::filesystem::path tempPath = cachePath;
+            tempPath += ".tmp";
+
+            std::error_code error;
+            std::filesystem::create_directories(cachePath.parent_path(), error);
+
+            // Write to a temporary file first, so closing the game halfway through saving doesn't leave a broken cache behind
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            if (!file.is_open())
+            {
+                NC_LOG_ERROR("[Renderer]: Failed to open %s for writing", tempPath.string().c_str());
+                return;
+            }
+
+            file.write(reinterpret_cast<const char*>(cacheData.data()), cacheSize);
+            file.close();
+
+            std::filesystem::rename(tempPath, cachePath, error);
+            if (error)
+            {
+                NC_LOG_ERROR("[Renderer]: Failed to save pipeline cache to %s", cachePath.string().c_str());
+                return;
+            }
+
+            _pipelineCacheDirty = false;
+            _framesSincePipelineCacheSave = 0;
+        }
+
         void RenderDeviceVK::CreateSurface(GLFWwindow* window, SwapChainVK* swapChain)
         {
             if (glfwCreateWindowSurface(_instance, window, nullptr, &swapChain->surface) != VK_SUCCESS)
@@ -489,9 +790,6 @@ namespace Renderer
 
         void RenderDeviceVK::CreateImageViews(SwapChainVK* swapChain)
         {
-            VkSemaphoreCreateInfo semaphoreInfo = {};
-            semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
-
             for (size_t i = 0; i < SwapChainVK::FRAME_BUFFER_COUNT; i++)
             {
                 VkImageViewCreateInfo viewInfo = {};
@@ -509,11 +807,25 @@ namespace Renderer
                 {
                     NC_LOG_FATAL("Failed to create texture image view!");
                 }
+            }
+        }
+
+        void RenderDeviceVK::CreateSemaphores(SwapChainVK* swapChain)
+        {
+            VkSemaphoreCreateInfo semaphoreInfo = {};
+            semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
 
+            for (size_t i = 0; i < FRAMES_IN_FLIGHT; i++)
+            {
                 if (vkCreateSemaphore(_device, &semaphoreInfo, nullptr, &swapChain->imageAvailableSemaphores[i]) != VK_SUCCESS)
                 {
                     NC_LOG_FATAL("Failed to create image available semaphore!");
                 }
+
+                if (vkCreateSemaphore(_device, &semaphoreInfo, nullptr, &swapChain->renderFinishedSemaphores[i]) != VK_SUCCESS)
+                {
+                    NC_LOG_FATAL("Failed to create render finished semaphore!");
+                }
             }
         }
 
@@ -604,6 +916,37 @@ namespace Renderer
             }
         }
 
+        void RenderDeviceVK::CreateBlitPipelines(ShaderHandlerVK* shaderHandler, SwapChainVK* swapChain)
+        {
+            CreateBlitPipeline(shaderHandler, swapChain, "blitFloat", IMAGE_COMPONENT_TYPE_FLOAT);
+            CreateBlitPipeline(shaderHandler, swapChain, "blitUint", IMAGE_COMPONENT_TYPE_UINT);
+            CreateBlitPipeline(shaderHandler, swapChain, "blitInt", IMAGE_COMPONENT_TYPE_SINT);
+        }
+
+        void RenderDeviceVK::DestroySwapChainResources(SwapChainVK* swapChain)
+        {
+            for (u32 i = 0; i < IMAGE_COMPONENT_TYPE_COUNT; i++)
+            {
+                BlitPipeline& pipeline = swapChain->blitPipelines[i];
+
+                vkDestroyPipeline(_device, pipeline.pipeline, nullptr);
+                vkDestroyPipelineLayout(_device, pipeline.pipelineLayout, nullptr);
+                vkDestroyDescriptorPool(_device, pipeline.descriptorPool, nullptr); // Frees the descriptor sets too
+                vkDestroyDescriptorSetLayout(_device, pipeline.descriptorSetLayout, nullptr);
+            }
+
+            vkDestroySampler(_device, swapChain->sampler, nullptr);
+
+            for (u32 i = 0; i < SwapChainVK::FRAME_BUFFER_COUNT; i++)
+            {
+                vkDestroyFramebuffer(_device, swapChain->framebuffers[i], nullptr);
+                vkDestroyImageView(_device, swapChain->imageViews[i], nullptr);
+            }
+
+            vkDestroyRenderPass(_device, swapChain->renderPass, nullptr);
+            vkDestroySwapchainKHR(_device, swapChain->swapChain, nullptr);
+        }
+
         void RenderDeviceVK::CreateBlitPipeline(ShaderHandlerVK* shaderHandler, SwapChainVK* swapChain, std::string fragShaderName, ImageComponentType componentType)
         {
             BlitPipeline& pipeline = swapChain->blitPipelines[componentType];
@@ -655,27 +998,33 @@ namespace Renderer
             // Create descriptor pool
             VkDescriptorPoolSize descriptorPoolSize = {}; 
             descriptorPoolSize.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-            descriptorPoolSize.descriptorCount = 1;
+            descriptorPoolSize.descriptorCount = FRAMES_IN_FLIGHT;
 
             VkDescriptorPoolCreateInfo descriptorPoolInfo = {};
             descriptorPoolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
             descriptorPoolInfo.poolSizeCount = 1;
             descriptorPoolInfo.pPoolSizes = &descriptorPoolSize;
-            descriptorPoolInfo.maxSets = 1;
+            descriptorPoolInfo.maxSets = FRAMES_IN_FLIGHT;
 
             if (vkCreateDescriptorPool(_device, &descriptorPoolInfo, nullptr, &pipeline.descriptorPool) != VK_SUCCESS)
             {
                 NC_LOG_FATAL("Failed to create descriptor pool!");
             }
 
-            // Create descriptor set
+            // Create descriptor sets
+            VkDescriptorSetLayout setLayouts[FRAMES_IN_FLIGHT];
+            for (u32 i = 0; i < FRAMES_IN_FLIGHT; i++)
+            {
+                setLayouts[i] = pipeline.descriptorSetLayout;
+            }
+
             VkDescriptorSetAllocateInfo allocInfo = {};
             allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
             allocInfo.descriptorPool = pipeline.descriptorPool;
-            allocInfo.descriptorSetCount = 1;
-            allocInfo.pSetLayouts = &pipeline.descriptorSetLayout;
+            allocInfo.descriptorSetCount = FRAMES_IN_FLIGHT;
+            allocInfo.pSetLayouts = setLayouts;
 
-            if (vkAllocateDescriptorSets(_device, &allocInfo, &pipeline.descriptorSet) != VK_SUCCESS)
+            if (vkAllocateDescriptorSets(_device, &allocInfo, pipeline.descriptorSets) != VK_SUCCESS)
             {
                 NC_LOG_FATAL("Failed to allocate descriptor sets!");
             }
@@ -789,7 +1138,7 @@ namespace Renderer
             pipelineInfo.basePipelineHandle = VK_NULL_HANDLE; // Optional
             pipelineInfo.basePipelineIndex = -1; // Optional
 
-            if (vkCreateGraphicsPipelines(_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &pipeline.pipeline) != VK_SUCCESS)
+            if (vkCreateGraphicsPipelines(_device, _pipelineCache, 1, &pipelineInfo, nullptr, &pipeline.pipeline) != VK_SUCCESS)
             {
                 NC_LOG_FATAL("Failed to create graphics pipeline!");
             }
@@ -891,6 +1240,19 @@ namespace Renderer
                 i++;
             }
 
+            // A transfer-only family lets uploads run on the copy engine next to rendering instead of in between it
+            for (u32 j = 0; j < queueFamilyCount; j++)
+            {
+                const VkQueueFamilyProperties& queueFamily = queueFamilies[j];
+                bool isTransferOnly = (queueFamily.queueFlags & VK_QUEUE_TRANSFER_BIT) && !(queueFamily.queueFlags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT));
+
+                if (queueFamily.queueCount > 0 && isTransferOnly)
+                {
+                    indices.transferFamily = j;
+                    break;
+                }
+            }
+
             return indices;
         }
 
@@ -958,41 +1320,6 @@ namespace Renderer
             return extensions;
         }
 
-        VkCommandBuffer RenderDeviceVK::BeginSingleTimeCommands()
-        {
-            VkCommandBufferAllocateInfo allocInfo = {};
-            allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-            allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-            allocInfo.commandPool = _commandPool;
-            allocInfo.commandBufferCount = 1;
-
-            VkCommandBuffer commandBuffer;
-            vkAllocateCommandBuffers(_device, &allocInfo, &commandBuffer);
-
-            VkCommandBufferBeginInfo beginInfo = {};
-            beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-            beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-
-            vkBeginCommandBuffer(commandBuffer, &beginInfo);
-
-            return commandBuffer;
-        }
-
-        void RenderDeviceVK::EndSingleTimeCommands(VkCommandBuffer commandBuffer)
-        {
-            vkEndCommandBuffer(commandBuffer);
-
-            VkSubmitInfo submitInfo = {};
-            submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-            submitInfo.commandBufferCount = 1;
-            submitInfo.pCommandBuffers = &commandBuffer;
-
-            vkQueueSubmit(_graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
-            vkQueueWaitIdle(_graphicsQueue);
-
-            vkFreeCommandBuffers(_device, _commandPool, 1, &commandBuffer);
-        }
-
         void RenderDeviceVK::CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VmaMemoryUsage memoryUsage, VkBuffer& buffer, VmaAllocation& allocation)
         {
             VkBufferCreateInfo bufferInfo = {};
@@ -1010,59 +1337,41 @@ namespace Renderer
             }
         }
 
-        void RenderDeviceVK::CopyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size)
+        void RenderDeviceVK::CreateMappedBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VmaMemoryUsage memoryUsage, VkBuffer& buffer, VmaAllocation& allocation, void*& mappedData)
         {
-            VkCommandBuffer commandBuffer = BeginSingleTimeCommands();
+            VkBufferCreateInfo bufferInfo = {};
+            bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+            bufferInfo.size = size;
+            bufferInfo.usage = usage;
+            bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
-            VkBufferCopy copyRegion = {};
-            copyRegion.srcOffset = 0; // Optional
-            copyRegion.dstOffset = 0; // Optional
-            copyRegion.size = size;
-            vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, 1, &copyRegion);
+            VmaAllocationCreateInfo allocInfo = {};
+            allocInfo.usage = memoryUsage;
+            allocInfo.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT; // Keep it mapped for as long as it lives instead of mapping on every write
+
+            VmaAllocationInfo allocationInfo;
+            if (vmaCreateBuffer(_allocator, &bufferInfo, &allocInfo, &buffer, &allocation, &allocationInfo) != VK_SUCCESS)
+            {
+                NC_LOG_FATAL("Failed to create mapped buffer!");
+            }
 
-            EndSingleTimeCommands(commandBuffer);
+            mappedData = allocationInfo.pMappedData;
+            assert(mappedData != nullptr); // CPU_TO_GPU is always host visible, so this should never fail to map
         }
 
-        void RenderDeviceVK::CopyBufferToImage(VkBuffer srcBuffer, VkImage dstImage, u32 width, u32 height, u32 numLayers)
+        void RenderDeviceVK::UploadToBuffer(VkBuffer dstBuffer, VkDeviceSize dstOffset, const void* data, VkDeviceSize size)
         {
-            VkCommandBuffer commandBuffer = BeginSingleTimeCommands();
-
-            VkBufferImageCopy region = {};
-            region.bufferOffset = 0;
-            region.bufferRowLength = 0;
-            region.bufferImageHeight = 0;
-
-            region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-            region.imageSubresource.mipLevel = 0;
-            region.imageSubresource.baseArrayLayer = 0;
-            region.imageSubresource.layerCount = numLayers;
-
-            region.imageOffset = { 0, 0, 0 };
-            region.imageExtent = {
-                width,
-                height,
-                1
-            };
-
-            vkCmdCopyBufferToImage(
-                commandBuffer,
-                srcBuffer,
-                dstImage,
-                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                1,
-                &region
-            );
+            _uploadHandler->UploadToBuffer(dstBuffer, dstOffset, data, size);
+        }
 
-            EndSingleTimeCommands(commandBuffer);
+        void RenderDeviceVK::UploadToImage(VkImage dstImage, const void* data, VkDeviceSize size, u32 width, u32 height, u32 numLayers)
+        {
+            _uploadHandler->UploadToImage(dstImage, data, size, width, height, numLayers);
         }
 
         void RenderDeviceVK::TransitionImageLayout(VkImage image, VkImageAspectFlags aspects, VkImageLayout oldLayout, VkImageLayout newLayout, u32 numLayers)
         {
-            VkCommandBuffer commandBuffer = BeginSingleTimeCommands();
-
-            TransitionImageLayout(commandBuffer, image, aspects, oldLayout, newLayout, numLayers);
-
-            EndSingleTimeCommands(commandBuffer);
+            _uploadHandler->TransitionImageLayout(image, aspects, oldLayout, newLayout, numLayers);
         }
 
         void RenderDeviceVK::TransitionImageLayout(VkCommandBuffer commandBuffer, VkImage image, VkImageAspectFlags aspects, VkImageLayout oldLayout, VkImageLayout newLayout, u32 numLayers)
@@ -2,6 +2,7 @@
 #include <NovusTypes.h>
 #include <vector>
 #include <optional>
+#include <functional>
 #include <vulkan/vulkan.h>
 #include "vk_mem_alloc.h"
 
@@ -21,11 +22,13 @@ namespace Renderer
         struct BufferBackendVK;
         struct SwapChainVK;
         class ShaderHandlerVK;
+        class UploadHandlerVK;
 
         struct QueueFamilyIndices
         {
             std::optional<uint32_t> graphicsFamily;
             std::optional<uint32_t> presentFamily;
+            std::optional<uint32_t> transferFamily; // Only set if there is a transfer family without graphics or compute, which is usually a DMA engine
 
             bool IsComplete()
             {
@@ -40,14 +43,21 @@ namespace Renderer
 
             void Init();
             void InitWindow(ShaderHandlerVK* shaderHandler, Window* window);
+            bool RecreateSwapChain(ShaderHandlerVK* shaderHandler, Window* window); // Returns false if the window has no area to present to right now, like when it's minimized
 
-            BufferBackend* CreateBufferBackend(size_t size, Backend::BufferBackend::Type type);
+            BufferBackend* CreateBufferBackend(size_t size, Backend::BufferBackend::Type type, Backend::BufferBackend::Usage usage);
+            void DestroyBufferBackend(BufferBackend* buffer);
+
+            // Runs destroyFunction once every frame that could have used the resource has retired, the GPU might still be reading it right now
+            void DeferDestroy(std::function<void()>&& destroyFunction);
 
             u32 GetFrameIndex() { return _frameIndex; }
-            void EndFrame() { _frameIndex = (_frameIndex + 1) % FRAME_INDEX_COUNT; }
+            void EndFrame(); // Fences the frame we just submitted and blocks until the frame we are about to reuse has retired on the GPU
 
             void FlushGPU();
 
+            void SavePipelineCache(); // Called on shutdown, and every PIPELINE_CACHE_SAVE_INTERVAL frames if we created new pipelines
+
         private:
             void InitOnce();
 
@@ -59,34 +69,45 @@ namespace Renderer
             void CreateAllocator();
             void CreateCommandPool();
             void CreateCommandBuffers();
+            void CreateFrameFences();
+            void CreateUploadHandler();
+            void CreatePipelineCache();
+            bool IsPipelineCacheCompatible(const std::vector<u8>& cacheData);
 
             // InitWindow helper functions
             void CreateSurface(GLFWwindow* window, SwapChainVK* swapChain);
             void CreateSwapChain(const ivec2& windowSize, SwapChainVK* swapChain);
             void CreateImageViews(SwapChainVK* swapChain);
+            void CreateSemaphores(SwapChainVK* swapChain);
             void CreateFrameBuffers(SwapChainVK* swapChain);
             void CreateBlitPipeline(ShaderHandlerVK* shaderHandler, SwapChainVK* swapChain, std::string fragShaderName, ImageComponentType componentType);
+            void CreateBlitPipelines(ShaderHandlerVK* shaderHandler, SwapChainVK* swapChain);
+            void DestroySwapChainResources(SwapChainVK* swapChain); // Everything but the surface and semaphores, those survive recreating the swapchain
 
             int RateDeviceSuitability(VkPhysicalDevice device);
             QueueFamilyIndices FindQueueFamilies(VkPhysicalDevice device);
             bool CheckDeviceExtensionSupport(VkPhysicalDevice device);
 
+            void ProcessDeletionQueue(u32 frameIndex);
+
             void CheckValidationLayerSupport();
             std::vector<const char*> GetRequiredExtensions();
 
-            VkCommandBuffer BeginSingleTimeCommands();
-            void EndSingleTimeCommands(VkCommandBuffer commandBuffer);
-
             void CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VmaMemoryUsage memoryUsage, VkBuffer& buffer, VmaAllocation& allocation);
-            void CopyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size);
-            void CopyBufferToImage(VkBuffer srcBuffer, VkImage dstImage, u32 width, u32 height, u32 numLayers);
+            void CreateMappedBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VmaMemoryUsage memoryUsage, VkBuffer& buffer, VmaAllocation& allocation, void*& mappedData);
+
+            // These are recorded into the current upload batch, which gets submitted before the next command list so the data is there when it runs
+            void UploadToBuffer(VkBuffer dstBuffer, VkDeviceSize dstOffset, const void* data, VkDeviceSize size);
+            void UploadToImage(VkImage dstImage, const void* data, VkDeviceSize size, u32 width, u32 height, u32 numLayers);
             void TransitionImageLayout(VkImage image, VkImageAspectFlags aspects, VkImageLayout oldLayout, VkImageLayout newLayout, u32 numLayers);
             void TransitionImageLayout(VkCommandBuffer commandBuffer, VkImage image, VkImageAspectFlags aspects, VkImageLayout oldLayout, VkImageLayout newLayout, u32 numLayers);
 
         private:
-            static const u32 FRAME_INDEX_COUNT = 2;
+            static const u32 FRAME_INDEX_COUNT = FRAMES_IN_FLIGHT;
+            static const u32 PIPELINE_CACHE_SAVE_INTERVAL = 3600;
+            static constexpr const char* PIPELINE_CACHE_PATH = "Data/cache/pipelines.vkcache";
             static bool _initialized;
-            u32 _frameIndex;
+            u32 _frameIndex = 0;
 
             VkInstance _instance;
             VkDebugUtilsMessengerEXT _debugMessenger;
@@ -95,15 +116,30 @@ namespace Renderer
             VkDevice _device = VK_NULL_HANDLE;
             VkCommandPool _commandPool = VK_NULL_HANDLE;
             VkCommandBuffer _commandBuffers[FRAME_INDEX_COUNT];
+            VkFence _frameFences[FRAME_INDEX_COUNT]; // Signaled once all work submitted during that frame has finished on the GPU
 
             VkQueue _graphicsQueue = VK_NULL_HANDLE;
             VkQueue _presentQueue = VK_NULL_HANDLE;
+            VkQueue _transferQueue = VK_NULL_HANDLE;
+
+            UploadHandlerVK* _uploadHandler = nullptr;
+
+            VkPipelineCache _pipelineCache = VK_NULL_HANDLE;
+            bool _pipelineCacheDirty = false;
+            u32 _framesSincePipelineCacheSave = 0;
 
             std::vector<BufferBackendVK*> _bufferBackends;
+            std::vector<std::function<void()>> _deletionQueues[FRAME_INDEX_COUNT]; // Indexed by the frame that queued the deletion
             std::vector<SwapChainVK*> _swapChains;
 
             VmaAllocator _allocator;
 
+            // Optional features
+            bool _hasMultiDrawIndirect = false;
+            bool _hasDrawIndirectCount = false;
+            PFN_vkCmdDrawIndirectCountKHR fnCmdDrawIndirectCount = nullptr;
+            PFN_vkCmdDrawIndexedIndirectCountKHR fnCmdDrawIndexedIndirectCount = nullptr;
+
             friend class RendererVK;
             friend struct BufferBackendVK;
             friend class ImageHandlerVK;
@@ -112,6 +148,7 @@ namespace Renderer
             friend class ShaderHandlerVK;
             friend class PipelineHandlerVK;
             friend class CommandListHandlerVK;
+            friend class UploadHandlerVK;
             friend class SamplerHandlerVK;
         };
     }
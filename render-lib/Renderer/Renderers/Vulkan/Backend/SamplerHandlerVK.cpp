@@ -31,10 +31,7 @@ namespace Renderer
             {
                 return SamplerID(static_cast<type>(nextID));
             }
-            nextID = _samplers.size();
-
-            // Make sure we haven't exceeded the limit of the SamplerID type, if this hits you need to change type of SamplerID to something bigger
-            assert(nextID < SamplerID::MaxValue());
+            nextID = AcquireSamplerHandle();
 
             Sampler sampler;
             sampler.samplerHash = samplerHash;
@@ -69,7 +66,7 @@ namespace Renderer
             descriptorLayout.binding = 0;
             descriptorLayout.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER;
             descriptorLayout.descriptorCount = 1;
-            descriptorLayout.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+            descriptorLayout.stageFlags = VK_SHADER_STAGE_ALL;
             descriptorLayout.pImmutableSamplers = NULL;
 
             VkDescriptorSetLayoutCreateInfo descriptorLayoutInfo = {};
@@ -128,10 +125,37 @@ namespace Renderer
 
             vkUpdateDescriptorSets(device->_device, 1, &descriptorWrite, 0, NULL);
 
-            _samplers.push_back(sampler);
+            _samplers[nextID] = sampler;
             return SamplerID(static_cast<type>(nextID));
         }
 
+        void SamplerHandlerVK::DestroySampler(RenderDeviceVK* device, SamplerID samplerID)
+        {
+            using type = type_safe::underlying_type<SamplerID>;
+
+            // Lets make sure this id exists
+            assert(_samplers.size() > static_cast<type>(samplerID));
+
+            Sampler& sampler = _samplers[static_cast<type>(samplerID)];
+            assert(!sampler.isDestroyed); // Destroying a sampler twice
+
+            VkSampler vkSampler = sampler.sampler;
+            VkDescriptorSetLayout descriptorSetLayout = sampler.descriptorSetLayout;
+            VkDescriptorPool descriptorPool = sampler.descriptorPool;
+
+            device->DeferDestroy([device, vkSampler, descriptorSetLayout, descriptorPool]()
+            {
+                vkDestroyDescriptorPool(device->_device, descriptorPool, nullptr);
+                vkDestroyDescriptorSetLayout(device->_device, descriptorSetLayout, nullptr);
+                vkDestroySampler(device->_device, vkSampler, nullptr);
+            });
+
+            sampler = Sampler();
+            sampler.isDestroyed = true;
+
+            _freeSamplerHandles.push_back(static_cast<type>(samplerID));
+        }
+
         /*SamplerID SamplerHandlerVK::CreateSampler(RenderDeviceVK* device, const SamplerDesc& desc)
         {
             using type = type_safe::underlying_type<SamplerID>;
@@ -246,6 +270,7 @@ namespace Renderer
 
             // Lets make sure this id exists
             assert(_samplers.size() > static_cast<type>(samplerID));
+            assert(!_samplers[static_cast<type>(samplerID)].isDestroyed); // This sampler has been destroyed
             return _samplers[static_cast<type>(samplerID)].descriptorSet;
         }
 
@@ -258,6 +283,25 @@ namespace Renderer
             return _samplers[static_cast<type>(samplerID)].desc;
         }
 
+        size_t SamplerHandlerVK::AcquireSamplerHandle()
+        {
+            if (!_freeSamplerHandles.empty())
+            {
+                size_t handle = _freeSamplerHandles.back();
+                _freeSamplerHandles.pop_back();
+
+                return handle;
+            }
+
+            size_t nextHandle = _samplers.size();
+
+            // Make sure we haven't exceeded the limit of the SamplerID type, if this hits you need to change type of SamplerID to something bigger
+            assert(nextHandle < SamplerID::MaxValue());
+
+            _samplers.emplace_back();
+            return nextHandle;
+        }
+
         u64 SamplerHandlerVK::CalculateSamplerHash(const SamplerDesc& desc)
         {
             return XXHash64::hash(&desc, sizeof(desc), 0);
@@ -285,7 +329,7 @@ namespace Renderer
 
             for (auto& sampler : _samplers)
             {
-                if (descHash == sampler.samplerHash)
+                if (!sampler.isDestroyed && descHash == sampler.samplerHash)
                 {
                     return true;
                 }
@@ -22,6 +22,7 @@ namespace Renderer
             ~SamplerHandlerVK();
 
             SamplerID CreateSampler(RenderDeviceVK* device, const SamplerDesc& desc);
+            void DestroySampler(RenderDeviceVK* device, SamplerID samplerID); // Samplers are shared by everyone who created the same desc, destroying it destroys it for all of them
 
             //VkDescriptorSet GetCombinedSampler(RenderDeviceVK* device, TextureHandlerVK* textureHandler, PipelineHandlerVK* pipelineHandler, const SamplerID samplerID, const u32 slot, const TextureID textureID, const GraphicsPipelineID pipelineID);
 
@@ -42,9 +43,12 @@ namespace Renderer
                 VkDescriptorSetLayout descriptorSetLayout;
                 VkDescriptorPool descriptorPool = NULL;
                 VkDescriptorSet descriptorSet;
+
+                bool isDestroyed = false;
             };
 
         private:
+            size_t AcquireSamplerHandle(); // Reuses the handle of a destroyed sampler if there is one
             u64 CalculateSamplerHash(const SamplerDesc& desc);
             //bool TryFindExistingSamplerContainer(u64 descHash, size_t& id);
 
@@ -61,6 +65,7 @@ namespace Renderer
             //std::vector<SamplerContainer> _samplerContainers;
 
             std::vector<Sampler> _samplers;
+            std::vector<size_t> _freeSamplerHandles;
         };
     }
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <Utils/StringUtils.h>
 #include "RenderDeviceVK.h"
 #include <fstream>
+#include <cstring>
 
 namespace Renderer
 {
@@ -32,29 +33,85 @@ namespace Renderer
             _computeShaders.clear();
         }
 
+        void ShaderHandlerVK::LoadAllShaders(RenderDeviceVK* device)
+        {
+            std::error_code errorCode;
+            std::filesystem::directory_iterator directory(SHADER_DIRECTORY, errorCode);
+            if (errorCode)
+            {
+                NC_LOG_WARNING("[Renderer]: Could not open shader directory %s, shaders will be loaded when they are first used", SHADER_DIRECTORY);
+                return;
+            }
+
+            for (const std::filesystem::directory_entry& entry : directory)
+            {
+                // The path has to be built the same way the callers of LoadShader build it, since that is what we look shaders up by
+                const std::filesystem::path& path = entry.path();
+                if (path.extension() != ".spv")
+                    continue;
+
+                std::string shaderPath = SHADER_DIRECTORY + path.filename().string();
+                std::filesystem::path shaderType = path.stem().extension(); // test.vert.spv -> .vert
+
+                if (shaderType == ".vert")
+                {
+                    LoadShader<VertexShaderID>(device, shaderPath, _vertexShaders, _vertexShaderLookup);
+                }
+                else if (shaderType == ".frag")
+                {
+                    LoadShader<PixelShaderID>(device, shaderPath, _pixelShaders, _pixelShaderLookup);
+                }
+                else if (shaderType == ".comp")
+                {
+                    LoadShader<ComputeShaderID>(device, shaderPath, _computeShaders, _computeShaderLookup);
+                }
+            }
+
+            NC_LOG_MESSAGE("[Renderer]: Loaded %u vertex, %u pixel and %u compute shaders", static_cast<u32>(_vertexShaders.size()), static_cast<u32>(_pixelShaders.size()), static_cast<u32>(_computeShaders.size()));
+        }
+
+        void ShaderHandlerVK::ReloadModifiedShaders(RenderDeviceVK* device, ReloadedShaders& reloadedShaders)
+        {
+            if (++_framesSinceShaderWatch < SHADER_WATCH_INTERVAL)
+                return;
+
+            _framesSinceShaderWatch = 0;
+
+            ReloadModifiedShaders<VertexShaderID>(device, _vertexShaders, reloadedShaders.vertexShaders, reloadedShaders.oldModules);
+            ReloadModifiedShaders<PixelShaderID>(device, _pixelShaders, reloadedShaders.pixelShaders, reloadedShaders.oldModules);
+            ReloadModifiedShaders<ComputeShaderID>(device, _computeShaders, reloadedShaders.computeShaders, reloadedShaders.oldModules);
+        }
+
+        void ShaderHandlerVK::DestroyOldShaderModules(RenderDeviceVK* device, ReloadedShaders& reloadedShaders)
+        {
+            for (VkShaderModule module : reloadedShaders.oldModules)
+            {
+                DestroyShaderModule(device, module);
+            }
+            reloadedShaders.oldModules.clear();
+        }
+
         VertexShaderID ShaderHandlerVK::LoadShader(RenderDeviceVK* device, const VertexShaderDesc& desc)
         {
-            return LoadShader<VertexShaderID>(device, desc.path, _vertexShaders);
+            return LoadShader<VertexShaderID>(device, desc.path, _vertexShaders, _vertexShaderLookup);
         }
 
         PixelShaderID ShaderHandlerVK::LoadShader(RenderDeviceVK* device, const PixelShaderDesc& desc)
         {
-            return LoadShader<PixelShaderID>(device, desc.path, _pixelShaders);
+            return LoadShader<PixelShaderID>(device, desc.path, _pixelShaders, _pixelShaderLookup);
         }
 
         ComputeShaderID ShaderHandlerVK::LoadShader(RenderDeviceVK* device, const ComputeShaderDesc& desc)
         {
-            return LoadShader<ComputeShaderID>(device, desc.path, _computeShaders);
+            return LoadShader<ComputeShaderID>(device, desc.path, _computeShaders, _computeShaderLookup);
         }
 
-        void ShaderHandlerVK::ReadFile(const std::string& filename, ShaderBinary& binary)
+        bool ShaderHandlerVK::ReadFile(const std::string& filename, ShaderBinary& binary)
         {
             std::ifstream file(filename, std::ios::ate | std::ios::binary);
 
             if (!file.is_open())
-            {
-                NC_LOG_FATAL("Failed to open file!");
-            }
+                return false;
 
             size_t fileSize = (size_t)file.tellg();
             binary.resize(fileSize);
@@ -63,6 +120,46 @@ namespace Renderer
             file.read(binary.data(), fileSize);
 
             file.close();
+            return true;
+        }
+
+        bool ShaderHandlerVK::IsValidSPIRV(const ShaderBinary& binary)
+        {
+            const u32 SPIRV_MAGIC = 0x07230203;
+            const size_t SPIRV_HEADER_SIZE = 5 * sizeof(u32);
+
+            if (binary.size() < SPIRV_HEADER_SIZE || binary.size() % sizeof(u32) != 0)
+                return false;
+
+            u32 magic;
+            memcpy(&magic, binary.data(), sizeof(u32));
+
+            return magic == SPIRV_MAGIC;
+        }
+
+        bool ShaderHandlerVK::LoadReflection(const std::string& shaderPath, const ShaderBinary& binary, std::filesystem::file_time_type shaderWriteTime, ShaderReflection& reflection)
+        {
+            // The shaders target writes test.vert.reflect next to test.vert.spv
+            std::filesystem::path reflectionPath = shaderPath;
+            reflectionPath.replace_extension(".reflect");
+
+            // If the SPIR-V is newer than its reflection it was compiled by hand, so we can't trust the reflection
+            std::error_code errorCode;
+            std::filesystem::file_time_type reflectionWriteTime = std::filesystem::last_write_time(reflectionPath, errorCode);
+            if (!errorCode && reflectionWriteTime >= shaderWriteTime && ShaderReflectionVK::Load(reflectionPath.string(), reflection))
+                return true;
+
+            NC_LOG_WARNING("[Renderer]: No up to date reflection for shader %s, reflecting it at runtime instead", shaderPath.c_str());
+            return ShaderReflectionVK::Reflect(binary.data(), binary.size(), reflection);
+        }
+
+        void ShaderHandlerVK::DestroyShaderModule(RenderDeviceVK* device, VkShaderModule module)
+        {
+            // Pipelines compiled from this module can still be in flight
+            device->DeferDestroy([device, module]()
+            {
+                vkDestroyShaderModule(device->_device, module, nullptr);
+            });
         }
 
         VkShaderModule ShaderHandlerVK::CreateShaderModule(RenderDeviceVK* device, const ShaderBinary& binary)
@@ -81,21 +178,14 @@ namespace Renderer
             return shaderModule;
         }
 
-        bool ShaderHandlerVK::TryFindExistingShader(const std::string& shaderPath, std::vector<Shader>& shaders, size_t& id)
+        bool ShaderHandlerVK::TryFindExistingShader(u32 shaderPathHash, robin_hood::unordered_map<u32, size_t>& shaderLookup, size_t& id)
         {
-            u32 shaderPathHash = StringUtils::fnv1a_32(shaderPath.c_str(), shaderPath.length());
-
-            id = 0;
-            for (Shader& existingShader : shaders)
-            {
-                if (StringUtils::fnv1a_32(existingShader.path.c_str(), existingShader.path.length()) == shaderPathHash)
-                {
-                    return true;
-                }
-                id++;
-            }
+            auto it = shaderLookup.find(shaderPathHash);
+            if (it == shaderLookup.end())
+                return false;
 
-            return false;
+            id = it->second;
+            return true;
         }
     }
 }
\ No newline at end of file
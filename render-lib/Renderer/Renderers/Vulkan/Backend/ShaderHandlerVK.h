@@ -3,9 +3,14 @@
 #include <vulkan/vulkan.h>
 #include <vector>
 #include <cassert>
+#include <filesystem>
+#include <robin_hood.h>
+#include <Utils/StringUtils.h>
+#include <Utils/DebugHandler.h>
 #include "../../../Descriptors/VertexShaderDesc.h"
 #include "../../../Descriptors/PixelShaderDesc.h"
 #include "../../../Descriptors/ComputeShaderDesc.h"
+#include "ShaderReflectionVK.h"
 
 namespace Renderer
 {
@@ -15,6 +20,17 @@ namespace Renderer
 
         typedef std::vector<char> ShaderBinary;
 
+        struct ReloadedShaders
+        {
+            std::vector<VertexShaderID> vertexShaders;
+            std::vector<PixelShaderID> pixelShaders;
+            std::vector<ComputeShaderID> computeShaders;
+
+            std::vector<VkShaderModule> oldModules; // Pipeline compile jobs can still be reading these, see ShaderHandlerVK::DestroyOldShaderModules
+
+            bool IsEmpty() const { return vertexShaders.empty() && pixelShaders.empty() && computeShaders.empty(); }
+        };
+
         class ShaderHandlerVK
         {
             using vsIDType = type_safe::underlying_type<VertexShaderID>;
@@ -25,6 +41,8 @@ namespace Renderer
             ShaderHandlerVK();
             ~ShaderHandlerVK();
 
+            void LoadAllShaders(RenderDeviceVK* device); // Loads every compiled shader in SHADER_DIRECTORY so LoadShader never has to touch the disk
+
             VertexShaderID LoadShader(RenderDeviceVK* device, const VertexShaderDesc& desc);
             PixelShaderID LoadShader(RenderDeviceVK* device, const PixelShaderDesc& desc);
             ComputeShaderID LoadShader(RenderDeviceVK* device, const ComputeShaderDesc& desc);
@@ -35,6 +53,16 @@ namespace Renderer
 
             const ShaderBinary* GetSPIRV(const VertexShaderID id) { return &_vertexShaders[static_cast<vsIDType>(id)].spirv; }
             const ShaderBinary* GetSPIRV(const PixelShaderID id) { return &_pixelShaders[static_cast<psIDType>(id)].spirv; }
+            const ShaderBinary* GetSPIRV(const ComputeShaderID id) { return &_computeShaders[static_cast<csIDType>(id)].spirv; }
+
+            const ShaderReflection& GetReflection(const VertexShaderID id) { return _vertexShaders[static_cast<vsIDType>(id)].reflection; }
+            const ShaderReflection& GetReflection(const PixelShaderID id) { return _pixelShaders[static_cast<psIDType>(id)].reflection; }
+            const ShaderReflection& GetReflection(const ComputeShaderID id) { return _computeShaders[static_cast<csIDType>(id)].reflection; }
+
+            // Polls the loaded shaders for changes on disk and swaps in the new shader modules, the pipelines using them need to be recompiled by the caller
+            // Only call this between frames, the old shader modules are handed back in reloadedShaders since compiles that started before the reload still read them
+            void ReloadModifiedShaders(RenderDeviceVK* device, ReloadedShaders& reloadedShaders);
+            void DestroyOldShaderModules(RenderDeviceVK* device, ReloadedShaders& reloadedShaders); // Call after PipelineHandlerVK::RecompilePipelinesUsingShaders, it waits for the compiles using them
 
         private:
             struct Shader
@@ -43,17 +71,20 @@ namespace Renderer
                 VkShaderModule module;
                 RenderDeviceVK* device;
                 ShaderBinary spirv;
+                ShaderReflection reflection;
+                std::filesystem::file_time_type lastWriteTime;
             };
 
         private:
             template <typename T>
-            T LoadShader(RenderDeviceVK* device, const std::string& shaderPath, std::vector<Shader>& shaders)
+            T LoadShader(RenderDeviceVK* device, const std::string& shaderPath, std::vector<Shader>& shaders, robin_hood::unordered_map<u32, size_t>& shaderLookup)
             {
                 size_t id;
                 using idType = type_safe::underlying_type<T>;
 
                 // If shader is already loaded, return ID of already loaded version
-                if (TryFindExistingShader(shaderPath, shaders, id))
+                u32 shaderPathHash = StringUtils::fnv1a_32(shaderPath.c_str(), shaderPath.length());
+                if (TryFindExistingShader(shaderPathHash, shaderLookup, id))
                 {
                     return T(static_cast<idType>(id));
                 }
@@ -62,25 +93,82 @@ namespace Renderer
                 assert(id < T::MaxValue());
 
                 Shader shader;
-                ReadFile(shaderPath, shader.spirv);
+                if (!ReadFile(shaderPath, shader.spirv))
+                {
+                    NC_LOG_FATAL("Failed to open shader %s!", shaderPath.c_str());
+                }
+
+                std::error_code errorCode;
+                shader.lastWriteTime = std::filesystem::last_write_time(shaderPath, errorCode);
+
+                if (!LoadReflection(shaderPath, shader.spirv, shader.lastWriteTime, shader.reflection))
+                {
+                    NC_LOG_FATAL("Failed to reflect shader %s!", shaderPath.c_str());
+                }
+
                 shader.path = shaderPath;
                 shader.module = CreateShaderModule(device, shader.spirv);
                 shader.device = device;
                 
                 shaders.push_back(shader);
+                shaderLookup[shaderPathHash] = id;
 
                 return T(static_cast<idType>(id));
             }
 
-            
-            void ReadFile(const std::string& filename, ShaderBinary& binary);
+            template <typename T>
+            void ReloadModifiedShaders(RenderDeviceVK* device, std::vector<Shader>& shaders, std::vector<T>& reloadedShaders, std::vector<VkShaderModule>& oldModules)
+            {
+                using idType = type_safe::underlying_type<T>;
+
+                for (size_t i = 0; i < shaders.size(); i++)
+                {
+                    Shader& shader = shaders[i];
+
+                    std::error_code errorCode;
+                    std::filesystem::file_time_type lastWriteTime = std::filesystem::last_write_time(shader.path, errorCode);
+                    if (errorCode || lastWriteTime == shader.lastWriteTime)
+                        continue;
+
+                    // The shader compiler might still be writing the file, if it doesn't look like SPIR-V yet we try again next time
+                    ShaderBinary spirv;
+                    ShaderReflection reflection;
+                    if (!ReadFile(shader.path, spirv) || !IsValidSPIRV(spirv) || !LoadReflection(shader.path, spirv, lastWriteTime, reflection))
+                        continue;
+
+                    oldModules.push_back(shader.module);
+
+                    shader.spirv = std::move(spirv);
+                    shader.reflection = std::move(reflection);
+                    shader.module = CreateShaderModule(device, shader.spirv);
+                    shader.lastWriteTime = lastWriteTime;
+
+                    NC_LOG_MESSAGE("[Renderer]: Reloaded shader %s", shader.path.c_str());
+                    reloadedShaders.push_back(T(static_cast<idType>(i)));
+                }
+            }
+
+            bool ReadFile(const std::string& filename, ShaderBinary& binary);
+            bool IsValidSPIRV(const ShaderBinary& binary);
+            bool LoadReflection(const std::string& shaderPath, const ShaderBinary& binary, std::filesystem::file_time_type shaderWriteTime, ShaderReflection& reflection);
+            void DestroyShaderModule(RenderDeviceVK* device, VkShaderModule module);
             VkShaderModule CreateShaderModule(RenderDeviceVK* device, const ShaderBinary& binary);
-            bool TryFindExistingShader(const std::string& shaderPath, std::vector<Shader>& shaders, size_t& id);
+            bool TryFindExistingShader(u32 shaderPathHash, robin_hood::unordered_map<u32, size_t>& shaderLookup, size_t& id);
 
         private:
+            static constexpr const char* SHADER_DIRECTORY = "Data/shaders/";
+            static const u32 SHADER_WATCH_INTERVAL = 30; // In frames, the shaders are only polled this often since it means a filesystem call per shader
+
+            u32 _framesSinceShaderWatch = 0;
+
             std::vector<Shader> _vertexShaders;
             std::vector<Shader> _pixelShaders;
             std::vector<Shader> _computeShaders;
+
+            // Maps the fnv1a hash of a shader's path to its index in the vectors above
+            robin_hood::unordered_map<u32, size_t> _vertexShaderLookup;
+            robin_hood::unordered_map<u32, size_t> _pixelShaderLookup;
+            robin_hood::unordered_map<u32, size_t> _computeShaderLookup;
         };
     }
 }
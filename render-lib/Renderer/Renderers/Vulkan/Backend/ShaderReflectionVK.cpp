@@ -0,0 +1,144 @@
+#include "ShaderReflectionVK.h"
+#include <fstream>
+#include <algorithm>
+#include "SpirvReflect.h"
+
+namespace Renderer
+{
+    namespace Backend
+    {
+        bool ShaderReflectionVK::Reflect(const void* spirv, size_t size, ShaderReflection& reflection)
+        {
+            SpvReflectShaderModule reflectModule = {};
+            if (spvReflectCreateShaderModule(size, spirv, &reflectModule) != SPV_REFLECT_RESULT_SUCCESS)
+                return false;
+
+            reflection = ShaderReflection();
+            reflection.shaderStage = static_cast<u32>(reflectModule.shader_stage);
+
+            u32 count = 0;
+            bool succeeded = spvReflectEnumerateDescriptorBindings(&reflectModule, &count, nullptr) == SPV_REFLECT_RESULT_SUCCESS;
+
+            std::vector<SpvReflectDescriptorBinding*> bindings(count);
+            succeeded = succeeded && spvReflectEnumerateDescriptorBindings(&reflectModule, &count, bindings.data()) == SPV_REFLECT_RESULT_SUCCESS;
+
+            for (u32 i = 0; succeeded && i < count; i++)
+            {
+                const SpvReflectDescriptorBinding& reflectionBinding = *bindings[i];
+
+                ShaderReflection::DescriptorBinding& binding = reflection.descriptorBindings.emplace_back();
+                binding.set = reflectionBinding.set;
+                binding.binding = reflectionBinding.binding;
+                binding.descriptorType = static_cast<u32>(reflectionBinding.descriptor_type);
+                binding.descriptorCount = 1;
+
+                for (u32 dim = 0; dim < reflectionBinding.array.dims_count; dim++)
+                {
+                    binding.descriptorCount *= reflectionBinding.array.dims[dim];
+                }
+            }
+
+            succeeded = succeeded && spvReflectEnumeratePushConstantBlocks(&reflectModule, &count, nullptr) == SPV_REFLECT_RESULT_SUCCESS;
+
+            std::vector<SpvReflectBlockVariable*> pushConstantBlocks(count);
+            succeeded = succeeded && spvReflectEnumeratePushConstantBlocks(&reflectModule, &count, pushConstantBlocks.data()) == SPV_REFLECT_RESULT_SUCCESS;
+
+            for (u32 i = 0; succeeded && i < count; i++)
+            {
+                const SpvReflectBlockVariable& reflectionBlock = *pushConstantBlocks[i];
+
+                ShaderReflection::PushConstantBlock& block = reflection.pushConstantBlocks.emplace_back();
+                block.begin = reflectionBlock.size;
+                block.end = 0;
+                block.name = (reflectionBlock.name != nullptr) ? reflectionBlock.name : "";
+
+                // The members tell us which bytes the shader actually reads
+                for (u32 member = 0; member < reflectionBlock.member_count; member++)
+                {
+                    const SpvReflectBlockVariable& memberVariable = reflectionBlock.members[member];
+                    block.begin = std::min(block.begin, memberVariable.offset);
+                    block.end = std::max(block.end, memberVariable.offset + memberVariable.size);
+                }
+            }
+
+            spvReflectDestroyShaderModule(&reflectModule);
+            return succeeded;
+        }
+
+        bool ShaderReflectionVK::Load(const std::string& path, ShaderReflection& reflection)
+        {
+            std::ifstream file(path, std::ios::binary);
+            if (!file.is_open())
+                return false;
+
+            Header header;
+            file.read(reinterpret_cast<char*>(&header), sizeof(Header));
+
+            if (!file || header.magic != REFLECTION_MAGIC || header.version != REFLECTION_VERSION)
+                return false;
+
+            reflection = ShaderReflection();
+            reflection.shaderStage = header.shaderStage;
+
+            reflection.descriptorBindings.resize(header.numDescriptorBindings);
+            for (ShaderReflection::DescriptorBinding& binding : reflection.descriptorBindings)
+            {
+                u32 values[4];
+                file.read(reinterpret_cast<char*>(values), sizeof(values));
+
+                binding.set = values[0];
+                binding.binding = values[1];
+                binding.descriptorType = values[2];
+                binding.descriptorCount = values[3];
+            }
+
+            reflection.pushConstantBlocks.resize(header.numPushConstantBlocks);
+            for (ShaderReflection::PushConstantBlock& block : reflection.pushConstantBlocks)
+            {
+                u32 values[3];
+                file.read(reinterpret_cast<char*>(values), sizeof(values));
+
+                block.begin = values[0];
+                block.end = values[1];
+
+                if (!file)
+                    return false;
+
+                block.name.resize(values[2]);
+                file.read(block.name.data(), values[2]);
+            }
+
+            return static_cast<bool>(file);
+        }
+
+        bool ShaderReflectionVK::Save(const std::string& path, const ShaderReflection& reflection)
+        {
+            std::ofstream file(path, std::ios::binary | std::ios::trunc);
+            if (!file.is_open())
+                return false;
+
+            Header header;
+            header.magic = REFLECTION_MAGIC;
+            header.version = REFLECTION_VERSION;
+            header.shaderStage = reflection.shaderStage;
+            header.numDescriptorBindings = static_cast<u32>(reflection.descriptorBindings.size());
+            header.numPushConstantBlocks = static_cast<u32>(reflection.pushConstantBlocks.size());
+            file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+
+            for (const ShaderReflection::DescriptorBinding& binding : reflection.descriptorBindings)
+            {
+                u32 values[4] = { binding.set, binding.binding, binding.descriptorType, binding.descriptorCount };
+                file.write(reinterpret_cast<const char*>(values), sizeof(values));
+            }
+
+            for (const ShaderReflection::PushConstantBlock& block : reflection.pushConstantBlocks)
+            {
+                u32 values[3] = { block.begin, block.end, static_cast<u32>(block.name.size()) };
+                file.write(reinterpret_cast<const char*>(values), sizeof(values));
+                file.write(block.name.data(), block.name.size());
+            }
+
+            return static_cast<bool>(file);
+        }
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <NovusTypes.h>
+#include <vector>
+#include <string>
+
+namespace Renderer
+{
+    namespace Backend
+    {
+        // Everything pipeline creation needs to know about a shader
+        // This is generated next to the SPIR-V by ShaderReflector when the shaders are built, so creating pipelines doesn't have to reflect SPIR-V
+        struct ShaderReflection
+        {
+            struct DescriptorBinding
+            {
+                u32 set = 0;
+                u32 binding = 0;
+                u32 descriptorType = 0; // VkDescriptorType
+                u32 descriptorCount = 1;
+            };
+
+            struct PushConstantBlock
+            {
+                // The bytes the shader actually reads, the block itself always starts at 0
+                u32 begin = 0;
+                u32 end = 0;
+                std::string name;
+            };
+
+            u32 shaderStage = 0; // VkShaderStageFlagBits
+            std::vector<DescriptorBinding> descriptorBindings;
+            std::vector<PushConstantBlock> pushConstantBlocks;
+        };
+
+        class ShaderReflectionVK
+        {
+        public:
+            static bool Reflect(const void* spirv, size_t size, ShaderReflection& reflection);
+
+            static bool Load(const std::string& path, ShaderReflection& reflection);
+            static bool Save(const std::string& path, const ShaderReflection& reflection);
+
+        private:
+            static const u32 REFLECTION_MAGIC = 0x5253434E; // NCSR
+            static const u32 REFLECTION_VERSION = 1;
+
+            struct Header
+            {
+                u32 magic;
+                u32 version;
+                u32 shaderStage;
+                u32 numDescriptorBindings;
+                u32 numPushConstantBlocks;
+            };
+        };
+    }
+}
@@ -1,6 +1,7 @@
 #pragma once
 #include <NovusTypes.h>
 #include "../../../SwapChain.h"
+#include "../../../FrameResource.h"
 #include <vulkan/vulkan.h>
 
 namespace Renderer
@@ -21,7 +22,7 @@ namespace Renderer
             VkPipelineLayout pipelineLayout;
             VkDescriptorPool descriptorPool;
             VkDescriptorSetLayout descriptorSetLayout;
-            VkDescriptorSet descriptorSet;
+            VkDescriptorSet descriptorSets[FRAMES_IN_FLIGHT]; // One per frame in flight, the GPU may still be reading last frame's set while we update this one
             VkPipeline pipeline;
         };
 
@@ -110,7 +111,6 @@ namespace Renderer
             RenderDeviceVK* device;
 
             static const u32 FRAME_BUFFER_COUNT = 2;
-            u32 frameIndex = 0;
             u32 bufferCount;
 
             VkRenderPass renderPass;
@@ -126,7 +126,11 @@ namespace Renderer
             VkExtent2D extent;
             VkImageView imageViews[FRAME_BUFFER_COUNT];
             VkFramebuffer framebuffers[FRAME_BUFFER_COUNT];
-            VkSemaphore imageAvailableSemaphores[FRAME_BUFFER_COUNT];
+            VkSemaphore imageAvailableSemaphores[FRAMES_IN_FLIGHT]; // Indexed by the device frame index, not the swapchain image
+            VkSemaphore renderFinishedSemaphores[FRAMES_IN_FLIGHT];
+            VkFence imagesInFlight[FRAME_BUFFER_COUNT] = {}; // The frame fence of the last frame that rendered into each image, FRAMES_IN_FLIGHT doesn't have to match FRAME_BUFFER_COUNT
+
+            bool isOutOfDate = false; // Set when acquiring or presenting says the swapchain no longer matches the surface, it gets recreated before the next acquire
         };
     }
 }
\ No newline at end of file
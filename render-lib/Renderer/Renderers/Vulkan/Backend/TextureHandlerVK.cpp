@@ -53,10 +53,7 @@ namespace Renderer
                 return TextureID(static_cast<type>(nextID)); // We already loaded this texture
             }
 
-            size_t nextHandle = _textures.size();
-
-            // Make sure we haven't exceeded the limit of the ImageID type, if this hits you need to change type of ImageID to something bigger
-            assert(nextHandle < TextureID::MaxValue());
+            size_t nextHandle = AcquireTextureHandle();
             
             Texture texture;
             texture.hash = cacheDescHash;
@@ -71,7 +68,7 @@ namespace Renderer
 
             CreateTexture(device, texture, pixels);
 
-            _textures.push_back(texture);
+            _textures[nextHandle] = texture;
             return TextureID(static_cast<type>(nextHandle));
         }
 
@@ -94,6 +91,7 @@ namespace Renderer
             // Otherwise load it
             using textureArrayType = type_safe::underlying_type<TextureArrayID>;
             assert(static_cast<textureArrayType>(textureArrayID) < _textureArrays.size());
+            assert(!_textureArrays[static_cast<textureArrayType>(textureArrayID)].isDestroyed); // This texture array has been destroyed
 
             textureID = LoadTexture(device, desc);
 
@@ -101,9 +99,7 @@ namespace Renderer
             Texture& texture = _textures[static_cast<textureType>(textureID)];
 
             TextureArray& textureArray = _textureArrays[static_cast<textureArrayType>(textureArrayID)];
-            arrayIndex = static_cast<u32>(textureArray.textures.size());
-            textureArray.textures.push_back(textureID);
-            textureArray.textureHashes.push_back(descHash);
+            arrayIndex = AddToTextureArray(textureArray, textureID, descHash);
 
             VkDescriptorImageInfo descriptorInfo = {};
             descriptorInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
@@ -128,21 +124,19 @@ namespace Renderer
         {
             assert(desc.size > 0);
 
-            size_t nextHandle = _textureArrays.size();
-
-            // Make sure we haven't exceeded the limit of the TextureArrayID type, if this hits you need to change type of TextureArrayID to something bigger
-            assert(nextHandle < TextureArrayID::MaxValue());
+            size_t nextHandle = AcquireTextureArrayHandle();
             using type = type_safe::underlying_type<TextureArrayID>;
 
             TextureArray textureArray;
             textureArray.textures.reserve(desc.size);
+            textureArray.size = desc.size;
 
             // Create descriptor set layout
             VkDescriptorSetLayoutBinding descriptorLayout = {};
             descriptorLayout.binding = 0;
             descriptorLayout.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
             descriptorLayout.descriptorCount = desc.size;
-            descriptorLayout.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+            descriptorLayout.stageFlags = VK_SHADER_STAGE_ALL;
             descriptorLayout.pImmutableSamplers = NULL;
 
             VkDescriptorSetLayoutCreateInfo descriptorLayoutInfo = {};
@@ -207,7 +201,7 @@ namespace Renderer
 
             vkUpdateDescriptorSets(device->_device, 1, &descriptorWrite, 0, NULL);
 
-            _textureArrays.push_back(textureArray);
+            _textureArrays[nextHandle] = textureArray;
             return TextureArrayID(static_cast<type>(nextHandle));
         }
 
@@ -218,10 +212,7 @@ namespace Renderer
             assert(desc.layers > 0);
             assert(desc.data != nullptr);
 
-            size_t nextHandle = _textures.size();
-
-            // Make sure we haven't exceeded the limit of the TextureID type, if this hits you need to change type of ImageID to something bigger
-            assert(nextHandle < TextureID::MaxValue());
+            size_t nextHandle = AcquireTextureHandle();
             using type = type_safe::underlying_type<TextureID>;
 
             Texture texture;
@@ -234,7 +225,7 @@ namespace Renderer
 
             CreateTexture(device, texture, desc.data);
 
-            _textures.push_back(texture);
+            _textures[nextHandle] = texture;
             return TextureID(static_cast<type>(nextHandle));
         }
 
@@ -242,6 +233,7 @@ namespace Renderer
         {
             using textureArrayType = type_safe::underlying_type<TextureArrayID>;
             assert(static_cast<textureArrayType>(textureArrayID) < _textureArrays.size());
+            assert(!_textureArrays[static_cast<textureArrayType>(textureArrayID)].isDestroyed); // This texture array has been destroyed
 
             TextureID textureID = CreateDataTexture(device, desc);
 
@@ -249,9 +241,7 @@ namespace Renderer
             Texture& texture = _textures[static_cast<textureType>(textureID)];
 
             TextureArray& textureArray = _textureArrays[static_cast<textureArrayType>(textureArrayID)];
-            arrayIndex = static_cast<u32>(textureArray.textures.size());
-            textureArray.textures.push_back(textureID);
-            textureArray.textureHashes.push_back(0);
+            arrayIndex = AddToTextureArray(textureArray, textureID, 0);
 
             VkDescriptorImageInfo descriptorInfo = {};
             descriptorInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
@@ -272,12 +262,100 @@ namespace Renderer
             return textureID;
         }
 
+        void TextureHandlerVK::DestroyTexture(RenderDeviceVK* device, TextureID textureID)
+        {
+            using type = type_safe::underlying_type<TextureID>;
+
+            // Lets make sure this id exists
+            assert(_textures.size() > static_cast<type>(textureID));
+
+            Texture& texture = _textures[static_cast<type>(textureID)];
+            assert(!texture.isDestroyed); // Destroying a texture twice
+
+            // Point every array slot that holds this texture at the debug texture instead, arrays are bound as a whole so the slot has to stay valid
+            VkDescriptorImageInfo debugDescriptorInfo = {};
+            debugDescriptorInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            debugDescriptorInfo.imageView = _debugTexture.imageView;
+
+            for (TextureArray& textureArray : _textureArrays)
+            {
+                if (textureArray.isDestroyed)
+                    continue;
+
+                for (u32 arrayIndex = 0; arrayIndex < textureArray.textures.size(); arrayIndex++)
+                {
+                    if (textureArray.textures[arrayIndex] != textureID)
+                        continue;
+
+                    textureArray.textures[arrayIndex] = TextureID::Invalid();
+                    textureArray.textureHashes[arrayIndex] = 0;
+
+                    VkWriteDescriptorSet descriptorWrite = {};
+                    descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                    descriptorWrite.pNext = NULL;
+                    descriptorWrite.dstSet = textureArray.descriptorSet;
+                    descriptorWrite.descriptorCount = 1;
+                    descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+                    descriptorWrite.pImageInfo = &debugDescriptorInfo;
+                    descriptorWrite.dstArrayElement = arrayIndex;
+                    descriptorWrite.dstBinding = 0;
+
+                    vkUpdateDescriptorSets(device->_device, 1, &descriptorWrite, 0, NULL);
+                }
+            }
+
+            VkImage image = texture.image;
+            VmaAllocation allocation = texture.allocation;
+            VkImageView imageView = texture.imageView;
+            VkDescriptorSetLayout descriptorSetLayout = texture.descriptorSetLayout;
+            VkDescriptorPool descriptorPool = texture.descriptorPool;
+
+            device->DeferDestroy([device, image, allocation, imageView, descriptorSetLayout, descriptorPool]()
+            {
+                vkDestroyDescriptorPool(device->_device, descriptorPool, nullptr);
+                vkDestroyDescriptorSetLayout(device->_device, descriptorSetLayout, nullptr);
+                vkDestroyImageView(device->_device, imageView, nullptr);
+                vmaDestroyImage(device->_allocator, image, allocation);
+            });
+
+            texture = Texture();
+            texture.isDestroyed = true;
+
+            _freeTextureHandles.push_back(static_cast<type>(textureID));
+        }
+
+        void TextureHandlerVK::DestroyTextureArray(RenderDeviceVK* device, TextureArrayID textureArrayID)
+        {
+            using type = type_safe::underlying_type<TextureArrayID>;
+
+            // Lets make sure this id exists
+            assert(_textureArrays.size() > static_cast<type>(textureArrayID));
+
+            TextureArray& textureArray = _textureArrays[static_cast<type>(textureArrayID)];
+            assert(!textureArray.isDestroyed); // Destroying a texture array twice
+
+            VkDescriptorSetLayout descriptorSetLayout = textureArray.descriptorSetLayout;
+            VkDescriptorPool descriptorPool = textureArray.descriptorPool;
+
+            device->DeferDestroy([device, descriptorSetLayout, descriptorPool]()
+            {
+                vkDestroyDescriptorPool(device->_device, descriptorPool, nullptr);
+                vkDestroyDescriptorSetLayout(device->_device, descriptorSetLayout, nullptr);
+            });
+
+            textureArray = TextureArray();
+            textureArray.isDestroyed = true;
+
+            _freeTextureArrayHandles.push_back(static_cast<type>(textureArrayID));
+        }
+
         VkImageView TextureHandlerVK::GetImageView(const TextureID id)
         {
             using type = type_safe::underlying_type<TextureID>;
 
             // Lets make sure this id exists
             assert(_textures.size() > static_cast<type>(id));
+            assert(!_textures[static_cast<type>(id)].isDestroyed); // This texture has been destroyed
             return _textures[static_cast<type>(id)].imageView;
         }
 
@@ -287,6 +365,7 @@ namespace Renderer
 
             // Lets make sure this id exists
             assert(_textures.size() > static_cast<type>(id));
+            assert(!_textures[static_cast<type>(id)].isDestroyed); // This texture has been destroyed
             return _textures[static_cast<type>(id)].descriptorSet;
         }
 
@@ -296,9 +375,48 @@ namespace Renderer
 
             // Lets make sure this id exists
             assert(_textureArrays.size() > static_cast<type>(id));
+            assert(!_textureArrays[static_cast<type>(id)].isDestroyed); // This texture array has been destroyed
             return _textureArrays[static_cast<type>(id)].descriptorSet;
         }
 
+        size_t TextureHandlerVK::AcquireTextureHandle()
+        {
+            if (!_freeTextureHandles.empty())
+            {
+                size_t handle = _freeTextureHandles.back();
+                _freeTextureHandles.pop_back();
+
+                return handle;
+            }
+
+            size_t nextHandle = _textures.size();
+
+            // Make sure we haven't exceeded the limit of the TextureID type, if this hits you need to change type of TextureID to something bigger
+            assert(nextHandle < TextureID::MaxValue());
+
+            _textures.emplace_back();
+            return nextHandle;
+        }
+
+        size_t TextureHandlerVK::AcquireTextureArrayHandle()
+        {
+            if (!_freeTextureArrayHandles.empty())
+            {
+                size_t handle = _freeTextureArrayHandles.back();
+                _freeTextureArrayHandles.pop_back();
+
+                return handle;
+            }
+
+            size_t nextHandle = _textureArrays.size();
+
+            // Make sure we haven't exceeded the limit of the TextureArrayID type, if this hits you need to change type of TextureArrayID to something bigger
+            assert(nextHandle < TextureArrayID::MaxValue());
+
+            _textureArrays.emplace_back();
+            return nextHandle;
+        }
+
         u64 TextureHandlerVK::CalculateDescHash(const TextureDesc& desc)
         {
             u64 hash = XXHash64::hash(desc.path.c_str(), desc.path.size(), 0);
@@ -342,6 +460,30 @@ namespace Renderer
             return false;
         }
 
+        u32 TextureHandlerVK::AddToTextureArray(TextureArray& textureArray, TextureID textureID, u64 descHash)
+        {
+            // Reuse the slot of a destroyed texture before growing, otherwise loading and unloading would walk off the end of the array
+            for (u32 arrayIndex = 0; arrayIndex < textureArray.textures.size(); arrayIndex++)
+            {
+                if (textureArray.textures[arrayIndex] != TextureID::Invalid())
+                    continue;
+
+                textureArray.textures[arrayIndex] = textureID;
+                textureArray.textureHashes[arrayIndex] = descHash;
+                return arrayIndex;
+            }
+
+            u32 arrayIndex = static_cast<u32>(textureArray.textures.size());
+            if (arrayIndex >= textureArray.size)
+            {
+                NC_LOG_FATAL("Texture array is full, it only has %u slots", textureArray.size);
+            }
+
+            textureArray.textures.push_back(textureID);
+            textureArray.textureHashes.push_back(descHash);
+            return arrayIndex;
+        }
+
         u8* TextureHandlerVK::ReadFile(const std::string& filename, i32& width, i32& height, VkFormat& format)
         {
             format = VK_FORMAT_R8G8B8A8_UNORM;
@@ -379,21 +521,8 @@ namespace Renderer
 
         void TextureHandlerVK::CreateTexture(RenderDeviceVK* device, Texture& texture, u8* pixels)
         {
-            // Create staging buffer
-            VkBuffer stagingBuffer;
-            VmaAllocation stagingBufferAllocation;
-
             VkDeviceSize imageSize = Math::RoofToInt(static_cast<f64>(texture.width) * static_cast<f64>(texture.height) * static_cast<f64>(texture.layers) * FormatTexelSize(texture.format));
 
-            device->CreateBuffer(imageSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY, stagingBuffer, stagingBufferAllocation);
-
-            void* data;
-            vmaMapMemory(device->_allocator, stagingBufferAllocation, &data);
-            memcpy(data, pixels, static_cast<size_t>(imageSize));
-            vmaUnmapMemory(device->_allocator, stagingBufferAllocation);
-
-            delete[] pixels;
-
             // Create image
             VkImageCreateInfo imageInfo = {};
             imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
@@ -421,10 +550,9 @@ namespace Renderer
 
             DebugMarkerUtilVK::SetObjectName(device->_device, (u64)texture.image, VK_DEBUG_REPORT_OBJECT_TYPE_IMAGE_EXT, texture.debugName.c_str());
 
-            // Copy data from stagingBuffer into image
-            device->TransitionImageLayout(texture.image, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, texture.layers);
-            device->CopyBufferToImage(stagingBuffer, texture.image, static_cast<u32>(texture.width), static_cast<u32>(texture.height), texture.layers);
-            device->TransitionImageLayout(texture.image, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, texture.layers);
+            // Stage the pixels and queue the copy into the image, the upload handler copies them so we can free them right away
+            device->UploadToImage(texture.image, pixels, imageSize, static_cast<u32>(texture.width), static_cast<u32>(texture.height), texture.layers);
+            delete[] pixels;
 
             // Create color view
             VkImageViewCreateInfo viewInfo = {};
@@ -450,7 +578,7 @@ namespace Renderer
             descriptorLayout.binding = 0;
             descriptorLayout.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
             descriptorLayout.descriptorCount = 1;
-            descriptorLayout.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+            descriptorLayout.stageFlags = VK_SHADER_STAGE_ALL;
             descriptorLayout.pImmutableSamplers = NULL;
 
             VkDescriptorSetLayoutCreateInfo descriptorLayoutInfo = {};
@@ -29,6 +29,11 @@ namespace Renderer
             TextureID CreateDataTexture(RenderDeviceVK* device, const DataTextureDesc& desc);
             TextureID CreateDataTextureIntoArray(RenderDeviceVK* device, const DataTextureDesc& desc, TextureArrayID textureArray, u32& arrayIndex);
 
+            // Loaded textures are shared by everyone who loaded the same path, destroying it destroys it for all of them
+            // Array slots that held the texture are pointed at the debug texture, the slot itself is not reused
+            void DestroyTexture(RenderDeviceVK* device, TextureID textureID);
+            void DestroyTextureArray(RenderDeviceVK* device, TextureArrayID textureArrayID); // Only destroys the array, the textures in it stay alive
+
             VkImageView GetImageView(const TextureID id);
             VkDescriptorSet GetDescriptorSet(const TextureID id);
             VkDescriptorSet GetDescriptorSet(const TextureArrayID id);
@@ -36,7 +41,7 @@ namespace Renderer
         private:
             struct Texture
             {
-                u64 hash;
+                u64 hash = 0; // 0 for data textures and destroyed textures, neither of them can be found in the cache
 
                 i32 width;
                 i32 height;
@@ -53,22 +58,31 @@ namespace Renderer
                 VkDescriptorSet descriptorSet;
 
                 std::string debugName = "";
+
+                bool isDestroyed = false;
             };
 
             struct TextureArray
             {
-                std::vector<TextureID> textures;
+                std::vector<TextureID> textures; // TextureID::Invalid() for slots whose texture got destroyed, the next texture added reuses them
                 std::vector<u64> textureHashes;
+                u32 size = 0; // How many slots the descriptor set has
 
                 VkDescriptorSetLayout descriptorSetLayout;
                 VkDescriptorPool descriptorPool;
                 VkDescriptorSet descriptorSet;
+
+                bool isDestroyed = false;
             };
 
         private:
+            size_t AcquireTextureHandle(); // Reuses the handle of a destroyed texture if there is one
+            size_t AcquireTextureArrayHandle();
+
             u64 CalculateDescHash(const TextureDesc& desc);
             bool TryFindExistingTexture(u64 descHash, size_t& id);
             bool TryFindExistingTextureInArray(TextureArrayID arrayID, u64 descHash, size_t& arrayIndex, TextureID& textureId);
+            u32 AddToTextureArray(TextureArray& textureArray, TextureID textureID, u64 descHash); // Returns the slot it went into
 
             u8* ReadFile(const std::string& filename, i32& width, i32& height, VkFormat& format);
             void CreateTexture(RenderDeviceVK* device, Texture& texture, u8* pixels);
@@ -77,6 +91,9 @@ namespace Renderer
             Texture _debugTexture;
             std::vector<Texture> _textures;
             std::vector<TextureArray> _textureArrays;
+
+            std::vector<size_t> _freeTextureHandles;
+            std::vector<size_t> _freeTextureArrayHandles;
         };
     }
 }
\ No newline at end of file
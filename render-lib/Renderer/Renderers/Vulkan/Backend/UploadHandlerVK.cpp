@@ -0,0 +1,390 @@
+#include "UploadHandlerVK.h"
+#include <Utils/DebugHandler.h>
+#include <algorithm>
+#include <cassert>
+#include "RenderDeviceVK.h"
+
+namespace Renderer
+{
+    namespace Backend
+    {
+        UploadHandlerVK::UploadHandlerVK()
+        {
+
+        }
+
+        UploadHandlerVK::~UploadHandlerVK()
+        {
+
+        }
+
+        void UploadHandlerVK::Init(RenderDeviceVK* device)
+        {
+            _device = device;
+
+            QueueFamilyIndices queueFamilyIndices = device->FindQueueFamilies(device->_physicalDevice);
+            _graphicsFamily = queueFamilyIndices.graphicsFamily.value();
+
+            _hasTransferQueue = queueFamilyIndices.transferFamily.has_value();
+            if (_hasTransferQueue)
+            {
+                _transferFamily = queueFamilyIndices.transferFamily.value();
+            }
+
+            void* mappedData;
+            device->CreateMappedBuffer(STAGING_RING_SIZE, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY, _stagingBuffer, _stagingAllocation, mappedData);
+            _stagingData = static_cast<u8*>(mappedData);
+        }
+
+        void UploadHandlerVK::UploadToBuffer(VkBuffer dstBuffer, VkDeviceSize dstOffset, const void* data, VkDeviceSize size)
+        {
+            std::scoped_lock lock(_mutex);
+
+            VkDeviceSize stagingOffset;
+            VkBuffer stagingBuffer = AllocateStaging(data, size, stagingOffset);
+
+            UploadBatch& batch = GetRecordingBatch();
+
+            // The copy can overwrite buffer data that earlier submissions still read or write, the staging ring doesn't need this since the frame fences guard it
+            // Only the first buffer copy of a batch needs to wait, and only on the stages that can touch buffers
+            if (!batch.hasBufferCopies)
+            {
+                VkMemoryBarrier memoryBarrier = {};
+                memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+                memoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+                memoryBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+                vkCmdPipelineBarrier(batch.graphicsCommandBuffer, BUFFER_ACCESS_STAGES, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &memoryBarrier, 0, nullptr, 0, nullptr);
+
+                batch.hasBufferCopies = true;
+            }
+
+            VkBufferCopy copyRegion = {};
+            copyRegion.srcOffset = stagingOffset;
+            copyRegion.dstOffset = dstOffset;
+            copyRegion.size = size;
+            vkCmdCopyBuffer(batch.graphicsCommandBuffer, stagingBuffer, dstBuffer, 1, &copyRegion);
+        }
+
+        void UploadHandlerVK::UploadToImage(VkImage dstImage, const void* data, VkDeviceSize size, u32 width, u32 height, u32 numLayers)
+        {
+            std::scoped_lock lock(_mutex);
+
+            VkDeviceSize stagingOffset;
+            VkBuffer stagingBuffer = AllocateStaging(data, size, stagingOffset);
+
+            UploadBatch& batch = GetRecordingBatch();
+
+            VkBufferImageCopy region = {};
+            region.bufferOffset = stagingOffset;
+            region.bufferRowLength = 0;
+            region.bufferImageHeight = 0;
+
+            region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            region.imageSubresource.mipLevel = 0;
+            region.imageSubresource.baseArrayLayer = 0;
+            region.imageSubresource.layerCount = numLayers;
+
+            region.imageOffset = { 0, 0, 0 };
+            region.imageExtent = { width, height, 1 };
+
+            if (!_hasTransferQueue)
+            {
+                _device->TransitionImageLayout(batch.graphicsCommandBuffer, dstImage, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, numLayers);
+                vkCmdCopyBufferToImage(batch.graphicsCommandBuffer, stagingBuffer, dstImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+                _device->TransitionImageLayout(batch.graphicsCommandBuffer, dstImage, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, numLayers);
+                return;
+            }
+
+            // The image is brand new, so nothing on the graphics queue can be using it while the transfer queue writes to it
+            VkImageMemoryBarrier imageBarrier = {};
+            imageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            imageBarrier.image = dstImage;
+            imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            imageBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            imageBarrier.subresourceRange.baseMipLevel = 0;
+            imageBarrier.subresourceRange.levelCount = 1;
+            imageBarrier.subresourceRange.baseArrayLayer = 0;
+            imageBarrier.subresourceRange.layerCount = numLayers;
+
+            imageBarrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            imageBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            imageBarrier.srcAccessMask = 0;
+            imageBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            vkCmdPipelineBarrier(batch.transferCommandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &imageBarrier);
+
+            vkCmdCopyBufferToImage(batch.transferCommandBuffer, stagingBuffer, dstImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+            // Hand the image over to the graphics queue, the release and acquire barriers need to match exactly
+            imageBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            imageBarrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            imageBarrier.srcQueueFamilyIndex = _transferFamily;
+            imageBarrier.dstQueueFamilyIndex = _graphicsFamily;
+
+            imageBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            imageBarrier.dstAccessMask = 0;
+            vkCmdPipelineBarrier(batch.transferCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 0, nullptr, 1, &imageBarrier);
+
+            imageBarrier.srcAccessMask = 0;
+            imageBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+            vkCmdPipelineBarrier(batch.graphicsCommandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, nullptr, 0, nullptr, 1, &imageBarrier);
+
+            batch.hasTransferCommands = true;
+        }
+
+        void UploadHandlerVK::TransitionImageLayout(VkImage image, VkImageAspectFlags aspects, VkImageLayout oldLayout, VkImageLayout newLayout, u32 numLayers)
+        {
+            std::scoped_lock lock(_mutex);
+
+            UploadBatch& batch = GetRecordingBatch();
+            _device->TransitionImageLayout(batch.graphicsCommandBuffer, image, aspects, oldLayout, newLayout, numLayers);
+        }
+
+        void UploadHandlerVK::SubmitUploads()
+        {
+            std::scoped_lock lock(_mutex);
+            Submit();
+        }
+
+        void UploadHandlerVK::EndFrame(u32 frameIndex)
+        {
+            std::scoped_lock lock(_mutex);
+            Submit();
+
+            _ringFrameEnds[frameIndex] = _ringHead;
+        }
+
+        void UploadHandlerVK::RecycleFrame(u32 frameIndex)
+        {
+            std::scoped_lock lock(_mutex);
+
+            // Everything staged up until the end of this frame has been consumed, the tail never moves backwards since a stall might have moved it ahead already
+            _ringTail = std::max(_ringTail, _ringFrameEnds[frameIndex]);
+
+            std::vector<size_t>& pendingBatches = _pendingBatches[frameIndex];
+            for (size_t batchIndex : pendingBatches)
+            {
+                _availableBatches.push(batchIndex);
+            }
+            pendingBatches.clear();
+        }
+
+        UploadHandlerVK::UploadBatch& UploadHandlerVK::GetRecordingBatch()
+        {
+            if (_isRecording)
+                return _batches[_recordingBatch];
+
+            if (_availableBatches.size() > 0)
+            {
+                _recordingBatch = _availableBatches.front();
+                _availableBatches.pop();
+            }
+            else
+            {
+                _recordingBatch = CreateBatch();
+            }
+
+            UploadBatch& batch = _batches[_recordingBatch];
+
+            VkCommandBufferBeginInfo beginInfo = {};
+            beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+            vkResetCommandPool(_device->_device, batch.graphicsCommandPool, 0);
+            if (vkBeginCommandBuffer(batch.graphicsCommandBuffer, &beginInfo) != VK_SUCCESS)
+            {
+                NC_LOG_FATAL("Failed to begin recording upload command buffer!");
+            }
+
+            if (_hasTransferQueue)
+            {
+                vkResetCommandPool(_device->_device, batch.transferCommandPool, 0);
+                if (vkBeginCommandBuffer(batch.transferCommandBuffer, &beginInfo) != VK_SUCCESS)
+                {
+                    NC_LOG_FATAL("Failed to begin recording transfer command buffer!");
+                }
+            }
+
+            batch.hasTransferCommands = false;
+            batch.hasBufferCopies = false;
+            _isRecording = true;
+
+            return batch;
+        }
+
+        size_t UploadHandlerVK::CreateBatch()
+        {
+            size_t batchIndex = _batches.size();
+            UploadBatch& batch = _batches.emplace_back();
+
+            VkCommandPoolCreateInfo poolInfo = {};
+            poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+            poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+            VkCommandBufferAllocateInfo allocInfo = {};
+            allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocInfo.commandBufferCount = 1;
+
+            poolInfo.queueFamilyIndex = _graphicsFamily;
+            if (vkCreateCommandPool(_device->_device, &poolInfo, nullptr, &batch.graphicsCommandPool) != VK_SUCCESS)
+            {
+                NC_LOG_FATAL("Failed to create upload command pool!");
+            }
+
+            allocInfo.commandPool = batch.graphicsCommandPool;
+            if (vkAllocateCommandBuffers(_device->_device, &allocInfo, &batch.graphicsCommandBuffer) != VK_SUCCESS)
+            {
+                NC_LOG_FATAL("Failed to allocate upload command buffer!");
+            }
+
+            if (_hasTransferQueue)
+            {
+                poolInfo.queueFamilyIndex = _transferFamily;
+                if (vkCreateCommandPool(_device->_device, &poolInfo, nullptr, &batch.transferCommandPool) != VK_SUCCESS)
+                {
+                    NC_LOG_FATAL("Failed to create transfer command pool!");
+                }
+
+                allocInfo.commandPool = batch.transferCommandPool;
+                if (vkAllocateCommandBuffers(_device->_device, &allocInfo, &batch.transferCommandBuffer) != VK_SUCCESS)
+                {
+                    NC_LOG_FATAL("Failed to allocate transfer command buffer!");
+                }
+
+                VkSemaphoreCreateInfo semaphoreInfo = {};
+                semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+                if (vkCreateSemaphore(_device->_device, &semaphoreInfo, nullptr, &batch.transferFinishedSemaphore) != VK_SUCCESS)
+                {
+                    NC_LOG_FATAL("Failed to create transfer finished semaphore!");
+                }
+            }
+
+            return batchIndex;
+        }
+
+        void UploadHandlerVK::Submit()
+        {
+            if (!_isRecording)
+                return;
+
+            UploadBatch& batch = _batches[_recordingBatch];
+
+            // Make the copies visible to everything that runs after this batch
+            VkMemoryBarrier memoryBarrier = {};
+            memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+            memoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            memoryBarrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+            vkCmdPipelineBarrier(batch.graphicsCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 1, &memoryBarrier, 0, nullptr, 0, nullptr);
+
+            if (vkEndCommandBuffer(batch.graphicsCommandBuffer) != VK_SUCCESS)
+            {
+                NC_LOG_FATAL("Failed to record upload command buffer!");
+            }
+
+            VkSubmitInfo submitInfo = {};
+            submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+            submitInfo.commandBufferCount = 1;
+
+            VkPipelineStageFlags waitStageMask = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+
+            if (_hasTransferQueue)
+            {
+                if (vkEndCommandBuffer(batch.transferCommandBuffer) != VK_SUCCESS)
+                {
+                    NC_LOG_FATAL("Failed to record transfer command buffer!");
+                }
+
+                if (batch.hasTransferCommands)
+                {
+                    submitInfo.pCommandBuffers = &batch.transferCommandBuffer;
+                    submitInfo.signalSemaphoreCount = 1;
+                    submitInfo.pSignalSemaphores = &batch.transferFinishedSemaphore;
+
+                    if (vkQueueSubmit(_device->_transferQueue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS)
+                    {
+                        NC_LOG_FATAL("Failed to submit transfer command buffer!");
+                    }
+
+                    // The graphics half acquires the images the transfer queue released, so it has to wait for it
+                    submitInfo.signalSemaphoreCount = 0;
+                    submitInfo.pSignalSemaphores = nullptr;
+                    submitInfo.waitSemaphoreCount = 1;
+                    submitInfo.pWaitSemaphores = &batch.transferFinishedSemaphore;
+                    submitInfo.pWaitDstStageMask = &waitStageMask;
+                }
+            }
+
+            submitInfo.pCommandBuffers = &batch.graphicsCommandBuffer;
+            if (vkQueueSubmit(_device->_graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS)
+            {
+                NC_LOG_FATAL("Failed to submit upload command buffer!");
+            }
+
+            // The frame fence is signaled after this submission, so that tells us when the batch can be recorded again
+            _pendingBatches[_device->GetFrameIndex()].push_back(_recordingBatch);
+            _isRecording = false;
+        }
+
+        VkBuffer UploadHandlerVK::AllocateStaging(const void* data, VkDeviceSize size, VkDeviceSize& offset)
+        {
+            if (!TryAllocateFromRing(size, offset))
+            {
+                if (size > STAGING_RING_SIZE)
+                {
+                    // Too big to ever fit the ring, give it a buffer of its own that dies with the frame
+                    VkBuffer stagingBuffer;
+                    VmaAllocation stagingAllocation;
+                    void* mappedData;
+                    _device->CreateMappedBuffer(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY, stagingBuffer, stagingAllocation, mappedData);
+                    memcpy(mappedData, data, static_cast<size_t>(size));
+
+                    RenderDeviceVK* device = _device;
+                    device->DeferDestroy([device, stagingBuffer, stagingAllocation]()
+                    {
+                        vmaDestroyBuffer(device->_allocator, stagingBuffer, stagingAllocation);
+                    });
+
+                    offset = 0;
+                    return stagingBuffer;
+                }
+
+                // The frames in flight have staged more than the whole ring, wait for the GPU to catch up and start over
+                NC_LOG_WARNING("Staging ring is full, stalling until the GPU has caught up. Consider increasing STAGING_RING_SIZE");
+                Submit();
+                vkQueueWaitIdle(_device->_graphicsQueue); // The graphics half of every batch runs last, so this covers the transfer queue as well
+                _ringTail = _ringHead;
+
+                bool didAllocate = TryAllocateFromRing(size, offset);
+                assert(didAllocate); // An empty ring always fits anything that is not bigger than the ring
+            }
+
+            memcpy(_stagingData + offset, data, static_cast<size_t>(size));
+            return _stagingBuffer;
+        }
+
+        bool UploadHandlerVK::TryAllocateFromRing(VkDeviceSize size, VkDeviceSize& offset)
+        {
+            VkDeviceSize alignedSize = (size + STAGING_ALIGNMENT - 1) & ~(STAGING_ALIGNMENT - 1);
+            if (alignedSize > STAGING_RING_SIZE)
+                return false;
+
+            // Allocations never wrap around the end of the ring, we skip to the start instead
+            u64 start = (_ringHead + STAGING_ALIGNMENT - 1) & ~(STAGING_ALIGNMENT - 1);
+            u64 physicalStart = start % STAGING_RING_SIZE;
+            if (physicalStart + alignedSize > STAGING_RING_SIZE)
+            {
+                start += STAGING_RING_SIZE - physicalStart;
+            }
+
+            if (start + alignedSize - _ringTail > STAGING_RING_SIZE)
+                return false;
+
+            offset = start % STAGING_RING_SIZE;
+            _ringHead = start + alignedSize;
+
+            return true;
+        }
+    }
+}
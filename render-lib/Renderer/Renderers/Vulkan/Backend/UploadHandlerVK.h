@@ -0,0 +1,89 @@
+#pragma once
+#include <NovusTypes.h>
+#include <vector>
+#include <queue>
+#include <mutex>
+#include <vulkan/vulkan.h>
+#include "vk_mem_alloc.h"
+
+#include "../../../FrameResource.h"
+
+namespace Renderer
+{
+    namespace Backend
+    {
+        class RenderDeviceVK;
+
+        // Batches every upload into one submission instead of stalling the GPU for each copy
+        // Data is staged in a persistently mapped ring buffer, a frame's part of the ring is reused once that frame's fence has signaled
+        // Image uploads go through a dedicated transfer queue when the device has one, buffer uploads stay on the graphics queue since they can overwrite buffers the GPU is still reading
+        class UploadHandlerVK
+        {
+        public:
+            UploadHandlerVK();
+            ~UploadHandlerVK();
+
+            void Init(RenderDeviceVK* device);
+
+            void UploadToBuffer(VkBuffer dstBuffer, VkDeviceSize dstOffset, const void* data, VkDeviceSize size);
+            void UploadToImage(VkImage dstImage, const void* data, VkDeviceSize size, u32 width, u32 height, u32 numLayers); // Leaves the image in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+            void TransitionImageLayout(VkImage image, VkImageAspectFlags aspects, VkImageLayout oldLayout, VkImageLayout newLayout, u32 numLayers);
+
+            // Submits everything recorded since the last call, every graphics submission calls this first so it sees the uploads
+            void SubmitUploads();
+
+            void EndFrame(u32 frameIndex); // Submits the frame's uploads and remembers how much of the ring the frame used
+            void RecycleFrame(u32 frameIndex); // Only call this once the frame has retired on the GPU
+
+        private:
+            struct UploadBatch
+            {
+                VkCommandPool graphicsCommandPool = VK_NULL_HANDLE;
+                VkCommandBuffer graphicsCommandBuffer = VK_NULL_HANDLE;
+
+                // Only created when we have a dedicated transfer queue
+                VkCommandPool transferCommandPool = VK_NULL_HANDLE;
+                VkCommandBuffer transferCommandBuffer = VK_NULL_HANDLE;
+                VkSemaphore transferFinishedSemaphore = VK_NULL_HANDLE;
+
+                bool hasTransferCommands = false;
+                bool hasBufferCopies = false; // The first buffer copy in a batch waits for earlier buffer accesses
+            };
+
+            UploadBatch& GetRecordingBatch();
+            size_t CreateBatch();
+            void Submit();
+
+            VkBuffer AllocateStaging(const void* data, VkDeviceSize size, VkDeviceSize& offset);
+            bool TryAllocateFromRing(VkDeviceSize size, VkDeviceSize& offset);
+
+        private:
+            static const VkDeviceSize STAGING_RING_SIZE = 64 * 1024 * 1024;
+            static const VkDeviceSize STAGING_ALIGNMENT = 16; // Copies into images need the offset to be a multiple of the texel size, 16 covers every block compressed format
+            static const VkPipelineStageFlags BUFFER_ACCESS_STAGES = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT;
+
+            RenderDeviceVK* _device = nullptr;
+            std::mutex _mutex;
+
+            bool _hasTransferQueue = false;
+            u32 _graphicsFamily = 0;
+            u32 _transferFamily = 0;
+
+            VkBuffer _stagingBuffer = VK_NULL_HANDLE;
+            VmaAllocation _stagingAllocation = VK_NULL_HANDLE;
+            u8* _stagingData = nullptr;
+
+            // These only ever grow, the physical offset into the ring is the value modulo STAGING_RING_SIZE
+            u64 _ringHead = 0;
+            u64 _ringTail = 0;
+            u64 _ringFrameEnds[FRAMES_IN_FLIGHT] = { 0 };
+
+            std::vector<UploadBatch> _batches;
+            std::queue<size_t> _availableBatches;
+            std::vector<size_t> _pendingBatches[FRAMES_IN_FLIGHT]; // Submitted but maybe still executing, indexed by the frame that submitted them
+
+            size_t _recordingBatch = 0;
+            bool _isRecording = false;
+        };
+    }
+}
@@ -15,6 +15,7 @@
 #include "Backend/SwapChainVK.h"
 #include "Backend/DebugMarkerUtilVK.h"
 #include "Backend/BufferBackendVK.h"
+#include "Backend/FormatConverterVK.h"
 
 namespace Renderer
 {
@@ -30,6 +31,7 @@ namespace Renderer
         _commandListHandler = new Backend::CommandListHandlerVK();
         _samplerHandler = new Backend::SamplerHandlerVK();
 
+        _shaderHandler->LoadAllShaders(_device);
         _textureHandler->LoadDebugTexture(_device, debugTexture);
     }
 
@@ -41,6 +43,7 @@ namespace Renderer
     void RendererVK::Deinit()
     {
         _device->FlushGPU(); // Make sure it has finished rendering
+        _device->SavePipelineCache();
 
         delete(_device);
         delete(_imageHandler);
@@ -62,6 +65,26 @@ namespace Renderer
         return _imageHandler->CreateDepthImage(_device, desc);
     }
 
+    ImageID RendererVK::AcquireTransientImage(ImageDesc& desc, u32 aliasSlot)
+    {
+        return _imageHandler->AcquireTransientImage(_device, desc, aliasSlot);
+    }
+
+    DepthImageID RendererVK::AcquireTransientDepthImage(DepthImageDesc& desc, u32 aliasSlot)
+    {
+        return _imageHandler->AcquireTransientDepthImage(_device, desc, aliasSlot);
+    }
+
+    void RendererVK::ReleaseTransientImage(ImageID image)
+    {
+        _imageHandler->ReleaseTransientImage(image);
+    }
+
+    void RendererVK::ReleaseTransientDepthImage(DepthImageID image)
+    {
+        _imageHandler->ReleaseTransientDepthImage(image);
+    }
+
     SamplerID RendererVK::CreateSampler(SamplerDesc& desc)
     {
         return _samplerHandler->CreateSampler(_device, desc);
@@ -69,13 +92,14 @@ namespace Renderer
 
     GraphicsPipelineID RendererVK::CreatePipeline(GraphicsPipelineDesc& desc)
     {
+        std::scoped_lock lock(_creationMutex);
         return _pipelineHandler->CreatePipeline(_device, _shaderHandler, _imageHandler, desc);
     }
 
-    ComputePipelineID RendererVK::CreatePipeline(ComputePipelineDesc& /*desc*/)
+    ComputePipelineID RendererVK::CreatePipeline(ComputePipelineDesc& desc)
     {
-        NC_LOG_FATAL("Not supported yet");
-        return ComputePipelineID::Invalid();
+        std::scoped_lock lock(_creationMutex);
+        return _pipelineHandler->CreatePipeline(_device, _shaderHandler, _imageHandler, desc);
     }
 
     ModelID RendererVK::CreatePrimitiveModel(PrimitiveModelDesc& desc)
@@ -120,19 +144,64 @@ namespace Renderer
 
     VertexShaderID RendererVK::LoadShader(VertexShaderDesc& desc)
     {
+        std::scoped_lock lock(_creationMutex);
         return _shaderHandler->LoadShader(_device, desc);
     }
 
     PixelShaderID RendererVK::LoadShader(PixelShaderDesc& desc)
     {
+        std::scoped_lock lock(_creationMutex);
         return _shaderHandler->LoadShader(_device, desc);
     }
 
     ComputeShaderID RendererVK::LoadShader(ComputeShaderDesc& desc)
     {
+        std::scoped_lock lock(_creationMutex);
         return _shaderHandler->LoadShader(_device, desc);
     }
 
+    void RendererVK::DestroyImage(ImageID image)
+    {
+        _pipelineHandler->DestroyPipelinesUsingImage(_device, image);
+        _imageHandler->DestroyImage(_device, image);
+    }
+
+    void RendererVK::DestroyDepthImage(DepthImageID image)
+    {
+        _pipelineHandler->DestroyPipelinesUsingImage(_device, image);
+        _imageHandler->DestroyDepthImage(_device, image);
+    }
+
+    void RendererVK::DestroySampler(SamplerID sampler)
+    {
+        _samplerHandler->DestroySampler(_device, sampler);
+    }
+
+    void RendererVK::DestroyPipeline(GraphicsPipelineID pipeline)
+    {
+        _pipelineHandler->DestroyPipeline(_device, pipeline);
+    }
+
+    void RendererVK::DestroyPipeline(ComputePipelineID pipeline)
+    {
+        _pipelineHandler->DestroyPipeline(_device, pipeline);
+    }
+
+    void RendererVK::DestroyModel(ModelID model)
+    {
+        _modelHandler->DestroyModel(_device, model);
+    }
+
+    void RendererVK::DestroyTexture(TextureID texture)
+    {
+        _textureHandler->DestroyTexture(_device, texture);
+    }
+
+    void RendererVK::DestroyTextureArray(TextureArrayID textureArray)
+    {
+        _textureHandler->DestroyTextureArray(_device, textureArray);
+    }
+
     CommandListID RendererVK::BeginCommandList()
     {
         return _commandListHandler->BeginCommandList(_device);
@@ -140,7 +209,7 @@ namespace Renderer
 
     void RendererVK::EndCommandList(CommandListID commandListID)
     {
-        if (_renderPassOpenCount != 0)
+        if (_commandListHandler->GetRenderPassOpenCount(commandListID) != 0)
         {
             NC_LOG_FATAL("We found unmatched calls to BeginPipeline in your commandlist, for every BeginPipeline you need to also EndPipeline!");
         }
@@ -211,7 +280,78 @@ namespace Renderer
         _device->TransitionImageLayout(commandBuffer, image, range.aspectMask, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, 1);
     }
 
-    void RendererVK::Draw(CommandListID commandListID, ModelID modelID)
+    void RendererVK::ImageBarrier(CommandListID commandListID, ImageID imageID, ResourceAccess srcAccess, ResourceAccess dstAccess)
+    {
+        VkCommandBuffer commandBuffer = _commandListHandler->GetCommandBuffer(commandListID);
+        const ImageDesc& desc = _imageHandler->GetImageDesc(imageID);
+
+        VkImageMemoryBarrier imageBarrier = {};
+        imageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        imageBarrier.srcAccessMask = Backend::FormatConverterVK::ToVkAccessFlags(srcAccess, false);
+        imageBarrier.dstAccessMask = Backend::FormatConverterVK::ToVkAccessFlags(dstAccess, false);
+        imageBarrier.oldLayout = Backend::FormatConverterVK::ToVkImageLayout(srcAccess, false);
+        imageBarrier.newLayout = Backend::FormatConverterVK::ToVkImageLayout(dstAccess, false);
+        imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        imageBarrier.image = _imageHandler->GetImage(imageID);
+        imageBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        imageBarrier.subresourceRange.baseMipLevel = 0;
+        imageBarrier.subresourceRange.levelCount = 1;
+        imageBarrier.subresourceRange.baseArrayLayer = 0;
+        imageBarrier.subresourceRange.layerCount = desc.depth;
+
+        VkPipelineStageFlags srcStageMask = Backend::FormatConverterVK::ToVkPipelineStageFlags(srcAccess, false);
+        VkPipelineStageFlags dstStageMask = Backend::FormatConverterVK::ToVkPipelineStageFlags(dstAccess, false);
+
+        vkCmdPipelineBarrier(commandBuffer, srcStageMask, dstStageMask, 0, 0, nullptr, 0, nullptr, 1, &imageBarrier);
+    }
+
+    void RendererVK::ImageBarrier(CommandListID commandListID, DepthImageID imageID, ResourceAccess srcAccess, ResourceAccess dstAccess)
+    {
+        VkCommandBuffer commandBuffer = _commandListHandler->GetCommandBuffer(commandListID);
+
+        VkImageMemoryBarrier imageBarrier = {};
+        imageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        imageBarrier.srcAccessMask = Backend::FormatConverterVK::ToVkAccessFlags(srcAccess, true);
+        imageBarrier.dstAccessMask = Backend::FormatConverterVK::ToVkAccessFlags(dstAccess, true);
+        imageBarrier.oldLayout = Backend::FormatConverterVK::ToVkImageLayout(srcAccess, true);
+        imageBarrier.newLayout = Backend::FormatConverterVK::ToVkImageLayout(dstAccess, true);
+        imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        imageBarrier.image = _imageHandler->GetImage(imageID);
+        imageBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+        imageBarrier.subresourceRange.baseMipLevel = 0;
+        imageBarrier.subresourceRange.levelCount = 1;
+        imageBarrier.subresourceRange.baseArrayLayer = 0;
+        imageBarrier.subresourceRange.layerCount = 1;
+
+        VkPipelineStageFlags srcStageMask = Backend::FormatConverterVK::ToVkPipelineStageFlags(srcAccess, true);
+        VkPipelineStageFlags dstStageMask = Backend::FormatConverterVK::ToVkPipelineStageFlags(dstAccess, true);
+
+        vkCmdPipelineBarrier(commandBuffer, srcStageMask, dstStageMask, 0, 0, nullptr, 0, nullptr, 1, &imageBarrier);
+    }
+
+    void RendererVK::BufferBarrier(CommandListID commandListID, void* buffer, ResourceAccess srcAccess, ResourceAccess dstAccess)
+    {
+        VkCommandBuffer commandBuffer = _commandListHandler->GetCommandBuffer(commandListID);
+
+        VkBufferMemoryBarrier bufferBarrier = {};
+        bufferBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        bufferBarrier.srcAccessMask = Backend::FormatConverterVK::ToVkAccessFlags(srcAccess, false);
+        bufferBarrier.dstAccessMask = Backend::FormatConverterVK::ToVkAccessFlags(dstAccess, false);
+        bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        bufferBarrier.buffer = *static_cast<VkBuffer*>(buffer);
+        bufferBarrier.offset = 0;
+        bufferBarrier.size = VK_WHOLE_SIZE;
+
+        VkPipelineStageFlags srcStageMask = Backend::FormatConverterVK::ToVkPipelineStageFlags(srcAccess, false);
+        VkPipelineStageFlags dstStageMask = Backend::FormatConverterVK::ToVkPipelineStageFlags(dstAccess, false);
+
+        vkCmdPipelineBarrier(commandBuffer, srcStageMask, dstStageMask, 0, 0, nullptr, 1, &bufferBarrier, 0, nullptr);
+    }
+
+    void RendererVK::Draw(CommandListID commandListID, ModelID modelID, u32 baseInstance, u32 numInstances)
     {
         VkCommandBuffer commandBuffer = _commandListHandler->GetCommandBuffer(commandListID);
 
@@ -224,13 +364,20 @@ namespace Renderer
         VkBuffer indexBuffer = _modelHandler->GetIndexBuffer(modelID);
         vkCmdBindIndexBuffer(commandBuffer, indexBuffer, 0, VK_INDEX_TYPE_UINT32);
 
+        // The binds above still happen when we skip, the CommandList tracks them as bound
+        if (!IsBoundGraphicsPipelineReady(commandListID))
+            return;
+
         // Draw
         u32 numIndices = _modelHandler->GetNumIndices(modelID);
-        vkCmdDrawIndexed(commandBuffer, numIndices, 1, 0, 0, 0);
+        vkCmdDrawIndexed(commandBuffer, numIndices, numInstances, 0, 0, baseInstance);
     }
 
     void RendererVK::DrawBindless(CommandListID commandListID, u32 numVertices, u32 numInstances)
     {
+        if (!IsBoundGraphicsPipelineReady(commandListID))
+            return;
+
         VkCommandBuffer commandBuffer = _commandListHandler->GetCommandBuffer(commandListID);
 
         // Draw
@@ -245,10 +392,124 @@ namespace Renderer
         VkBuffer indexBuffer = _modelHandler->GetIndexBuffer(modelID);
         vkCmdBindIndexBuffer(commandBuffer, indexBuffer, 0, VK_INDEX_TYPE_UINT32);
 
+        if (!IsBoundGraphicsPipelineReady(commandListID))
+            return;
+
         // Draw
         vkCmdDrawIndexed(commandBuffer, numVertices, numInstances, 0, 0, 0);
     }
 
+    void RendererVK::DrawIndirect(CommandListID commandListID, void* argumentBuffer, u32 argumentBufferOffset, u32 drawCount)
+    {
+        if (!IsBoundGraphicsPipelineReady(commandListID))
+            return;
+
+        VkCommandBuffer commandBuffer = _commandListHandler->GetCommandBuffer(commandListID);
+        VkBuffer vkArgumentBuffer = *static_cast<VkBuffer*>(argumentBuffer);
+
+        // Draw
+        if (_device->_hasMultiDrawIndirect)
+        {
+            vkCmdDrawIndirect(commandBuffer, vkArgumentBuffer, argumentBufferOffset, drawCount, sizeof(DrawIndirectArguments));
+        }
+        else
+        {
+            // Without multiDrawIndirect every indirect draw has to be recorded on its own
+            for (u32 i = 0; i < drawCount; i++)
+            {
+                vkCmdDrawIndirect(commandBuffer, vkArgumentBuffer, argumentBufferOffset + i * sizeof(DrawIndirectArguments), 1, sizeof(DrawIndirectArguments));
+            }
+        }
+    }
+
+    void RendererVK::DrawIndexedIndirect(CommandListID commandListID, ModelID modelID, void* argumentBuffer, u32 argumentBufferOffset, u32 drawCount)
+    {
+        VkCommandBuffer commandBuffer = _commandListHandler->GetCommandBuffer(commandListID);
+        VkBuffer vkArgumentBuffer = *static_cast<VkBuffer*>(argumentBuffer);
+
+        // Bind index buffer
+        VkBuffer indexBuffer = _modelHandler->GetIndexBuffer(modelID);
+        vkCmdBindIndexBuffer(commandBuffer, indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+
+        if (!IsBoundGraphicsPipelineReady(commandListID))
+            return;
+
+        // Draw
+        if (_device->_hasMultiDrawIndirect)
+        {
+            vkCmdDrawIndexedIndirect(commandBuffer, vkArgumentBuffer, argumentBufferOffset, drawCount, sizeof(DrawIndexedIndirectArguments));
+        }
+        else
+        {
+            // Without multiDrawIndirect every indirect draw has to be recorded on its own
+            for (u32 i = 0; i < drawCount; i++)
+            {
+                vkCmdDrawIndexedIndirect(commandBuffer, vkArgumentBuffer, argumentBufferOffset + i * sizeof(DrawIndexedIndirectArguments), 1, sizeof(DrawIndexedIndirectArguments));
+            }
+        }
+    }
+
+    void RendererVK::DrawIndirectCount(CommandListID commandListID, void* argumentBuffer, u32 argumentBufferOffset, void* drawCountBuffer, u32 drawCountBufferOffset, u32 maxDrawCount)
+    {
+        if (!IsBoundGraphicsPipelineReady(commandListID))
+            return;
+
+        if (!_device->_hasDrawIndirectCount)
+        {
+            // Without VK_KHR_draw_indirect_count we draw all of them, the unused arguments have an instanceCount of 0 so they don't draw anything
+            DrawIndirect(commandListID, argumentBuffer, argumentBufferOffset, maxDrawCount);
+            return;
+        }
+
+        VkCommandBuffer commandBuffer = _commandListHandler->GetCommandBuffer(commandListID);
+        VkBuffer vkArgumentBuffer = *static_cast<VkBuffer*>(argumentBuffer);
+        VkBuffer vkDrawCountBuffer = *static_cast<VkBuffer*>(drawCountBuffer);
+
+        // Draw
+        _device->fnCmdDrawIndirectCount(commandBuffer, vkArgumentBuffer, argumentBufferOffset, vkDrawCountBuffer, drawCountBufferOffset, maxDrawCount, sizeof(DrawIndirectArguments));
+    }
+
+    void RendererVK::DrawIndexedIndirectCount(CommandListID commandListID, ModelID modelID, void* argumentBuffer, u32 argumentBufferOffset, void* drawCountBuffer, u32 drawCountBufferOffset, u32 maxDrawCount)
+    {
+        if (!_device->_hasDrawIndirectCount)
+        {
+            // Without VK_KHR_draw_indirect_count we draw all of them, the unused arguments have an instanceCount of 0 so they don't draw anything
+            DrawIndexedIndirect(commandListID, modelID, argumentBuffer, argumentBufferOffset, maxDrawCount);
+            return;
+        }
+
+        VkCommandBuffer commandBuffer = _commandListHandler->GetCommandBuffer(commandListID);
+        VkBuffer vkArgumentBuffer = *static_cast<VkBuffer*>(argumentBuffer);
+        VkBuffer vkDrawCountBuffer = *static_cast<VkBuffer*>(drawCountBuffer);
+
+        // Bind index buffer
+        VkBuffer indexBuffer = _modelHandler->GetIndexBuffer(modelID);
+        vkCmdBindIndexBuffer(commandBuffer, indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+
+        if (!IsBoundGraphicsPipelineReady(commandListID))
+            return;
+
+        // Draw
+        _device->fnCmdDrawIndexedIndirectCount(commandBuffer, vkArgumentBuffer, argumentBufferOffset, vkDrawCountBuffer, drawCountBufferOffset, maxDrawCount, sizeof(DrawIndexedIndirectArguments));
+    }
+
+    void RendererVK::Dispatch(CommandListID commandListID, u32 threadGroupCountX, u32 threadGroupCountY, u32 threadGroupCountZ)
+    {
+        VkCommandBuffer commandBuffer = _commandListHandler->GetCommandBuffer(commandListID);
+        assert(_commandListHandler->GetBoundComputePipeline(commandListID) != ComputePipelineID::Invalid()); // Dispatching needs a compute pipeline set
+
+        vkCmdDispatch(commandBuffer, threadGroupCountX, threadGroupCountY, threadGroupCountZ);
+    }
+
+    void RendererVK::DispatchIndirect(CommandListID commandListID, void* argumentBuffer, u32 argumentBufferOffset)
+    {
+        VkCommandBuffer commandBuffer = _commandListHandler->GetCommandBuffer(commandListID);
+        assert(_commandListHandler->GetBoundComputePipeline(commandListID) != ComputePipelineID::Invalid()); // Dispatching needs a compute pipeline set
+
+        VkBuffer vkArgumentBuffer = *static_cast<VkBuffer*>(argumentBuffer);
+        vkCmdDispatchIndirect(commandBuffer, vkArgumentBuffer, argumentBufferOffset);
+    }
+
     void RendererVK::PopMarker(CommandListID commandListID)
     {
         VkCommandBuffer commandBuffer = _commandListHandler->GetCommandBuffer(commandListID);
@@ -264,14 +525,14 @@ namespace Renderer
     void RendererVK::SetConstantBuffer(CommandListID commandListID, u32 slot, void* descriptor, size_t frameIndex)
     {
         VkCommandBuffer commandBuffer = _commandListHandler->GetCommandBuffer(commandListID);
-        GraphicsPipelineID graphicsPipelineID = _commandListHandler->GetBoundGraphicsPipeline(commandListID);
 
-        Backend::DescriptorSetLayoutData& descriptorSetLayoutData = _pipelineHandler->GetDescriptorSetLayoutData(graphicsPipelineID, slot);
-        VkDescriptorSetLayout& descriptorSetLayout = _pipelineHandler->GetDescriptorSetLayout(graphicsPipelineID, slot);
-        VkPipelineLayout pipelineLayout = _pipelineHandler->GetPipelineLayout(graphicsPipelineID);
+        VkPipelineLayout pipelineLayout;
+        VkPipelineBindPoint bindPoint = GetBoundPipelineLayout(commandListID, pipelineLayout);
+        VkDescriptorSetLayout& descriptorSetLayout = GetBoundDescriptorSetLayout(commandListID, slot);
 
         // TODO: This is ugly, we really don't want to do this here, but without reflecting the descriptorSetLayout we need the user to provide it, how can we fix this?
         Backend::BufferBackendVK* buffer = static_cast<Backend::BufferBackendVK*>(descriptor);
+        std::scoped_lock lock(buffer->descriptorMutex); // Commandlists can be recorded in parallel and several of them might bind the same buffer
         if (buffer->descriptorPool == NULL)
         {
             VkDescriptorPoolSize poolSize = {};
@@ -323,20 +584,20 @@ namespace Renderer
         }
 
         // Bind descriptor set
-        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, slot, 1, &buffer->descriptorSet.Get(frameIndex), 0, nullptr);
+        vkCmdBindDescriptorSets(commandBuffer, bindPoint, pipelineLayout, slot, 1, &buffer->descriptorSet.Get(frameIndex), 0, nullptr);
     }
 
     void RendererVK::SetStorageBuffer(CommandListID commandListID, u32 slot, void* descriptor, size_t frameIndex)
     {
         VkCommandBuffer commandBuffer = _commandListHandler->GetCommandBuffer(commandListID);
-        GraphicsPipelineID graphicsPipelineID = _commandListHandler->GetBoundGraphicsPipeline(commandListID);
 
-        Backend::DescriptorSetLayoutData& descriptorSetLayoutData = _pipelineHandler->GetDescriptorSetLayoutData(graphicsPipelineID, slot);
-        VkDescriptorSetLayout& descriptorSetLayout = _pipelineHandler->GetDescriptorSetLayout(graphicsPipelineID, slot);
-        VkPipelineLayout pipelineLayout = _pipelineHandler->GetPipelineLayout(graphicsPipelineID);
+        VkPipelineLayout pipelineLayout;
+        VkPipelineBindPoint bindPoint = GetBoundPipelineLayout(commandListID, pipelineLayout);
+        VkDescriptorSetLayout& descriptorSetLayout = GetBoundDescriptorSetLayout(commandListID, slot);
 
         // TODO: This is ugly, we really don't want to do this here, but without reflecting the descriptorSetLayout we need the user to provide it, how can we fix this?
         Backend::BufferBackendVK* buffer = static_cast<Backend::BufferBackendVK*>(descriptor);
+        std::scoped_lock lock(buffer->descriptorMutex); // Commandlists can be recorded in parallel and several of them might bind the same buffer
         if (buffer->descriptorPool == NULL)
         {
             VkDescriptorPoolSize poolSize = {};
@@ -388,7 +649,7 @@ namespace Renderer
         }
 
         // Bind descriptor set
-        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, slot, 1, &buffer->descriptorSet.Get(frameIndex), 0, nullptr);
+        vkCmdBindDescriptorSets(commandBuffer, bindPoint, pipelineLayout, slot, 1, &buffer->descriptorSet.Get(frameIndex), 0, nullptr);
     }
 
     void RendererVK::BeginPipeline(CommandListID commandListID, GraphicsPipelineID pipelineID)
@@ -400,11 +661,12 @@ namespace Renderer
         VkRenderPass renderPass = _pipelineHandler->GetRenderPass(pipelineID);
         VkFramebuffer frameBuffer = _pipelineHandler->GetFramebuffer(pipelineID);
 
-        if (_renderPassOpenCount != 0)
+        i8 renderPassOpenCount = _commandListHandler->GetRenderPassOpenCount(commandListID);
+        if (renderPassOpenCount != 0)
         {
             NC_LOG_FATAL("You need to match your BeginPipeline calls with a EndPipeline call before beginning another pipeline!");
         }
-        _renderPassOpenCount++;
+        _commandListHandler->SetRenderPassOpenCount(commandListID, renderPassOpenCount + 1);
 
         // Set up renderpass
         VkRenderPassBeginInfo renderPassInfo = {};
@@ -417,28 +679,44 @@ namespace Renderer
         // Start renderpass
         vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
 
-        // Bind pipeline
-        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+        // Bind pipeline, if it's still compiling the draws until EndPipeline get skipped instead
+        if (pipeline != VK_NULL_HANDLE)
+        {
+            vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+        }
 
         _commandListHandler->SetBoundGraphicsPipeline(commandListID, pipelineID);
+        _commandListHandler->SetBoundComputePipeline(commandListID, ComputePipelineID::Invalid());
     }
 
     void RendererVK::EndPipeline(CommandListID commandListID, GraphicsPipelineID /*pipelineID*/)
     {
         VkCommandBuffer commandBuffer = _commandListHandler->GetCommandBuffer(commandListID);
 
-        if (_renderPassOpenCount <= 0)
+        i8 renderPassOpenCount = _commandListHandler->GetRenderPassOpenCount(commandListID);
+        if (renderPassOpenCount <= 0)
         {
             NC_LOG_FATAL("You tried to call EndPipeline without first calling BeginPipeline!");
         }
-        _renderPassOpenCount--;
+        _commandListHandler->SetRenderPassOpenCount(commandListID, renderPassOpenCount - 1);
 
         vkCmdEndRenderPass(commandBuffer);
     }
 
-    void RendererVK::SetPipeline(CommandListID /*commandListID*/, ComputePipelineID /*pipelineID*/)
+    void RendererVK::SetPipeline(CommandListID commandListID, ComputePipelineID pipelineID)
     {
-        
+        VkCommandBuffer commandBuffer = _commandListHandler->GetCommandBuffer(commandListID);
+
+        if (_commandListHandler->GetRenderPassOpenCount(commandListID) != 0)
+        {
+            NC_LOG_FATAL("Compute pipelines can't be set between BeginPipeline and EndPipeline!");
+        }
+
+        VkPipeline pipeline = _pipelineHandler->GetPipeline(pipelineID);
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+
+        _commandListHandler->SetBoundComputePipeline(commandListID, pipelineID);
+        _commandListHandler->SetBoundGraphicsPipeline(commandListID, GraphicsPipelineID::Invalid());
     }
 
     void RendererVK::SetScissorRect(CommandListID /*commandListID*/, ScissorRect /*scissorRect*/)
@@ -454,37 +732,53 @@ namespace Renderer
     void RendererVK::SetSampler(CommandListID commandListID, u32 slot, SamplerID samplerID)
     {
         VkCommandBuffer commandBuffer = _commandListHandler->GetCommandBuffer(commandListID);
-        GraphicsPipelineID graphicsPipelineID = _commandListHandler->GetBoundGraphicsPipeline(commandListID);
-        VkPipelineLayout pipelineLayout = _pipelineHandler->GetPipelineLayout(graphicsPipelineID);
+
+        VkPipelineLayout pipelineLayout;
+        VkPipelineBindPoint bindPoint = GetBoundPipelineLayout(commandListID, pipelineLayout);
 
         VkDescriptorSet samplerDescriptor = _samplerHandler->GetDescriptorSet(samplerID);
 
         // Bind descriptor set
-        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, slot, 1, &samplerDescriptor, 0, nullptr);
+        vkCmdBindDescriptorSets(commandBuffer, bindPoint, pipelineLayout, slot, 1, &samplerDescriptor, 0, nullptr);
     }
 
     void RendererVK::SetTexture(CommandListID commandListID, u32 slot, TextureID textureID)
     {
         VkCommandBuffer commandBuffer = _commandListHandler->GetCommandBuffer(commandListID);
-        GraphicsPipelineID graphicsPipelineID = _commandListHandler->GetBoundGraphicsPipeline(commandListID);
-        VkPipelineLayout pipelineLayout = _pipelineHandler->GetPipelineLayout(graphicsPipelineID);
+
+        VkPipelineLayout pipelineLayout;
+        VkPipelineBindPoint bindPoint = GetBoundPipelineLayout(commandListID, pipelineLayout);
 
         VkDescriptorSet textureDescriptor = _textureHandler->GetDescriptorSet(textureID);
 
         // Bind descriptor set
-        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, slot, 1, &textureDescriptor, 0, nullptr);
+        vkCmdBindDescriptorSets(commandBuffer, bindPoint, pipelineLayout, slot, 1, &textureDescriptor, 0, nullptr);
     }
 
     void RendererVK::SetTextureArray(CommandListID commandListID, u32 slot, TextureArrayID textureArrayID)
     {
         VkCommandBuffer commandBuffer = _commandListHandler->GetCommandBuffer(commandListID);
-        GraphicsPipelineID graphicsPipelineID = _commandListHandler->GetBoundGraphicsPipeline(commandListID);
-        VkPipelineLayout pipelineLayout = _pipelineHandler->GetPipelineLayout(graphicsPipelineID);
+
+        VkPipelineLayout pipelineLayout;
+        VkPipelineBindPoint bindPoint = GetBoundPipelineLayout(commandListID, pipelineLayout);
 
         VkDescriptorSet textureArrayDescriptor = _textureHandler->GetDescriptorSet(textureArrayID);
 
         // Bind descriptor set
-        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, slot, 1, &textureArrayDescriptor, 0, nullptr);
+        vkCmdBindDescriptorSets(commandBuffer, bindPoint, pipelineLayout, slot, 1, &textureArrayDescriptor, 0, nullptr);
+    }
+
+    void RendererVK::SetStorageImage(CommandListID commandListID, u32 slot, ImageID imageID)
+    {
+        VkCommandBuffer commandBuffer = _commandListHandler->GetCommandBuffer(commandListID);
+
+        VkPipelineLayout pipelineLayout;
+        VkPipelineBindPoint bindPoint = GetBoundPipelineLayout(commandListID, pipelineLayout);
+
+        VkDescriptorSet storageImageDescriptor = _imageHandler->GetStorageDescriptorSet(imageID);
+
+        // Bind descriptor set
+        vkCmdBindDescriptorSets(commandBuffer, bindPoint, pipelineLayout, slot, 1, &storageImageDescriptor, 0, nullptr);
     }
 
     void RendererVK::SetVertexBuffer(CommandListID commandListID, u32 slot, ModelID modelID)
@@ -516,20 +810,120 @@ namespace Renderer
         vkCmdBindVertexBuffers(commandBuffer, slot, 1, &vkBuffer, offsets);
     }
 
-    void RendererVK::Present(Window* window, ImageID imageID)
+    void RendererVK::PushConstant(CommandListID commandListID, const void* data, u32 offset, u32 size)
     {
-        CommandListID commandListID = _commandListHandler->BeginCommandList(_device);
         VkCommandBuffer commandBuffer = _commandListHandler->GetCommandBuffer(commandListID);
-        PushMarker(commandListID, Color::Red, "Present Blitting");
 
+        VkPipelineLayout pipelineLayout;
+        GetBoundPipelineLayout(commandListID, pipelineLayout);
+
+        // Vulkan wants the stages of every range the update touches
+        VkShaderStageFlags stageFlags = 0;
+        for (const VkPushConstantRange& range : GetBoundPushConstantRanges(commandListID))
+        {
+            if (offset < range.offset + range.size && range.offset < offset + size)
+            {
+                stageFlags |= range.stageFlags;
+            }
+        }
+
+        if (stageFlags == 0)
+        {
+            NC_LOG_FATAL("Tried to push constants to a range that the bound pipeline doesn't declare in its pushConstantRanges!");
+        }
+
+        vkCmdPushConstants(commandBuffer, pipelineLayout, stageFlags, offset, size, data);
+    }
+
+    VkPipelineBindPoint RendererVK::GetBoundPipelineLayout(CommandListID commandListID, VkPipelineLayout& pipelineLayout)
+    {
+        ComputePipelineID computePipelineID = _commandListHandler->GetBoundComputePipeline(commandListID);
+        if (computePipelineID != ComputePipelineID::Invalid())
+        {
+            pipelineLayout = _pipelineHandler->GetPipelineLayout(computePipelineID);
+            return VK_PIPELINE_BIND_POINT_COMPUTE;
+        }
+
+        GraphicsPipelineID graphicsPipelineID = _commandListHandler->GetBoundGraphicsPipeline(commandListID);
+        assert(graphicsPipelineID != GraphicsPipelineID::Invalid()); // Binding resources needs a pipeline to bind them to
+
+        pipelineLayout = _pipelineHandler->GetPipelineLayout(graphicsPipelineID);
+        return VK_PIPELINE_BIND_POINT_GRAPHICS;
+    }
+
+    VkDescriptorSetLayout& RendererVK::GetBoundDescriptorSetLayout(CommandListID commandListID, u32 slot)
+    {
+        ComputePipelineID computePipelineID = _commandListHandler->GetBoundComputePipeline(commandListID);
+        if (computePipelineID != ComputePipelineID::Invalid())
+            return _pipelineHandler->GetDescriptorSetLayout(computePipelineID, slot);
+
+        return _pipelineHandler->GetDescriptorSetLayout(_commandListHandler->GetBoundGraphicsPipeline(commandListID), slot);
+    }
+
+    bool RendererVK::IsBoundGraphicsPipelineReady(CommandListID commandListID)
+    {
+        GraphicsPipelineID graphicsPipelineID = _commandListHandler->GetBoundGraphicsPipeline(commandListID);
+        return graphicsPipelineID == GraphicsPipelineID::Invalid() || _pipelineHandler->IsPipelineReady(graphicsPipelineID);
+    }
+
+    const std::vector<VkPushConstantRange>& RendererVK::GetBoundPushConstantRanges(CommandListID commandListID)
+    {
+        ComputePipelineID computePipelineID = _commandListHandler->GetBoundComputePipeline(commandListID);
+        if (computePipelineID != ComputePipelineID::Invalid())
+            return _pipelineHandler->GetPushConstantRanges(computePipelineID);
+
+        return _pipelineHandler->GetPushConstantRanges(_commandListHandler->GetBoundGraphicsPipeline(commandListID));
+    }
+
+    void RendererVK::Present(Window* window, ImageID imageID)
+    {
         Backend::SwapChainVK* swapChain = static_cast<Backend::SwapChainVK*>(window->GetSwapChain());
 
-        u32 semaphoreIndex = swapChain->frameIndex;
+        // If we can't recreate it yet the window is minimized, so there's nothing to present to
+        if (swapChain->isOutOfDate && !_device->RecreateSwapChain(_shaderHandler, window))
+        {
+            EndFrame();
+            return;
+        }
+
+        // Semaphores and descriptor sets are per frame in flight, the swapchain image we get back can be any of them
+        u32 semaphoreIndex = _device->GetFrameIndex();
 
         // Acquire next swapchain image
         u32 frameIndex;
-        vkAcquireNextImageKHR(_device->_device, swapChain->swapChain, UINT64_MAX, swapChain->imageAvailableSemaphores[semaphoreIndex], VK_NULL_HANDLE, &frameIndex);
+        VkResult result = vkAcquireNextImageKHR(_device->_device, swapChain->swapChain, UINT64_MAX, swapChain->imageAvailableSemaphores[semaphoreIndex], VK_NULL_HANDLE, &frameIndex);
+        if (result == VK_ERROR_OUT_OF_DATE_KHR)
+        {
+            // Nothing was acquired so the semaphore won't be signaled, skip presenting this frame and recreate before the next one
+            swapChain->isOutOfDate = true;
+            EndFrame();
+            return;
+        }
+        else if (result == VK_SUBOPTIMAL_KHR)
+        {
+            // We can still present to it, so we recreate it after this frame
+            swapChain->isOutOfDate = true;
+        }
+        else if (result != VK_SUCCESS)
+        {
+            NC_LOG_FATAL("Failed to acquire swapchain image!");
+        }
+
+        // EndFrame only waited for the frame FRAMES_IN_FLIGHT ago, the image we got back might still be used by a different one
+        VkFence frameFence = _device->_frameFences[semaphoreIndex];
+        VkFence imageFence = swapChain->imagesInFlight[frameIndex];
+        if (imageFence != VK_NULL_HANDLE && imageFence != frameFence)
+        {
+            vkWaitForFences(_device->_device, 1, &imageFence, VK_TRUE, UINT64_MAX);
+        }
+        swapChain->imagesInFlight[frameIndex] = frameFence;
+
+        CommandListID commandListID = _commandListHandler->BeginCommandList(_device);
+        VkCommandBuffer commandBuffer = _commandListHandler->GetCommandBuffer(commandListID);
+        PushMarker(commandListID, Color::Red, "Present Blitting");
+
         _commandListHandler->SetWaitSemaphore(commandListID, swapChain->imageAvailableSemaphores[semaphoreIndex]);
+        _commandListHandler->SetSignalSemaphore(commandListID, swapChain->renderFinishedSemaphores[semaphoreIndex]);
 
         ImageDesc imageDesc = _imageHandler->GetImageDesc(imageID);
         ImageComponentType componentType = ToImageComponentType(imageDesc.format);
@@ -546,7 +940,7 @@ namespace Renderer
 
         VkWriteDescriptorSet descriptorWrite = {};
         descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        descriptorWrite.dstSet = pipeline.descriptorSet;
+        descriptorWrite.dstSet = pipeline.descriptorSets[semaphoreIndex];
         descriptorWrite.dstBinding = 0;
         descriptorWrite.dstArrayElement = 0;
         descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
@@ -576,7 +970,7 @@ namespace Renderer
        
         // Bind pipeline and descriptors and render
         vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline.pipeline);
-        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline.pipelineLayout, 0, 1, &pipeline.descriptorSet, 0, nullptr);
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline.pipelineLayout, 0, 1, &pipeline.descriptorSets[semaphoreIndex], 0, nullptr);
 
         vkCmdDraw(commandBuffer, 3, 1, 0, 0);
 
@@ -591,19 +985,47 @@ namespace Renderer
         // Present
         VkPresentInfoKHR presentInfo = {};
         presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
-        presentInfo.waitSemaphoreCount = 0;
-        presentInfo.pWaitSemaphores = VK_NULL_HANDLE;
+        presentInfo.waitSemaphoreCount = 1;
+        presentInfo.pWaitSemaphores = &swapChain->renderFinishedSemaphores[semaphoreIndex];
 
         presentInfo.swapchainCount = 1;
         presentInfo.pSwapchains = &swapChain->swapChain;
         presentInfo.pImageIndices = &frameIndex;
         presentInfo.pResults = nullptr; // Optional
 
-        vkQueuePresentKHR(_device->_presentQueue, &presentInfo);
-        vkQueueWaitIdle(_device->_presentQueue);
+        result = vkQueuePresentKHR(_device->_presentQueue, &presentInfo);
+        if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR)
+        {
+            swapChain->isOutOfDate = true;
+        }
+        else if (result != VK_SUCCESS)
+        {
+            NC_LOG_FATAL("Failed to present swapchain image!");
+        }
+
+        EndFrame();
+    }
 
-        // Flip frameIndex between 0 and 1
-        swapChain->frameIndex = !swapChain->frameIndex;
+    void RendererVK::EndFrame()
+    {
+        // This blocks until the frame we are about to reuse has retired, after that its command lists are free to record again
+        _device->EndFrame();
+        _commandListHandler->RecycleCommandLists(_device->GetFrameIndex());
+
+        // We're between frames here, so this is where shaders changed on disk get swapped in
+        Backend::ReloadedShaders reloadedShaders;
+        _shaderHandler->ReloadModifiedShaders(_device, reloadedShaders);
+        if (!reloadedShaders.IsEmpty())
+        {
+            _pipelineHandler->RecompilePipelinesUsingShaders(_device, _shaderHandler, reloadedShaders);
+            _shaderHandler->DestroyOldShaderModules(_device, reloadedShaders);
+        }
+
+        // Pipelines that finished compiling since last frame can be used from the next frame on
+        _pipelineHandler->CollectCompiledPipelines(_device);
+
+        // Transient images no rendergraph has held for a while get freed
+        _imageHandler->EvictUnusedTransientImages(_device, _pipelineHandler);
     }
 
     void RendererVK::Present(Window* /*window*/, DepthImageID /*image*/)
@@ -611,8 +1033,13 @@ namespace Renderer
         
     }
 
-    Backend::BufferBackend* RendererVK::CreateBufferBackend(size_t size, Backend::BufferBackend::Type type)
+    Backend::BufferBackend* RendererVK::CreateBufferBackend(size_t size, Backend::BufferBackend::Type type, Backend::BufferBackend::Usage usage)
+    {
+        return _device->CreateBufferBackend(size, type, usage);
+    }
+
+    void RendererVK::DestroyBufferBackend(Backend::BufferBackend* buffer)
     {
-        return _device->CreateBufferBackend(size, type);
+        _device->DestroyBufferBackend(buffer);
     }
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 #include "../../Renderer.h"
+#include <vulkan/vulkan.h>
 
 namespace Renderer
 {
@@ -27,6 +28,11 @@ namespace Renderer
         ImageID CreateImage(ImageDesc& desc) override;
         DepthImageID CreateDepthImage(DepthImageDesc& desc) override;
 
+        ImageID AcquireTransientImage(ImageDesc& desc, u32 aliasSlot) override;
+        DepthImageID AcquireTransientDepthImage(DepthImageDesc& desc, u32 aliasSlot) override;
+        void ReleaseTransientImage(ImageID image) override;
+        void ReleaseTransientDepthImage(DepthImageID image) override;
+
         SamplerID CreateSampler(SamplerDesc& desc) override;
 
         GraphicsPipelineID CreatePipeline(GraphicsPipelineDesc& desc) override;
@@ -50,14 +56,37 @@ namespace Renderer
         PixelShaderID LoadShader(PixelShaderDesc& desc) override;
         ComputeShaderID LoadShader(ComputeShaderDesc& desc) override;
 
+        // Destruction
+        void DestroyImage(ImageID image) override;
+        void DestroyDepthImage(DepthImageID image) override;
+
+        void DestroySampler(SamplerID sampler) override;
+
+        void DestroyPipeline(GraphicsPipelineID pipeline) override;
+        void DestroyPipeline(ComputePipelineID pipeline) override;
+
+        void DestroyModel(ModelID model) override;
+
+        void DestroyTexture(TextureID texture) override;
+        void DestroyTextureArray(TextureArrayID textureArray) override;
+
         // Command List Functions
         CommandListID BeginCommandList() override;
         void EndCommandList(CommandListID commandListID) override;
         void Clear(CommandListID commandListID, ImageID image, Color color) override;
         void Clear(CommandListID commandListID, DepthImageID image, DepthClearFlags clearFlags, f32 depth, u8 stencil) override;
-        void Draw(CommandListID commandListID, ModelID modelID) override;
+        void ImageBarrier(CommandListID commandListID, ImageID image, ResourceAccess srcAccess, ResourceAccess dstAccess) override;
+        void ImageBarrier(CommandListID commandListID, DepthImageID image, ResourceAccess srcAccess, ResourceAccess dstAccess) override;
+        void BufferBarrier(CommandListID commandListID, void* buffer, ResourceAccess srcAccess, ResourceAccess dstAccess) override;
+        void Draw(CommandListID commandListID, ModelID modelID, u32 baseInstance, u32 numInstances) override;
         void DrawBindless(CommandListID commandList, u32 numVertices, u32 numInstances) override;
         void DrawIndexedBindless(CommandListID commandList, ModelID modelID, u32 numVertices, u32 numInstances) override;
+        void DrawIndirect(CommandListID commandList, void* argumentBuffer, u32 argumentBufferOffset, u32 drawCount) override;
+        void DrawIndexedIndirect(CommandListID commandList, ModelID modelID, void* argumentBuffer, u32 argumentBufferOffset, u32 drawCount) override;
+        void DrawIndirectCount(CommandListID commandList, void* argumentBuffer, u32 argumentBufferOffset, void* drawCountBuffer, u32 drawCountBufferOffset, u32 maxDrawCount) override;
+        void DrawIndexedIndirectCount(CommandListID commandList, ModelID modelID, void* argumentBuffer, u32 argumentBufferOffset, void* drawCountBuffer, u32 drawCountBufferOffset, u32 maxDrawCount) override;
+        void Dispatch(CommandListID commandListID, u32 threadGroupCountX, u32 threadGroupCountY, u32 threadGroupCountZ) override;
+        void DispatchIndirect(CommandListID commandListID, void* argumentBuffer, u32 argumentBufferOffset) override;
         void PopMarker(CommandListID commandListID) override;
         void PushMarker(CommandListID commandListID, Color color, std::string name) override;
         void SetConstantBuffer(CommandListID commandListID, u32 slot, void* descriptor, size_t frameIndex) override;
@@ -70,16 +99,27 @@ namespace Renderer
         void SetSampler(CommandListID commandListID, u32 slot, SamplerID samplerID) override;
         void SetTexture(CommandListID commandList, u32 slot, TextureID texture) override;
         void SetTextureArray(CommandListID commandList, u32 slot, TextureArrayID textureArray) override;
+        void SetStorageImage(CommandListID commandListID, u32 slot, ImageID image) override;
         void SetVertexBuffer(CommandListID commandList, u32 slot, ModelID modelID) override;
         void SetIndexBuffer(CommandListID commandList, ModelID modelID) override;
         void SetBuffer(CommandListID commandList, u32 slot, void* buffer) override;
+        void PushConstant(CommandListID commandList, const void* data, u32 offset, u32 size) override;
 
         // Non-commandlist based present functions
         void Present(Window* window, ImageID image) override;
         void Present(Window* window, DepthImageID image) override;
         
     protected:
-        Backend::BufferBackend* CreateBufferBackend(size_t size, Backend::BufferBackend::Type type) override;
+        Backend::BufferBackend* CreateBufferBackend(size_t size, Backend::BufferBackend::Type type, Backend::BufferBackend::Usage usage) override;
+        void DestroyBufferBackend(Backend::BufferBackend* buffer) override;
+
+    private:
+        // Resources bind to whichever of the graphics or compute pipeline was set last
+        VkPipelineBindPoint GetBoundPipelineLayout(CommandListID commandListID, VkPipelineLayout& pipelineLayout);
+        VkDescriptorSetLayout& GetBoundDescriptorSetLayout(CommandListID commandListID, u32 slot);
+        const std::vector<VkPushConstantRange>& GetBoundPushConstantRanges(CommandListID commandListID);
+        bool IsBoundGraphicsPipelineReady(CommandListID commandListID); // Draws are skipped while the bound pipeline is still compiling
+        void EndFrame(); // The end of Present, also runs when there was no swapchain image to present to
 
     private:
         Backend::RenderDeviceVK* _device = nullptr;
@@ -90,7 +130,5 @@ namespace Renderer
         Backend::PipelineHandlerVK* _pipelineHandler = nullptr;
         Backend::CommandListHandlerVK* _commandListHandler = nullptr;
         Backend::SamplerHandlerVK* _samplerHandler = nullptr;
-
-        i8 _renderPassOpenCount = 0;
     };
 }
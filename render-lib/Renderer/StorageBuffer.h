@@ -1,5 +1,6 @@
 #pragma once
 #include "BufferBackend.h"
+#include "FrameResource.h"
 
 namespace Renderer
 {
@@ -20,7 +21,9 @@ namespace Renderer
 
         void ApplyAll()
         {
-            for (u32 i = 0; i < 2; i++)
+            // Static buffers only have the one copy, so a single upload covers every frame
+            u32 numCopies = (usage == Backend::BufferBackend::USAGE_STATIC) ? 1 : FRAMES_IN_FLIGHT;
+            for (u32 i = 0; i < numCopies; i++)
             {
                 Apply(i);
             }
@@ -37,6 +40,7 @@ namespace Renderer
         }
 
         Backend::BufferBackend* backend = nullptr;
+        Backend::BufferBackend::Usage usage = Backend::BufferBackend::USAGE_DYNAMIC;
 
     protected:
         StorageBuffer() {}; // This has to be created through Renderer::CreateStorageBuffer<T>
@@ -0,0 +1,44 @@
+#include <NovusTypes.h>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+#include "ShaderReflectionVK.h"
+
+// Usage: shader-reflector <input.spv> <output.reflect>
+int main(int argc, char* argv[])
+{
+    if (argc != 3)
+    {
+        printf("Usage: shader-reflector <input.spv> <output.reflect>\n");
+        return 1;
+    }
+
+    std::ifstream file(argv[1], std::ios::ate | std::ios::binary);
+    if (!file.is_open())
+    {
+        printf("shader-reflector: Failed to open %s\n", argv[1]);
+        return 1;
+    }
+
+    size_t fileSize = static_cast<size_t>(file.tellg());
+    std::vector<char> spirv(fileSize);
+
+    file.seekg(0);
+    file.read(spirv.data(), fileSize);
+    file.close();
+
+    Renderer::Backend::ShaderReflection reflection;
+    if (!Renderer::Backend::ShaderReflectionVK::Reflect(spirv.data(), spirv.size(), reflection))
+    {
+        printf("shader-reflector: Failed to reflect %s\n", argv[1]);
+        return 1;
+    }
+
+    if (!Renderer::Backend::ShaderReflectionVK::Save(argv[2], reflection))
+    {
+        printf("shader-reflector: Failed to write %s\n", argv[2]);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,45 @@
+#version 450
+#extension GL_KHR_vulkan_glsl : enable
+#extension GL_ARB_separate_shader_objects : enable
+
+// What we are drawing, 0 is a textured panel and 1 is a signed distance field glyph, matches UIRenderer::UI_SHADER_MODE_*
+layout(constant_id = 0) const uint UI_SHADER_MODE = 0;
+
+layout(push_constant) uniform PushConstants
+{
+	vec4 color; // Both modes read color
+	vec4 outlineColor; // Only read by text, panels don't push it
+	float outlineWidth; // Only read by text, panels don't push it
+} uiConstants;
+
+layout(set = 0, binding = 0) uniform sampler _sampler;
+layout(set = 1, binding = 0) uniform texture2D _texture;
+
+layout(location = 0) in vec2 fragTexCoord;
+
+layout(location = 0) out vec4 outColor;
+
+void main() 
+{
+	if (UI_SHADER_MODE == 0)
+	{
+		outColor = texture(sampler2D(_texture, _sampler), fragTexCoord);
+		outColor *= uiConstants.color;
+	}
+	else
+	{
+		float distance = texture(sampler2D(_texture, _sampler), fragTexCoord).r;
+		float smoothWidth = fwidth(distance);
+		float alpha = smoothstep(0.5 - smoothWidth, 0.5 + smoothWidth, distance);
+		vec3 rgb = vec3(alpha) * uiConstants.color.rgb;
+
+		if (uiConstants.outlineWidth > 0.0)
+		{
+			float w = 1.0 - uiConstants.outlineWidth;
+			alpha = smoothstep(w - smoothWidth, w + smoothWidth, distance);
+			rgb += mix(vec3(alpha), uiConstants.outlineColor.rgb, alpha);
+		}
+
+		outColor = vec4(rgb, alpha);
+	}
+}
\ No newline at end of file
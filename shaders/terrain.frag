@@ -5,24 +5,28 @@
 #extension VK_EXT_descriptor_indexing : enable
 #extension GL_EXT_scalar_block_layout : enable
 
+// How many of the chunk's diffuse layers we blend, the layers past this are compiled out
+layout(constant_id = 0) const uint NUM_TERRAIN_LAYERS = 4;
+
 // Textures
-layout(set = 3, binding = 0) uniform sampler alphaSampler;
-layout(set = 4, binding = 0) uniform sampler colorSampler;
-layout(set = 5, binding = 0) uniform texture2D terrainColorTextures[4096];
-layout(set = 6, binding = 0) uniform texture2DArray terrainAlphaTextures[196];
+layout(set = 2, binding = 0) uniform sampler alphaSampler;
+layout(set = 3, binding = 0) uniform sampler colorSampler;
+layout(set = 4, binding = 0) uniform texture2D terrainColorTextures[4096];
+layout(set = 5, binding = 0) uniform texture2DArray terrainAlphaTextures[196];
 
 struct ChunkData
 {
 	uvec4 diffuseIDs;
 };
-layout(set = 7, binding = 0, std430) uniform ChunkDataBuffer
+layout(set = 6, binding = 0, std430) readonly buffer ChunkDataBuffer
 {
-    ChunkData chunkDatas[256];
+    ChunkData chunkDatas[];
 };
 
 // From vertex shader
 layout(location = 0) flat in uint fragInstanceID;
 layout(location = 1) in vec2 fragTexCoord;
+layout(location = 2) flat in uint fragChunkDataIndex;
 
 layout(location = 0) out vec4 outColor;
 
@@ -41,23 +45,31 @@ void main()
 	// [2222] diffuseIDs[1]
 	// [3333] diffuseIDs[2]
 	// [AA44] diffuseIDs[3] Alpha is read from the most significant bits, the fourth diffuseID read from the least 
-	uint diffuse0ID = chunkDatas[fragInstanceID].diffuseIDs[0];
-	uint diffuse1ID = chunkDatas[fragInstanceID].diffuseIDs[1];
-	uint diffuse2ID = chunkDatas[fragInstanceID].diffuseIDs[2];
-	uint diffuse3ID = chunkDatas[fragInstanceID].diffuseIDs[3] & 0xFFFF;
-	uint alphaID	= chunkDatas[fragInstanceID].diffuseIDs[3] >> 16;
+	uint diffuse0ID = chunkDatas[fragChunkDataIndex].diffuseIDs[0];
+	uint diffuse1ID = chunkDatas[fragChunkDataIndex].diffuseIDs[1];
+	uint diffuse2ID = chunkDatas[fragChunkDataIndex].diffuseIDs[2];
+	uint diffuse3ID = chunkDatas[fragChunkDataIndex].diffuseIDs[3] & 0xFFFF;
+	uint alphaID	= chunkDatas[fragChunkDataIndex].diffuseIDs[3] >> 16;
 	
 	vec3 alpha = texture(sampler2DArray(terrainAlphaTextures[alphaID], alphaSampler), alphaUV).rgb;
 
-	vec4 diffuse0 = texture(sampler2D(terrainColorTextures[diffuse0ID], colorSampler), uv);
-	vec4 diffuse1 = texture(sampler2D(terrainColorTextures[diffuse1ID], colorSampler), uv);
-	vec4 diffuse2 = texture(sampler2D(terrainColorTextures[diffuse2ID], colorSampler), uv);
-	vec4 diffuse3 = texture(sampler2D(terrainColorTextures[diffuse3ID], colorSampler), uv);
+	vec4 color = texture(sampler2D(terrainColorTextures[diffuse0ID], colorSampler), uv);
 
-	vec4 color = diffuse0;
-	color = diffuse1 * alpha.r + (1.0 - alpha.r) * color;
-	color = diffuse2 * alpha.g + (1.0 - alpha.g) * color;
-	color = diffuse3 * alpha.b + (1.0 - alpha.b) * color;
+	if (NUM_TERRAIN_LAYERS > 1)
+	{
+		vec4 diffuse1 = texture(sampler2D(terrainColorTextures[diffuse1ID], colorSampler), uv);
+		color = diffuse1 * alpha.r + (1.0 - alpha.r) * color;
+	}
+	if (NUM_TERRAIN_LAYERS > 2)
+	{
+		vec4 diffuse2 = texture(sampler2D(terrainColorTextures[diffuse2ID], colorSampler), uv);
+		color = diffuse2 * alpha.g + (1.0 - alpha.g) * color;
+	}
+	if (NUM_TERRAIN_LAYERS > 3)
+	{
+		vec4 diffuse3 = texture(sampler2D(terrainColorTextures[diffuse3ID], colorSampler), uv);
+		color = diffuse3 * alpha.b + (1.0 - alpha.b) * color;
+	}
 
 	outColor = color;
 }
\ No newline at end of file
@@ -9,34 +9,36 @@ layout(set = 0, binding = 0) uniform SharedUBO
     mat4 proj;
 } sharedUbo;
 
-layout(set = 1, binding = 0) uniform ModelUBO 
-{
-	vec4 colorMultiplier;
-    mat4 model;
-} modelUbo;
-
 struct Vertex
 {
     vec4 position;
     vec4 texCoord;
 };
-layout(set = 2, binding = 0, std430) readonly buffer VertexBuffer
+layout(set = 1, binding = 0, std430) readonly buffer VertexBuffer
 {
     Vertex vertices[];
 };
 
+layout(push_constant) uniform PushConstants
+{
+    uint chunkDataIndex; // Where this chunk starts in the chunk data buffer
+    uint vertexOffset; // Where this chunk starts in the vertex buffer
+} pushConstants;
+
 layout(location = 0) in uint inInstanceID;
 
 layout(location = 0) out uint fragInstanceID;
 layout(location = 1) out vec2 fragTexCoord;
+layout(location = 2) flat out uint fragChunkDataIndex;
 
 void main()
 {
-    uint vertexID = gl_VertexIndex + (inInstanceID * 145); // 145 vertices per cell
+    uint vertexID = pushConstants.vertexOffset + gl_VertexIndex + (inInstanceID * 145); // 145 vertices per cell
 
-    vec3 position = vertices[vertexID].position.xyz;
-    gl_Position = sharedUbo.proj * sharedUbo.view * modelUbo.model * vec4(position, 1.0);
+    vec3 position = vertices[vertexID].position.xyz; // Chunk vertices are already in world space
+    gl_Position = sharedUbo.proj * sharedUbo.view * vec4(position, 1.0);
 
 	fragTexCoord = vertices[vertexID].texCoord.xy;
+    fragChunkDataIndex = pushConstants.chunkDataIndex + inInstanceID;
     fragInstanceID = inInstanceID;
 }
\ No newline at end of file
@@ -6,23 +6,24 @@
 #extension GL_EXT_scalar_block_layout : enable
 
 // Textures
-layout(set = 3, binding = 0) uniform sampler alphaSampler;
-layout(set = 4, binding = 0) uniform sampler colorSampler;
-layout(set = 5, binding = 0) uniform texture2D terrainTextures[4096];
-layout(set = 6, binding = 0) uniform texture2DArray terrainAlphaTextures[196];
+layout(set = 2, binding = 0) uniform sampler alphaSampler;
+layout(set = 3, binding = 0) uniform sampler colorSampler;
+layout(set = 4, binding = 0) uniform texture2D terrainTextures[4096];
+layout(set = 5, binding = 0) uniform texture2DArray terrainAlphaTextures[196];
 
 struct ChunkData
 {
 	uvec4 diffuseIDs;
 };
-layout(set = 7, binding = 0, std430) uniform ChunkDataBuffer
+layout(set = 6, binding = 0, std430) readonly buffer ChunkDataBuffer
 {
-    ChunkData chunkDatas[256];
+    ChunkData chunkDatas[];
 };
 
 // From vertex shader
 layout(location = 0) flat in uint fragInstanceID;
 layout(location = 1) in vec2 fragTexCoord;
+layout(location = 2) flat in uint fragChunkDataIndex;
 
 layout(location = 0) out uvec4 outTextureID;
 layout(location = 1) out vec4 outAlphaMap;
@@ -42,11 +43,11 @@ void main()
 	// [2222] diffuseIDs[1]
 	// [3333] diffuseIDs[2]
 	// [AA44] diffuseIDs[3] Alpha is read from the most significant bits, the fourth diffuseID read from the least 
-	uint diffuse0ID = chunkDatas[fragInstanceID].diffuseIDs[0];
-	uint diffuse1ID = chunkDatas[fragInstanceID].diffuseIDs[1];
-	uint diffuse2ID = chunkDatas[fragInstanceID].diffuseIDs[2];
-	uint diffuse3ID = (chunkDatas[fragInstanceID].diffuseIDs[3] & 0xFFFF);
-	uint alphaID	= (chunkDatas[fragInstanceID].diffuseIDs[3] & 0xFFFF0000) >> 16;
+	uint diffuse0ID = chunkDatas[fragChunkDataIndex].diffuseIDs[0];
+	uint diffuse1ID = chunkDatas[fragChunkDataIndex].diffuseIDs[1];
+	uint diffuse2ID = chunkDatas[fragChunkDataIndex].diffuseIDs[2];
+	uint diffuse3ID = (chunkDatas[fragChunkDataIndex].diffuseIDs[3] & 0xFFFF);
+	uint alphaID	= (chunkDatas[fragChunkDataIndex].diffuseIDs[3] & 0xFFFF0000) >> 16;
 	
 	vec3 alphaBlend = texture(sampler2DArray(terrainAlphaTextures[alphaID], alphaSampler), alphaUV).rgb;
 
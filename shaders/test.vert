@@ -7,11 +7,15 @@ layout(set = 0, binding = 0) uniform SharedUniformBufferObject
     mat4 proj;
 } sharedUbo;
 
-layout(set = 1, binding = 0) uniform ModelUniformBufferObject 
+struct Instance
 {
-	vec4 colorMultiplier;
+    vec4 colorMultiplier;
     mat4 model;
-} modelUbo;
+};
+layout(set = 1, binding = 0, std430) readonly buffer InstanceBuffer
+{
+    Instance instances[];
+};
 
 layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec3 inNormal;
@@ -21,6 +25,6 @@ layout(location = 0) out vec2 fragTexCoord;
 
 void main() 
 {
-    gl_Position = sharedUbo.proj * sharedUbo.view * modelUbo.model * vec4(inPosition, 1.0);
+    gl_Position = sharedUbo.proj * sharedUbo.view * instances[gl_InstanceIndex].model * vec4(inPosition, 1.0);
 	fragTexCoord = inTexCoord;
 }
\ No newline at end of file